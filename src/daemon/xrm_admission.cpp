@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2019-2021, Xilinx Inc - All rights reserved
+ *
+ * Copyright (C) 2023, Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Xilinx Resource Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "xrm_admission.hpp"
+
+/*
+ * Admit one more connection, it has no client context yet. Return false if the limit of the
+ * connections without context or the limit of the user is reached.
+ */
+bool xrm::admission::admitConnection(bool userKnown, uid_t uid) {
+    std::unique_lock<std::mutex> lock(m_lock);
+
+    if (m_numIdleConnection >= m_limitIdleConnection) return (false);
+    if (userKnown && m_limitUserConnection) {
+        uint32_t& numUserConnection = m_numUserConnection[uid];
+        if (numUserConnection >= m_limitUserConnection) return (false);
+        numUserConnection++;
+    }
+    m_numIdleConnection++;
+    return (true);
+}
+
+void xrm::admission::releaseConnection(bool userKnown, uid_t uid, bool hasContext) {
+    std::unique_lock<std::mutex> lock(m_lock);
+
+    if (hasContext) {
+        if (m_numContextConnection > 0) m_numContextConnection--;
+    } else {
+        if (m_numIdleConnection > 0) m_numIdleConnection--;
+    }
+    if (userKnown && m_limitUserConnection) {
+        auto it = m_numUserConnection.find(uid);
+        if (it != m_numUserConnection.end() && --it->second == 0) m_numUserConnection.erase(it);
+    }
+}
+
+/*
+ * The connection creates a client context, move it from the connections without context to
+ * the ones with context. Return false if the limit of concurrent clients is reached, then the
+ * connection stays counted as one without context.
+ */
+bool xrm::admission::enterContext() {
+    std::unique_lock<std::mutex> lock(m_lock);
+
+    if (m_numContextConnection >= m_limitContextConnection) return (false);
+    m_numContextConnection++;
+    if (m_numIdleConnection > 0) m_numIdleConnection--;
+    return (true);
+}
+
+/*
+ * The client context of the connection is destroyed, e.g. the connection is kept in the
+ * connection pool of the client.
+ */
+void xrm::admission::leaveContext() {
+    std::unique_lock<std::mutex> lock(m_lock);
+
+    if (m_numContextConnection > 0) m_numContextConnection--;
+    m_numIdleConnection++;
+}
+
+/*
+ * Run the task at once if there is free slot, otherwise queue it until one is freed by
+ * finishCommand(). Return false if the queue is full, the task is not run then.
+ */
+bool xrm::admission::submitCommand(taskFunc task) {
+    std::unique_lock<std::mutex> lock(m_lock);
+
+    if (m_numRunningCommand < m_commandSlotNum) {
+        m_numRunningCommand++;
+        lock.unlock();
+        task();
+        return (true);
+    }
+    if (m_pendingCommands.size() >= m_limitPendingCommand) return (false);
+    m_pendingCommands.push_back(task);
+    return (true);
+}
+
+/*
+ * The slot is handed over to the first queued task, which is posted to the io thread pool.
+ */
+void xrm::admission::finishCommand() {
+    std::unique_lock<std::mutex> lock(m_lock);
+
+    if (m_pendingCommands.empty()) {
+        m_numRunningCommand--;
+        return;
+    }
+    taskFunc task = m_pendingCommands.front();
+    m_pendingCommands.pop_front();
+    lock.unlock();
+    boost::asio::post(m_ioService, task);
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2019-2021, Xilinx Inc - All rights reserved
+ *
+ * Copyright (C) 2023, Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Xilinx Resource Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef _XRM_ADMISSION_HPP_
+#define _XRM_ADMISSION_HPP_
+
+#include <sys/types.h>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <boost/asio.hpp>
+
+namespace xrm {
+
+/*
+ * Admission control of the daemon, shared by the server and the sessions.
+ *
+ * The connection is admitted up to the limit of the connections without client context and
+ * the limit of the connections from one user, the user is known only for the unix domain
+ * socket. The connection over the limit is answered with XRM_ERROR_DAEMON_IS_BUSY and closed.
+ * Once the connection creates a client context, it's counted against the limit of concurrent
+ * clients instead, so the clients with context never take the room of the admin tool or the
+ * idle pooled connections, and the other way around.
+ *
+ * The json requests without framing (context creating, admin commands and the clients
+ * without binary framing) run in limited number of slots, so a burst of them can not take
+ * all the io threads from the framed allocation and release traffic. The ones waiting for a
+ * slot are queued in order, the request over the queue limit is rejected at once.
+ */
+class admission {
+   public:
+    typedef std::function<void()> taskFunc;
+
+    admission(boost::asio::io_service& ioService,
+              uint32_t limitContextConnection,
+              uint32_t limitIdleConnection,
+              uint32_t limitUserConnection,
+              uint32_t commandSlotNum,
+              uint32_t limitPendingCommand)
+        : m_ioService(ioService),
+          m_limitContextConnection(limitContextConnection),
+          m_limitIdleConnection(limitIdleConnection),
+          m_limitUserConnection(limitUserConnection),
+          m_commandSlotNum(commandSlotNum),
+          m_limitPendingCommand(limitPendingCommand) {}
+
+    bool admitConnection(bool userKnown, uid_t uid);
+    void releaseConnection(bool userKnown, uid_t uid, bool hasContext);
+    bool enterContext();
+    void leaveContext();
+    bool submitCommand(taskFunc task);
+    void finishCommand();
+
+   private:
+    boost::asio::io_service& m_ioService;
+    std::mutex m_lock;
+    uint32_t m_limitContextConnection; // same as the limit of concurrent clients
+    uint32_t m_limitIdleConnection;
+    uint32_t m_limitUserConnection; // 0: no limit
+    uint32_t m_commandSlotNum;
+    uint32_t m_limitPendingCommand;
+    uint32_t m_numContextConnection = 0;
+    uint32_t m_numIdleConnection = 0;
+    std::map<uid_t, uint32_t> m_numUserConnection;
+    uint32_t m_numRunningCommand = 0;
+    std::deque<taskFunc> m_pendingCommands;
+};
+} // namespace xrm
+
+#endif // _XRM_ADMISSION_HPP_
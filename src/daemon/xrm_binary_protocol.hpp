@@ -0,0 +1,264 @@
+/*
+ * Copyright (C) 2019-2021, Xilinx Inc - All rights reserved
+ *
+ * Copyright (C) 2023, Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Xilinx Resource Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef _XRM_BINARY_PROTOCOL_HPP_
+#define _XRM_BINARY_PROTOCOL_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/types.h>
+#include "xrm_limits.h"
+
+/*
+ * Binary framing for the hot path commands, it's used next to the json framing
+ * on the same connection. The client asks for it with binaryProtocolVersion
+ * in createContext request, and daemon answers with the version it supports
+ * (0 means not supported, then client stays on json).
+ *
+ * frame from client: binaryFrameHeader + request record
+ * frame from daemon: 4 bytes length (same as json response) + binaryFrameHeader + response record
+ *
+ * Records are fixed layout in host byte order since client and daemon are on same host.
+ * Every response record starts with int32_t status, when the daemon can not handle the
+ * request it answers with binaryStatusResponse only.
+ *
+ * From version 2, any json request can be carried in a frame with XRM_BINARY_OP_JSON,
+ * the record is the json text and the response record is the json response. Frames are
+ * processed concurrently, so the client can pipeline requests on one connection and
+ * match the responses, which may come back out of order, by requestId of the header.
+ *
+ * From version 4, independent operations can be carried in one XRM_BINARY_OP_BATCH frame,
+ * they are processed in order under one lock acquisition and answered with per operation
+ * results, see binaryBatchRequest.
+ *
+ * From version 5, the json cuAlloc, cuListAlloc and cuGroupAlloc requests in frame with
+ * waitPriority (and optional waitTimeout in microseconds) parameters are parked in the daemon
+ * until the allocation is done or timed out, instead of being polled by the client. The waiter
+ * with higher priority is served first, then the earlier one.
+ *
+ * From version 6, the connection subscribed with eventSubscribe json request keeps one
+ * eventWait json request in frame, the daemon answers it with the queued events (cu available,
+ * device offline / reset, xclbin loaded / unloaded, reserve pool relinquished) or parks it
+ * until the next event comes. The client sends the next eventWait after each answer.
+ */
+
+#define XRM_BINARY_PROTOCOL_MAGIC 0x4d525842 // "BXRM" on wire, never the '{' starting json request
+#define XRM_BINARY_PROTOCOL_VERSION_1 1 // frame format, hot path records
+#define XRM_BINARY_PROTOCOL_VERSION_2 2 // json in frame, pipelined requests
+#define XRM_BINARY_PROTOCOL_VERSION_3 3 // shared memory ring, see xrm_shm_ring.hpp
+#define XRM_BINARY_PROTOCOL_VERSION_4 4 // batched operations
+#define XRM_BINARY_PROTOCOL_VERSION_5 5 // blocking allocation waits in daemon
+#define XRM_BINARY_PROTOCOL_VERSION_6 6 // event subscription
+#define XRM_BINARY_PROTOCOL_VERSION XRM_BINARY_PROTOCOL_VERSION_6
+
+/* max length of response record, the frame is limited to 128K as json response */
+#define XRM_BINARY_MAX_RESPONSE_LEN (131072 - 4 - 16)
+
+namespace xrm {
+
+enum binaryOpcode {
+    XRM_BINARY_OP_NONE = 0,
+    XRM_BINARY_OP_CU_ALLOC_V2 = 1,
+    XRM_BINARY_OP_CU_RELEASE_V2 = 2,
+    XRM_BINARY_OP_CU_LIST_ALLOC_V2 = 3,
+    XRM_BINARY_OP_CU_LIST_RELEASE_V2 = 4,
+    XRM_BINARY_OP_CU_CHECK_STATUS = 5,
+    XRM_BINARY_OP_BATCH = 6,
+    XRM_BINARY_OP_ALLOCATION_QUERY_V2 = 7, // only inside batch
+    XRM_BINARY_OP_JSON = 0xFFFF, // json request / response carried in the frame
+};
+
+#pragma pack(push, 1)
+
+struct binaryFrameHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t opcode;
+    uint32_t requestId;
+    uint32_t length; // length of the record following this header
+};
+
+struct binaryCuProperty {
+    char kernelName[XRM_MAX_NAME_LEN];
+    char kernelAlias[XRM_MAX_NAME_LEN];
+    int64_t deviceInfo;
+    int64_t memoryInfo;
+    int64_t policyInfo;
+    uint64_t poolId;
+    int32_t devExcl;
+    int32_t requestLoadUnified;
+    int32_t requestLoadOriginal;
+    int32_t reserved;
+};
+
+/* allocated cu, it's what client gives back for release and status check */
+struct binaryCuHandle {
+    int32_t deviceId;
+    int32_t cuId;
+    int32_t channelId;
+    int32_t cuType;
+    uint64_t allocServiceId;
+    int32_t channelLoadUnified;
+    int32_t channelLoadOriginal;
+    uint64_t poolId;
+};
+
+struct binaryCuResource {
+    char xclbinFileName[XRM_MAX_PATH_NAME_LEN];
+    char uuidStr[XRM_MAX_NAME_LEN];
+    char kernelPluginFileName[XRM_MAX_PATH_NAME_LEN];
+    char kernelName[XRM_MAX_NAME_LEN];
+    char kernelAlias[XRM_MAX_NAME_LEN];
+    char instanceName[XRM_MAX_NAME_LEN];
+    char cuName[XRM_MAX_NAME_LEN];
+    binaryCuHandle handle;
+    uint64_t baseAddr;
+    uint32_t membankId;
+    uint32_t membankType;
+    uint64_t membankSize;
+    uint64_t membankBaseAddr;
+};
+
+struct binaryStatusResponse {
+    int32_t status;
+    int32_t reserved;
+};
+
+struct binaryCuAllocV2Request {
+    uint64_t clientId;
+    int32_t clientProcessId;
+    int32_t reserved;
+    binaryCuProperty cuProp;
+};
+
+struct binaryCuAllocV2Response {
+    int32_t status;
+    int32_t reserved;
+    binaryCuResource cuRes;
+};
+
+/* only cuNum entries of cuProps are on wire */
+struct binaryCuListAllocV2Request {
+    uint64_t clientId;
+    int32_t clientProcessId;
+    int32_t cuNum;
+    binaryCuProperty cuProps[XRM_MAX_LIST_CU_NUM_V2];
+};
+
+/* only cuNum entries of cuResources are on wire */
+struct binaryCuListAllocV2Response {
+    int32_t status;
+    int32_t cuNum;
+    binaryCuResource cuResources[XRM_MAX_LIST_CU_NUM_V2];
+};
+
+struct binaryCuReleaseV2Request {
+    uint64_t clientId;
+    binaryCuHandle cuHandle;
+};
+
+/* only cuNum entries of cuHandles are on wire */
+struct binaryCuListReleaseV2Request {
+    uint64_t clientId;
+    int32_t cuNum;
+    int32_t reserved;
+    binaryCuHandle cuHandles[XRM_MAX_LIST_CU_NUM_V2];
+};
+
+struct binaryCuCheckStatusRequest {
+    uint64_t clientId;
+    binaryCuHandle cuHandle;
+};
+
+struct binaryCuCheckStatusResponse {
+    int32_t status;
+    int32_t isBusy;
+    int32_t usedLoadUnified;
+    int32_t usedLoadOriginal;
+};
+
+/*
+ * Batch of operations, followed by opNum operations, each is binaryBatchOpHeader followed by
+ * the operation record:
+ *   XRM_BINARY_OP_CU_ALLOC_V2: binaryCuProperty
+ *   XRM_BINARY_OP_CU_RELEASE_V2: binaryCuHandle
+ *   XRM_BINARY_OP_CU_CHECK_STATUS: binaryCuHandle
+ *   XRM_BINARY_OP_ALLOCATION_QUERY_V2: binaryAllocationQueryV2Request
+ * The client id and process id of the batch apply to all the operations.
+ */
+struct binaryBatchRequest {
+    uint64_t clientId;
+    int32_t clientProcessId;
+    int32_t opNum;
+};
+
+/*
+ * Followed by opNum results in the order of the operations, each is binaryBatchOpHeader
+ * followed by the response record of the operation:
+ *   XRM_BINARY_OP_CU_ALLOC_V2: binaryCuAllocV2Response
+ *   XRM_BINARY_OP_CU_RELEASE_V2: binaryStatusResponse
+ *   XRM_BINARY_OP_CU_CHECK_STATUS: binaryCuCheckStatusResponse
+ *   XRM_BINARY_OP_ALLOCATION_QUERY_V2: binaryCuListAllocV2Response, cuNum entries on wire
+ */
+struct binaryBatchResponse {
+    int32_t status;
+    int32_t opNum;
+};
+
+struct binaryBatchOpHeader {
+    uint16_t opcode;
+    uint16_t reserved;
+    uint32_t length; // length of the record following this header
+};
+
+struct binaryAllocationQueryV2Request {
+    uint64_t allocServiceId;
+    char kernelName[XRM_MAX_NAME_LEN];
+    char kernelAlias[XRM_MAX_NAME_LEN];
+};
+
+#pragma pack(pop)
+
+/*
+ * The process id reported by kernel is trusted over the one provided by the client, it's put
+ * into the request record before the record is dispatched. The records carrying the process
+ * id all have it right after the client id, the one of batch applies to all the operations.
+ * Other records are not changed.
+ */
+static_assert(offsetof(binaryCuAllocV2Request, clientProcessId) == sizeof(uint64_t) &&
+                  offsetof(binaryCuListAllocV2Request, clientProcessId) == sizeof(uint64_t) &&
+                  offsetof(binaryBatchRequest, clientProcessId) == sizeof(uint64_t),
+              "client process id is not right after client id");
+
+inline void binaryOverrideProcessId(uint16_t opcode, char* req, uint32_t reqLen, pid_t processId) {
+    int32_t clientProcessId = processId;
+
+    if (processId <= 0) return;
+    if (opcode != XRM_BINARY_OP_CU_ALLOC_V2 && opcode != XRM_BINARY_OP_CU_LIST_ALLOC_V2 &&
+        opcode != XRM_BINARY_OP_BATCH)
+        return;
+    if (reqLen < sizeof(uint64_t) + sizeof(int32_t)) return;
+    memcpy(req + sizeof(uint64_t), &clientProcessId, sizeof(clientProcessId));
+}
+
+} // namespace xrm
+
+#endif // _XRM_BINARY_PROTOCOL_HPP_
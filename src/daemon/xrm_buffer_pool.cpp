@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2019-2021, Xilinx Inc - All rights reserved
+ *
+ * Copyright (C) 2023, Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Xilinx Resource Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "xrm_buffer_pool.hpp"
+
+xrm::bufferPool::~bufferPool() {
+    for (int32_t i = 0; i < XRM_BUFFER_POOL_CLASS_NUM; i++) {
+        for (auto buf : m_freeList[i]) delete buf;
+        m_freeList[i].clear();
+    }
+}
+
+/*
+ * Get the size class fitting the size, -1 if it's bigger than the largest class
+ */
+int32_t xrm::bufferPool::getClass(std::size_t size) {
+    std::size_t classSize = XRM_BUFFER_POOL_MIN_SIZE;
+
+    for (int32_t i = 0; i < XRM_BUFFER_POOL_CLASS_NUM; i++, classSize <<= 2) {
+        if (size <= std::min(classSize, (std::size_t)XRM_BUFFER_POOL_MAX_SIZE)) return (i);
+    }
+    return (-1);
+}
+
+/*
+ * Get a buffer of the size, the capacity is the size of the class so it can be resized
+ * up to the class size without allocation.
+ */
+xrm::bufferPool::buffer_ptr xrm::bufferPool::get(std::size_t size) {
+    std::vector<char>* buf = NULL;
+    int32_t classId = getClass(size);
+
+    if (classId >= 0) {
+        std::unique_lock<std::mutex> lock(m_lock);
+        if (!m_freeList[classId].empty()) {
+            buf = m_freeList[classId].back();
+            m_freeList[classId].pop_back();
+        }
+    }
+    if (buf == NULL) {
+        buf = new std::vector<char>;
+        if (classId >= 0)
+            buf->reserve(std::min((std::size_t)XRM_BUFFER_POOL_MIN_SIZE << (2 * classId),
+                                  (std::size_t)XRM_BUFFER_POOL_MAX_SIZE));
+    }
+    buf->resize(size);
+
+    auto self(shared_from_this());
+    return (buffer_ptr(buf, [self](std::vector<char>* buf) { self->put(buf); }));
+}
+
+void xrm::bufferPool::put(std::vector<char>* buf) {
+    int32_t classId = getClass(buf->capacity());
+
+    /* capacity is exactly the class size for the buffer from pool */
+    if (classId >= 0 && buf->capacity() == std::min((std::size_t)XRM_BUFFER_POOL_MIN_SIZE << (2 * classId),
+                                                    (std::size_t)XRM_BUFFER_POOL_MAX_SIZE)) {
+        std::size_t maxFree = (classId == 0) ? XRM_BUFFER_POOL_MAX_FREE_SMALL : XRM_BUFFER_POOL_MAX_FREE_LARGE;
+        std::unique_lock<std::mutex> lock(m_lock);
+        if (m_freeList[classId].size() < maxFree) {
+            m_freeList[classId].push_back(buf);
+            return;
+        }
+    }
+    delete buf;
+}
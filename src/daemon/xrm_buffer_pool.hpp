@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2019-2021, Xilinx Inc - All rights reserved
+ *
+ * Copyright (C) 2023, Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Xilinx Resource Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef _XRM_BUFFER_POOL_HPP_
+#define _XRM_BUFFER_POOL_HPP_
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#define XRM_BUFFER_POOL_CLASS_NUM 4           // 4 KB, 16 KB, 64 KB, 128 KB
+#define XRM_BUFFER_POOL_MIN_SIZE 4096         // size of the smallest class
+#define XRM_BUFFER_POOL_MAX_SIZE 131072       // size of the largest class, same as max request length
+#define XRM_BUFFER_POOL_MAX_FREE_SMALL 1024   // max free buffers kept in the smallest class
+#define XRM_BUFFER_POOL_MAX_FREE_LARGE 16     // max free buffers kept in other classes
+
+namespace xrm {
+
+/*
+ * Buffers shared by all the sessions for request and response data. The session only
+ * holds a buffer while there is data to be handled or written, so the idle connection
+ * costs no buffer memory.
+ *
+ * The buffer comes from the smallest size class fitting the request, the one bigger than
+ * the largest class is allocated directly. The buffer goes back to the pool when the last
+ * reference is dropped, the free buffers over the limit of the class are released.
+ */
+class bufferPool : public std::enable_shared_from_this<bufferPool> {
+   public:
+    typedef std::shared_ptr<std::vector<char> > buffer_ptr;
+
+    ~bufferPool();
+
+    buffer_ptr get(std::size_t size);
+
+   private:
+    int32_t getClass(std::size_t size);
+    void put(std::vector<char>* buf);
+
+    std::mutex m_lock;
+    std::vector<std::vector<char>*> m_freeList[XRM_BUFFER_POOL_CLASS_NUM];
+};
+} // namespace xrm
+
+#endif // _XRM_BUFFER_POOL_HPP_
@@ -23,21 +23,33 @@
 
 #include <map>
 #include "xrm_system.hpp"
+#include "xrm_binary_protocol.hpp"
 
 namespace pt = boost::property_tree;
 
 namespace xrm {
 class command {
    public:
-    command(const std::string& name, xrm::system& sys) : m_name(name), m_system(&sys) {}
+    command(const std::string& name, xrm::system& sys, uint16_t binaryOpcode = XRM_BINARY_OP_NONE)
+        : m_name(name), m_system(&sys), m_binaryOpcode(binaryOpcode) {}
 
     virtual ~command() {}
     std::string& getName() { return m_name; }
+    uint16_t getBinaryOpcode() { return m_binaryOpcode; }
     virtual void processCmd(pt::ptree& incmd, pt::ptree& outrsp) = 0;
 
+    /*
+     * Binary framing of the command, only the hot path commands implement it.
+     * The response record is filled into rsp and its length into rspLen.
+     */
+    virtual int32_t processBinaryCmd(const char* /*req*/, uint32_t /*reqLen*/, char* /*rsp*/, uint32_t* /*rspLen*/) {
+        return (XRM_ERROR_INVALID);
+    }
+
    protected:
     std::string m_name;
     xrm::system* m_system;
+    uint16_t m_binaryOpcode;
 };
 } // namespace xrm
 
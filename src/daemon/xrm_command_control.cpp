@@ -127,3 +127,17 @@ void xrm::disableOneDeviceCommand::processCmd(pt::ptree& incmd, pt::ptree& outrs
     outrsp.put("response.status.value", XRM_SUCCESS);
     outrsp.put("response.data.ok", "disable one device completed");
 }
+
+/*
+ * The function is for command stats cmd line from xrmadm.
+ */
+void xrm::commandStatsCommand::processCmd(pt::ptree& incmd, pt::ptree& outrsp) {
+    auto requestId = incmd.get<int>("request.requestId");
+    pt::ptree statsTree;
+
+    outrsp.put("response.name", "commandStats");
+    outrsp.put("response.requestId", requestId);
+    m_registry->getStats(statsTree);
+    outrsp.put("response.status", "ok");
+    outrsp.add_child("response.data", statsTree);
+}
@@ -22,6 +22,7 @@
 #define _XRM_COMMAND_CONTROL_HPP_
 
 #include "xrm_command.hpp"
+#include "xrm_command_registry.hpp"
 
 namespace xrm {
 class enableDevicesCommand : public command {
@@ -51,6 +52,18 @@ class disableOneDeviceCommand : public command {
 
     void processCmd(pt::ptree& incmd, pt::ptree& outrsp);
 };
+
+/* counters of the commands dispatched by the registry, for xrmadm */
+class commandStatsCommand : public command {
+   public:
+    commandStatsCommand(xrm::system& sys, xrm::commandRegistry& registry)
+        : command("commandStats", sys), m_registry(&registry) {}
+
+    void processCmd(pt::ptree& incmd, pt::ptree& outrsp);
+
+   private:
+    xrm::commandRegistry* m_registry;
+};
 } // namespace xrm
 
 #endif // _XRM_COMMAND_CONTROL_HPP_
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2019-2021, Xilinx Inc - All rights reserved
+ *
+ * Copyright (C) 2023, Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Xilinx Resource Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef _XRM_COMMAND_OPCODE_HPP_
+#define _XRM_COMMAND_OPCODE_HPP_
+
+#include <stdint.h>
+
+/*
+ * Stable numeric opcodes of the json commands. The opcode is what the registry dispatches
+ * and counts by, the client may carry it as request.opcode next to request.name to skip the
+ * name lookup. The values are part of the protocol: never renumber them, only append.
+ */
+#define XRM_COMMAND_OPCODES(X)        \
+    X(1, list)                        \
+    X(2, load)                        \
+    X(3, loadOneDevice)               \
+    X(4, unload)                      \
+    X(5, unloadOneDevice)             \
+    X(6, enableDevices)               \
+    X(7, disableDevices)              \
+    X(8, enableOneDevice)             \
+    X(9, disableOneDevice)            \
+    X(10, createContext)              \
+    X(11, echoContext)                \
+    X(12, destroyContext)             \
+    X(13, isDaemonRunning)            \
+    X(14, isCuExisting)               \
+    X(15, isCuListExisting)           \
+    X(16, isCuGroupExisting)          \
+    X(17, cuAlloc)                    \
+    X(18, cuAllocFromDev)             \
+    X(19, cuAllocLeastUsedFromDev)    \
+    X(20, cuRelease)                  \
+    X(21, cuListAlloc)                \
+    X(22, cuListRelease)              \
+    X(23, udfCuGroupDeclare)          \
+    X(24, udfCuGroupUndeclare)        \
+    X(25, cuGroupAlloc)               \
+    X(26, cuGroupRelease)             \
+    X(27, cuPoolReserve)              \
+    X(28, cuPoolRelinquish)           \
+    X(29, cuGetMaxCapacity)           \
+    X(30, cuCheckStatus)              \
+    X(31, allocationQuery)            \
+    X(32, reservationQuery)           \
+    X(33, checkCuAvailableNum)        \
+    X(34, checkCuListAvailableNum)    \
+    X(35, checkCuGroupAvailableNum)   \
+    X(36, checkCuPoolAvailableNum)    \
+    X(37, loadXrmPlugins)             \
+    X(38, unloadXrmPlugins)           \
+    X(39, execXrmPluginFunc)          \
+    X(40, cuAllocWithLoad)            \
+    X(41, cuAllocLeastUsedWithLoad)   \
+    X(42, loadAndAllCuAlloc)          \
+    X(43, cuAllocV2)                  \
+    X(44, cuReleaseV2)                \
+    X(45, cuListAllocV2)              \
+    X(46, cuListReleaseV2)            \
+    X(47, udfCuGroupDeclareV2)        \
+    X(48, udfCuGroupUndeclareV2)      \
+    X(49, cuGroupAllocV2)             \
+    X(50, cuGroupReleaseV2)           \
+    X(51, cuPoolReserveV2)            \
+    X(52, cuPoolRelinquishV2)         \
+    X(53, allocationQueryV2)          \
+    X(54, reservationQueryV2)         \
+    X(55, checkCuAvailableNumV2)      \
+    X(56, checkCuListAvailableNumV2)  \
+    X(57, checkCuGroupAvailableNumV2) \
+    X(58, checkCuPoolAvailableNumV2)  \
+    X(59, batch)                      \
+    X(60, commandStats)               \
+    X(61, allocationReleaseV2)
+
+namespace xrm {
+
+enum commandOpcode : uint16_t {
+    XRM_CMD_NONE = 0,
+#define XRM_COMMAND_OPCODE_ENUM(value, name) XRM_CMD_##name = value,
+    XRM_COMMAND_OPCODES(XRM_COMMAND_OPCODE_ENUM)
+#undef XRM_COMMAND_OPCODE_ENUM
+};
+
+/* size of the dense tables indexed by opcode */
+enum {
+#define XRM_COMMAND_OPCODE_COUNT(value, name) +1
+    XRM_CMD_OPCODE_NUM = 1 XRM_COMMAND_OPCODES(XRM_COMMAND_OPCODE_COUNT)
+#undef XRM_COMMAND_OPCODE_COUNT
+};
+
+} // namespace xrm
+
+#endif // _XRM_COMMAND_OPCODE_HPP_
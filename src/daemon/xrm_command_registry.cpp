@@ -27,192 +27,171 @@
 #include "xrm_command_resource.hpp"
 #include "xrm_command_plugin.hpp"
 
-void xrm::commandRegistry::dispatch(std::string& name, pt::ptree& incmd, pt::ptree& outrsp) {
-    auto iter = m_registry.find(name);
-    if (iter != m_registry.end()) {
-        iter->second->processCmd(incmd, outrsp);
-    } else {
-        outrsp.put("response.status", "failed");
-        outrsp.put("response.data.failed", "unsupported cmd name: " + name);
-    }
+xrm::commandRegistry::commandRegistry() {
+#define XRM_COMMAND_OPCODE_MAP(value, name) m_opcodes.insert(std::make_pair(#name, XRM_CMD_##name));
+    XRM_COMMAND_OPCODES(XRM_COMMAND_OPCODE_MAP)
+#undef XRM_COMMAND_OPCODE_MAP
 }
 
-void xrm::commandRegistry::registerAll(system& sys) {
-    auto list = new xrm::listCommand(sys);
-    registerCmd(*list);
-
-    auto load = new xrm::loadCommand(sys);
-    registerCmd(*load);
-
-    auto loadOneDevice = new xrm::loadOneDeviceCommand(sys);
-    registerCmd(*loadOneDevice);
-
-    auto unload = new xrm::unloadCommand(sys);
-    registerCmd(*unload);
-
-    auto unloadOneDevice = new xrm::unloadOneDeviceCommand(sys);
-    registerCmd(*unloadOneDevice);
-
-    auto enableDevices = new xrm::enableDevicesCommand(sys);
-    registerCmd(*enableDevices);
-
-    auto disableDevices = new xrm::disableDevicesCommand(sys);
-    registerCmd(*disableDevices);
-
-    auto enableOneDevice = new xrm::enableOneDeviceCommand(sys);
-    registerCmd(*enableOneDevice);
-
-    auto disableOneDevice = new xrm::disableOneDeviceCommand(sys);
-    registerCmd(*disableOneDevice);
-
-    auto createContext = new xrm::createContextCommand(sys);
-    registerCmd(*createContext);
-
-    auto echoContext = new xrm::echoContextCommand(sys);
-    registerCmd(*echoContext);
-
-    auto destroyContext = new xrm::destroyContextCommand(sys);
-    registerCmd(*destroyContext);
-
-    auto isDaemonRunning = new xrm::isDaemonRunningCommand(sys);
-    registerCmd(*isDaemonRunning);
-
-    auto isCuExisting = new xrm::isCuExistingCommand(sys);
-    registerCmd(*isCuExisting);
-
-    auto isCuListExisting = new xrm::isCuListExistingCommand(sys);
-    registerCmd(*isCuListExisting);
-
-    auto isCuGroupExisting = new xrm::isCuGroupExistingCommand(sys);
-    registerCmd(*isCuGroupExisting);
-
-    auto cuAlloc = new xrm::cuAllocCommand(sys);
-    registerCmd(*cuAlloc);
-
-    auto cuAllocFromDev = new xrm::cuAllocFromDevCommand(sys);
-    registerCmd(*cuAllocFromDev);
-
-    auto cuAllocLeastUsedFromDev = new xrm::cuAllocLeastUsedFromDevCommand(sys);
-    registerCmd(*cuAllocLeastUsedFromDev);
-
-    auto cuRelease = new xrm::cuReleaseCommand(sys);
-    registerCmd(*cuRelease);
-
-    auto cuListAlloc = new xrm::cuListAllocCommand(sys);
-    registerCmd(*cuListAlloc);
-
-    auto cuListRelease = new xrm::cuListReleaseCommand(sys);
-    registerCmd(*cuListRelease);
-
-    auto udfCuGroupDeclare = new xrm::udfCuGroupDeclareCommand(sys);
-    registerCmd(*udfCuGroupDeclare);
-
-    auto udfCuGroupUndeclare = new xrm::udfCuGroupUndeclareCommand(sys);
-    registerCmd(*udfCuGroupUndeclare);
-
-    auto cuGroupAlloc = new xrm::cuGroupAllocCommand(sys);
-    registerCmd(*cuGroupAlloc);
-
-    auto cuGroupRelease = new xrm::cuGroupReleaseCommand(sys);
-    registerCmd(*cuGroupRelease);
-
-    auto cuPoolReserve = new xrm::cuPoolReserveCommand(sys);
-    registerCmd(*cuPoolReserve);
-
-    auto cuPoolRelinquish = new xrm::cuPoolRelinquishCommand(sys);
-    registerCmd(*cuPoolRelinquish);
-
-    auto cuGetMaxCapacity = new xrm::cuGetMaxCapacityCommand(sys);
-    registerCmd(*cuGetMaxCapacity);
-
-    auto cuCheckStatus = new xrm::cuCheckStatusCommand(sys);
-    registerCmd(*cuCheckStatus);
-
-    auto allocationQuery = new xrm::allocationQueryCommand(sys);
-    registerCmd(*allocationQuery);
-
-    auto reservationQuery = new xrm::reservationQueryCommand(sys);
-    registerCmd(*reservationQuery);
-
-    auto checkCuAvailableNum = new xrm::checkCuAvailableNumCommand(sys);
-    registerCmd(*checkCuAvailableNum);
-
-    auto checkCuListAvailableNum = new xrm::checkCuListAvailableNumCommand(sys);
-    registerCmd(*checkCuListAvailableNum);
-
-    auto checkCuGroupAvailableNum = new xrm::checkCuGroupAvailableNumCommand(sys);
-    registerCmd(*checkCuGroupAvailableNum);
-
-    auto checkCuPoolAvailableNum = new xrm::checkCuPoolAvailableNumCommand(sys);
-    registerCmd(*checkCuPoolAvailableNum);
-
-    auto loadXrmPlugins = new xrm::loadXrmPluginsCommand(sys);
-    registerCmd(*loadXrmPlugins);
-
-    auto unloadXrmPlugins = new xrm::unloadXrmPluginsCommand(sys);
-    registerCmd(*unloadXrmPlugins);
-
-    auto execXrmPluginFunc = new xrm::execXrmPluginFuncCommand(sys);
-    registerCmd(*execXrmPluginFunc);
-
-    auto cuAllocWithLoad = new xrm::cuAllocWithLoadCommand(sys);
-    registerCmd(*cuAllocWithLoad);
-
-    auto cuAllocLeastUsedWithLoad = new xrm::cuAllocLeastUsedWithLoadCommand(sys);
-    registerCmd(*cuAllocLeastUsedWithLoad);
-
-    auto loadAndAllCuAlloc = new xrm::loadAndAllCuAllocCommand(sys);
-    registerCmd(*loadAndAllCuAlloc);
-
-    auto cuAllocV2 = new xrm::cuAllocV2Command(sys);
-    registerCmd(*cuAllocV2);
-
-    auto cuReleaseV2 = new xrm::cuReleaseV2Command(sys);
-    registerCmd(*cuReleaseV2);
-
-    auto cuListAllocV2 = new xrm::cuListAllocV2Command(sys);
-    registerCmd(*cuListAllocV2);
-
-    auto cuListReleaseV2 = new xrm::cuListReleaseV2Command(sys);
-    registerCmd(*cuListReleaseV2);
-
-    auto udfCuGroupDeclareV2 = new xrm::udfCuGroupDeclareV2Command(sys);
-    registerCmd(*udfCuGroupDeclareV2);
-
-    auto udfCuGroupUndeclareV2 = new xrm::udfCuGroupUndeclareV2Command(sys);
-    registerCmd(*udfCuGroupUndeclareV2);
-
-    auto cuGroupAllocV2 = new xrm::cuGroupAllocV2Command(sys);
-    registerCmd(*cuGroupAllocV2);
-
-    auto cuGroupReleaseV2 = new xrm::cuGroupReleaseV2Command(sys);
-    registerCmd(*cuGroupReleaseV2);
+/*
+ * The opcode carried by the client is taken only if it's of the named command, so the
+ * client with stale opcode table still gets the right command.
+ */
+uint16_t xrm::commandRegistry::getOpcode(const std::string& name, pt::ptree& incmd) {
+    auto opcode = incmd.get_optional<uint16_t>("request.opcode");
+    if (opcode && *opcode < XRM_CMD_OPCODE_NUM && m_table[*opcode] != NULL && m_table[*opcode]->getName() == name)
+        return (*opcode);
+
+    auto iter = m_opcodes.find(name);
+    if (iter == m_opcodes.end()) return (XRM_CMD_NONE);
+    return (iter->second);
+}
 
-    auto cuPoolReserveV2 = new xrm::cuPoolReserveV2Command(sys);
-    registerCmd(*cuPoolReserveV2);
+/*
+ * The json command fails with "failed" status or negative status value, the status value of
+ * some commands is the result instead, e.g. log level of createContext.
+ */
+static bool isFailedResponse(pt::ptree& outrsp) {
+    auto status = outrsp.get_child_optional("response.status");
+    if (!status) return (false);
+    if (status->data() == "failed") return (true);
+    auto value = status->get_optional<int32_t>("value");
+    return (value && *value < 0);
+}
 
-    auto cuPoolRelinquishV2 = new xrm::cuPoolRelinquishV2Command(sys);
-    registerCmd(*cuPoolRelinquishV2);
+void xrm::commandRegistry::countCmd(uint16_t opcode, bool failed, std::chrono::steady_clock::time_point start) {
+    commandStats& stats = m_stats[opcode];
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
 
-    auto allocationQueryV2 = new xrm::allocationQueryV2Command(sys);
-    registerCmd(*allocationQueryV2);
+    stats.calls.fetch_add(1, std::memory_order_relaxed);
+    if (failed) stats.errors.fetch_add(1, std::memory_order_relaxed);
+    stats.timeNs.fetch_add(elapsed.count(), std::memory_order_relaxed);
+}
 
-    auto reservationQueryV2 = new xrm::reservationQueryV2Command(sys);
-    registerCmd(*reservationQueryV2);
+void xrm::commandRegistry::dispatch(std::string& name, pt::ptree& incmd, pt::ptree& outrsp) {
+    uint16_t opcode = getOpcode(name, incmd);
+    xrm::command* cmd = m_table[opcode];
 
-    auto checkCuAvailableNumV2 = new xrm::checkCuAvailableNumV2Command(sys);
-    registerCmd(*checkCuAvailableNumV2);
+    if (cmd == NULL) {
+        outrsp.put("response.status", "failed");
+        outrsp.put("response.data.failed", "unsupported cmd name: " + name);
+        return;
+    }
+    auto start = std::chrono::steady_clock::now();
+    cmd->processCmd(incmd, outrsp);
+    countCmd(opcode, isFailedResponse(outrsp), start);
+}
 
-    auto checkCuListAvailableNumV2 = new xrm::checkCuListAvailableNumV2Command(sys);
-    registerCmd(*checkCuListAvailableNumV2);
+/*
+ * Every binary response record starts with int32_t status.
+ */
+int32_t xrm::commandRegistry::dispatchBinary(
+    uint16_t opcode, const char* req, uint32_t reqLen, char* rsp, uint32_t* rspLen) {
+    if (opcode >= m_binaryTable.size() || m_binaryTable[opcode] == XRM_CMD_NONE) return (XRM_ERROR_INVALID);
+    uint16_t cmdOpcode = m_binaryTable[opcode];
+
+    auto start = std::chrono::steady_clock::now();
+    int32_t ret = m_table[cmdOpcode]->processBinaryCmd(req, reqLen, rsp, rspLen);
+    countCmd(cmdOpcode, ret != XRM_SUCCESS || *(const int32_t*)rsp < 0, start);
+    return (ret);
+}
 
-    auto checkCuGroupAvailableNumV2 = new xrm::checkCuGroupAvailableNumV2Command(sys);
-    registerCmd(*checkCuGroupAvailableNumV2);
+/*
+ * Counters of the registered commands, keyed by the command name.
+ */
+void xrm::commandRegistry::getStats(pt::ptree& statsTree) {
+    for (uint16_t opcode = 1; opcode < XRM_CMD_OPCODE_NUM; opcode++) {
+        if (m_table[opcode] == NULL) continue;
+        uint64_t calls = m_stats[opcode].calls.load(std::memory_order_relaxed);
+        uint64_t timeNs = m_stats[opcode].timeNs.load(std::memory_order_relaxed);
+        pt::ptree cmdTree;
+        cmdTree.put("opcode", opcode);
+        cmdTree.put("calls", calls);
+        cmdTree.put("errors", m_stats[opcode].errors.load(std::memory_order_relaxed));
+        cmdTree.put("totalTimeUs", timeNs / 1000);
+        cmdTree.put("averageTimeUs", calls ? timeNs / calls / 1000 : 0);
+        statsTree.add_child(m_table[opcode]->getName(), cmdTree);
+    }
+}
 
-    auto checkCuPoolAvailableNumV2 = new xrm::checkCuPoolAvailableNumV2Command(sys);
-    registerCmd(*checkCuPoolAvailableNumV2);
+void xrm::commandRegistry::registerAll(system& sys) {
+    registerCmd(std::make_unique<xrm::listCommand>(sys));
+    registerCmd(std::make_unique<xrm::loadCommand>(sys));
+    registerCmd(std::make_unique<xrm::loadOneDeviceCommand>(sys));
+    registerCmd(std::make_unique<xrm::unloadCommand>(sys));
+    registerCmd(std::make_unique<xrm::unloadOneDeviceCommand>(sys));
+    registerCmd(std::make_unique<xrm::enableDevicesCommand>(sys));
+    registerCmd(std::make_unique<xrm::disableDevicesCommand>(sys));
+    registerCmd(std::make_unique<xrm::enableOneDeviceCommand>(sys));
+    registerCmd(std::make_unique<xrm::disableOneDeviceCommand>(sys));
+    registerCmd(std::make_unique<xrm::createContextCommand>(sys));
+    registerCmd(std::make_unique<xrm::echoContextCommand>(sys));
+    registerCmd(std::make_unique<xrm::destroyContextCommand>(sys));
+    registerCmd(std::make_unique<xrm::isDaemonRunningCommand>(sys));
+    registerCmd(std::make_unique<xrm::isCuExistingCommand>(sys));
+    registerCmd(std::make_unique<xrm::isCuListExistingCommand>(sys));
+    registerCmd(std::make_unique<xrm::isCuGroupExistingCommand>(sys));
+    registerCmd(std::make_unique<xrm::cuAllocCommand>(sys));
+    registerCmd(std::make_unique<xrm::cuAllocFromDevCommand>(sys));
+    registerCmd(std::make_unique<xrm::cuAllocLeastUsedFromDevCommand>(sys));
+    registerCmd(std::make_unique<xrm::cuReleaseCommand>(sys));
+    registerCmd(std::make_unique<xrm::cuListAllocCommand>(sys));
+    registerCmd(std::make_unique<xrm::cuListReleaseCommand>(sys));
+    registerCmd(std::make_unique<xrm::udfCuGroupDeclareCommand>(sys));
+    registerCmd(std::make_unique<xrm::udfCuGroupUndeclareCommand>(sys));
+    registerCmd(std::make_unique<xrm::cuGroupAllocCommand>(sys));
+    registerCmd(std::make_unique<xrm::cuGroupReleaseCommand>(sys));
+    registerCmd(std::make_unique<xrm::cuPoolReserveCommand>(sys));
+    registerCmd(std::make_unique<xrm::cuPoolRelinquishCommand>(sys));
+    registerCmd(std::make_unique<xrm::cuGetMaxCapacityCommand>(sys));
+    registerCmd(std::make_unique<xrm::cuCheckStatusCommand>(sys));
+    registerCmd(std::make_unique<xrm::allocationQueryCommand>(sys));
+    registerCmd(std::make_unique<xrm::reservationQueryCommand>(sys));
+    registerCmd(std::make_unique<xrm::checkCuAvailableNumCommand>(sys));
+    registerCmd(std::make_unique<xrm::checkCuListAvailableNumCommand>(sys));
+    registerCmd(std::make_unique<xrm::checkCuGroupAvailableNumCommand>(sys));
+    registerCmd(std::make_unique<xrm::checkCuPoolAvailableNumCommand>(sys));
+    registerCmd(std::make_unique<xrm::loadXrmPluginsCommand>(sys));
+    registerCmd(std::make_unique<xrm::unloadXrmPluginsCommand>(sys));
+    registerCmd(std::make_unique<xrm::execXrmPluginFuncCommand>(sys));
+    registerCmd(std::make_unique<xrm::cuAllocWithLoadCommand>(sys));
+    registerCmd(std::make_unique<xrm::cuAllocLeastUsedWithLoadCommand>(sys));
+    registerCmd(std::make_unique<xrm::loadAndAllCuAllocCommand>(sys));
+    registerCmd(std::make_unique<xrm::cuAllocV2Command>(sys));
+    registerCmd(std::make_unique<xrm::cuReleaseV2Command>(sys));
+    registerCmd(std::make_unique<xrm::cuListAllocV2Command>(sys));
+    registerCmd(std::make_unique<xrm::cuListReleaseV2Command>(sys));
+    registerCmd(std::make_unique<xrm::udfCuGroupDeclareV2Command>(sys));
+    registerCmd(std::make_unique<xrm::udfCuGroupUndeclareV2Command>(sys));
+    registerCmd(std::make_unique<xrm::cuGroupAllocV2Command>(sys));
+    registerCmd(std::make_unique<xrm::cuGroupReleaseV2Command>(sys));
+    registerCmd(std::make_unique<xrm::cuPoolReserveV2Command>(sys));
+    registerCmd(std::make_unique<xrm::cuPoolRelinquishV2Command>(sys));
+    registerCmd(std::make_unique<xrm::allocationQueryV2Command>(sys));
+    registerCmd(std::make_unique<xrm::reservationQueryV2Command>(sys));
+    registerCmd(std::make_unique<xrm::checkCuAvailableNumV2Command>(sys));
+    registerCmd(std::make_unique<xrm::checkCuListAvailableNumV2Command>(sys));
+    registerCmd(std::make_unique<xrm::checkCuGroupAvailableNumV2Command>(sys));
+    registerCmd(std::make_unique<xrm::checkCuPoolAvailableNumV2Command>(sys));
+    registerCmd(std::make_unique<xrm::batchCommand>(sys));
+
+    registerCmd(std::make_unique<xrm::commandStatsCommand>(sys, *this));
+    registerCmd(std::make_unique<xrm::allocationReleaseV2Command>(sys));
 }
 
-void xrm::commandRegistry::registerCmd(xrm::command& cmd) {
-    m_registry.insert(std::make_pair(cmd.getName(), &cmd));
+/*
+ * The command must have an opcode in XRM_COMMAND_OPCODES.
+ */
+void xrm::commandRegistry::registerCmd(std::unique_ptr<xrm::command> cmd) {
+    auto iter = m_opcodes.find(cmd->getName());
+    if (iter == m_opcodes.end()) return;
+
+    uint16_t opcode = iter->second;
+    m_table[opcode] = cmd.get();
+    uint16_t binaryOpcode = cmd->getBinaryOpcode();
+    if (binaryOpcode != XRM_BINARY_OP_NONE) {
+        if (binaryOpcode >= m_binaryTable.size()) m_binaryTable.resize(binaryOpcode + 1, XRM_CMD_NONE);
+        m_binaryTable[binaryOpcode] = opcode;
+    }
+    m_commands.push_back(std::move(cmd));
 }
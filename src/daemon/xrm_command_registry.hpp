@@ -21,8 +21,14 @@
 #ifndef _XRM_COMMAND_REGISTRY_HPP_
 #define _XRM_COMMAND_REGISTRY_HPP_
 
-#include <map>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include "xrm_command.hpp"
+#include "xrm_command_opcode.hpp"
 
 namespace pt = boost::property_tree;
 
@@ -31,16 +37,38 @@ namespace xrm {
 class command;
 class system;
 
+/*
+ * The registry owns the commands and dispatches the requests by opcode through dense tables.
+ * The json request is mapped to the opcode by request.opcode if the client carries it, or
+ * by request.name. Every dispatch is counted per opcode, the counters are read with the
+ * commandStats command.
+ */
 class commandRegistry {
    public:
-    commandRegistry() {}
+    /* counters of one command, updated from the io threads without lock */
+    struct commandStats {
+        std::atomic<uint64_t> calls{0};
+        std::atomic<uint64_t> errors{0};
+        std::atomic<uint64_t> timeNs{0}; // cumulative processing time
+    };
+
+    commandRegistry();
 
     void dispatch(std::string& name, pt::ptree& incmd, pt::ptree& outrsp);
+    int32_t dispatchBinary(uint16_t opcode, const char* req, uint32_t reqLen, char* rsp, uint32_t* rspLen);
     void registerAll(system& sys);
+    void getStats(pt::ptree& statsTree);
 
    private:
-    void registerCmd(xrm::command& cmd);
-    std::map<std::string, xrm::command*> m_registry;
+    void registerCmd(std::unique_ptr<xrm::command> cmd);
+    uint16_t getOpcode(const std::string& name, pt::ptree& incmd);
+    void countCmd(uint16_t opcode, bool failed, std::chrono::steady_clock::time_point start);
+
+    std::vector<std::unique_ptr<xrm::command>> m_commands;
+    std::unordered_map<std::string, uint16_t> m_opcodes; // command name to opcode
+    xrm::command* m_table[XRM_CMD_OPCODE_NUM] = {};      // indexed by opcode
+    std::vector<uint16_t> m_binaryTable;                 // binary opcode to opcode of the command
+    commandStats m_stats[XRM_CMD_OPCODE_NUM];
 };
 } // namespace xrm
 
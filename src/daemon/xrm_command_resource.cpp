@@ -20,6 +20,14 @@
 
 #include "xrm_command_resource.hpp"
 
+/*
+ * To collect the devices used by the cu resources, for taking the device locks of cu list / group
+ */
+static void getCuResourceDeviceIds(
+    const xrm::cuResource* cuResources, int32_t cuNum, int32_t maxCuNum, std::vector<int32_t>& devIds) {
+    for (int32_t i = 0; i < cuNum && i < maxCuNum; i++) devIds.push_back(cuResources[i].deviceId);
+}
+
 void xrm::createContextCommand::processCmd(pt::ptree& incmd, pt::ptree& outrsp) {
     auto context = incmd.get<std::string>("request.parameters.context");
     int32_t logLevel = m_system->getLogLevel();
@@ -32,6 +40,10 @@ void xrm::createContextCommand::processCmd(pt::ptree& incmd, pt::ptree& outrsp)
     m_system->exitLock();
     outrsp.put("response.status.value", logLevel);
     outrsp.put("response.data.clientId", clientId);
+    /* binary framing is negotiated here, answer with the highest version both sides support */
+    auto binaryProtocolVersion = incmd.get<uint32_t>("request.parameters.binaryProtocolVersion", 0);
+    if (binaryProtocolVersion > XRM_BINARY_PROTOCOL_VERSION) binaryProtocolVersion = XRM_BINARY_PROTOCOL_VERSION;
+    outrsp.put("response.data.binaryProtocolVersion", binaryProtocolVersion);
 }
 
 void xrm::echoContextCommand::processCmd(pt::ptree& incmd, pt::ptree& outrsp) {
@@ -73,53 +85,15 @@ void xrm::cuAllocCommand::processCmd(pt::ptree& incmd, pt::ptree& outrsp) {
     cuResource cuRes;
     std::string errmsg;
 
-    auto kernelName = incmd.get<std::string>("request.parameters.kernelName");
-    auto kernelAlias = incmd.get<std::string>("request.parameters.kernelAlias");
-    auto devExcl = incmd.get<int32_t>("request.parameters.devExcl");
-    auto requestLoadUnified = incmd.get<int32_t>("request.parameters.requestLoadUnified");
-    auto requestLoadOriginal = incmd.get<int32_t>("request.parameters.requestLoadOriginal");
-    auto clientId = incmd.get<uint64_t>("request.parameters.clientId");
-    auto clientProcessId = incmd.get<pid_t>("request.parameters.clientProcessId");
-    auto poolId = incmd.get<uint64_t>("request.parameters.poolId");
-    strncpy(cuProp.kernelName, kernelName.c_str(), XRM_MAX_NAME_LEN - 1);
-    strncpy(cuProp.kernelAlias, kernelAlias.c_str(), XRM_MAX_NAME_LEN - 1);
-    strcpy(cuProp.cuName, "");
-    if (devExcl == 0)
-        cuProp.devExcl = false;
-    else
-        cuProp.devExcl = true;
-    cuProp.requestLoadUnified = requestLoadUnified;
-    cuProp.requestLoadOriginal = requestLoadOriginal;
-    cuProp.clientId = clientId;
-    cuProp.clientProcessId = clientProcessId;
-    cuProp.poolId = poolId;
+    requestParams params(incmd);
+    decodeCuProperty(params, -1, &cuProp);
 
     bool update_id = true;
     m_system->enterLock();
     int32_t ret = m_system->resAllocCu(&cuProp, &cuRes, update_id);
     m_system->exitLock();
     outrsp.put("response.status.value", ret);
-    if (ret == XRM_SUCCESS) {
-        outrsp.put("response.data.xclbinFileName", cuRes.xclbinFileName);
-        outrsp.put("response.data.uuidStr", cuRes.uuidStr);
-        outrsp.put("response.data.kernelPluginFileName", cuRes.kernelPluginFileName);
-        outrsp.put("response.data.kernelName", cuRes.kernelName);
-        outrsp.put("response.data.instanceName", cuRes.instanceName);
-        outrsp.put("response.data.cuName", cuRes.cuName);
-        outrsp.put("response.data.kernelAlias", cuRes.kernelAlias);
-        outrsp.put("response.data.deviceId", cuRes.deviceId);
-        outrsp.put("response.data.cuId", cuRes.cuId);
-        outrsp.put("response.data.channelId", cuRes.channelId);
-        outrsp.put("response.data.cuType", (int32_t)cuRes.cuType);
-        outrsp.put("response.data.baseAddr", cuRes.baseAddr);
-        outrsp.put("response.data.membankId", cuRes.membankId);
-        outrsp.put("response.data.membankType", cuRes.membankType);
-        outrsp.put("response.data.membankSize", cuRes.membankSize);
-        outrsp.put("response.data.membankBaseAddr", cuRes.membankBaseAddr);
-        outrsp.put("response.data.allocServiceId", cuRes.allocServiceId);
-        outrsp.put("response.data.channelLoadOriginal", cuRes.channelLoadOriginal);
-        outrsp.put("response.data.poolId", cuRes.poolId);
-    }
+    if (ret == XRM_SUCCESS) encodeCuResource(responseData(outrsp), &cuRes, "");
 }
 
 void xrm::cuAllocFromDevCommand::processCmd(pt::ptree& incmd, pt::ptree& outrsp) {
@@ -127,54 +101,16 @@ void xrm::cuAllocFromDevCommand::processCmd(pt::ptree& incmd, pt::ptree& outrsp)
     cuResource cuRes;
     std::string errmsg;
 
-    auto deviceId = incmd.get<std::int32_t>("request.parameters.deviceId");
-    auto kernelName = incmd.get<std::string>("request.parameters.kernelName");
-    auto kernelAlias = incmd.get<std::string>("request.parameters.kernelAlias");
-    auto devExcl = incmd.get<int32_t>("request.parameters.devExcl");
-    auto requestLoadUnified = incmd.get<int32_t>("request.parameters.requestLoadUnified");
-    auto requestLoadOriginal = incmd.get<int32_t>("request.parameters.requestLoadOriginal");
-    auto clientId = incmd.get<uint64_t>("request.parameters.clientId");
-    auto clientProcessId = incmd.get<pid_t>("request.parameters.clientProcessId");
-    auto poolId = incmd.get<uint64_t>("request.parameters.poolId");
-    strncpy(cuProp.kernelName, kernelName.c_str(), XRM_MAX_NAME_LEN - 1);
-    strncpy(cuProp.kernelAlias, kernelAlias.c_str(), XRM_MAX_NAME_LEN - 1);
-    strcpy(cuProp.cuName, "");
-    if (devExcl == 0)
-        cuProp.devExcl = false;
-    else
-        cuProp.devExcl = true;
-    cuProp.requestLoadUnified = requestLoadUnified;
-    cuProp.requestLoadOriginal = requestLoadOriginal;
-    cuProp.clientId = clientId;
-    cuProp.clientProcessId = clientProcessId;
-    cuProp.poolId = poolId;
+    requestParams params(incmd);
+    auto deviceId = params.get<int32_t>(requestParams::deviceId);
+    decodeCuProperty(params, -1, &cuProp);
 
     bool update_id = true;
     m_system->enterLock();
     int32_t ret = m_system->resAllocCuFromDev(deviceId, &cuProp, &cuRes, update_id);
     m_system->exitLock();
     outrsp.put("response.status.value", ret);
-    if (ret == XRM_SUCCESS) {
-        outrsp.put("response.data.xclbinFileName", cuRes.xclbinFileName);
-        outrsp.put("response.data.uuidStr", cuRes.uuidStr);
-        outrsp.put("response.data.kernelPluginFileName", cuRes.kernelPluginFileName);
-        outrsp.put("response.data.kernelName", cuRes.kernelName);
-        outrsp.put("response.data.instanceName", cuRes.instanceName);
-        outrsp.put("response.data.cuName", cuRes.cuName);
-        outrsp.put("response.data.kernelAlias", cuRes.kernelAlias);
-        outrsp.put("response.data.deviceId", cuRes.deviceId);
-        outrsp.put("response.data.cuId", cuRes.cuId);
-        outrsp.put("response.data.channelId", cuRes.channelId);
-        outrsp.put("response.data.cuType", (int32_t)cuRes.cuType);
-        outrsp.put("response.data.baseAddr", cuRes.baseAddr);
-        outrsp.put("response.data.membankId", cuRes.membankId);
-        outrsp.put("response.data.membankType", cuRes.membankType);
-        outrsp.put("response.data.membankSize", cuRes.membankSize);
-        outrsp.put("response.data.membankBaseAddr", cuRes.membankBaseAddr);
-        outrsp.put("response.data.allocServiceId", cuRes.allocServiceId);
-        outrsp.put("response.data.channelLoadOriginal", cuRes.channelLoadOriginal);
-        outrsp.put("response.data.poolId", cuRes.poolId);
-    }
+    if (ret == XRM_SUCCESS) encodeCuResource(responseData(outrsp), &cuRes, "");
 }
 
 void xrm::cuAllocLeastUsedFromDevCommand::processCmd(pt::ptree& incmd, pt::ptree& outrsp) {
@@ -182,54 +118,16 @@ void xrm::cuAllocLeastUsedFromDevCommand::processCmd(pt::ptree& incmd, pt::ptree
     cuResource cuRes;
     std::string errmsg;
 
-    auto deviceId = incmd.get<std::int32_t>("request.parameters.deviceId");
-    auto kernelName = incmd.get<std::string>("request.parameters.kernelName");
-    auto kernelAlias = incmd.get<std::string>("request.parameters.kernelAlias");
-    auto devExcl = incmd.get<int32_t>("request.parameters.devExcl");
-    auto requestLoadUnified = incmd.get<int32_t>("request.parameters.requestLoadUnified");
-    auto requestLoadOriginal = incmd.get<int32_t>("request.parameters.requestLoadOriginal");
-    auto clientId = incmd.get<uint64_t>("request.parameters.clientId");
-    auto clientProcessId = incmd.get<pid_t>("request.parameters.clientProcessId");
-    auto poolId = incmd.get<uint64_t>("request.parameters.poolId");
-    strncpy(cuProp.kernelName, kernelName.c_str(), XRM_MAX_NAME_LEN - 1);
-    strncpy(cuProp.kernelAlias, kernelAlias.c_str(), XRM_MAX_NAME_LEN - 1);
-    strcpy(cuProp.cuName, "");
-    if (devExcl == 0)
-        cuProp.devExcl = false;
-    else
-        cuProp.devExcl = true;
-    cuProp.requestLoadUnified = requestLoadUnified;
-    cuProp.requestLoadOriginal = requestLoadOriginal;
-    cuProp.clientId = clientId;
-    cuProp.clientProcessId = clientProcessId;
-    cuProp.poolId = poolId;
+    requestParams params(incmd);
+    auto deviceId = params.get<int32_t>(requestParams::deviceId);
+    decodeCuProperty(params, -1, &cuProp);
 
     bool update_id = true;
     m_system->enterLock();
     int32_t ret = m_system->resAllocLeastUsedCuFromDev(deviceId, &cuProp, &cuRes, update_id);
     m_system->exitLock();
     outrsp.put("response.status.value", ret);
-    if (ret == XRM_SUCCESS) {
-        outrsp.put("response.data.xclbinFileName", cuRes.xclbinFileName);
-        outrsp.put("response.data.uuidStr", cuRes.uuidStr);
-        outrsp.put("response.data.kernelPluginFileName", cuRes.kernelPluginFileName);
-        outrsp.put("response.data.kernelName", cuRes.kernelName);
-        outrsp.put("response.data.instanceName", cuRes.instanceName);
-        outrsp.put("response.data.cuName", cuRes.cuName);
-        outrsp.put("response.data.kernelAlias", cuRes.kernelAlias);
-        outrsp.put("response.data.deviceId", cuRes.deviceId);
-        outrsp.put("response.data.cuId", cuRes.cuId);
-        outrsp.put("response.data.channelId", cuRes.channelId);
-        outrsp.put("response.data.cuType", (int32_t)cuRes.cuType);
-        outrsp.put("response.data.baseAddr", cuRes.baseAddr);
-        outrsp.put("response.data.membankId", cuRes.membankId);
-        outrsp.put("response.data.membankType", cuRes.membankType);
-        outrsp.put("response.data.membankSize", cuRes.membankSize);
-        outrsp.put("response.data.membankBaseAddr", cuRes.membankBaseAddr);
-        outrsp.put("response.data.allocServiceId", cuRes.allocServiceId);
-        outrsp.put("response.data.channelLoadOriginal", cuRes.channelLoadOriginal);
-        outrsp.put("response.data.poolId", cuRes.poolId);
-    }
+    if (ret == XRM_SUCCESS) encodeCuResource(responseData(outrsp), &cuRes, "");
 }
 
 void xrm::cuListAllocCommand::processCmd(pt::ptree& incmd, pt::ptree& outrsp) {
@@ -238,36 +136,16 @@ void xrm::cuListAllocCommand::processCmd(pt::ptree& incmd, pt::ptree& outrsp) {
     std::string errmsg;
     int32_t i;
 
+    requestParams params(incmd);
     memset(&cuListProp, 0, sizeof(cuListProperty));
-    auto cuNum = incmd.get<int32_t>("request.parameters.cuNum");
+    auto cuNum = params.get<int32_t>(requestParams::cuNum);
     cuListProp.cuNum = cuNum;
-    auto sameDevice = incmd.get<int32_t>("request.parameters.sameDevice");
-    auto clientId = incmd.get<uint64_t>("request.parameters.clientId");
-    auto clientProcessId = incmd.get<pid_t>("request.parameters.clientProcessId");
+    auto sameDevice = params.get<int32_t>(requestParams::sameDevice);
     if (sameDevice == 0)
         cuListProp.sameDevice = false;
     else
         cuListProp.sameDevice = true;
-    for (i = 0; i < cuListProp.cuNum; i++) {
-        auto kernelName = incmd.get<std::string>("request.parameters.kernelName" + std::to_string(i));
-        auto kernelAlias = incmd.get<std::string>("request.parameters.kernelAlias" + std::to_string(i));
-        auto devExcl = incmd.get<int32_t>("request.parameters.devExcl" + std::to_string(i));
-        auto requestLoadUnified = incmd.get<int32_t>("request.parameters.requestLoadUnified" + std::to_string(i));
-        auto requestLoadOriginal = incmd.get<int32_t>("request.parameters.requestLoadOriginal" + std::to_string(i));
-        auto poolId = incmd.get<uint64_t>("request.parameters.poolId" + std::to_string(i));
-        strncpy(cuListProp.cuProps[i].kernelName, kernelName.c_str(), XRM_MAX_NAME_LEN - 1);
-        strncpy(cuListProp.cuProps[i].kernelAlias, kernelAlias.c_str(), XRM_MAX_NAME_LEN - 1);
-        strcpy(cuListProp.cuProps[i].cuName, "");
-        if (devExcl == 0)
-            cuListProp.cuProps[i].devExcl = false;
-        else
-            cuListProp.cuProps[i].devExcl = true;
-        cuListProp.cuProps[i].requestLoadUnified = requestLoadUnified;
-        cuListProp.cuProps[i].requestLoadOriginal = requestLoadOriginal;
-        cuListProp.cuProps[i].clientId = clientId;
-        cuListProp.cuProps[i].clientProcessId = clientProcessId;
-        cuListProp.cuProps[i].poolId = poolId;
-    }
+    for (i = 0; i < cuListProp.cuNum; i++) decodeCuProperty(params, i, &cuListProp.cuProps[i]);
 
     memset(&cuListRes, 0, sizeof(cuListResource));
     m_system->enterLock();
@@ -276,29 +154,8 @@ void xrm::cuListAllocCommand::processCmd(pt::ptree& incmd, pt::ptree& outrsp) {
     outrsp.put("response.status.value", ret);
     if (ret == XRM_SUCCESS) {
         outrsp.put("response.data.cuNum", cuListRes.cuNum);
-        for (i = 0; i < cuListRes.cuNum; i++) {
-            outrsp.put("response.data.xclbinFileName" + std::to_string(i), cuListRes.cuResources[i].xclbinFileName);
-            outrsp.put("response.data.uuidStr" + std::to_string(i), cuListRes.cuResources[i].uuidStr);
-            outrsp.put("response.data.kernelPluginFileName" + std::to_string(i),
-                       cuListRes.cuResources[i].kernelPluginFileName);
-            outrsp.put("response.data.kernelName" + std::to_string(i), cuListRes.cuResources[i].kernelName);
-            outrsp.put("response.data.instanceName" + std::to_string(i), cuListRes.cuResources[i].instanceName);
-            outrsp.put("response.data.cuName" + std::to_string(i), cuListRes.cuResources[i].cuName);
-            outrsp.put("response.data.kernelAlias" + std::to_string(i), cuListRes.cuResources[i].kernelAlias);
-            outrsp.put("response.data.deviceId" + std::to_string(i), cuListRes.cuResources[i].deviceId);
-            outrsp.put("response.data.cuId" + std::to_string(i), cuListRes.cuResources[i].cuId);
-            outrsp.put("response.data.channelId" + std::to_string(i), cuListRes.cuResources[i].channelId);
-            outrsp.put("response.data.cuType" + std::to_string(i), (int32_t)cuListRes.cuResources[i].cuType);
-            outrsp.put("response.data.baseAddr" + std::to_string(i), cuListRes.cuResources[i].baseAddr);
-            outrsp.put("response.data.membankId" + std::to_string(i), cuListRes.cuResources[i].membankId);
-            outrsp.put("response.data.membankType" + std::to_string(i), cuListRes.cuResources[i].membankType);
-            outrsp.put("response.data.membankSize" + std::to_string(i), cuListRes.cuResources[i].membankSize);
-            outrsp.put("response.data.membankBaseAddr" + std::to_string(i), cuListRes.cuResources[i].membankBaseAddr);
-            outrsp.put("response.data.allocServiceId" + std::to_string(i), cuListRes.cuResources[i].allocServiceId);
-            outrsp.put("response.data.channelLoadOriginal" + std::to_string(i),
-                       cuListRes.cuResources[i].channelLoadOriginal);
-            outrsp.put("response.data.poolId" + std::to_string(i), cuListRes.cuResources[i].poolId);
-        }
+        pt::ptree& data = responseData(outrsp);
+        for (i = 0; i < cuListRes.cuNum; i++) encodeCuResource(data, &cuListRes.cuResources[i], std::to_string(i));
     }
 }
 
@@ -324,29 +181,8 @@ void xrm::cuGroupAllocCommand::processCmd(pt::ptree& incmd, pt::ptree& outrsp) {
     outrsp.put("response.status.value", ret);
     if (ret == XRM_SUCCESS) {
         outrsp.put("response.data.cuNum", cuGroupRes.cuNum);
-        for (i = 0; i < cuGroupRes.cuNum; i++) {
-            outrsp.put("response.data.xclbinFileName" + std::to_string(i), cuGroupRes.cuResources[i].xclbinFileName);
-            outrsp.put("response.data.uuidStr" + std::to_string(i), cuGroupRes.cuResources[i].uuidStr);
-            outrsp.put("response.data.kernelPluginFileName" + std::to_string(i),
-                       cuGroupRes.cuResources[i].kernelPluginFileName);
-            outrsp.put("response.data.kernelName" + std::to_string(i), cuGroupRes.cuResources[i].kernelName);
-            outrsp.put("response.data.instanceName" + std::to_string(i), cuGroupRes.cuResources[i].instanceName);
-            outrsp.put("response.data.cuName" + std::to_string(i), cuGroupRes.cuResources[i].cuName);
-            outrsp.put("response.data.kernelAlias" + std::to_string(i), cuGroupRes.cuResources[i].kernelAlias);
-            outrsp.put("response.data.deviceId" + std::to_string(i), cuGroupRes.cuResources[i].deviceId);
-            outrsp.put("response.data.cuId" + std::to_string(i), cuGroupRes.cuResources[i].cuId);
-            outrsp.put("response.data.channelId" + std::to_string(i), cuGroupRes.cuResources[i].channelId);
-            outrsp.put("response.data.cuType" + std::to_string(i), (int32_t)cuGroupRes.cuResources[i].cuType);
-            outrsp.put("response.data.baseAddr" + std::to_string(i), cuGroupRes.cuResources[i].baseAddr);
-            outrsp.put("response.data.membankId" + std::to_string(i), cuGroupRes.cuResources[i].membankId);
-            outrsp.put("response.data.membankType" + std::to_string(i), cuGroupRes.cuResources[i].membankType);
-            outrsp.put("response.data.membankSize" + std::to_string(i), cuGroupRes.cuResources[i].membankSize);
-            outrsp.put("response.data.membankBaseAddr" + std::to_string(i), cuGroupRes.cuResources[i].membankBaseAddr);
-            outrsp.put("response.data.allocServiceId" + std::to_string(i), cuGroupRes.cuResources[i].allocServiceId);
-            outrsp.put("response.data.channelLoadOriginal" + std::to_string(i),
-                       cuGroupRes.cuResources[i].channelLoadOriginal);
-            outrsp.put("response.data.poolId" + std::to_string(i), cuGroupRes.cuResources[i].poolId);
-        }
+        pt::ptree& data = responseData(outrsp);
+        for (i = 0; i < cuGroupRes.cuNum; i++) encodeCuResource(data, &cuGroupRes.cuResources[i], std::to_string(i));
     }
 }
 
@@ -354,28 +190,12 @@ void xrm::cuReleaseCommand::processCmd(pt::ptree& incmd, pt::ptree& outrsp) {
     cuResource cuRes;
     std::string errmsg;
 
-    auto deviceId = incmd.get<int32_t>("request.parameters.deviceId");
-    auto cuId = incmd.get<int32_t>("request.parameters.cuId");
-    auto channelId = incmd.get<int32_t>("request.parameters.channelId");
-    auto cuType = incmd.get<int32_t>("request.parameters.cuType");
-    auto allocServiceId = incmd.get<uint64_t>("request.parameters.allocServiceId");
-    auto clientId = incmd.get<uint64_t>("request.parameters.clientId");
-    auto channelLoadUnified = incmd.get<int32_t>("request.parameters.channelLoadUnified");
-    auto channelLoadOriginal = incmd.get<int32_t>("request.parameters.channelLoadOriginal");
-    auto poolId = incmd.get<uint64_t>("request.parameters.poolId");
-    cuRes.deviceId = deviceId;
-    cuRes.cuId = cuId;
-    cuRes.channelId = channelId;
-    cuRes.cuType = (xrmCuType)cuType;
-    cuRes.allocServiceId = allocServiceId;
-    cuRes.clientId = clientId;
-    cuRes.channelLoadUnified = channelLoadUnified;
-    cuRes.channelLoadOriginal = channelLoadOriginal;
-    cuRes.poolId = poolId;
+    requestParams params(incmd);
+    decodeCuHandle(params, -1, &cuRes);
 
-    m_system->enterLock();
+    m_system->enterDeviceLock(cuRes.deviceId);
     int32_t ret = m_system->resReleaseCu(&cuRes);
-    m_system->exitLock();
+    m_system->exitDeviceLock(cuRes.deviceId);
     outrsp.put("response.status.value", ret);
 }
 
@@ -384,33 +204,17 @@ void xrm::cuListReleaseCommand::processCmd(pt::ptree& incmd, pt::ptree& outrsp)
     std::string errmsg;
     int32_t i;
 
+    requestParams params(incmd);
     memset(&cuListRes, 0, sizeof(cuListResource));
-    auto cuNum = incmd.get<int32_t>("request.parameters.cuNum");
-    auto clientId = incmd.get<uint64_t>("request.parameters.clientId");
+    auto cuNum = params.get<int32_t>(requestParams::cuNum);
     cuListRes.cuNum = cuNum;
-    for (i = 0; i < cuListRes.cuNum; i++) {
-        auto deviceId = incmd.get<int32_t>("request.parameters.deviceId" + std::to_string(i));
-        auto cuId = incmd.get<int32_t>("request.parameters.cuId" + std::to_string(i));
-        auto channelId = incmd.get<int32_t>("request.parameters.channelId" + std::to_string(i));
-        auto cuType = incmd.get<int32_t>("request.parameters.cuType" + std::to_string(i));
-        auto allocServiceId = incmd.get<uint64_t>("request.parameters.allocServiceId" + std::to_string(i));
-        auto channelLoadUnified = incmd.get<int32_t>("request.parameters.channelLoadUnified" + std::to_string(i));
-        auto channelLoadOriginal = incmd.get<int32_t>("request.parameters.channelLoadOriginal" + std::to_string(i));
-        auto poolId = incmd.get<uint64_t>("request.parameters.poolId" + std::to_string(i));
-        cuListRes.cuResources[i].deviceId = deviceId;
-        cuListRes.cuResources[i].cuId = cuId;
-        cuListRes.cuResources[i].channelId = channelId;
-        cuListRes.cuResources[i].cuType = (xrmCuType)cuType;
-        cuListRes.cuResources[i].allocServiceId = allocServiceId;
-        cuListRes.cuResources[i].clientId = clientId;
-        cuListRes.cuResources[i].channelLoadUnified = channelLoadUnified;
-        cuListRes.cuResources[i].channelLoadOriginal = channelLoadOriginal;
-        cuListRes.cuResources[i].poolId = poolId;
-    }
+    for (i = 0; i < cuListRes.cuNum; i++) decodeCuHandle(params, i, &cuListRes.cuResources[i]);
 
-    m_system->enterLock();
+    std::vector<int32_t> devIds;
+    getCuResourceDeviceIds(cuListRes.cuResources, cuListRes.cuNum, XRM_MAX_LIST_CU_NUM, devIds);
+    m_system->enterDeviceListLock(devIds);
     int32_t ret = m_system->resReleaseCuList(&cuListRes);
-    m_system->exitLock();
+    m_system->exitDeviceListLock(devIds);
     outrsp.put("response.status.value", ret);
 }
 
@@ -419,33 +223,17 @@ void xrm::cuGroupReleaseCommand::processCmd(pt::ptree& incmd, pt::ptree& outrsp)
     std::string errmsg;
     int32_t i;
 
+    requestParams params(incmd);
     memset(&cuGroupRes, 0, sizeof(cuGroupResource));
-    auto cuNum = incmd.get<int32_t>("request.parameters.cuNum");
+    auto cuNum = params.get<int32_t>(requestParams::cuNum);
     cuGroupRes.cuNum = cuNum;
-    auto clientId = incmd.get<uint64_t>("request.parameters.clientId");
-    for (i = 0; i < cuGroupRes.cuNum; i++) {
-        auto deviceId = incmd.get<int32_t>("request.parameters.deviceId" + std::to_string(i));
-        auto cuId = incmd.get<int32_t>("request.parameters.cuId" + std::to_string(i));
-        auto channelId = incmd.get<int32_t>("request.parameters.channelId" + std::to_string(i));
-        auto cuType = incmd.get<int32_t>("request.parameters.cuType" + std::to_string(i));
-        auto allocServiceId = incmd.get<uint64_t>("request.parameters.allocServiceId" + std::to_string(i));
-        auto channelLoadUnified = incmd.get<int32_t>("request.parameters.channelLoadUnified" + std::to_string(i));
-        auto channelLoadOriginal = incmd.get<int32_t>("request.parameters.channelLoadOriginal" + std::to_string(i));
-        auto poolId = incmd.get<uint64_t>("request.parameters.poolId" + std::to_string(i));
-        cuGroupRes.cuResources[i].deviceId = deviceId;
-        cuGroupRes.cuResources[i].cuId = cuId;
-        cuGroupRes.cuResources[i].channelId = channelId;
-        cuGroupRes.cuResources[i].cuType = (xrmCuType)cuType;
-        cuGroupRes.cuResources[i].allocServiceId = allocServiceId;
-        cuGroupRes.cuResources[i].clientId = clientId;
-        cuGroupRes.cuResources[i].channelLoadUnified = channelLoadUnified;
-        cuGroupRes.cuResources[i].channelLoadOriginal = channelLoadOriginal;
-        cuGroupRes.cuResources[i].poolId = poolId;
-    }
+    for (i = 0; i < cuGroupRes.cuNum; i++) decodeCuHandle(params, i, &cuGroupRes.cuResources[i]);
 
-    m_system->enterLock();
+    std::vector<int32_t> devIds;
+    getCuResourceDeviceIds(cuGroupRes.cuResources, cuGroupRes.cuNum, XRM_MAX_GROUP_CU_NUM, devIds);
+    m_system->enterDeviceListLock(devIds);
     int32_t ret = m_system->resReleaseCuGroup(&cuGroupRes);
-    m_system->exitLock();
+    m_system->exitDeviceListLock(devIds);
     outrsp.put("response.status.value", ret);
 }
 
@@ -543,9 +331,9 @@ void xrm::cuCheckStatusCommand::processCmd(pt::ptree& incmd, pt::ptree& outrsp)
     cuRes.cuType = (xrmCuType)cuType;
     cuRes.allocServiceId = allocServiceId;
 
-    m_system->enterLock();
+    m_system->enterDeviceLock(cuRes.deviceId);
     int32_t ret = m_system->checkCuStat(&cuRes, &cuStat);
-    m_system->exitLock();
+    m_system->exitDeviceLock(cuRes.deviceId);
     outrsp.put("response.status.value", ret);
     if (ret == XRM_SUCCESS) {
         if (cuStat.isBusy)
@@ -558,6 +346,29 @@ void xrm::cuCheckStatusCommand::processCmd(pt::ptree& incmd, pt::ptree& outrsp)
     }
 }
 
+int32_t xrm::cuCheckStatusCommand::processBinaryCmd(const char* req, uint32_t reqLen, char* rsp, uint32_t* rspLen) {
+    const binaryCuCheckStatusRequest* statusReq = (const binaryCuCheckStatusRequest*)req;
+    binaryCuCheckStatusResponse* statusRsp = (binaryCuCheckStatusResponse*)rsp;
+    cuResource cuRes;
+    cuStatus cuStat;
+
+    if (reqLen != sizeof(binaryCuCheckStatusRequest)) return (XRM_ERROR_INVALID);
+    binaryToCuResource(&statusReq->cuHandle, statusReq->clientId, &cuRes);
+
+    m_system->enterDeviceLock(cuRes.deviceId);
+    int32_t ret = m_system->checkCuStat(&cuRes, &cuStat);
+    m_system->exitDeviceLock(cuRes.deviceId);
+    memset(statusRsp, 0, sizeof(binaryCuCheckStatusResponse));
+    statusRsp->status = ret;
+    if (ret == XRM_SUCCESS) {
+        statusRsp->isBusy = cuStat.isBusy ? 1 : 0;
+        statusRsp->usedLoadUnified = cuStat.usedLoadUnified;
+        statusRsp->usedLoadOriginal = cuStat.usedLoadOriginal;
+    }
+    *rspLen = sizeof(binaryCuCheckStatusResponse);
+    return (XRM_SUCCESS);
+}
+
 void xrm::allocationQueryCommand::processCmd(pt::ptree& incmd, pt::ptree& outrsp) {
     allocationQueryInfo allocQuery;
     cuListResource cuListRes;
@@ -579,30 +390,8 @@ void xrm::allocationQueryCommand::processCmd(pt::ptree& incmd, pt::ptree& outrsp
     outrsp.put("response.status.value", ret);
     if (ret == XRM_SUCCESS) {
         outrsp.put("response.data.cuNum", cuListRes.cuNum);
-        for (i = 0; i < cuListRes.cuNum; i++) {
-            outrsp.put("response.data.xclbinFileName" + std::to_string(i), cuListRes.cuResources[i].xclbinFileName);
-            outrsp.put("response.data.uuidStr" + std::to_string(i), cuListRes.cuResources[i].uuidStr);
-            outrsp.put("response.data.kernelPluginFileName" + std::to_string(i),
-                       cuListRes.cuResources[i].kernelPluginFileName);
-            outrsp.put("response.data.kernelName" + std::to_string(i), cuListRes.cuResources[i].kernelName);
-            outrsp.put("response.data.instanceName" + std::to_string(i), cuListRes.cuResources[i].instanceName);
-            outrsp.put("response.data.cuName" + std::to_string(i), cuListRes.cuResources[i].cuName);
-            outrsp.put("response.data.kernelAlias" + std::to_string(i), cuListRes.cuResources[i].kernelAlias);
-            outrsp.put("response.data.deviceId" + std::to_string(i), cuListRes.cuResources[i].deviceId);
-            outrsp.put("response.data.cuId" + std::to_string(i), cuListRes.cuResources[i].cuId);
-            outrsp.put("response.data.channelId" + std::to_string(i), cuListRes.cuResources[i].channelId);
-            outrsp.put("response.data.cuType" + std::to_string(i), (int32_t)cuListRes.cuResources[i].cuType);
-            outrsp.put("response.data.baseAddr" + std::to_string(i), (int32_t)cuListRes.cuResources[i].baseAddr);
-            outrsp.put("response.data.membankId" + std::to_string(i), (int32_t)cuListRes.cuResources[i].membankId);
-            outrsp.put("response.data.membankType" + std::to_string(i), (int32_t)cuListRes.cuResources[i].membankType);
-            outrsp.put("response.data.membankSize" + std::to_string(i), (int32_t)cuListRes.cuResources[i].membankSize);
-            outrsp.put("response.data.membankBaseAddr" + std::to_string(i),
-                       (int32_t)cuListRes.cuResources[i].membankBaseAddr);
-            outrsp.put("response.data.allocServiceId" + std::to_string(i), cuListRes.cuResources[i].allocServiceId);
-            outrsp.put("response.data.channelLoadOriginal" + std::to_string(i),
-                       cuListRes.cuResources[i].channelLoadOriginal);
-            outrsp.put("response.data.poolId" + std::to_string(i), cuListRes.cuResources[i].poolId);
-        }
+        pt::ptree& data = responseData(outrsp);
+        for (i = 0; i < cuListRes.cuNum; i++) encodeCuResource(data, &cuListRes.cuResources[i], std::to_string(i));
     }
 }
 
@@ -683,157 +472,60 @@ void xrm::isCuGroupExistingCommand::processCmd(pt::ptree& incmd, pt::ptree& outr
 
 void xrm::checkCuAvailableNumCommand::processCmd(pt::ptree& incmd, pt::ptree& outrsp) {
     cuProperty cuProp;
-    std::vector<cuResource*> cuRes;
     std::string errmsg;
-    cuResource* tmpCuRes;
-    int32_t i, ret;
+    int32_t ret;
     int32_t availableCuNum = 0;
 
-    auto kernelName = incmd.get<std::string>("request.parameters.kernelName");
-    auto kernelAlias = incmd.get<std::string>("request.parameters.kernelAlias");
-    auto devExcl = incmd.get<int32_t>("request.parameters.devExcl");
-    auto requestLoadUnified = incmd.get<int32_t>("request.parameters.requestLoadUnified");
-    auto requestLoadOriginal = incmd.get<int32_t>("request.parameters.requestLoadOriginal");
-    auto clientId = incmd.get<uint64_t>("request.parameters.clientId");
-    auto clientProcessId = incmd.get<pid_t>("request.parameters.clientProcessId");
-    auto poolId = incmd.get<uint64_t>("request.parameters.poolId");
-    strncpy(cuProp.kernelName, kernelName.c_str(), XRM_MAX_NAME_LEN - 1);
-    strncpy(cuProp.kernelAlias, kernelAlias.c_str(), XRM_MAX_NAME_LEN - 1);
-    strcpy(cuProp.cuName, "");
-    if (devExcl == 0)
-        cuProp.devExcl = false;
-    else
-        cuProp.devExcl = true;
-    cuProp.requestLoadUnified = requestLoadUnified;
-    cuProp.requestLoadOriginal = requestLoadOriginal;
-    cuProp.clientId = clientId;
-    cuProp.clientProcessId = clientProcessId;
-    cuProp.poolId = poolId;
+    requestParams params(incmd);
+    decodeCuProperty(params, -1, &cuProp);
 
-    bool update_id = true;
     m_system->enterLock();
-    do {
-        tmpCuRes = (cuResource*)malloc(sizeof(cuResource));
-        memset(tmpCuRes, 0, sizeof(cuResource));
-        ret = m_system->resAllocCu(&cuProp, tmpCuRes, update_id);
-        if (ret == XRM_SUCCESS) {
-            cuRes.push_back(tmpCuRes);
-            availableCuNum++;
-        } else {
-            free(tmpCuRes);
-            break;
-        }
-    } while (ret == XRM_SUCCESS);
-    if (availableCuNum > 0) {
-        /* get the available cu number */
-        for (i = 0; i < availableCuNum; i++) {
-            m_system->resReleaseCu(cuRes[i]);
-            free(cuRes[i]);
-        }
+    ret = m_system->resCheckCuAvailableNum(&cuProp, &availableCuNum);
+    m_system->exitLock();
+    if (ret == XRM_SUCCESS) {
         outrsp.put("response.status.value", XRM_SUCCESS);
         outrsp.put("response.data.availableCuNum", availableCuNum);
     } else {
-        /*
-         * There is no available resource or input is invalid.
-         * Available cu list num is 0.
-         */
-        if (ret == XRM_ERROR_INVALID) {
-            /* The input is invalid */
-            outrsp.put("response.status.value", XRM_ERROR_INVALID);
-            outrsp.put("response.data.failed", "failed to check available cu number");
-        } else {
-            /* there is no available resource */
-            outrsp.put("response.status.value", XRM_SUCCESS);
-            outrsp.put("response.data.availableCuNum", availableCuNum);
-        }
+        /* The input is invalid */
+        outrsp.put("response.status.value", XRM_ERROR_INVALID);
+        outrsp.put("response.data.failed", "failed to check available cu number");
     }
-    m_system->exitLock();
 }
 
 void xrm::checkCuListAvailableNumCommand::processCmd(pt::ptree& incmd, pt::ptree& outrsp) {
     cuListProperty cuListProp;
-    std::vector<cuListResource*> cuListRes;
-    cuListResource* tmpCuListRes;
     std::string errmsg;
     int32_t i, ret;
     int32_t availableListNum = 0;
 
+    requestParams params(incmd);
     memset(&cuListProp, 0, sizeof(cuListProperty));
-    auto cuNum = incmd.get<int32_t>("request.parameters.cuNum");
+    auto cuNum = params.get<int32_t>(requestParams::cuNum);
     cuListProp.cuNum = cuNum;
-    auto sameDevice = incmd.get<int32_t>("request.parameters.sameDevice");
-    auto clientId = incmd.get<uint64_t>("request.parameters.clientId");
-    auto clientProcessId = incmd.get<pid_t>("request.parameters.clientProcessId");
+    auto sameDevice = params.get<int32_t>(requestParams::sameDevice);
     if (sameDevice == 0)
         cuListProp.sameDevice = false;
     else
         cuListProp.sameDevice = true;
-    for (i = 0; i < cuListProp.cuNum; i++) {
-        auto kernelName = incmd.get<std::string>("request.parameters.kernelName" + std::to_string(i));
-        auto kernelAlias = incmd.get<std::string>("request.parameters.kernelAlias" + std::to_string(i));
-        auto devExcl = incmd.get<int32_t>("request.parameters.devExcl" + std::to_string(i));
-        auto requestLoadUnified = incmd.get<int32_t>("request.parameters.requestLoadUnified" + std::to_string(i));
-        auto requestLoadOriginal = incmd.get<int32_t>("request.parameters.requestLoadOriginal" + std::to_string(i));
-        auto poolId = incmd.get<uint64_t>("request.parameters.poolId" + std::to_string(i));
-        strncpy(cuListProp.cuProps[i].kernelName, kernelName.c_str(), XRM_MAX_NAME_LEN - 1);
-        strncpy(cuListProp.cuProps[i].kernelAlias, kernelAlias.c_str(), XRM_MAX_NAME_LEN - 1);
-        strcpy(cuListProp.cuProps[i].cuName, "");
-        if (devExcl == 0)
-            cuListProp.cuProps[i].devExcl = false;
-        else
-            cuListProp.cuProps[i].devExcl = true;
-        cuListProp.cuProps[i].requestLoadUnified = requestLoadUnified;
-        cuListProp.cuProps[i].requestLoadOriginal = requestLoadOriginal;
-        cuListProp.cuProps[i].clientId = clientId;
-        cuListProp.cuProps[i].clientProcessId = clientProcessId;
-        cuListProp.cuProps[i].poolId = poolId;
-    }
+    for (i = 0; i < cuListProp.cuNum; i++) decodeCuProperty(params, i, &cuListProp.cuProps[i]);
 
     m_system->enterLock();
-    do {
-        tmpCuListRes = (cuListResource*)malloc(sizeof(cuListResource));
-        memset(tmpCuListRes, 0, sizeof(cuListResource));
-        ret = m_system->resAllocCuList(&cuListProp, tmpCuListRes);
-        if (ret == XRM_SUCCESS) {
-            cuListRes.push_back(tmpCuListRes);
-            availableListNum++;
-        } else {
-            free(tmpCuListRes);
-            break;
-        }
-    } while (ret == XRM_SUCCESS);
-    if (availableListNum > 0) {
-        /* get the available cu list number */
-        for (i = 0; i < availableListNum; i++) {
-            m_system->resReleaseCuList(cuListRes[i]);
-            free(cuListRes[i]);
-        }
+    ret = m_system->resCheckCuListAvailableNum(&cuListProp, &availableListNum);
+    m_system->exitLock();
+    if (ret == XRM_SUCCESS) {
         outrsp.put("response.status.value", XRM_SUCCESS);
         outrsp.put("response.data.availableListNum", availableListNum);
     } else {
-        /*
-         * There is no available resource or input is invalid.
-         * Available cu list num is 0.
-         */
-        if (ret == XRM_ERROR_INVALID) {
-            /* The input is invalid */
-            outrsp.put("response.status.value", XRM_ERROR_INVALID);
-            outrsp.put("response.data.failed", "failed to check available cu list number");
-        } else {
-            /* there is no available resource */
-            outrsp.put("response.status.value", XRM_SUCCESS);
-            outrsp.put("response.data.availableListNum", availableListNum);
-        }
+        /* The input is invalid */
+        outrsp.put("response.status.value", XRM_ERROR_INVALID);
+        outrsp.put("response.data.failed", "failed to check available cu list number");
     }
-    m_system->exitLock();
 }
 
 void xrm::checkCuGroupAvailableNumCommand::processCmd(pt::ptree& incmd, pt::ptree& outrsp) {
     cuGroupProperty cuGroupProp;
-    std::vector<cuGroupResource*> cuGroupRes;
-    cuGroupResource* tmpCuGroupRes;
     std::string errmsg;
-    int32_t i, ret;
+    int32_t ret;
     int32_t availableGroupNum = 0;
 
     auto udfCuGroupName = incmd.get<std::string>("request.parameters.udfCuGroupName");
@@ -846,51 +538,23 @@ void xrm::checkCuGroupAvailableNumCommand::processCmd(pt::ptree& incmd, pt::ptre
     cuGroupProp.poolId = poolId;
 
     m_system->enterLock();
-    do {
-        tmpCuGroupRes = (cuGroupResource*)malloc(sizeof(cuGroupResource));
-        memset(tmpCuGroupRes, 0, sizeof(cuGroupResource));
-        ret = m_system->resAllocCuGroup(&cuGroupProp, tmpCuGroupRes);
-        if (ret == XRM_SUCCESS) {
-            cuGroupRes.push_back(tmpCuGroupRes);
-            availableGroupNum++;
-        } else {
-            free(tmpCuGroupRes);
-            break;
-        }
-    } while (ret == XRM_SUCCESS);
-    if (availableGroupNum > 0) {
-        /* get the available cu group number */
-        for (i = 0; i < availableGroupNum; i++) {
-            m_system->resReleaseCuGroup(cuGroupRes[i]);
-            free(cuGroupRes[i]);
-        }
+    ret = m_system->resCheckCuGroupAvailableNum(&cuGroupProp, &availableGroupNum);
+    m_system->exitLock();
+    if (ret == XRM_SUCCESS) {
         outrsp.put("response.status.value", XRM_SUCCESS);
         outrsp.put("response.data.availableGroupNum", availableGroupNum);
     } else {
-        /*
-         * There is no available resource or input is invalid.
-         * Available cu group num is 0.
-         */
-        if (ret == XRM_ERROR_INVALID) {
-            /* The input is invalid */
-            outrsp.put("response.status.value", XRM_ERROR_INVALID);
-            outrsp.put("response.data.failed", "failed to check available cu group number");
-        } else {
-            /* there is no available resource */
-            outrsp.put("response.status.value", XRM_SUCCESS);
-            outrsp.put("response.data.availableGroupNum", availableGroupNum);
-        }
+        /* The input is invalid */
+        outrsp.put("response.status.value", XRM_ERROR_INVALID);
+        outrsp.put("response.data.failed", "failed to check available cu group number");
     }
-    m_system->exitLock();
 }
 
 void xrm::checkCuPoolAvailableNumCommand::processCmd(pt::ptree& incmd, pt::ptree& outrsp) {
     cuPoolProperty cuPoolProp;
     cuListProperty* cuListProp = NULL;
-    std::vector<uint64_t> cuPoolId;
     std::string errmsg;
     int32_t i;
-    uint64_t poolId;
     int32_t availablePoolNum = 0;
 
     memset(&cuPoolProp, 0, sizeof(cuPoolProperty));
@@ -931,28 +595,10 @@ void xrm::checkCuPoolAvailableNumCommand::processCmd(pt::ptree& incmd, pt::ptree
     cuPoolProp.xclbinNum = xclbinNum;
 
     m_system->enterLock();
-    do {
-        poolId = m_system->resReserveCuPool(&cuPoolProp);
-        if (poolId != 0) {
-            cuPoolId.push_back(poolId);
-            availablePoolNum++;
-        } else {
-            break;
-        }
-    } while (poolId != 0);
-    if (availablePoolNum > 0) {
-        /* get the available cu pool id */
-        for (i = 0; i < availablePoolNum; i++) m_system->resRelinquishCuPool(cuPoolId[i]);
-        outrsp.put("response.status.value", XRM_SUCCESS);
-        outrsp.put("response.data.availablePoolNum", availablePoolNum);
-    } else {
-        /*
-         * Available cu pool num is 0.
-         */
-        outrsp.put("response.status.value", XRM_SUCCESS);
-        outrsp.put("response.data.availablePoolNum", 0);
-    }
+    m_system->resCheckCuPoolAvailableNum(&cuPoolProp, &availablePoolNum);
     m_system->exitLock();
+    outrsp.put("response.status.value", XRM_SUCCESS);
+    outrsp.put("response.data.availablePoolNum", availablePoolNum);
 }
 
 void xrm::cuPoolReserveCommand::processCmd(pt::ptree& incmd, pt::ptree& outrsp) {
@@ -1068,54 +714,16 @@ void xrm::cuAllocWithLoadCommand::processCmd(pt::ptree& incmd, pt::ptree& outrsp
     cuResource cuRes;
     std::string errmsg;
 
-    auto kernelName = incmd.get<std::string>("request.parameters.kernelName");
-    auto kernelAlias = incmd.get<std::string>("request.parameters.kernelAlias");
-    auto devExcl = incmd.get<int32_t>("request.parameters.devExcl");
-    auto requestLoadUnified = incmd.get<int32_t>("request.parameters.requestLoadUnified");
-    auto requestLoadOriginal = incmd.get<int32_t>("request.parameters.requestLoadOriginal");
-    auto clientId = incmd.get<uint64_t>("request.parameters.clientId");
-    auto clientProcessId = incmd.get<pid_t>("request.parameters.clientProcessId");
-    auto poolId = incmd.get<uint64_t>("request.parameters.poolId");
+    requestParams params(incmd);
+    decodeCuProperty(params, -1, &cuProp);
     auto xclbinFileName = incmd.get<std::string>("request.parameters.xclbinFileName");
-    strncpy(cuProp.kernelName, kernelName.c_str(), XRM_MAX_NAME_LEN - 1);
-    strncpy(cuProp.kernelAlias, kernelAlias.c_str(), XRM_MAX_NAME_LEN - 1);
-    strcpy(cuProp.cuName, "");
-    if (devExcl == 0)
-        cuProp.devExcl = false;
-    else
-        cuProp.devExcl = true;
-    cuProp.requestLoadUnified = requestLoadUnified;
-    cuProp.requestLoadOriginal = requestLoadOriginal;
-    cuProp.clientId = clientId;
-    cuProp.clientProcessId = clientProcessId;
-    cuProp.poolId = poolId;
 
     bool update_id = true;
     m_system->enterLock();
     int32_t ret = m_system->resAllocCuWithLoad(&cuProp, xclbinFileName, &cuRes, update_id);
     m_system->exitLock();
     outrsp.put("response.status.value", ret);
-    if (ret == XRM_SUCCESS) {
-        outrsp.put("response.data.xclbinFileName", cuRes.xclbinFileName);
-        outrsp.put("response.data.uuidStr", cuRes.uuidStr);
-        outrsp.put("response.data.kernelPluginFileName", cuRes.kernelPluginFileName);
-        outrsp.put("response.data.kernelName", cuRes.kernelName);
-        outrsp.put("response.data.instanceName", cuRes.instanceName);
-        outrsp.put("response.data.cuName", cuRes.cuName);
-        outrsp.put("response.data.kernelAlias", cuRes.kernelAlias);
-        outrsp.put("response.data.deviceId", cuRes.deviceId);
-        outrsp.put("response.data.cuId", cuRes.cuId);
-        outrsp.put("response.data.channelId", cuRes.channelId);
-        outrsp.put("response.data.cuType", (int32_t)cuRes.cuType);
-        outrsp.put("response.data.baseAddr", cuRes.baseAddr);
-        outrsp.put("response.data.membankId", cuRes.membankId);
-        outrsp.put("response.data.membankType", cuRes.membankType);
-        outrsp.put("response.data.membankSize", cuRes.membankSize);
-        outrsp.put("response.data.membankBaseAddr", cuRes.membankBaseAddr);
-        outrsp.put("response.data.allocServiceId", cuRes.allocServiceId);
-        outrsp.put("response.data.channelLoadOriginal", cuRes.channelLoadOriginal);
-        outrsp.put("response.data.poolId", cuRes.poolId);
-    }
+    if (ret == XRM_SUCCESS) encodeCuResource(responseData(outrsp), &cuRes, "");
 }
 
 void xrm::cuAllocLeastUsedWithLoadCommand::processCmd(pt::ptree& incmd, pt::ptree& outrsp) {
@@ -1123,54 +731,16 @@ void xrm::cuAllocLeastUsedWithLoadCommand::processCmd(pt::ptree& incmd, pt::ptre
     cuResource cuRes;
     std::string errmsg;
 
-    auto kernelName = incmd.get<std::string>("request.parameters.kernelName");
-    auto kernelAlias = incmd.get<std::string>("request.parameters.kernelAlias");
-    auto devExcl = incmd.get<int32_t>("request.parameters.devExcl");
-    auto requestLoadUnified = incmd.get<int32_t>("request.parameters.requestLoadUnified");
-    auto requestLoadOriginal = incmd.get<int32_t>("request.parameters.requestLoadOriginal");
-    auto clientId = incmd.get<uint64_t>("request.parameters.clientId");
-    auto clientProcessId = incmd.get<pid_t>("request.parameters.clientProcessId");
-    auto poolId = incmd.get<uint64_t>("request.parameters.poolId");
+    requestParams params(incmd);
+    decodeCuProperty(params, -1, &cuProp);
     auto xclbinFileName = incmd.get<std::string>("request.parameters.xclbinFileName");
-    strncpy(cuProp.kernelName, kernelName.c_str(), XRM_MAX_NAME_LEN - 1);
-    strncpy(cuProp.kernelAlias, kernelAlias.c_str(), XRM_MAX_NAME_LEN - 1);
-    strcpy(cuProp.cuName, "");
-    if (devExcl == 0)
-        cuProp.devExcl = false;
-    else
-        cuProp.devExcl = true;
-    cuProp.requestLoadUnified = requestLoadUnified;
-    cuProp.requestLoadOriginal = requestLoadOriginal;
-    cuProp.clientId = clientId;
-    cuProp.clientProcessId = clientProcessId;
-    cuProp.poolId = poolId;
 
     bool update_id = true;
     m_system->enterLock();
     int32_t ret = m_system->resAllocCuLeastUsedWithLoad(&cuProp, xclbinFileName, &cuRes, update_id);
     m_system->exitLock();
     outrsp.put("response.status.value", ret);
-    if (ret == XRM_SUCCESS) {
-        outrsp.put("response.data.xclbinFileName", cuRes.xclbinFileName);
-        outrsp.put("response.data.uuidStr", cuRes.uuidStr);
-        outrsp.put("response.data.kernelPluginFileName", cuRes.kernelPluginFileName);
-        outrsp.put("response.data.kernelName", cuRes.kernelName);
-        outrsp.put("response.data.instanceName", cuRes.instanceName);
-        outrsp.put("response.data.cuName", cuRes.cuName);
-        outrsp.put("response.data.kernelAlias", cuRes.kernelAlias);
-        outrsp.put("response.data.deviceId", cuRes.deviceId);
-        outrsp.put("response.data.cuId", cuRes.cuId);
-        outrsp.put("response.data.channelId", cuRes.channelId);
-        outrsp.put("response.data.cuType", (int32_t)cuRes.cuType);
-        outrsp.put("response.data.baseAddr", cuRes.baseAddr);
-        outrsp.put("response.data.membankId", cuRes.membankId);
-        outrsp.put("response.data.membankType", cuRes.membankType);
-        outrsp.put("response.data.membankSize", cuRes.membankSize);
-        outrsp.put("response.data.membankBaseAddr", cuRes.membankBaseAddr);
-        outrsp.put("response.data.allocServiceId", cuRes.allocServiceId);
-        outrsp.put("response.data.channelLoadOriginal", cuRes.channelLoadOriginal);
-        outrsp.put("response.data.poolId", cuRes.poolId);
-    }
+    if (ret == XRM_SUCCESS) encodeCuResource(responseData(outrsp), &cuRes, "");
 }
 
 void xrm::loadAndAllCuAllocCommand::processCmd(pt::ptree& incmd, pt::ptree& outrsp) {
@@ -1189,29 +759,8 @@ void xrm::loadAndAllCuAllocCommand::processCmd(pt::ptree& incmd, pt::ptree& outr
     outrsp.put("response.status.value", ret);
     if (ret == XRM_SUCCESS) {
         outrsp.put("response.data.cuNum", cuListRes.cuNum);
-        for (i = 0; i < cuListRes.cuNum; i++) {
-            outrsp.put("response.data.xclbinFileName" + std::to_string(i), cuListRes.cuResources[i].xclbinFileName);
-            outrsp.put("response.data.uuidStr" + std::to_string(i), cuListRes.cuResources[i].uuidStr);
-            outrsp.put("response.data.kernelPluginFileName" + std::to_string(i),
-                       cuListRes.cuResources[i].kernelPluginFileName);
-            outrsp.put("response.data.kernelName" + std::to_string(i), cuListRes.cuResources[i].kernelName);
-            outrsp.put("response.data.instanceName" + std::to_string(i), cuListRes.cuResources[i].instanceName);
-            outrsp.put("response.data.cuName" + std::to_string(i), cuListRes.cuResources[i].cuName);
-            outrsp.put("response.data.kernelAlias" + std::to_string(i), cuListRes.cuResources[i].kernelAlias);
-            outrsp.put("response.data.deviceId" + std::to_string(i), cuListRes.cuResources[i].deviceId);
-            outrsp.put("response.data.cuId" + std::to_string(i), cuListRes.cuResources[i].cuId);
-            outrsp.put("response.data.channelId" + std::to_string(i), cuListRes.cuResources[i].channelId);
-            outrsp.put("response.data.cuType" + std::to_string(i), (int32_t)cuListRes.cuResources[i].cuType);
-            outrsp.put("response.data.baseAddr" + std::to_string(i), cuListRes.cuResources[i].baseAddr);
-            outrsp.put("response.data.membankId" + std::to_string(i), cuListRes.cuResources[i].membankId);
-            outrsp.put("response.data.membankType" + std::to_string(i), cuListRes.cuResources[i].membankType);
-            outrsp.put("response.data.membankSize" + std::to_string(i), cuListRes.cuResources[i].membankSize);
-            outrsp.put("response.data.membankBaseAddr" + std::to_string(i), cuListRes.cuResources[i].membankBaseAddr);
-            outrsp.put("response.data.allocServiceId" + std::to_string(i), cuListRes.cuResources[i].allocServiceId);
-            outrsp.put("response.data.channelLoadOriginal" + std::to_string(i),
-                       cuListRes.cuResources[i].channelLoadOriginal);
-            outrsp.put("response.data.poolId" + std::to_string(i), cuListRes.cuResources[i].poolId);
-        }
+        pt::ptree& data = responseData(outrsp);
+        for (i = 0; i < cuListRes.cuNum; i++) encodeCuResource(data, &cuListRes.cuResources[i], std::to_string(i));
     }
 }
 
@@ -1220,59 +769,35 @@ void xrm::cuAllocV2Command::processCmd(pt::ptree& incmd, pt::ptree& outrsp) {
     cuResource cuRes;
     std::string errmsg;
 
-    auto kernelName = incmd.get<std::string>("request.parameters.kernelName");
-    auto kernelAlias = incmd.get<std::string>("request.parameters.kernelAlias");
-    auto devExcl = incmd.get<int32_t>("request.parameters.devExcl");
-    auto deviceInfo = incmd.get<int64_t>("request.parameters.deviceInfo");
-    auto memoryInfo = incmd.get<int64_t>("request.parameters.memoryInfo");
-    auto policyInfo = incmd.get<int64_t>("request.parameters.policyInfo");
-    auto requestLoadUnified = incmd.get<int32_t>("request.parameters.requestLoadUnified");
-    auto requestLoadOriginal = incmd.get<int32_t>("request.parameters.requestLoadOriginal");
-    auto clientId = incmd.get<uint64_t>("request.parameters.clientId");
-    auto clientProcessId = incmd.get<pid_t>("request.parameters.clientProcessId");
-    auto poolId = incmd.get<uint64_t>("request.parameters.poolId");
-    strncpy(cuProp.kernelName, kernelName.c_str(), XRM_MAX_NAME_LEN - 1);
-    strncpy(cuProp.kernelAlias, kernelAlias.c_str(), XRM_MAX_NAME_LEN - 1);
-    strcpy(cuProp.cuName, "");
-    if (devExcl == 0)
-        cuProp.devExcl = false;
-    else
-        cuProp.devExcl = true;
-    cuProp.deviceInfo = deviceInfo;
-    cuProp.memoryInfo = memoryInfo;
-    cuProp.policyInfo = policyInfo;
-    cuProp.requestLoadUnified = requestLoadUnified;
-    cuProp.requestLoadOriginal = requestLoadOriginal;
-    cuProp.clientId = clientId;
-    cuProp.clientProcessId = clientProcessId;
-    cuProp.poolId = poolId;
+    requestParams params(incmd);
+    decodeCuPropertyV2(params, -1, &cuProp);
 
     bool update_id = true;
     m_system->enterLock();
     int32_t ret = m_system->resAllocCuV2(&cuProp, &cuRes, update_id);
     m_system->exitLock();
     outrsp.put("response.status.value", ret);
-    if (ret == XRM_SUCCESS) {
-        outrsp.put("response.data.xclbinFileName", cuRes.xclbinFileName);
-        outrsp.put("response.data.uuidStr", cuRes.uuidStr);
-        outrsp.put("response.data.kernelPluginFileName", cuRes.kernelPluginFileName);
-        outrsp.put("response.data.kernelName", cuRes.kernelName);
-        outrsp.put("response.data.instanceName", cuRes.instanceName);
-        outrsp.put("response.data.cuName", cuRes.cuName);
-        outrsp.put("response.data.kernelAlias", cuRes.kernelAlias);
-        outrsp.put("response.data.deviceId", cuRes.deviceId);
-        outrsp.put("response.data.cuId", cuRes.cuId);
-        outrsp.put("response.data.channelId", cuRes.channelId);
-        outrsp.put("response.data.cuType", (int32_t)cuRes.cuType);
-        outrsp.put("response.data.baseAddr", cuRes.baseAddr);
-        outrsp.put("response.data.membankId", cuRes.membankId);
-        outrsp.put("response.data.membankType", cuRes.membankType);
-        outrsp.put("response.data.membankSize", cuRes.membankSize);
-        outrsp.put("response.data.membankBaseAddr", cuRes.membankBaseAddr);
-        outrsp.put("response.data.allocServiceId", cuRes.allocServiceId);
-        outrsp.put("response.data.channelLoadOriginal", cuRes.channelLoadOriginal);
-        outrsp.put("response.data.poolId", cuRes.poolId);
-    }
+    if (ret == XRM_SUCCESS) encodeCuResource(responseData(outrsp), &cuRes, "");
+}
+
+int32_t xrm::cuAllocV2Command::processBinaryCmd(const char* req, uint32_t reqLen, char* rsp, uint32_t* rspLen) {
+    const binaryCuAllocV2Request* allocReq = (const binaryCuAllocV2Request*)req;
+    binaryCuAllocV2Response* allocRsp = (binaryCuAllocV2Response*)rsp;
+    cuPropertyV2 cuProp;
+    cuResource cuRes;
+
+    if (reqLen != sizeof(binaryCuAllocV2Request)) return (XRM_ERROR_INVALID);
+    binaryToCuPropertyV2(&allocReq->cuProp, allocReq->clientId, allocReq->clientProcessId, &cuProp);
+
+    bool update_id = true;
+    m_system->enterLock();
+    int32_t ret = m_system->resAllocCuV2(&cuProp, &cuRes, update_id);
+    m_system->exitLock();
+    memset(allocRsp, 0, sizeof(binaryCuAllocV2Response));
+    allocRsp->status = ret;
+    if (ret == XRM_SUCCESS) cuResourceToBinary(&cuRes, &allocRsp->cuRes);
+    *rspLen = sizeof(binaryCuAllocV2Response);
+    return (XRM_SUCCESS);
 }
 
 void xrm::cuListAllocV2Command::processCmd(pt::ptree& incmd, pt::ptree& outrsp) {
@@ -1281,38 +806,12 @@ void xrm::cuListAllocV2Command::processCmd(pt::ptree& incmd, pt::ptree& outrsp)
     std::string errmsg;
     int32_t i;
 
+    requestParams params(incmd);
     cuListProp = (cuListPropertyV2*)malloc(sizeof(cuListPropertyV2));
     memset(cuListProp, 0, sizeof(cuListPropertyV2));
-    auto cuNum = incmd.get<int32_t>("request.parameters.cuNum");
+    auto cuNum = params.get<int32_t>(requestParams::cuNum);
     cuListProp->cuNum = cuNum;
-    auto clientId = incmd.get<uint64_t>("request.parameters.clientId");
-    auto clientProcessId = incmd.get<pid_t>("request.parameters.clientProcessId");
-    for (i = 0; i < cuListProp->cuNum; i++) {
-        auto kernelName = incmd.get<std::string>("request.parameters.kernelName" + std::to_string(i));
-        auto kernelAlias = incmd.get<std::string>("request.parameters.kernelAlias" + std::to_string(i));
-        auto devExcl = incmd.get<int32_t>("request.parameters.devExcl" + std::to_string(i));
-        auto deviceInfo = incmd.get<int64_t>("request.parameters.deviceInfo" + std::to_string(i));
-        auto memoryInfo = incmd.get<int64_t>("request.parameters.memoryInfo" + std::to_string(i));
-        auto policyInfo = incmd.get<int64_t>("request.parameters.policyInfo" + std::to_string(i));
-        auto requestLoadUnified = incmd.get<int32_t>("request.parameters.requestLoadUnified" + std::to_string(i));
-        auto requestLoadOriginal = incmd.get<int32_t>("request.parameters.requestLoadOriginal" + std::to_string(i));
-        auto poolId = incmd.get<uint64_t>("request.parameters.poolId" + std::to_string(i));
-        strncpy(cuListProp->cuProps[i].kernelName, kernelName.c_str(), XRM_MAX_NAME_LEN - 1);
-        strncpy(cuListProp->cuProps[i].kernelAlias, kernelAlias.c_str(), XRM_MAX_NAME_LEN - 1);
-        strcpy(cuListProp->cuProps[i].cuName, "");
-        if (devExcl == 0)
-            cuListProp->cuProps[i].devExcl = false;
-        else
-            cuListProp->cuProps[i].devExcl = true;
-        cuListProp->cuProps[i].deviceInfo = deviceInfo;
-        cuListProp->cuProps[i].memoryInfo = memoryInfo;
-        cuListProp->cuProps[i].policyInfo = policyInfo;
-        cuListProp->cuProps[i].requestLoadUnified = requestLoadUnified;
-        cuListProp->cuProps[i].requestLoadOriginal = requestLoadOriginal;
-        cuListProp->cuProps[i].clientId = clientId;
-        cuListProp->cuProps[i].clientProcessId = clientProcessId;
-        cuListProp->cuProps[i].poolId = poolId;
-    }
+    for (i = 0; i < cuListProp->cuNum; i++) decodeCuPropertyV2(params, i, &cuListProp->cuProps[i]);
 
     cuListRes = (cuListResourceV2*)malloc(sizeof(cuListResourceV2));
     memset(cuListRes, 0, sizeof(cuListResourceV2));
@@ -1322,34 +821,51 @@ void xrm::cuListAllocV2Command::processCmd(pt::ptree& incmd, pt::ptree& outrsp)
     outrsp.put("response.status.value", ret);
     if (ret == XRM_SUCCESS) {
         outrsp.put("response.data.cuNum", cuListRes->cuNum);
-        for (i = 0; i < cuListRes->cuNum; i++) {
-            outrsp.put("response.data.xclbinFileName" + std::to_string(i), cuListRes->cuResources[i].xclbinFileName);
-            outrsp.put("response.data.uuidStr" + std::to_string(i), cuListRes->cuResources[i].uuidStr);
-            outrsp.put("response.data.kernelPluginFileName" + std::to_string(i),
-                       cuListRes->cuResources[i].kernelPluginFileName);
-            outrsp.put("response.data.kernelName" + std::to_string(i), cuListRes->cuResources[i].kernelName);
-            outrsp.put("response.data.instanceName" + std::to_string(i), cuListRes->cuResources[i].instanceName);
-            outrsp.put("response.data.cuName" + std::to_string(i), cuListRes->cuResources[i].cuName);
-            outrsp.put("response.data.kernelAlias" + std::to_string(i), cuListRes->cuResources[i].kernelAlias);
-            outrsp.put("response.data.deviceId" + std::to_string(i), cuListRes->cuResources[i].deviceId);
-            outrsp.put("response.data.cuId" + std::to_string(i), cuListRes->cuResources[i].cuId);
-            outrsp.put("response.data.channelId" + std::to_string(i), cuListRes->cuResources[i].channelId);
-            outrsp.put("response.data.cuType" + std::to_string(i), (int32_t)cuListRes->cuResources[i].cuType);
-            outrsp.put("response.data.baseAddr" + std::to_string(i), cuListRes->cuResources[i].baseAddr);
-            outrsp.put("response.data.membankId" + std::to_string(i), cuListRes->cuResources[i].membankId);
-            outrsp.put("response.data.membankType" + std::to_string(i), cuListRes->cuResources[i].membankType);
-            outrsp.put("response.data.membankSize" + std::to_string(i), cuListRes->cuResources[i].membankSize);
-            outrsp.put("response.data.membankBaseAddr" + std::to_string(i), cuListRes->cuResources[i].membankBaseAddr);
-            outrsp.put("response.data.allocServiceId" + std::to_string(i), cuListRes->cuResources[i].allocServiceId);
-            outrsp.put("response.data.channelLoadOriginal" + std::to_string(i),
-                       cuListRes->cuResources[i].channelLoadOriginal);
-            outrsp.put("response.data.poolId" + std::to_string(i), cuListRes->cuResources[i].poolId);
-        }
+        pt::ptree& data = responseData(outrsp);
+        for (i = 0; i < cuListRes->cuNum; i++) encodeCuResource(data, &cuListRes->cuResources[i], std::to_string(i));
     }
     free(cuListProp);
     free(cuListRes);
 }
 
+int32_t xrm::cuListAllocV2Command::processBinaryCmd(const char* req, uint32_t reqLen, char* rsp, uint32_t* rspLen) {
+    const binaryCuListAllocV2Request* allocReq = (const binaryCuListAllocV2Request*)req;
+    binaryCuListAllocV2Response* allocRsp = (binaryCuListAllocV2Response*)rsp;
+    cuListPropertyV2* cuListProp;
+    cuListResourceV2* cuListRes;
+    int32_t i;
+
+    if (reqLen < offsetof(binaryCuListAllocV2Request, cuProps)) return (XRM_ERROR_INVALID);
+    if (allocReq->cuNum <= 0 || allocReq->cuNum > XRM_MAX_LIST_CU_NUM_V2) return (XRM_ERROR_INVALID);
+    if (reqLen != offsetof(binaryCuListAllocV2Request, cuProps) + allocReq->cuNum * sizeof(binaryCuProperty))
+        return (XRM_ERROR_INVALID);
+
+    cuListProp = (cuListPropertyV2*)malloc(sizeof(cuListPropertyV2));
+    memset(cuListProp, 0, sizeof(cuListPropertyV2));
+    cuListProp->cuNum = allocReq->cuNum;
+    for (i = 0; i < cuListProp->cuNum; i++)
+        binaryToCuPropertyV2(&allocReq->cuProps[i], allocReq->clientId, allocReq->clientProcessId,
+                             &cuListProp->cuProps[i]);
+
+    cuListRes = (cuListResourceV2*)malloc(sizeof(cuListResourceV2));
+    memset(cuListRes, 0, sizeof(cuListResourceV2));
+    m_system->enterLock();
+    int32_t ret = m_system->resAllocCuListV2(cuListProp, cuListRes);
+    m_system->exitLock();
+    allocRsp->status = ret;
+    allocRsp->cuNum = 0;
+    if (ret == XRM_SUCCESS) {
+        allocRsp->cuNum = cuListRes->cuNum;
+        memset(allocRsp->cuResources, 0, cuListRes->cuNum * sizeof(binaryCuResource));
+        for (i = 0; i < cuListRes->cuNum; i++)
+            cuResourceToBinary(&cuListRes->cuResources[i], &allocRsp->cuResources[i]);
+    }
+    *rspLen = offsetof(binaryCuListAllocV2Response, cuResources) + allocRsp->cuNum * sizeof(binaryCuResource);
+    free(cuListProp);
+    free(cuListRes);
+    return (XRM_SUCCESS);
+}
+
 void xrm::cuGroupAllocV2Command::processCmd(pt::ptree& incmd, pt::ptree& outrsp) {
     cuGroupPropertyV2* cuGroupProp;
     cuGroupResourceV2* cuGroupRes;
@@ -1374,29 +890,8 @@ void xrm::cuGroupAllocV2Command::processCmd(pt::ptree& incmd, pt::ptree& outrsp)
     outrsp.put("response.status.value", ret);
     if (ret == XRM_SUCCESS) {
         outrsp.put("response.data.cuNum", cuGroupRes->cuNum);
-        for (i = 0; i < cuGroupRes->cuNum; i++) {
-            outrsp.put("response.data.xclbinFileName" + std::to_string(i), cuGroupRes->cuResources[i].xclbinFileName);
-            outrsp.put("response.data.uuidStr" + std::to_string(i), cuGroupRes->cuResources[i].uuidStr);
-            outrsp.put("response.data.kernelPluginFileName" + std::to_string(i),
-                       cuGroupRes->cuResources[i].kernelPluginFileName);
-            outrsp.put("response.data.kernelName" + std::to_string(i), cuGroupRes->cuResources[i].kernelName);
-            outrsp.put("response.data.instanceName" + std::to_string(i), cuGroupRes->cuResources[i].instanceName);
-            outrsp.put("response.data.cuName" + std::to_string(i), cuGroupRes->cuResources[i].cuName);
-            outrsp.put("response.data.kernelAlias" + std::to_string(i), cuGroupRes->cuResources[i].kernelAlias);
-            outrsp.put("response.data.deviceId" + std::to_string(i), cuGroupRes->cuResources[i].deviceId);
-            outrsp.put("response.data.cuId" + std::to_string(i), cuGroupRes->cuResources[i].cuId);
-            outrsp.put("response.data.channelId" + std::to_string(i), cuGroupRes->cuResources[i].channelId);
-            outrsp.put("response.data.cuType" + std::to_string(i), (int32_t)cuGroupRes->cuResources[i].cuType);
-            outrsp.put("response.data.baseAddr" + std::to_string(i), cuGroupRes->cuResources[i].baseAddr);
-            outrsp.put("response.data.membankId" + std::to_string(i), cuGroupRes->cuResources[i].membankId);
-            outrsp.put("response.data.membankType" + std::to_string(i), cuGroupRes->cuResources[i].membankType);
-            outrsp.put("response.data.membankSize" + std::to_string(i), cuGroupRes->cuResources[i].membankSize);
-            outrsp.put("response.data.membankBaseAddr" + std::to_string(i), cuGroupRes->cuResources[i].membankBaseAddr);
-            outrsp.put("response.data.allocServiceId" + std::to_string(i), cuGroupRes->cuResources[i].allocServiceId);
-            outrsp.put("response.data.channelLoadOriginal" + std::to_string(i),
-                       cuGroupRes->cuResources[i].channelLoadOriginal);
-            outrsp.put("response.data.poolId" + std::to_string(i), cuGroupRes->cuResources[i].poolId);
-        }
+        pt::ptree& data = responseData(outrsp);
+        for (i = 0; i < cuGroupRes->cuNum; i++) encodeCuResource(data, &cuGroupRes->cuResources[i], std::to_string(i));
     }
     free(cuGroupProp);
     free(cuGroupRes);
@@ -1406,101 +901,99 @@ void xrm::cuReleaseV2Command::processCmd(pt::ptree& incmd, pt::ptree& outrsp) {
     cuResource cuRes;
     std::string errmsg;
 
-    auto deviceId = incmd.get<int32_t>("request.parameters.deviceId");
-    auto cuId = incmd.get<int32_t>("request.parameters.cuId");
-    auto channelId = incmd.get<int32_t>("request.parameters.channelId");
-    auto cuType = incmd.get<int32_t>("request.parameters.cuType");
-    auto allocServiceId = incmd.get<uint64_t>("request.parameters.allocServiceId");
-    auto clientId = incmd.get<uint64_t>("request.parameters.clientId");
-    auto channelLoadUnified = incmd.get<int32_t>("request.parameters.channelLoadUnified");
-    auto channelLoadOriginal = incmd.get<int32_t>("request.parameters.channelLoadOriginal");
-    auto poolId = incmd.get<uint64_t>("request.parameters.poolId");
-    cuRes.deviceId = deviceId;
-    cuRes.cuId = cuId;
-    cuRes.channelId = channelId;
-    cuRes.cuType = (xrmCuType)cuType;
-    cuRes.allocServiceId = allocServiceId;
-    cuRes.clientId = clientId;
-    cuRes.channelLoadUnified = channelLoadUnified;
-    cuRes.channelLoadOriginal = channelLoadOriginal;
-    cuRes.poolId = poolId;
+    requestParams params(incmd);
+    decodeCuHandle(params, -1, &cuRes);
 
-    m_system->enterLock();
+    m_system->enterDeviceLock(cuRes.deviceId);
     int32_t ret = m_system->resReleaseCuV2(&cuRes);
-    m_system->exitLock();
+    m_system->exitDeviceLock(cuRes.deviceId);
     outrsp.put("response.status.value", ret);
 }
 
+int32_t xrm::cuReleaseV2Command::processBinaryCmd(const char* req, uint32_t reqLen, char* rsp, uint32_t* rspLen) {
+    const binaryCuReleaseV2Request* releaseReq = (const binaryCuReleaseV2Request*)req;
+    binaryStatusResponse* releaseRsp = (binaryStatusResponse*)rsp;
+    cuResource cuRes;
+
+    if (reqLen != sizeof(binaryCuReleaseV2Request)) return (XRM_ERROR_INVALID);
+    binaryToCuResource(&releaseReq->cuHandle, releaseReq->clientId, &cuRes);
+
+    m_system->enterDeviceLock(cuRes.deviceId);
+    int32_t ret = m_system->resReleaseCuV2(&cuRes);
+    m_system->exitDeviceLock(cuRes.deviceId);
+    releaseRsp->status = ret;
+    releaseRsp->reserved = 0;
+    *rspLen = sizeof(binaryStatusResponse);
+    return (XRM_SUCCESS);
+}
+
 void xrm::cuListReleaseV2Command::processCmd(pt::ptree& incmd, pt::ptree& outrsp) {
     cuListResourceV2* cuListRes;
     std::string errmsg;
     int32_t i;
 
+    requestParams params(incmd);
     cuListRes = (cuListResourceV2*)malloc(sizeof(cuListResourceV2));
     memset(cuListRes, 0, sizeof(cuListResourceV2));
-    auto cuNum = incmd.get<int32_t>("request.parameters.cuNum");
-    auto clientId = incmd.get<uint64_t>("request.parameters.clientId");
+    auto cuNum = params.get<int32_t>(requestParams::cuNum);
     cuListRes->cuNum = cuNum;
-    for (i = 0; i < cuListRes->cuNum; i++) {
-        auto deviceId = incmd.get<int32_t>("request.parameters.deviceId" + std::to_string(i));
-        auto cuId = incmd.get<int32_t>("request.parameters.cuId" + std::to_string(i));
-        auto channelId = incmd.get<int32_t>("request.parameters.channelId" + std::to_string(i));
-        auto cuType = incmd.get<int32_t>("request.parameters.cuType" + std::to_string(i));
-        auto allocServiceId = incmd.get<uint64_t>("request.parameters.allocServiceId" + std::to_string(i));
-        auto channelLoadUnified = incmd.get<int32_t>("request.parameters.channelLoadUnified" + std::to_string(i));
-        auto channelLoadOriginal = incmd.get<int32_t>("request.parameters.channelLoadOriginal" + std::to_string(i));
-        auto poolId = incmd.get<uint64_t>("request.parameters.poolId" + std::to_string(i));
-        cuListRes->cuResources[i].deviceId = deviceId;
-        cuListRes->cuResources[i].cuId = cuId;
-        cuListRes->cuResources[i].channelId = channelId;
-        cuListRes->cuResources[i].cuType = (xrmCuType)cuType;
-        cuListRes->cuResources[i].allocServiceId = allocServiceId;
-        cuListRes->cuResources[i].clientId = clientId;
-        cuListRes->cuResources[i].channelLoadUnified = channelLoadUnified;
-        cuListRes->cuResources[i].channelLoadOriginal = channelLoadOriginal;
-        cuListRes->cuResources[i].poolId = poolId;
-    }
+    for (i = 0; i < cuListRes->cuNum; i++) decodeCuHandle(params, i, &cuListRes->cuResources[i]);
 
-    m_system->enterLock();
+    std::vector<int32_t> devIds;
+    getCuResourceDeviceIds(cuListRes->cuResources, cuListRes->cuNum, XRM_MAX_LIST_CU_NUM_V2, devIds);
+    m_system->enterDeviceListLock(devIds);
     int32_t ret = m_system->resReleaseCuListV2(cuListRes);
-    m_system->exitLock();
+    m_system->exitDeviceListLock(devIds);
     free(cuListRes);
     outrsp.put("response.status.value", ret);
 }
 
+int32_t xrm::cuListReleaseV2Command::processBinaryCmd(const char* req, uint32_t reqLen, char* rsp, uint32_t* rspLen) {
+    const binaryCuListReleaseV2Request* releaseReq = (const binaryCuListReleaseV2Request*)req;
+    binaryStatusResponse* releaseRsp = (binaryStatusResponse*)rsp;
+    cuListResourceV2* cuListRes;
+    int32_t i;
+
+    if (reqLen < offsetof(binaryCuListReleaseV2Request, cuHandles)) return (XRM_ERROR_INVALID);
+    if (releaseReq->cuNum < 0 || releaseReq->cuNum > XRM_MAX_LIST_CU_NUM_V2) return (XRM_ERROR_INVALID);
+    if (reqLen != offsetof(binaryCuListReleaseV2Request, cuHandles) + releaseReq->cuNum * sizeof(binaryCuHandle))
+        return (XRM_ERROR_INVALID);
+
+    cuListRes = (cuListResourceV2*)malloc(sizeof(cuListResourceV2));
+    memset(cuListRes, 0, sizeof(cuListResourceV2));
+    cuListRes->cuNum = releaseReq->cuNum;
+    for (i = 0; i < cuListRes->cuNum; i++)
+        binaryToCuResource(&releaseReq->cuHandles[i], releaseReq->clientId, &cuListRes->cuResources[i]);
+
+    std::vector<int32_t> devIds;
+    getCuResourceDeviceIds(cuListRes->cuResources, cuListRes->cuNum, XRM_MAX_LIST_CU_NUM_V2, devIds);
+    m_system->enterDeviceListLock(devIds);
+    int32_t ret = m_system->resReleaseCuListV2(cuListRes);
+    m_system->exitDeviceListLock(devIds);
+    free(cuListRes);
+    releaseRsp->status = ret;
+    releaseRsp->reserved = 0;
+    *rspLen = sizeof(binaryStatusResponse);
+    return (XRM_SUCCESS);
+}
+
 void xrm::cuGroupReleaseV2Command::processCmd(pt::ptree& incmd, pt::ptree& outrsp) {
     cuGroupResourceV2* cuGroupRes;
     std::string errmsg;
     int32_t i;
 
+    requestParams params(incmd);
     cuGroupRes = (cuGroupResourceV2*)malloc(sizeof(cuGroupResourceV2));
     memset(cuGroupRes, 0, sizeof(cuGroupResourceV2));
-    auto cuNum = incmd.get<int32_t>("request.parameters.cuNum");
+    auto cuNum = params.get<int32_t>(requestParams::cuNum);
     cuGroupRes->cuNum = cuNum;
-    auto clientId = incmd.get<uint64_t>("request.parameters.clientId");
-    for (i = 0; i < cuGroupRes->cuNum; i++) {
-        auto deviceId = incmd.get<int32_t>("request.parameters.deviceId" + std::to_string(i));
-        auto cuId = incmd.get<int32_t>("request.parameters.cuId" + std::to_string(i));
-        auto channelId = incmd.get<int32_t>("request.parameters.channelId" + std::to_string(i));
-        auto cuType = incmd.get<int32_t>("request.parameters.cuType" + std::to_string(i));
-        auto allocServiceId = incmd.get<uint64_t>("request.parameters.allocServiceId" + std::to_string(i));
-        auto channelLoadUnified = incmd.get<int32_t>("request.parameters.channelLoadUnified" + std::to_string(i));
-        auto channelLoadOriginal = incmd.get<int32_t>("request.parameters.channelLoadOriginal" + std::to_string(i));
-        auto poolId = incmd.get<uint64_t>("request.parameters.poolId" + std::to_string(i));
-        cuGroupRes->cuResources[i].deviceId = deviceId;
-        cuGroupRes->cuResources[i].cuId = cuId;
-        cuGroupRes->cuResources[i].channelId = channelId;
-        cuGroupRes->cuResources[i].cuType = (xrmCuType)cuType;
-        cuGroupRes->cuResources[i].allocServiceId = allocServiceId;
-        cuGroupRes->cuResources[i].clientId = clientId;
-        cuGroupRes->cuResources[i].channelLoadUnified = channelLoadUnified;
-        cuGroupRes->cuResources[i].channelLoadOriginal = channelLoadOriginal;
-        cuGroupRes->cuResources[i].poolId = poolId;
-    }
+    for (i = 0; i < cuGroupRes->cuNum; i++) decodeCuHandle(params, i, &cuGroupRes->cuResources[i]);
 
-    m_system->enterLock();
+    std::vector<int32_t> devIds;
+    getCuResourceDeviceIds(cuGroupRes->cuResources, cuGroupRes->cuNum, XRM_MAX_GROUP_CU_NUM_V2, devIds);
+    m_system->enterDeviceListLock(devIds);
     int32_t ret = m_system->resReleaseCuGroupV2(cuGroupRes);
-    m_system->exitLock();
+    m_system->exitDeviceListLock(devIds);
     free(cuGroupRes);
     outrsp.put("response.status.value", ret);
 }
@@ -1591,196 +1084,81 @@ void xrm::allocationQueryV2Command::processCmd(pt::ptree& incmd, pt::ptree& outr
     outrsp.put("response.status.value", ret);
     if (ret == XRM_SUCCESS) {
         outrsp.put("response.data.cuNum", cuListRes->cuNum);
-        for (i = 0; i < cuListRes->cuNum; i++) {
-            outrsp.put("response.data.xclbinFileName" + std::to_string(i), cuListRes->cuResources[i].xclbinFileName);
-            outrsp.put("response.data.uuidStr" + std::to_string(i), cuListRes->cuResources[i].uuidStr);
-            outrsp.put("response.data.kernelPluginFileName" + std::to_string(i),
-                       cuListRes->cuResources[i].kernelPluginFileName);
-            outrsp.put("response.data.kernelName" + std::to_string(i), cuListRes->cuResources[i].kernelName);
-            outrsp.put("response.data.instanceName" + std::to_string(i), cuListRes->cuResources[i].instanceName);
-            outrsp.put("response.data.cuName" + std::to_string(i), cuListRes->cuResources[i].cuName);
-            outrsp.put("response.data.kernelAlias" + std::to_string(i), cuListRes->cuResources[i].kernelAlias);
-            outrsp.put("response.data.deviceId" + std::to_string(i), cuListRes->cuResources[i].deviceId);
-            outrsp.put("response.data.cuId" + std::to_string(i), cuListRes->cuResources[i].cuId);
-            outrsp.put("response.data.channelId" + std::to_string(i), cuListRes->cuResources[i].channelId);
-            outrsp.put("response.data.cuType" + std::to_string(i), (int32_t)cuListRes->cuResources[i].cuType);
-            outrsp.put("response.data.baseAddr" + std::to_string(i), (int32_t)cuListRes->cuResources[i].baseAddr);
-            outrsp.put("response.data.membankId" + std::to_string(i), (int32_t)cuListRes->cuResources[i].membankId);
-            outrsp.put("response.data.membankType" + std::to_string(i), (int32_t)cuListRes->cuResources[i].membankType);
-            outrsp.put("response.data.membankSize" + std::to_string(i), (int32_t)cuListRes->cuResources[i].membankSize);
-            outrsp.put("response.data.membankBaseAddr" + std::to_string(i),
-                       (int32_t)cuListRes->cuResources[i].membankBaseAddr);
-            outrsp.put("response.data.allocServiceId" + std::to_string(i), cuListRes->cuResources[i].allocServiceId);
-            outrsp.put("response.data.channelLoadOriginal" + std::to_string(i),
-                       cuListRes->cuResources[i].channelLoadOriginal);
-            outrsp.put("response.data.poolId" + std::to_string(i), cuListRes->cuResources[i].poolId);
-        }
+        pt::ptree& data = responseData(outrsp);
+        for (i = 0; i < cuListRes->cuNum; i++) encodeCuResource(data, &cuListRes->cuResources[i], std::to_string(i));
     }
     free(cuListRes);
 }
 
+void xrm::allocationReleaseV2Command::processCmd(pt::ptree& incmd, pt::ptree& outrsp) {
+    int32_t cuNum = 0;
+
+    auto clientId = incmd.get<uint64_t>("request.parameters.clientId");
+    auto allocServiceId = incmd.get<uint64_t>("request.parameters.allocServiceId");
+    m_system->enterLock();
+    int32_t ret = m_system->resReleaseAllocServiceV2(clientId, allocServiceId, &cuNum);
+    m_system->exitLock();
+    outrsp.put("response.status.value", ret);
+    if (ret == XRM_SUCCESS) {
+        outrsp.put("response.data.cuNum", cuNum);
+    } else {
+        outrsp.put("response.data.failed", "failed to release the allocation service");
+    }
+}
+
 void xrm::checkCuAvailableNumV2Command::processCmd(pt::ptree& incmd, pt::ptree& outrsp) {
     cuPropertyV2 cuProp;
-    std::vector<cuResource*> cuRes;
     std::string errmsg;
-    cuResource* tmpCuRes;
-    int32_t i, ret;
+    int32_t ret;
     int32_t availableCuNum = 0;
 
-    auto kernelName = incmd.get<std::string>("request.parameters.kernelName");
-    auto kernelAlias = incmd.get<std::string>("request.parameters.kernelAlias");
-    auto devExcl = incmd.get<int32_t>("request.parameters.devExcl");
-    auto deviceInfo = incmd.get<int64_t>("request.parameters.deviceInfo");
-    auto memoryInfo = incmd.get<int64_t>("request.parameters.memoryInfo");
-    auto policyInfo = incmd.get<int64_t>("request.parameters.policyInfo");
-    auto requestLoadUnified = incmd.get<int32_t>("request.parameters.requestLoadUnified");
-    auto requestLoadOriginal = incmd.get<int32_t>("request.parameters.requestLoadOriginal");
-    auto clientId = incmd.get<uint64_t>("request.parameters.clientId");
-    auto clientProcessId = incmd.get<pid_t>("request.parameters.clientProcessId");
-    auto poolId = incmd.get<uint64_t>("request.parameters.poolId");
-    strncpy(cuProp.kernelName, kernelName.c_str(), XRM_MAX_NAME_LEN - 1);
-    strncpy(cuProp.kernelAlias, kernelAlias.c_str(), XRM_MAX_NAME_LEN - 1);
-    strcpy(cuProp.cuName, "");
-    if (devExcl == 0)
-        cuProp.devExcl = false;
-    else
-        cuProp.devExcl = true;
-    cuProp.deviceInfo = deviceInfo;
-    cuProp.memoryInfo = memoryInfo;
-    cuProp.policyInfo = policyInfo;
-    cuProp.requestLoadUnified = requestLoadUnified;
-    cuProp.requestLoadOriginal = requestLoadOriginal;
-    cuProp.clientId = clientId;
-    cuProp.clientProcessId = clientProcessId;
-    cuProp.poolId = poolId;
+    requestParams params(incmd);
+    decodeCuPropertyV2(params, -1, &cuProp);
 
-    bool update_id = true;
     m_system->enterLock();
-    do {
-        tmpCuRes = (cuResource*)malloc(sizeof(cuResource));
-        memset(tmpCuRes, 0, sizeof(cuResource));
-        ret = m_system->resAllocCuV2(&cuProp, tmpCuRes, update_id);
-        if (ret == XRM_SUCCESS) {
-            cuRes.push_back(tmpCuRes);
-            availableCuNum++;
-        } else {
-            free(tmpCuRes);
-            break;
-        }
-    } while (ret == XRM_SUCCESS);
-    if (availableCuNum > 0) {
-        /* get the available cu number */
-        for (i = 0; i < availableCuNum; i++) {
-            m_system->resReleaseCuV2(cuRes[i]);
-            free(cuRes[i]);
-        }
+    ret = m_system->resCheckCuAvailableNumV2(&cuProp, &availableCuNum);
+    m_system->exitLock();
+    if (ret == XRM_SUCCESS) {
         outrsp.put("response.status.value", XRM_SUCCESS);
         outrsp.put("response.data.availableCuNum", availableCuNum);
     } else {
-        /*
-         * There is no available resource or input is invalid.
-         * Available cu list num is 0.
-         */
-        if (ret == XRM_ERROR_INVALID) {
-            /* The input is invalid */
-            outrsp.put("response.status.value", XRM_ERROR_INVALID);
-            outrsp.put("response.data.failed", "failed to check available cu number");
-        } else {
-            /* there is no available resource */
-            outrsp.put("response.status.value", XRM_SUCCESS);
-            outrsp.put("response.data.availableCuNum", availableCuNum);
-        }
+        /* The input is invalid */
+        outrsp.put("response.status.value", XRM_ERROR_INVALID);
+        outrsp.put("response.data.failed", "failed to check available cu number");
     }
-    m_system->exitLock();
 }
 
 void xrm::checkCuListAvailableNumV2Command::processCmd(pt::ptree& incmd, pt::ptree& outrsp) {
     cuListPropertyV2* cuListProp;
-    std::vector<cuListResourceV2*> cuListRes;
-    cuListResourceV2* tmpCuListRes;
     std::string errmsg;
     int32_t i, ret;
     int32_t availableListNum = 0;
 
+    requestParams params(incmd);
     cuListProp = (cuListPropertyV2*)malloc(sizeof(cuListPropertyV2));
     memset(cuListProp, 0, sizeof(cuListPropertyV2));
-    auto cuNum = incmd.get<int32_t>("request.parameters.cuNum");
+    auto cuNum = params.get<int32_t>(requestParams::cuNum);
     cuListProp->cuNum = cuNum;
-    auto clientId = incmd.get<uint64_t>("request.parameters.clientId");
-    auto clientProcessId = incmd.get<pid_t>("request.parameters.clientProcessId");
-    for (i = 0; i < cuListProp->cuNum; i++) {
-        auto kernelName = incmd.get<std::string>("request.parameters.kernelName" + std::to_string(i));
-        auto kernelAlias = incmd.get<std::string>("request.parameters.kernelAlias" + std::to_string(i));
-        auto devExcl = incmd.get<int32_t>("request.parameters.devExcl" + std::to_string(i));
-        auto deviceInfo = incmd.get<int64_t>("request.parameters.deviceInfo" + std::to_string(i));
-        auto memoryInfo = incmd.get<int64_t>("request.parameters.memoryInfo" + std::to_string(i));
-        auto policyInfo = incmd.get<int64_t>("request.parameters.policyInfo" + std::to_string(i));
-        auto requestLoadUnified = incmd.get<int32_t>("request.parameters.requestLoadUnified" + std::to_string(i));
-        auto requestLoadOriginal = incmd.get<int32_t>("request.parameters.requestLoadOriginal" + std::to_string(i));
-        auto poolId = incmd.get<uint64_t>("request.parameters.poolId" + std::to_string(i));
-        strncpy(cuListProp->cuProps[i].kernelName, kernelName.c_str(), XRM_MAX_NAME_LEN - 1);
-        strncpy(cuListProp->cuProps[i].kernelAlias, kernelAlias.c_str(), XRM_MAX_NAME_LEN - 1);
-        strcpy(cuListProp->cuProps[i].cuName, "");
-        if (devExcl == 0)
-            cuListProp->cuProps[i].devExcl = false;
-        else
-            cuListProp->cuProps[i].devExcl = true;
-        cuListProp->cuProps[i].deviceInfo = deviceInfo;
-        cuListProp->cuProps[i].memoryInfo = memoryInfo;
-        cuListProp->cuProps[i].policyInfo = policyInfo;
-        cuListProp->cuProps[i].requestLoadUnified = requestLoadUnified;
-        cuListProp->cuProps[i].requestLoadOriginal = requestLoadOriginal;
-        cuListProp->cuProps[i].clientId = clientId;
-        cuListProp->cuProps[i].clientProcessId = clientProcessId;
-        cuListProp->cuProps[i].poolId = poolId;
-    }
+    for (i = 0; i < cuListProp->cuNum; i++) decodeCuPropertyV2(params, i, &cuListProp->cuProps[i]);
 
     m_system->enterLock();
-    do {
-        tmpCuListRes = (cuListResourceV2*)malloc(sizeof(cuListResourceV2));
-        memset(tmpCuListRes, 0, sizeof(cuListResourceV2));
-        ret = m_system->resAllocCuListV2(cuListProp, tmpCuListRes);
-        if (ret == XRM_SUCCESS) {
-            cuListRes.push_back(tmpCuListRes);
-            availableListNum++;
-        } else {
-            free(tmpCuListRes);
-            break;
-        }
-    } while (ret == XRM_SUCCESS);
-    if (availableListNum > 0) {
-        /* get the available cu list number */
-        for (i = 0; i < availableListNum; i++) {
-            m_system->resReleaseCuListV2(cuListRes[i]);
-            free(cuListRes[i]);
-        }
+    ret = m_system->resCheckCuListAvailableNumV2(cuListProp, &availableListNum);
+    m_system->exitLock();
+    if (ret == XRM_SUCCESS) {
         outrsp.put("response.status.value", XRM_SUCCESS);
         outrsp.put("response.data.availableListNum", availableListNum);
     } else {
-        /*
-         * There is no available resource or input is invalid.
-         * Available cu list num is 0.
-         */
-        if (ret == XRM_ERROR_INVALID) {
-            /* The input is invalid */
-            outrsp.put("response.status.value", XRM_ERROR_INVALID);
-            outrsp.put("response.data.failed", "failed to check available cu list number");
-        } else {
-            /* there is no available resource */
-            outrsp.put("response.status.value", XRM_SUCCESS);
-            outrsp.put("response.data.availableListNum", availableListNum);
-        }
+        /* The input is invalid */
+        outrsp.put("response.status.value", XRM_ERROR_INVALID);
+        outrsp.put("response.data.failed", "failed to check available cu list number");
     }
-    m_system->exitLock();
     free(cuListProp);
 }
 
 void xrm::checkCuGroupAvailableNumV2Command::processCmd(pt::ptree& incmd, pt::ptree& outrsp) {
     cuGroupPropertyV2 cuGroupProp;
-    std::vector<cuGroupResourceV2*> cuGroupRes;
-    cuGroupResourceV2* tmpCuGroupRes;
     std::string errmsg;
-    int32_t i, ret;
+    int32_t ret;
     int32_t availableGroupNum = 0;
 
     auto udfCuGroupName = incmd.get<std::string>("request.parameters.udfCuGroupName");
@@ -1793,54 +1171,25 @@ void xrm::checkCuGroupAvailableNumV2Command::processCmd(pt::ptree& incmd, pt::pt
     cuGroupProp.poolId = poolId;
 
     m_system->enterLock();
-    do {
-        tmpCuGroupRes = (cuGroupResourceV2*)malloc(sizeof(cuGroupResourceV2));
-        memset(tmpCuGroupRes, 0, sizeof(cuGroupResourceV2));
-        ret = m_system->resAllocCuGroupV2(&cuGroupProp, tmpCuGroupRes);
-        if (ret == XRM_SUCCESS) {
-            cuGroupRes.push_back(tmpCuGroupRes);
-            availableGroupNum++;
-        } else {
-            free(tmpCuGroupRes);
-            break;
-        }
-    } while (ret == XRM_SUCCESS);
-    if (availableGroupNum > 0) {
-        /* get the available cu group number */
-        for (i = 0; i < availableGroupNum; i++) {
-            m_system->resReleaseCuGroupV2(cuGroupRes[i]);
-            free(cuGroupRes[i]);
-        }
+    ret = m_system->resCheckCuGroupAvailableNumV2(&cuGroupProp, &availableGroupNum);
+    m_system->exitLock();
+    if (ret == XRM_SUCCESS) {
         outrsp.put("response.status.value", XRM_SUCCESS);
         outrsp.put("response.data.availableGroupNum", availableGroupNum);
     } else {
-        /*
-         * There is no available resource or input is invalid.
-         * Available cu group num is 0.
-         */
-        if (ret == XRM_ERROR_INVALID) {
-            /* The input is invalid */
-            outrsp.put("response.status.value", XRM_ERROR_INVALID);
-            outrsp.put("response.data.failed", "failed to check available cu group number");
-        } else {
-            /* there is no available resource */
-            outrsp.put("response.status.value", XRM_SUCCESS);
-            outrsp.put("response.data.availableGroupNum", availableGroupNum);
-        }
+        /* The input is invalid */
+        outrsp.put("response.status.value", XRM_ERROR_INVALID);
+        outrsp.put("response.data.failed", "failed to check available cu group number");
     }
-    m_system->exitLock();
 }
 
 void xrm::checkCuPoolAvailableNumV2Command::processCmd(pt::ptree& incmd, pt::ptree& outrsp) {
     cuPoolPropertyV2* cuPoolProp;
     cuListPropertyV2* cuListProp = NULL;
     deviceIdListPropertyV2* deviceIdListProp = NULL;
-    std::vector<uint64_t> cuPoolId;
     std::string errmsg;
     int32_t i;
-    uint64_t poolId;
     int32_t availablePoolNum = 0;
-    cuPoolResInforV2* cuPoolResInfor = NULL;
 
     cuPoolProp = (cuPoolPropertyV2*)malloc(sizeof(cuPoolPropertyV2));
     memset(cuPoolProp, 0, sizeof(cuPoolPropertyV2));
@@ -1888,33 +1237,12 @@ void xrm::checkCuPoolAvailableNumV2Command::processCmd(pt::ptree& incmd, pt::ptr
     auto xclbinNum = incmd.get<int32_t>("request.parameters.xclbinNum");
     cuPoolProp->xclbinNum = xclbinNum;
 
-    cuPoolResInfor = (cuPoolResInforV2*)malloc(sizeof(cuPoolResInforV2));
-    memset(cuPoolResInfor, 0, sizeof(cuPoolResInforV2));
     m_system->enterLock();
-    do {
-        poolId = m_system->resReserveCuPoolV2(cuPoolProp, cuPoolResInfor);
-        if (poolId != 0) {
-            cuPoolId.push_back(poolId);
-            availablePoolNum++;
-        } else {
-            break;
-        }
-    } while (poolId != 0);
-    if (availablePoolNum > 0) {
-        /* get the available cu pool id */
-        for (i = 0; i < availablePoolNum; i++) m_system->resRelinquishCuPoolV2(cuPoolId[i]);
-        outrsp.put("response.status.value", XRM_SUCCESS);
-        outrsp.put("response.data.availablePoolNum", availablePoolNum);
-    } else {
-        /*
-         * Available cu pool num is 0.
-         */
-        outrsp.put("response.status.value", XRM_SUCCESS);
-        outrsp.put("response.data.availablePoolNum", 0);
-    }
+    m_system->resCheckCuPoolAvailableNumV2(cuPoolProp, &availablePoolNum);
     m_system->exitLock();
+    outrsp.put("response.status.value", XRM_SUCCESS);
+    outrsp.put("response.data.availablePoolNum", availablePoolNum);
     free(cuPoolProp);
-    free(cuPoolResInfor);
 }
 
 void xrm::cuPoolReserveV2Command::processCmd(pt::ptree& incmd, pt::ptree& outrsp) {
@@ -2071,3 +1399,160 @@ void xrm::reservationQueryV2Command::processCmd(pt::ptree& incmd, pt::ptree& out
     free(reserveQueryInfo);
     free(cuPoolRes);
 }
+
+void xrm::batchCommand::processCmd(pt::ptree& /*incmd*/, pt::ptree& outrsp) {
+    outrsp.put("response.status.value", XRM_ERROR_INVALID);
+    outrsp.put("response.data.failed", "batch is only supported with binary framing");
+}
+
+/*
+ * Length of the operation record in batch request, 0 for the operation not supported in batch
+ */
+static uint32_t getBatchOpRequestLength(uint16_t opcode) {
+    switch (opcode) {
+        case xrm::XRM_BINARY_OP_CU_ALLOC_V2:
+            return (sizeof(xrm::binaryCuProperty));
+        case xrm::XRM_BINARY_OP_CU_RELEASE_V2:
+        case xrm::XRM_BINARY_OP_CU_CHECK_STATUS:
+            return (sizeof(xrm::binaryCuHandle));
+        case xrm::XRM_BINARY_OP_ALLOCATION_QUERY_V2:
+            return (sizeof(xrm::binaryAllocationQueryV2Request));
+        default:
+            return (0);
+    }
+}
+
+int32_t xrm::batchCommand::processBinaryCmd(const char* req, uint32_t reqLen, char* rsp, uint32_t* rspLen) {
+    const binaryBatchRequest* batchReq = (const binaryBatchRequest*)req;
+    binaryBatchResponse* batchRsp = (binaryBatchResponse*)rsp;
+    const binaryBatchOpHeader* opHdr;
+    binaryBatchOpHeader* rspOpHdr;
+    cuListResourceV2* cuListRes = NULL; // for allocation query, allocated on first use
+    uint32_t reqOffset, rspOffset, opRspMaxLen;
+    int32_t i;
+
+    if (reqLen < sizeof(binaryBatchRequest)) return (XRM_ERROR_INVALID);
+    if (batchReq->opNum <= 0 || batchReq->opNum > XRM_MAX_BATCH_OP_NUM) return (XRM_ERROR_INVALID);
+    /* the whole batch is checked before any operation is done */
+    reqOffset = sizeof(binaryBatchRequest);
+    for (i = 0; i < batchReq->opNum; i++) {
+        if (reqLen - reqOffset < sizeof(binaryBatchOpHeader)) return (XRM_ERROR_INVALID);
+        opHdr = (const binaryBatchOpHeader*)(req + reqOffset);
+        reqOffset += sizeof(binaryBatchOpHeader);
+        if (opHdr->length == 0 || opHdr->length != getBatchOpRequestLength(opHdr->opcode) ||
+            reqLen - reqOffset < opHdr->length)
+            return (XRM_ERROR_INVALID);
+        reqOffset += opHdr->length;
+    }
+    if (reqOffset != reqLen) return (XRM_ERROR_INVALID);
+
+    reqOffset = sizeof(binaryBatchRequest);
+    rspOffset = sizeof(binaryBatchResponse);
+    m_system->enterLock();
+    for (i = 0; i < batchReq->opNum; i++) {
+        opHdr = (const binaryBatchOpHeader*)(req + reqOffset);
+        rspOpHdr = (binaryBatchOpHeader*)(rsp + rspOffset);
+        /* keep room for the largest result of the remaining operations, only query result may not fit */
+        opRspMaxLen = XRM_BINARY_MAX_RESPONSE_LEN - rspOffset - sizeof(binaryBatchOpHeader) -
+                      (batchReq->opNum - i - 1) * (sizeof(binaryBatchOpHeader) + sizeof(binaryCuAllocV2Response));
+        rspOpHdr->opcode = opHdr->opcode;
+        rspOpHdr->reserved = 0;
+        rspOpHdr->length =
+            processOp(batchReq, opHdr, rsp + rspOffset + sizeof(binaryBatchOpHeader), opRspMaxLen, &cuListRes);
+        reqOffset += sizeof(binaryBatchOpHeader) + opHdr->length;
+        rspOffset += sizeof(binaryBatchOpHeader) + rspOpHdr->length;
+    }
+    m_system->exitLock();
+    free(cuListRes);
+    batchRsp->status = XRM_SUCCESS;
+    batchRsp->opNum = batchReq->opNum;
+    *rspLen = rspOffset;
+    return (XRM_SUCCESS);
+}
+
+/*
+ * Does one operation of the batch, called with the lock held. The result is filled into
+ * opRsp and its length is returned.
+ */
+uint32_t xrm::batchCommand::processOp(const binaryBatchRequest* batchReq,
+                                      const binaryBatchOpHeader* opHdr,
+                                      char* opRsp,
+                                      uint32_t opRspMaxLen,
+                                      cuListResourceV2** cuListRes) {
+    const char* opReq = (const char*)opHdr + sizeof(binaryBatchOpHeader);
+    int32_t i, ret;
+
+    switch (opHdr->opcode) {
+        case XRM_BINARY_OP_CU_ALLOC_V2: {
+            binaryCuAllocV2Response* allocRsp = (binaryCuAllocV2Response*)opRsp;
+            cuPropertyV2 cuProp;
+            cuResource cuRes;
+            binaryToCuPropertyV2((const binaryCuProperty*)opReq, batchReq->clientId, batchReq->clientProcessId,
+                                 &cuProp);
+            bool update_id = true;
+            ret = m_system->resAllocCuV2(&cuProp, &cuRes, update_id);
+            memset(allocRsp, 0, sizeof(binaryCuAllocV2Response));
+            allocRsp->status = ret;
+            if (ret == XRM_SUCCESS) cuResourceToBinary(&cuRes, &allocRsp->cuRes);
+            return (sizeof(binaryCuAllocV2Response));
+        }
+        case XRM_BINARY_OP_CU_RELEASE_V2: {
+            binaryStatusResponse* releaseRsp = (binaryStatusResponse*)opRsp;
+            cuResource cuRes;
+            binaryToCuResource((const binaryCuHandle*)opReq, batchReq->clientId, &cuRes);
+            releaseRsp->status = m_system->resReleaseCuV2(&cuRes);
+            releaseRsp->reserved = 0;
+            return (sizeof(binaryStatusResponse));
+        }
+        case XRM_BINARY_OP_CU_CHECK_STATUS: {
+            binaryCuCheckStatusResponse* statusRsp = (binaryCuCheckStatusResponse*)opRsp;
+            cuResource cuRes;
+            cuStatus cuStat;
+            binaryToCuResource((const binaryCuHandle*)opReq, batchReq->clientId, &cuRes);
+            ret = m_system->checkCuStat(&cuRes, &cuStat);
+            memset(statusRsp, 0, sizeof(binaryCuCheckStatusResponse));
+            statusRsp->status = ret;
+            if (ret == XRM_SUCCESS) {
+                statusRsp->isBusy = cuStat.isBusy ? 1 : 0;
+                statusRsp->usedLoadUnified = cuStat.usedLoadUnified;
+                statusRsp->usedLoadOriginal = cuStat.usedLoadOriginal;
+            }
+            return (sizeof(binaryCuCheckStatusResponse));
+        }
+        case XRM_BINARY_OP_ALLOCATION_QUERY_V2: {
+            const binaryAllocationQueryV2Request* queryReq = (const binaryAllocationQueryV2Request*)opReq;
+            binaryCuListAllocV2Response* queryRsp = (binaryCuListAllocV2Response*)opRsp;
+            allocationQueryInfoV2 allocQuery;
+            if (*cuListRes == NULL) *cuListRes = (cuListResourceV2*)malloc(sizeof(cuListResourceV2));
+            memset(*cuListRes, 0, sizeof(cuListResourceV2));
+            memset(&allocQuery, 0, sizeof(allocationQueryInfoV2));
+            allocQuery.allocServiceId = queryReq->allocServiceId;
+            strncpy(allocQuery.kernelName, queryReq->kernelName, XRM_MAX_NAME_LEN - 1);
+            strncpy(allocQuery.kernelAlias, queryReq->kernelAlias, XRM_MAX_NAME_LEN - 1);
+            ret = m_system->resAllocationQueryV2(&allocQuery, *cuListRes);
+            queryRsp->status = ret;
+            queryRsp->cuNum = 0;
+            if (ret == XRM_SUCCESS) {
+                uint32_t queryRspLen =
+                    offsetof(binaryCuListAllocV2Response, cuResources) + (*cuListRes)->cuNum * sizeof(binaryCuResource);
+                if (queryRspLen > opRspMaxLen) {
+                    /* no room left in the response, the query can be done in a smaller batch */
+                    queryRsp->status = XRM_ERROR_INVALID;
+                } else {
+                    queryRsp->cuNum = (*cuListRes)->cuNum;
+                    memset(queryRsp->cuResources, 0, queryRsp->cuNum * sizeof(binaryCuResource));
+                    for (i = 0; i < queryRsp->cuNum; i++)
+                        cuResourceToBinary(&(*cuListRes)->cuResources[i], &queryRsp->cuResources[i]);
+                }
+            }
+            return (offsetof(binaryCuListAllocV2Response, cuResources) + queryRsp->cuNum * sizeof(binaryCuResource));
+        }
+        default: {
+            /* not reached, the operations are checked before */
+            binaryStatusResponse* statusRsp = (binaryStatusResponse*)opRsp;
+            statusRsp->status = XRM_ERROR_INVALID;
+            statusRsp->reserved = 0;
+            return (sizeof(binaryStatusResponse));
+        }
+    }
+}
@@ -22,6 +22,7 @@
 #define _XRM_COMMAND_RESOURCE_HPP_
 
 #include "xrm_command.hpp"
+#include "xrm_command_schema.hpp"
 
 namespace xrm {
 class createContextCommand : public command {
@@ -131,9 +132,10 @@ class cuGetMaxCapacityCommand : public command {
 
 class cuCheckStatusCommand : public command {
    public:
-    cuCheckStatusCommand(xrm::system& sys) : command("cuCheckStatus", sys) {}
+    cuCheckStatusCommand(xrm::system& sys) : command("cuCheckStatus", sys, XRM_BINARY_OP_CU_CHECK_STATUS) {}
 
     void processCmd(pt::ptree& incmd, pt::ptree& outrsp);
+    int32_t processBinaryCmd(const char* req, uint32_t reqLen, char* rsp, uint32_t* rspLen);
 };
 
 class allocationQueryCommand : public command {
@@ -236,30 +238,34 @@ class loadAndAllCuAllocCommand : public command {
 
 class cuAllocV2Command : public command {
    public:
-    cuAllocV2Command(xrm::system& sys) : command("cuAllocV2", sys) {}
+    cuAllocV2Command(xrm::system& sys) : command("cuAllocV2", sys, XRM_BINARY_OP_CU_ALLOC_V2) {}
 
     void processCmd(pt::ptree& incmd, pt::ptree& outrsp);
+    int32_t processBinaryCmd(const char* req, uint32_t reqLen, char* rsp, uint32_t* rspLen);
 };
 
 class cuListAllocV2Command : public command {
    public:
-    cuListAllocV2Command(xrm::system& sys) : command("cuListAllocV2", sys) {}
+    cuListAllocV2Command(xrm::system& sys) : command("cuListAllocV2", sys, XRM_BINARY_OP_CU_LIST_ALLOC_V2) {}
 
     void processCmd(pt::ptree& incmd, pt::ptree& outrsp);
+    int32_t processBinaryCmd(const char* req, uint32_t reqLen, char* rsp, uint32_t* rspLen);
 };
 
 class cuReleaseV2Command : public command {
    public:
-    cuReleaseV2Command(xrm::system& sys) : command("cuReleaseV2", sys) {}
+    cuReleaseV2Command(xrm::system& sys) : command("cuReleaseV2", sys, XRM_BINARY_OP_CU_RELEASE_V2) {}
 
     void processCmd(pt::ptree& incmd, pt::ptree& outrsp);
+    int32_t processBinaryCmd(const char* req, uint32_t reqLen, char* rsp, uint32_t* rspLen);
 };
 
 class cuListReleaseV2Command : public command {
    public:
-    cuListReleaseV2Command(xrm::system& sys) : command("cuListReleaseV2", sys) {}
+    cuListReleaseV2Command(xrm::system& sys) : command("cuListReleaseV2", sys, XRM_BINARY_OP_CU_LIST_RELEASE_V2) {}
 
     void processCmd(pt::ptree& incmd, pt::ptree& outrsp);
+    int32_t processBinaryCmd(const char* req, uint32_t reqLen, char* rsp, uint32_t* rspLen);
 };
 
 class udfCuGroupDeclareV2Command : public command {
@@ -297,6 +303,13 @@ class allocationQueryV2Command : public command {
     void processCmd(pt::ptree& incmd, pt::ptree& outrsp);
 };
 
+class allocationReleaseV2Command : public command {
+   public:
+    allocationReleaseV2Command(xrm::system& sys) : command("allocationReleaseV2", sys) {}
+
+    void processCmd(pt::ptree& incmd, pt::ptree& outrsp);
+};
+
 class checkCuAvailableNumV2Command : public command {
    public:
     checkCuAvailableNumV2Command(xrm::system& sys) : command("checkCuAvailableNumV2", sys) {}
@@ -346,6 +359,25 @@ class reservationQueryV2Command : public command {
     void processCmd(pt::ptree& incmd, pt::ptree& outrsp);
 };
 
+/*
+ * Batch of cu alloc / release / status check / allocation query operations, only through
+ * binary framing. The operations are done in order under one lock acquisition.
+ */
+class batchCommand : public command {
+   public:
+    batchCommand(xrm::system& sys) : command("batch", sys, XRM_BINARY_OP_BATCH) {}
+
+    void processCmd(pt::ptree& incmd, pt::ptree& outrsp);
+    int32_t processBinaryCmd(const char* req, uint32_t reqLen, char* rsp, uint32_t* rspLen);
+
+   private:
+    uint32_t processOp(const binaryBatchRequest* batchReq,
+                       const binaryBatchOpHeader* opHdr,
+                       char* opRsp,
+                       uint32_t opRspMaxLen,
+                       cuListResourceV2** cuListRes);
+};
+
 } // namespace xrm
 
 #endif // _XRM_COMMAND_RESOURCE_HPP_
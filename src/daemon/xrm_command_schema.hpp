@@ -0,0 +1,320 @@
+/*
+ * Copyright (C) 2019-2021, Xilinx Inc - All rights reserved
+ *
+ * Copyright (C) 2023, Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Xilinx Resource Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef _XRM_COMMAND_SCHEMA_HPP_
+#define _XRM_COMMAND_SCHEMA_HPP_
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <boost/property_tree/ptree.hpp>
+#include "xrm_binary_protocol.hpp"
+#include "xrm_system.hpp"
+
+/*
+ * Schema of the records carried by the resource commands. Each record is declared once as
+ * X(key, kind) list, the key is the json key of the field and the member name in both the
+ * daemon structure and the binary record, the kind selects the conversion:
+ *   str: char array, copied with strncpy
+ *   flag: bool in daemon structure, 0 / 1 in json and int32_t in binary record
+ *   i32, u32, i64, u64: integer of the size
+ *   cuType: xrmCuType in daemon structure, int32_t in json and binary record
+ *
+ * The json decoders, the json encoders and the conversions of binary records are generated
+ * from the lists, so the V1, V2 and binary commands share the field handling. The fields of
+ * the cu list are carried with the index as suffix of the key, e.g. kernelName0, kernelName1.
+ */
+
+/* request property of one cu, cuPropertyV2 has the constraint information in addition */
+#define XRM_SCHEMA_CU_PROPERTY(X)  \
+    X(kernelName, str)             \
+    X(kernelAlias, str)            \
+    X(devExcl, flag)               \
+    X(requestLoadUnified, i32)     \
+    X(requestLoadOriginal, i32)    \
+    X(poolId, u64)
+
+#define XRM_SCHEMA_CU_PROPERTY_V2(X) \
+    XRM_SCHEMA_CU_PROPERTY(X)        \
+    X(deviceInfo, i64)               \
+    X(memoryInfo, i64)               \
+    X(policyInfo, i64)
+
+/* allocated cu, it's what client gives back for release, same as binaryCuHandle */
+#define XRM_SCHEMA_CU_HANDLE(X)    \
+    X(deviceId, i32)               \
+    X(cuId, i32)                   \
+    X(channelId, i32)              \
+    X(cuType, cuType)              \
+    X(allocServiceId, u64)         \
+    X(channelLoadUnified, i32)     \
+    X(channelLoadOriginal, i32)    \
+    X(poolId, u64)
+
+/* the rest of allocated cu, it's answered with the handle */
+#define XRM_SCHEMA_CU_RESOURCE(X)  \
+    X(xclbinFileName, str)         \
+    X(uuidStr, str)                \
+    X(kernelPluginFileName, str)   \
+    X(kernelName, str)             \
+    X(instanceName, str)           \
+    X(cuName, str)                 \
+    X(kernelAlias, str)            \
+    X(baseAddr, u64)               \
+    X(membankId, u32)              \
+    X(membankType, u32)            \
+    X(membankSize, u64)            \
+    X(membankBaseAddr, u64)
+
+/* the parameters indexed by requestParams, every key of the records above is here */
+#define XRM_SCHEMA_PARAM_KEYS(X)                                                                          \
+    X(kernelName) X(kernelAlias) X(devExcl) X(requestLoadUnified) X(requestLoadOriginal) X(poolId)          \
+    X(deviceInfo) X(memoryInfo) X(policyInfo) X(deviceId) X(cuId) X(channelId) X(cuType) X(allocServiceId) \
+    X(channelLoadUnified) X(channelLoadOriginal) X(clientId) X(clientProcessId) X(cuNum) X(sameDevice)
+
+namespace xrm {
+
+/*
+ * The parameters of one request, indexed in one pass over the children of request.parameters,
+ * so the fields are found without building the path for every field. The value is converted
+ * as property tree does, the missing field and the bad value throw the same exceptions as
+ * ptree::get().
+ */
+class requestParams {
+   public:
+    enum paramKey {
+#define XRM_SCHEMA_PARAM_ENUM(key) key,
+        XRM_SCHEMA_PARAM_KEYS(XRM_SCHEMA_PARAM_ENUM)
+#undef XRM_SCHEMA_PARAM_ENUM
+        paramKeyNum
+    };
+
+    explicit requestParams(const boost::property_tree::ptree& incmd) {
+        const boost::property_tree::ptree& params = incmd.get_child("request.parameters");
+
+        m_values.resize(2 * paramKeyNum, NULL);
+        for (auto it = params.begin(); it != params.end(); it++) {
+            const std::string& name = it->first;
+            std::size_t baseLen = name.size();
+            int32_t idx = -1;
+
+            while (baseLen > 0 && name[baseLen - 1] >= '0' && name[baseLen - 1] <= '9') baseLen--;
+            if (baseLen < name.size()) {
+                /* the index of cu list is small, other numbers are not the index */
+                if (name.size() - baseLen > 4) continue;
+                idx = atoi(name.c_str() + baseLen);
+            }
+            int32_t key = findKey(name.c_str(), baseLen);
+            if (key < 0) continue;
+            std::size_t slot = (idx + 1) * paramKeyNum + key;
+            if (slot >= m_values.size()) m_values.resize((idx + 2) * paramKeyNum, NULL);
+            /* the first one is taken as ptree::get() does */
+            if (m_values[slot] == NULL) m_values[slot] = &it->second.data();
+        }
+    }
+
+    bool has(paramKey key, int32_t idx = -1) const { return (lookup(key, idx) != NULL); }
+
+    template <typename T>
+    T get(paramKey key, int32_t idx = -1) const {
+        static_assert(std::is_integral<T>::value, "only integer parameter is converted");
+        const std::string& str = value(key, idx);
+        const char* begin = str.c_str();
+        char* end = NULL;
+        bool valid;
+        T ret;
+
+        errno = 0;
+        if (std::is_signed<T>::value) {
+            long long val = strtoll(begin, &end, 10);
+            valid = val >= (long long)std::numeric_limits<T>::min() && val <= (long long)std::numeric_limits<T>::max();
+            ret = (T)val;
+        } else {
+            unsigned long long val = strtoull(begin, &end, 10);
+            valid = val <= (unsigned long long)std::numeric_limits<T>::max();
+            ret = (T)val;
+        }
+        while (end != NULL && (*end == ' ' || *end == '\t' || *end == '\n' || *end == '\r')) end++;
+        if (errno != 0 || end == begin || end == NULL || *end != '\0' || !valid)
+            throw boost::property_tree::ptree_bad_data("conversion of data to type failed", str);
+        return (ret);
+    }
+
+    /* always terminated, the long value is cut as strncpy() does */
+    void getString(paramKey key, int32_t idx, char* dst, std::size_t size) const {
+        const std::string& str = value(key, idx);
+        std::size_t len = std::min(str.size(), size - 1);
+
+        memcpy(dst, str.c_str(), len);
+        dst[len] = '\0';
+    }
+
+    std::string getString(paramKey key, int32_t idx = -1) const { return (value(key, idx)); }
+
+   private:
+    static const char* keyName(int32_t key) {
+        static const char* const keyNames[] = {
+#define XRM_SCHEMA_PARAM_NAME(key) #key,
+            XRM_SCHEMA_PARAM_KEYS(XRM_SCHEMA_PARAM_NAME)
+#undef XRM_SCHEMA_PARAM_NAME
+        };
+        return (keyNames[key]);
+    }
+
+    static int32_t findKey(const char* name, std::size_t len) {
+        for (int32_t key = 0; key < paramKeyNum; key++)
+            if (strncmp(keyName(key), name, len) == 0 && keyName(key)[len] == '\0') return (key);
+        return (-1);
+    }
+
+    const std::string* lookup(paramKey key, int32_t idx) const {
+        std::size_t slot = (idx + 1) * paramKeyNum + key;
+        return (slot < m_values.size() ? m_values[slot] : NULL);
+    }
+
+    const std::string& value(paramKey key, int32_t idx) const {
+        const std::string* str = lookup(key, idx);
+        if (str == NULL) {
+            std::string path = std::string("request.parameters.") + keyName(key);
+            if (idx >= 0) path += std::to_string(idx);
+            throw boost::property_tree::ptree_bad_path("No such node", boost::property_tree::ptree::path_type(path));
+        }
+        return (*str);
+    }
+
+    std::vector<const std::string*> m_values; // [(idx + 1) * paramKeyNum + key], idx -1 for the field without index
+};
+
+/* conversions by kind, see the schema above */
+#define XRM_SCHEMA_DECODE_str(params, key, idx, out) \
+    params.getString(requestParams::key, idx, out->key, sizeof(out->key))
+#define XRM_SCHEMA_DECODE_flag(params, key, idx, out) out->key = (params.get<int32_t>(requestParams::key, idx) != 0)
+#define XRM_SCHEMA_DECODE_i32(params, key, idx, out) out->key = params.get<int32_t>(requestParams::key, idx)
+#define XRM_SCHEMA_DECODE_u32(params, key, idx, out) out->key = params.get<uint32_t>(requestParams::key, idx)
+#define XRM_SCHEMA_DECODE_i64(params, key, idx, out) out->key = params.get<int64_t>(requestParams::key, idx)
+#define XRM_SCHEMA_DECODE_u64(params, key, idx, out) out->key = params.get<uint64_t>(requestParams::key, idx)
+#define XRM_SCHEMA_DECODE_cuType(params, key, idx, out) \
+    out->key = (xrmCuType)params.get<int32_t>(requestParams::key, idx)
+
+#define XRM_SCHEMA_VALUE_str(val) std::string(val)
+#define XRM_SCHEMA_VALUE_flag(val) std::to_string((int32_t)(val))
+#define XRM_SCHEMA_VALUE_i32(val) std::to_string(val)
+#define XRM_SCHEMA_VALUE_u32(val) std::to_string(val)
+#define XRM_SCHEMA_VALUE_i64(val) std::to_string(val)
+#define XRM_SCHEMA_VALUE_u64(val) std::to_string(val)
+#define XRM_SCHEMA_VALUE_cuType(val) std::to_string((int32_t)(val))
+
+#define XRM_SCHEMA_COPY_str(dst, src) strncpy(dst, src, sizeof(dst) - 1)
+#define XRM_SCHEMA_COPY_flag(dst, src) dst = ((src) != 0)
+#define XRM_SCHEMA_COPY_i32(dst, src) dst = src
+#define XRM_SCHEMA_COPY_u32(dst, src) dst = src
+#define XRM_SCHEMA_COPY_i64(dst, src) dst = src
+#define XRM_SCHEMA_COPY_u64(dst, src) dst = src
+#define XRM_SCHEMA_COPY_cuType(dst, src) dst = (decltype(dst))(src)
+
+/*
+ * The json decoders, idx is the index of the cu in the list, -1 for the single cu request.
+ * The client id and process id are of the request.
+ */
+template <typename propertyType>
+inline void decodeCuPropertyCommon(const requestParams& params, propertyType* cuProp) {
+    cuProp->cuName[0] = '\0';
+    cuProp->clientId = params.get<uint64_t>(requestParams::clientId);
+    cuProp->clientProcessId = params.get<pid_t>(requestParams::clientProcessId);
+}
+
+inline void decodeCuProperty(const requestParams& params, int32_t idx, cuProperty* cuProp) {
+#define XRM_SCHEMA_DECODE_FIELD(key, kind) XRM_SCHEMA_DECODE_##kind(params, key, idx, cuProp);
+    XRM_SCHEMA_CU_PROPERTY(XRM_SCHEMA_DECODE_FIELD)
+#undef XRM_SCHEMA_DECODE_FIELD
+    decodeCuPropertyCommon(params, cuProp);
+}
+
+inline void decodeCuPropertyV2(const requestParams& params, int32_t idx, cuPropertyV2* cuProp) {
+#define XRM_SCHEMA_DECODE_FIELD(key, kind) XRM_SCHEMA_DECODE_##kind(params, key, idx, cuProp);
+    XRM_SCHEMA_CU_PROPERTY_V2(XRM_SCHEMA_DECODE_FIELD)
+#undef XRM_SCHEMA_DECODE_FIELD
+    decodeCuPropertyCommon(params, cuProp);
+}
+
+/* only the handle of cu resource is filled, it's enough for the release */
+inline void decodeCuHandle(const requestParams& params, int32_t idx, cuResource* cuRes) {
+#define XRM_SCHEMA_DECODE_FIELD(key, kind) XRM_SCHEMA_DECODE_##kind(params, key, idx, cuRes);
+    XRM_SCHEMA_CU_HANDLE(XRM_SCHEMA_DECODE_FIELD)
+#undef XRM_SCHEMA_DECODE_FIELD
+    cuRes->clientId = params.get<uint64_t>(requestParams::clientId);
+}
+
+/*
+ * The json encoder, the fields are appended to the data node of the response with the suffix
+ * of the cu index, empty for the single cu response.
+ */
+inline boost::property_tree::ptree& responseData(boost::property_tree::ptree& outrsp) {
+    auto data = outrsp.get_child_optional("response.data");
+    if (data) return (*data);
+    return (outrsp.put_child("response.data", boost::property_tree::ptree()));
+}
+
+inline void encodeCuResource(boost::property_tree::ptree& data, const cuResource* cuRes, const std::string& suffix) {
+#define XRM_SCHEMA_ENCODE_FIELD(key, kind) \
+    data.push_back(std::make_pair(#key + suffix, boost::property_tree::ptree(XRM_SCHEMA_VALUE_##kind(cuRes->key))));
+    XRM_SCHEMA_CU_RESOURCE(XRM_SCHEMA_ENCODE_FIELD)
+    XRM_SCHEMA_CU_HANDLE(XRM_SCHEMA_ENCODE_FIELD)
+#undef XRM_SCHEMA_ENCODE_FIELD
+}
+
+/*
+ * The conversions between the binary records and the structures used by the resource allocation.
+ */
+inline void binaryToCuPropertyV2(const binaryCuProperty* binCuProp,
+                                 uint64_t clientId,
+                                 pid_t clientProcessId,
+                                 cuPropertyV2* cuProp) {
+    memset(cuProp, 0, sizeof(cuPropertyV2));
+#define XRM_SCHEMA_COPY_FIELD(key, kind) XRM_SCHEMA_COPY_##kind(cuProp->key, binCuProp->key);
+    XRM_SCHEMA_CU_PROPERTY_V2(XRM_SCHEMA_COPY_FIELD)
+#undef XRM_SCHEMA_COPY_FIELD
+    cuProp->clientId = clientId;
+    cuProp->clientProcessId = clientProcessId;
+}
+
+inline void binaryToCuResource(const binaryCuHandle* cuHandle, uint64_t clientId, cuResource* cuRes) {
+#define XRM_SCHEMA_COPY_FIELD(key, kind) XRM_SCHEMA_COPY_##kind(cuRes->key, cuHandle->key);
+    XRM_SCHEMA_CU_HANDLE(XRM_SCHEMA_COPY_FIELD)
+#undef XRM_SCHEMA_COPY_FIELD
+    cuRes->clientId = clientId;
+}
+
+inline void cuResourceToBinary(const cuResource* cuRes, binaryCuResource* binCuRes) {
+#define XRM_SCHEMA_COPY_FIELD(key, kind) XRM_SCHEMA_COPY_##kind(binCuRes->key, cuRes->key);
+    XRM_SCHEMA_CU_RESOURCE(XRM_SCHEMA_COPY_FIELD)
+#undef XRM_SCHEMA_COPY_FIELD
+#define XRM_SCHEMA_COPY_FIELD(key, kind) XRM_SCHEMA_COPY_##kind(binCuRes->handle.key, cuRes->key);
+    XRM_SCHEMA_CU_HANDLE(XRM_SCHEMA_COPY_FIELD)
+#undef XRM_SCHEMA_COPY_FIELD
+}
+
+} // namespace xrm
+
+#endif // _XRM_COMMAND_SCHEMA_HPP_
@@ -134,7 +134,11 @@ uint32_t getVerbosity() {
 }
 
 uint32_t getLimitConcurrentClient() {
-    return (getUint32Value("XRM.limitConcurrentClient", XRM_DEFAULT_LIMIT_CONCURRENT_CLIENT));
+    uint32_t limitConcurrentClient =
+        getUint32Value("XRM.limitConcurrentClient", XRM_DEFAULT_LIMIT_CONCURRENT_CLIENT);
+    if (limitConcurrentClient > XRM_MAX_LIMIT_CONCURRENT_CLIENT)
+        limitConcurrentClient = XRM_MAX_LIMIT_CONCURRENT_CLIENT;
+    return (limitConcurrentClient);
 }
 
 std::string getLibXrtCoreFileFullPathName() {
@@ -145,6 +149,37 @@ std::string getXrtVersionFileFullPathName() {
     return (getStringValue("XRM.xrtVersionFileFullPathName", XRM_DEFAULT_XRT_VERSION_FILE_FULL_PATH_NAME));
 }
 
+std::string getUnixSocketPath() {
+    return (getStringValue("XRM.unixSocketPath", XRM_DEFAULT_UNIX_SOCKET_PATH));
+}
+
+uint32_t getIoThreadNumber() {
+    uint32_t ioThreadNum = getUint32Value("XRM.ioThreadNumber", XRM_DEFAULT_IO_THREAD_NUM);
+    if (ioThreadNum == 0) ioThreadNum = 1;
+    if (ioThreadNum > XRM_MAX_IO_THREAD_NUM) ioThreadNum = XRM_MAX_IO_THREAD_NUM;
+    return (ioThreadNum);
+}
+
+uint32_t getAcceptBacklog() {
+    uint32_t backlog = getUint32Value("XRM.acceptBacklog", XRM_DEFAULT_ACCEPT_BACKLOG);
+    if (backlog == 0) backlog = XRM_DEFAULT_ACCEPT_BACKLOG;
+    return (backlog);
+}
+
+uint32_t getLimitUserConnection() {
+    return (getUint32Value("XRM.limitUserConnection", XRM_DEFAULT_LIMIT_USER_CONNECTION));
+}
+
+uint32_t getLimitPendingCommand() {
+    return (getUint32Value("XRM.limitPendingCommand", XRM_DEFAULT_LIMIT_PENDING_COMMAND));
+}
+
+uint32_t getLimitIdleConnection() {
+    uint32_t limitIdleConnection = getUint32Value("XRM.limitIdleConnection", XRM_DEFAULT_LIMIT_IDLE_CONNECTION);
+    if (limitIdleConnection == 0) limitIdleConnection = XRM_DEFAULT_LIMIT_IDLE_CONNECTION;
+    return (limitIdleConnection);
+}
+
 } // namespace config
 
 } // namespace xrm
@@ -51,6 +51,12 @@ uint32_t getVerbosity();
 uint32_t getLimitConcurrentClient();
 std::string getXrtVersionFileFullPathName();
 std::string getLibXrtCoreFileFullPathName();
+std::string getUnixSocketPath();
+uint32_t getIoThreadNumber();
+uint32_t getAcceptBacklog();
+uint32_t getLimitUserConnection();
+uint32_t getLimitPendingCommand();
+uint32_t getLimitIdleConnection();
 
 } // namespace config
 } // namespace xrm
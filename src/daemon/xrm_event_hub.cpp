@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2019-2021, Xilinx Inc - All rights reserved
+ *
+ * Copyright (C) 2023, Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Xilinx Resource Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <cstring>
+#include "xrm_event_hub.hpp"
+
+/*
+ * Set the subscribed event types, 0 to unsubscribe. The queued events are dropped.
+ */
+void xrm::eventSubscription::setMask(uint32_t mask) {
+    std::unique_lock<std::mutex> lock(m_lock);
+    m_mask = mask;
+    m_events.clear();
+    m_overflow = false;
+}
+
+/*
+ * Answer the event wait with the queued events, or park it until the next event comes.
+ * Return false if not subscribed.
+ */
+bool xrm::eventSubscription::wait(deliverFunc deliver) {
+    std::vector<xrmEvent> events;
+
+    std::unique_lock<std::mutex> lock(m_lock);
+    if (m_mask == 0) return (false);
+    if (m_events.empty() && !m_overflow) {
+        /* only one event wait is expected, the former one is answered with nothing */
+        std::swap(m_deliver, deliver);
+        lock.unlock();
+        if (deliver) deliver(events);
+        return (true);
+    }
+    take(events);
+    lock.unlock();
+
+    deliver(events);
+    return (true);
+}
+
+void xrm::eventSubscription::push(const xrmEvent& event) {
+    std::vector<xrmEvent> events;
+    deliverFunc deliver;
+
+    std::unique_lock<std::mutex> lock(m_lock);
+    if ((m_mask & event.type) == 0) return;
+    if (event.type == XRM_EVENT_CU_AVAILABLE) {
+        for (auto& queued : m_events) {
+            if (queued.type == event.type && queued.deviceId == event.deviceId &&
+                strcmp(queued.kernelName, event.kernelName) == 0 && strcmp(queued.kernelAlias, event.kernelAlias) == 0)
+                return;
+        }
+    }
+    if (m_events.size() >= XRM_EVENT_QUEUE_LEN) {
+        m_events.pop_front();
+        m_overflow = true;
+    }
+    m_events.push_back(event);
+    if (!m_deliver) return;
+    take(events);
+    std::swap(m_deliver, deliver);
+    lock.unlock();
+
+    deliver(events);
+}
+
+/*
+ * Unsubscribe, the parked event wait is answered with nothing.
+ */
+void xrm::eventSubscription::cancel() {
+    std::vector<xrmEvent> events;
+    deliverFunc deliver;
+
+    std::unique_lock<std::mutex> lock(m_lock);
+    m_mask = 0;
+    m_events.clear();
+    m_overflow = false;
+    std::swap(m_deliver, deliver);
+    lock.unlock();
+
+    if (deliver) deliver(events);
+}
+
+/*
+ * Take the queued events up to the number answered at once, called with m_lock.
+ */
+void xrm::eventSubscription::take(std::vector<xrmEvent>& events) {
+    if (m_overflow) {
+        xrmEvent overflow;
+        memset(&overflow, 0, sizeof(overflow));
+        overflow.type = XRM_EVENT_OVERFLOW;
+        overflow.deviceId = -1;
+        events.push_back(overflow);
+        m_overflow = false;
+    }
+    while (!m_events.empty() && events.size() < XRM_EVENT_DELIVER_NUM) {
+        events.push_back(m_events.front());
+        m_events.pop_front();
+    }
+}
+
+void xrm::eventHub::subscribe(std::shared_ptr<eventSubscription> sub) {
+    std::unique_lock<std::mutex> lock(m_lock);
+    for (auto& it : m_subs) {
+        if (it == sub) return;
+    }
+    m_subs.push_back(sub);
+    m_numSub = m_subs.size();
+}
+
+void xrm::eventHub::unsubscribe(eventSubscription* sub) {
+    std::unique_lock<std::mutex> lock(m_lock);
+    for (auto it = m_subs.begin(); it != m_subs.end(); it++) {
+        if (it->get() == sub) {
+            m_subs.erase(it);
+            break;
+        }
+    }
+    m_numSub = m_subs.size();
+}
+
+/*
+ * Called under system / device locks, nothing to do when there is no subscriber.
+ */
+void xrm::eventHub::publish(const xrmEvent& event) {
+    if (m_numSub == 0) return;
+
+    std::unique_lock<std::mutex> lock(m_lock);
+    for (auto& sub : m_subs) sub->push(event);
+}
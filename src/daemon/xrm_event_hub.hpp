@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2019-2021, Xilinx Inc - All rights reserved
+ *
+ * Copyright (C) 2023, Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Xilinx Resource Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef _XRM_EVENT_HUB_HPP_
+#define _XRM_EVENT_HUB_HPP_
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "xrm.h"
+
+#define XRM_EVENT_QUEUE_LEN 256  // max events kept for one subscriber, the oldest is dropped on overflow
+#define XRM_EVENT_DELIVER_NUM 32 // max events answered to one event wait
+
+namespace xrm {
+
+/*
+ * Events of one connection. The client keeps one event wait request in flight, it's answered
+ * with the queued events, or parked until the next event comes. The same cu available event
+ * is queued only once, the client reads the state once for it anyway.
+ */
+class eventSubscription {
+   public:
+    typedef std::function<void(const std::vector<xrmEvent>&)> deliverFunc;
+
+    void setMask(uint32_t mask);
+    bool wait(deliverFunc deliver);
+    void push(const xrmEvent& event);
+    void cancel();
+
+   private:
+    void take(std::vector<xrmEvent>& events);
+
+    std::mutex m_lock;
+    uint32_t m_mask = 0;
+    std::deque<xrmEvent> m_events;
+    bool m_overflow = false;
+    deliverFunc m_deliver; // the parked event wait
+};
+
+/*
+ * Events published by the resource functions to the subscribed connections. publish() is
+ * called under system / device locks, it only queues the events and hands them to the parked
+ * event waits, the responses are built and written on the io thread pool.
+ */
+class eventHub {
+   public:
+    void subscribe(std::shared_ptr<eventSubscription> sub);
+    void unsubscribe(eventSubscription* sub);
+    void publish(const xrmEvent& event);
+
+   private:
+    std::mutex m_lock;
+    std::vector<std::shared_ptr<eventSubscription> > m_subs;
+    std::atomic<uint32_t> m_numSub{0};
+};
+} // namespace xrm
+
+#endif // _XRM_EVENT_HUB_HPP_
@@ -0,0 +1,483 @@
+/*
+ * Copyright (C) 2019-2021, Xilinx Inc - All rights reserved
+ *
+ * Copyright (C) 2023, Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Xilinx Resource Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef _XRM_JSON_CODEC_HPP_
+#define _XRM_JSON_CODEC_HPP_
+
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include "xrm_error.h"
+
+#define XRM_JSON_MAX_DEPTH 64 // max nesting of json objects and arrays
+
+namespace xrm {
+
+/*
+ * Codec of the json requests and responses, shared by daemon and library. Both codecs
+ * decode into and encode from property tree, so the commands are not changed, and produce
+ * the same text on wire, so xrmadm and the python tools are not affected.
+ *
+ * The codec is selected with environment XRM_JSON_CODEC, "ptree" for the boost property
+ * tree parser and writer, the fast codec is used by default.
+ */
+class jsonCodec {
+   public:
+    virtual ~jsonCodec() {}
+
+    /* the tree is replaced only if the text is decoded successfully */
+    virtual int32_t decode(const char* data,
+                           std::size_t length,
+                           boost::property_tree::ptree& tree,
+                           std::string& errmsg) const = 0;
+    virtual void encode(const boost::property_tree::ptree& tree, std::string& out) const = 0;
+    /* appended after the data already in out, e.g. the length header reserved by the daemon */
+    virtual void encode(const boost::property_tree::ptree& tree, std::vector<char>& out) const = 0;
+};
+
+/*
+ * The boost property tree parser and writer.
+ */
+class ptreeJsonCodec : public jsonCodec {
+   public:
+    int32_t decode(const char* data,
+                   std::size_t length,
+                   boost::property_tree::ptree& tree,
+                   std::string& errmsg) const override {
+        std::stringstream instr(std::string(data, length));
+        try {
+            boost::property_tree::read_json(instr, tree);
+        } catch (const boost::property_tree::json_parser_error& e) {
+            errmsg = e.message();
+            return (XRM_ERROR_INVALID);
+        }
+        return (XRM_SUCCESS);
+    }
+
+    void encode(const boost::property_tree::ptree& tree, std::string& out) const override {
+        std::stringstream outstr;
+        boost::property_tree::write_json(outstr, tree);
+        out = outstr.str();
+    }
+
+    void encode(const boost::property_tree::ptree& tree, std::vector<char>& out) const override {
+        std::string outstr;
+        encode(tree, outstr);
+        out.insert(out.end(), outstr.begin(), outstr.end());
+    }
+};
+
+/*
+ * Single pass parser building the tree in place and writer appending to one buffer. The
+ * tree is the same as boost parser builds: the numbers and literals are kept as text, the
+ * array items have empty key. The text is the same as boost writer writes.
+ */
+class fastJsonCodec : public jsonCodec {
+   public:
+    int32_t decode(const char* data,
+                   std::size_t length,
+                   boost::property_tree::ptree& tree,
+                   std::string& errmsg) const override {
+        boost::property_tree::ptree local;
+        parser p = {data, data, data + length, &errmsg};
+
+        /* byte order mark is skipped as boost parser does */
+        if (length >= 3 && (unsigned char)data[0] == 0xEF) p.cur += 3;
+        p.skipSpace();
+        if (!p.parseValue(local, 0)) return (XRM_ERROR_INVALID);
+        p.skipSpace();
+        if (p.cur != p.end) {
+            p.fail("garbage after data");
+            return (XRM_ERROR_INVALID);
+        }
+        tree.swap(local);
+        return (XRM_SUCCESS);
+    }
+
+    void encode(const boost::property_tree::ptree& tree, std::string& out) const override {
+        out.clear();
+        writeNode(tree, 0, out);
+        out += '\n';
+    }
+
+    void encode(const boost::property_tree::ptree& tree, std::vector<char>& out) const override {
+        writeNode(tree, 0, out);
+        out.push_back('\n');
+    }
+
+   private:
+    struct parser {
+        const char* begin;
+        const char* cur;
+        const char* end;
+        std::string* errmsg;
+
+        bool fail(const char* msg) {
+            *errmsg = std::string(msg) + " at offset " + std::to_string(cur - begin);
+            return (false);
+        }
+
+        void skipSpace() {
+            while (cur < end && (*cur == ' ' || *cur == '\t' || *cur == '\n' || *cur == '\r')) cur++;
+        }
+
+        bool isDigit() const { return (cur < end && *cur >= '0' && *cur <= '9'); }
+
+        bool parseValue(boost::property_tree::ptree& node, int32_t depth) {
+            if (depth > XRM_JSON_MAX_DEPTH) return (fail("nesting is too deep"));
+            if (cur >= end) return (fail("expected value"));
+            switch (*cur) {
+                case '{':
+                    return (parseObject(node, depth));
+                case '[':
+                    return (parseArray(node, depth));
+                case '"':
+                    return (parseString(node.data()));
+                case 't':
+                    return (parseLiteral("true", node));
+                case 'f':
+                    return (parseLiteral("false", node));
+                case 'n':
+                    return (parseLiteral("null", node));
+                default:
+                    return (parseNumber(node));
+            }
+        }
+
+        bool parseObject(boost::property_tree::ptree& node, int32_t depth) {
+            cur++;
+            skipSpace();
+            if (cur < end && *cur == '}') {
+                cur++;
+                return (true);
+            }
+            while (true) {
+                std::string key;
+                if (cur >= end || *cur != '"') return (fail("expected key string"));
+                if (!parseString(key)) return (false);
+                skipSpace();
+                if (cur >= end || *cur != ':') return (fail("expected ':'"));
+                cur++;
+                skipSpace();
+                auto it = node.push_back(std::make_pair(std::move(key), boost::property_tree::ptree()));
+                if (!parseValue(it->second, depth + 1)) return (false);
+                skipSpace();
+                if (cur < end && *cur == ',') {
+                    cur++;
+                    skipSpace();
+                    continue;
+                }
+                if (cur < end && *cur == '}') {
+                    cur++;
+                    return (true);
+                }
+                return (fail("expected ',' or '}'"));
+            }
+        }
+
+        bool parseArray(boost::property_tree::ptree& node, int32_t depth) {
+            cur++;
+            skipSpace();
+            if (cur < end && *cur == ']') {
+                cur++;
+                return (true);
+            }
+            while (true) {
+                auto it = node.push_back(std::make_pair(std::string(), boost::property_tree::ptree()));
+                if (!parseValue(it->second, depth + 1)) return (false);
+                skipSpace();
+                if (cur < end && *cur == ',') {
+                    cur++;
+                    skipSpace();
+                    continue;
+                }
+                if (cur < end && *cur == ']') {
+                    cur++;
+                    return (true);
+                }
+                return (fail("expected ',' or ']'"));
+            }
+        }
+
+        bool parseHex4(uint32_t* codePoint) {
+            *codePoint = 0;
+            if (end - cur < 4) return (fail("invalid escape sequence"));
+            for (int32_t i = 0; i < 4; i++, cur++) {
+                char c = *cur;
+                *codePoint <<= 4;
+                if (c >= '0' && c <= '9')
+                    *codePoint |= c - '0';
+                else if (c >= 'a' && c <= 'f')
+                    *codePoint |= c - 'a' + 10;
+                else if (c >= 'A' && c <= 'F')
+                    *codePoint |= c - 'A' + 10;
+                else
+                    return (fail("invalid escape sequence"));
+            }
+            return (true);
+        }
+
+        bool parseCodePoint(std::string& out) {
+            uint32_t codePoint, low;
+
+            if (!parseHex4(&codePoint)) return (false);
+            if (codePoint >= 0xDC00 && codePoint <= 0xDFFF) return (fail("invalid codepoint, stray low surrogate"));
+            if (codePoint >= 0xD800 && codePoint <= 0xDBFF) {
+                if (end - cur < 2 || cur[0] != '\\' || cur[1] != 'u') return (fail("expected low surrogate"));
+                cur += 2;
+                if (!parseHex4(&low)) return (false);
+                if (low < 0xDC00 || low > 0xDFFF) return (fail("expected low surrogate"));
+                codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+            }
+            if (codePoint < 0x80) {
+                out += (char)codePoint;
+            } else if (codePoint < 0x800) {
+                out += (char)(0xC0 | (codePoint >> 6));
+                out += (char)(0x80 | (codePoint & 0x3F));
+            } else if (codePoint < 0x10000) {
+                out += (char)(0xE0 | (codePoint >> 12));
+                out += (char)(0x80 | ((codePoint >> 6) & 0x3F));
+                out += (char)(0x80 | (codePoint & 0x3F));
+            } else {
+                out += (char)(0xF0 | (codePoint >> 18));
+                out += (char)(0x80 | ((codePoint >> 12) & 0x3F));
+                out += (char)(0x80 | ((codePoint >> 6) & 0x3F));
+                out += (char)(0x80 | (codePoint & 0x3F));
+            }
+            return (true);
+        }
+
+        /* multi byte utf-8 sequence, the lead byte tells the number of trailing bytes */
+        bool skipUtf8() {
+            unsigned char c = *cur++;
+            int32_t trailing;
+
+            if (c >= 0xC0 && c < 0xE0)
+                trailing = 1;
+            else if (c >= 0xE0 && c < 0xF0)
+                trailing = 2;
+            else if (c >= 0xF0 && c < 0xF8)
+                trailing = 3;
+            else
+                return (false);
+            for (; trailing > 0; trailing--, cur++) {
+                if (cur >= end || (*cur & 0xC0) != 0x80) return (false);
+            }
+            return (true);
+        }
+
+        /* the runs without escape are appended at once */
+        bool parseString(std::string& out) {
+            const char* start = ++cur;
+
+            while (true) {
+                if (cur >= end) return (fail("unterminated string"));
+                unsigned char c = *cur;
+                if (c == '"') {
+                    out.append(start, cur);
+                    cur++;
+                    return (true);
+                }
+                if (c < 0x20) return (fail("invalid code point"));
+                if (c >= 0x80) {
+                    if (!skipUtf8()) return (fail("invalid code sequence"));
+                    continue;
+                }
+                if (c != '\\') {
+                    cur++;
+                    continue;
+                }
+                out.append(start, cur);
+                if (++cur >= end) return (fail("invalid escape sequence"));
+                switch (*cur++) {
+                    case '"':
+                        out += '"';
+                        break;
+                    case '\\':
+                        out += '\\';
+                        break;
+                    case '/':
+                        out += '/';
+                        break;
+                    case 'b':
+                        out += '\b';
+                        break;
+                    case 'f':
+                        out += '\f';
+                        break;
+                    case 'n':
+                        out += '\n';
+                        break;
+                    case 'r':
+                        out += '\r';
+                        break;
+                    case 't':
+                        out += '\t';
+                        break;
+                    case 'u':
+                        if (!parseCodePoint(out)) return (false);
+                        break;
+                    default:
+                        cur--;
+                        return (fail("invalid escape sequence"));
+                }
+                start = cur;
+            }
+        }
+
+        bool parseLiteral(const char* literal, boost::property_tree::ptree& node) {
+            std::size_t length = strlen(literal);
+
+            if ((std::size_t)(end - cur) < length || memcmp(cur, literal, length) != 0)
+                return (fail("expected value"));
+            node.data().assign(literal, length);
+            cur += length;
+            return (true);
+        }
+
+        bool parseNumber(boost::property_tree::ptree& node) {
+            const char* start = cur;
+
+            if (cur < end && *cur == '-') cur++;
+            if (cur < end && *cur == '0') {
+                cur++;
+            } else if (isDigit()) {
+                while (isDigit()) cur++;
+            } else {
+                return (fail("expected value"));
+            }
+            if (cur < end && *cur == '.') {
+                cur++;
+                if (!isDigit()) return (fail("need at least one digit after '.'"));
+                while (isDigit()) cur++;
+            }
+            if (cur < end && (*cur == 'e' || *cur == 'E')) {
+                cur++;
+                if (cur < end && (*cur == '+' || *cur == '-')) cur++;
+                if (!isDigit()) return (fail("need at least one digit in exponent"));
+                while (isDigit()) cur++;
+            }
+            node.data().assign(start, cur);
+            return (true);
+        }
+    };
+
+    /* the writer appends to std::string or to the response buffer of the daemon */
+    template <typename outType>
+    static void writeText(const char* text, outType& out) {
+        out.insert(out.end(), text, text + strlen(text));
+    }
+
+    template <typename outType>
+    static void writeEscaped(const std::string& str, outType& out) {
+        static const char hexDigits[] = "0123456789ABCDEF";
+        const char* start = str.data();
+        const char* end = start + str.size();
+        const char* run = start;
+
+        for (const char* p = start; p < end; p++) {
+            unsigned char c = *p;
+            if (c == 0x20 || c == 0x21 || (c >= 0x23 && c <= 0x2E) || (c >= 0x30 && c <= 0x5B) || c >= 0x5D)
+                continue;
+            out.insert(out.end(), run, p);
+            run = p + 1;
+            out.push_back('\\');
+            switch (c) {
+                case '\b':
+                    out.push_back('b');
+                    break;
+                case '\f':
+                    out.push_back('f');
+                    break;
+                case '\n':
+                    out.push_back('n');
+                    break;
+                case '\r':
+                    out.push_back('r');
+                    break;
+                case '\t':
+                    out.push_back('t');
+                    break;
+                case '/':
+                case '"':
+                case '\\':
+                    out.push_back(c);
+                    break;
+                default:
+                    writeText("u00", out);
+                    out.push_back(hexDigits[c >> 4]);
+                    out.push_back(hexDigits[c & 0xF]);
+                    break;
+            }
+        }
+        out.insert(out.end(), run, end);
+    }
+
+    /* the root is always written as object, the node with only empty keys as array */
+    template <typename outType>
+    static void writeNode(const boost::property_tree::ptree& node, int32_t indent, outType& out) {
+        bool isArray = indent > 0;
+
+        if (indent > 0 && node.empty()) {
+            out.push_back('"');
+            writeEscaped(node.data(), out);
+            out.push_back('"');
+            return;
+        }
+        for (auto it = node.begin(); isArray && it != node.end(); it++) isArray = it->first.empty();
+        writeText(isArray ? "[\n" : "{\n", out);
+        for (auto it = node.begin(); it != node.end(); it++) {
+            out.insert(out.end(), 4 * (indent + 1), ' ');
+            if (!isArray) {
+                out.push_back('"');
+                writeEscaped(it->first, out);
+                writeText("\": ", out);
+            }
+            writeNode(it->second, indent + 1, out);
+            if (std::next(it) != node.end()) out.push_back(',');
+            out.push_back('\n');
+        }
+        out.insert(out.end(), 4 * indent, ' ');
+        out.push_back(isArray ? ']' : '}');
+    }
+};
+
+/*
+ * The codec selected with environment XRM_JSON_CODEC.
+ */
+inline const jsonCodec& getJsonCodec() {
+    static const ptreeJsonCodec ptreeCodec;
+    static const fastJsonCodec fastCodec;
+    static const jsonCodec* codec = []() -> const jsonCodec* {
+        const char* name = std::getenv("XRM_JSON_CODEC");
+        if (name != NULL && strcmp(name, "ptree") == 0) return (&ptreeCodec);
+        return (&fastCodec);
+    }();
+
+    return (*codec);
+}
+} // namespace xrm
+
+#endif // _XRM_JSON_CODEC_HPP_
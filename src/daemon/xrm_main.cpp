@@ -18,6 +18,7 @@
  * under the License.
  */
 
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
 #include <memory>
@@ -26,6 +27,7 @@
 #include <boost/thread.hpp>
 #include "xrm_version.h"
 #include "xrm_command_registry.hpp"
+#include "xrm_config.hpp"
 #include "xrm_tcp_server.hpp"
 #include "xrm_system.hpp"
 
@@ -38,6 +40,8 @@ using boost::asio::ip::tcp;
 xrm::system* sys = NULL;
 xrm::commandRegistry* registry = NULL;
 boost::asio::io_service* ioService = NULL;
+xrm::waitQueue* waitQ = NULL;
+xrm::eventHub* eventHub = NULL;
 xrm::server* serv = NULL;
 const uint16_t xrmPort = 9763;
 uint32_t isExit = 0;
@@ -100,9 +104,23 @@ int main(int argc, char* argv[]) {
 
         // Accept connections and process commands
         ioService = new boost::asio::io_service;
-        serv = new xrm::server(*ioService, xrmPort);
+        uint32_t ioThreadNum = xrm::config::getIoThreadNumber();
+        waitQ = new xrm::waitQueue(*ioService);
+        sys->setWaitQueue(waitQ);
+        eventHub = new xrm::eventHub;
+        sys->setEventHub(eventHub);
+        serv = new xrm::server(*ioService, xrmPort, xrm::config::getAcceptBacklog());
         serv->setSystem(sys);
         serv->setRegistry(registry);
+        serv->setBufferPool(std::make_shared<xrm::bufferPool>());
+        serv->setWaitQueue(waitQ);
+        serv->setEventHub(eventHub);
+        /* half of the io threads at most for the json requests without framing */
+        serv->setAdmission(std::make_shared<xrm::admission>(
+            *ioService, xrm::config::getLimitConcurrentClient(), xrm::config::getLimitIdleConnection(),
+            xrm::config::getLimitUserConnection(), std::max(ioThreadNum / 2, (uint32_t)1),
+            xrm::config::getLimitPendingCommand()));
+        serv->openUnixSocket(xrm::config::getUnixSocketPath());
 
         memset (&act, 0, sizeof(act));
         act.sa_sigaction = sigbusHandler;
@@ -111,13 +129,23 @@ int main(int argc, char* argv[]) {
         if (sigaction(SIGBUS, &act, 0))
             syslog(LOG_NOTICE, "Failed to setup SIGBUS handler");
 
+        // Serve the sessions with a pool of io threads, the resource data is protected by system / device locks
+        syslog(LOG_NOTICE, "    IO Threads = %d", ioThreadNum);
+        boost::thread_group ioThreads;
+        for (uint32_t i = 1; i < ioThreadNum; i++)
+            ioThreads.create_thread(boost::bind(&boost::asio::io_service::run, ioService));
         ioService->run();
+        ioThreads.join_all();
     } catch (std::exception& e) {
         syslog(LOG_NOTICE, "Exception: %s", e.what());
     }
     isExit = 1;
     workerThread.join();
     if (serv != NULL) delete (serv);
+    if (sys != NULL) sys->setWaitQueue(NULL);
+    if (waitQ != NULL) delete (waitQ);
+    if (sys != NULL) sys->setEventHub(NULL);
+    if (eventHub != NULL) delete (eventHub);
     if (ioService != NULL) delete (ioService);
     if (registry != NULL) delete (registry);
     if (sys != NULL) delete (sys);
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2019-2021, Xilinx Inc - All rights reserved
+ *
+ * Copyright (C) 2023, Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Xilinx Resource Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef _XRM_NAME_TABLE_HPP_
+#define _XRM_NAME_TABLE_HPP_
+
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+
+#define XRM_NAME_ID_NONE 0             // empty name, the field is not presented
+#define XRM_NAME_ID_UNKNOWN 0xFFFFFFFF // name not in the table, it matches no cu
+
+namespace xrm {
+
+/*
+ * Interning table of the kernel names, kernel aliases, cu names and instance names of the
+ * cus on the devices. The names are interned once per xclbin load and the names of request
+ * are resolved once per request, then the cu matching is integer compare.
+ *
+ * The id is never reused, the table only grows with the names of the loaded xclbins, so the
+ * id resolved earlier is still valid after the xclbin is unloaded. The name not in the table
+ * is resolved to XRM_NAME_ID_UNKNOWN, it needs to be resolved again after the table grows,
+ * see size().
+ *
+ * The table is changed under the system lock, and read under the system lock or device lock.
+ */
+class nameTable {
+   public:
+    nameTable() { m_ids.emplace("", XRM_NAME_ID_NONE); }
+
+    uint32_t intern(const std::string& name) {
+        auto it = m_ids.emplace(name, (uint32_t)m_ids.size());
+        return (it.first->second);
+    }
+
+    uint32_t find(const char* name) const {
+        if (name[0] == '\0') return (XRM_NAME_ID_NONE);
+        auto it = m_ids.find(name);
+        if (it == m_ids.end()) return (XRM_NAME_ID_UNKNOWN);
+        return (it->second);
+    }
+
+    /* number of names in the table, including the empty one, it never goes back */
+    uint32_t size() const { return ((uint32_t)m_ids.size()); }
+
+   private:
+    std::unordered_map<std::string, uint32_t> m_ids;
+};
+} // namespace xrm
+
+#endif // _XRM_NAME_TABLE_HPP_
@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2019-2021, Xilinx Inc - All rights reserved
+ *
+ * Copyright (C) 2023, Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Xilinx Resource Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "xrm_shm_channel.hpp"
+
+#ifndef SYS_pidfd_open
+#define SYS_pidfd_open 434
+#endif
+#ifndef SYS_pidfd_getfd
+#define SYS_pidfd_getfd 438
+#endif
+
+xrm::shmChannel::~shmChannel() {
+    if (m_rings != NULL) munmap(m_rings, sizeof(shmRingPair));
+    if (m_responseEventFd >= 0) close(m_responseEventFd);
+}
+
+/*
+ * Get the shared memory and eventfds from the client process, the process id is from
+ * SO_PEERCRED of the unix domain socket.
+ */
+int32_t xrm::shmChannel::attach(pid_t clientProcessId, int32_t shmFd, int32_t requestEventFd,
+                                int32_t responseEventFd) {
+    struct stat shmStat;
+    int32_t pidFd, localShmFd, localRequestEventFd;
+    void* addr;
+
+    pidFd = syscall(SYS_pidfd_open, clientProcessId, 0);
+    if (pidFd < 0) {
+        m_system->logMsg(XRM_LOG_ERROR, "%s: fail to open pidfd of process %d, errno %d", __func__,
+                         clientProcessId, errno);
+        return (XRM_ERROR);
+    }
+    localShmFd = syscall(SYS_pidfd_getfd, pidFd, shmFd, 0);
+    localRequestEventFd = syscall(SYS_pidfd_getfd, pidFd, requestEventFd, 0);
+    m_responseEventFd = syscall(SYS_pidfd_getfd, pidFd, responseEventFd, 0);
+    close(pidFd);
+    if (localShmFd < 0 || localRequestEventFd < 0 || m_responseEventFd < 0) {
+        m_system->logMsg(XRM_LOG_ERROR, "%s: fail to get fd from process %d, errno %d", __func__, clientProcessId,
+                         errno);
+        if (localShmFd >= 0) close(localShmFd);
+        if (localRequestEventFd >= 0) close(localRequestEventFd);
+        return (XRM_ERROR);
+    }
+    m_clientProcessId = clientProcessId;
+    m_eventDesc.assign(localRequestEventFd);
+
+    if (fstat(localShmFd, &shmStat) != 0 || shmStat.st_size < (off_t)sizeof(shmRingPair)) {
+        m_system->logMsg(XRM_LOG_ERROR, "%s: wrong size of shared memory", __func__);
+        close(localShmFd);
+        return (XRM_ERROR);
+    }
+    addr = mmap(NULL, sizeof(shmRingPair), PROT_READ | PROT_WRITE, MAP_SHARED, localShmFd, 0);
+    close(localShmFd);
+    if (addr == MAP_FAILED) {
+        m_system->logMsg(XRM_LOG_ERROR, "%s: fail to map shared memory, errno %d", __func__, errno);
+        return (XRM_ERROR);
+    }
+    m_rings = (shmRingPair*)addr;
+    if (m_rings->magic != XRM_SHM_RING_MAGIC || m_rings->size != sizeof(shmRingPair)) {
+        m_system->logMsg(XRM_LOG_ERROR, "%s: wrong magic or size of shared memory ring", __func__);
+        return (XRM_ERROR);
+    }
+    return (XRM_SUCCESS);
+}
+
+/*
+ * start and stop are called on the strand
+ */
+void xrm::shmChannel::start() {
+    handleRequest();
+}
+
+void xrm::shmChannel::stop() {
+    boost::system::error_code ec;
+
+    m_stopped = true;
+    m_eventDesc.close(ec);
+}
+
+void xrm::shmChannel::doWait() {
+    auto self(shared_from_this());
+    m_eventDesc.async_read_some(boost::asio::buffer(&m_eventValue, sizeof(m_eventValue)),
+                                [this, self](boost::system::error_code const& ec, std::size_t /*length*/) {
+                                    if (ec || m_stopped) return;
+                                    m_rings->request.consumerWaiting.store(0);
+                                    handleRequest();
+                                });
+}
+
+void xrm::shmChannel::handleRequest() {
+    shmRing* reqRing = &m_rings->request;
+    shmRing* rspRing = &m_rings->response;
+
+    while (!m_stopped) {
+        while (!reqRing->isEmpty()) {
+            if (rspRing->isFull()) {
+                /* client only has one request in flight, it's broken */
+                m_system->logMsg(XRM_LOG_ERROR, "%s: response ring is full, stop the channel", __func__);
+                stop();
+                return;
+            }
+            processSlot(reqRing->consumerSlot(), rspRing->producerSlot());
+            reqRing->consume();
+            rspRing->produce();
+            if (rspRing->consumerWaiting.load()) {
+                uint64_t value = 1;
+                if (write(m_responseEventFd, &value, sizeof(value)) != sizeof(value))
+                    m_system->logMsg(XRM_LOG_ERROR, "%s: fail to signal client, errno %d", __func__, errno);
+            }
+        }
+        /* announce the sleep then check again, the request may come in between */
+        reqRing->consumerWaiting.store(1);
+        if (reqRing->isEmpty()) break;
+        reqRing->consumerWaiting.store(0);
+    }
+    if (!m_stopped) doWait();
+}
+
+/*
+ * The request slot is in memory shared with client, copy it before checking.
+ */
+void xrm::shmChannel::processSlot(const char* reqSlot, char* rspSlot) {
+    char req[XRM_SHM_RING_SLOT_SIZE];
+    binaryFrameHeader* reqHdr = (binaryFrameHeader*)req;
+    binaryFrameHeader* rspHdr = (binaryFrameHeader*)rspSlot;
+    char* rsp = rspSlot + sizeof(binaryFrameHeader);
+    uint32_t rspLen = 0;
+    int32_t ret = XRM_ERROR_INVALID;
+
+    memcpy(req, reqSlot, XRM_SHM_RING_SLOT_SIZE);
+    if (reqHdr->magic == XRM_BINARY_PROTOCOL_MAGIC && reqHdr->version == XRM_BINARY_PROTOCOL_VERSION_1 &&
+        isShmRingOpcode(reqHdr->opcode) && reqHdr->length <= XRM_SHM_RING_SLOT_SIZE - sizeof(binaryFrameHeader)) {
+        /* the slot is written by client, the process id of the attaching connection is trusted */
+        binaryOverrideProcessId(reqHdr->opcode, req + sizeof(binaryFrameHeader), reqHdr->length, m_clientProcessId);
+        ret = m_registry->dispatchBinary(reqHdr->opcode, req + sizeof(binaryFrameHeader), reqHdr->length, rsp,
+                                         &rspLen);
+    }
+    if (ret != XRM_SUCCESS) {
+        binaryStatusResponse* statusRsp = (binaryStatusResponse*)rsp;
+        statusRsp->status = ret;
+        statusRsp->reserved = 0;
+        rspLen = sizeof(binaryStatusResponse);
+    }
+    rspHdr->magic = XRM_BINARY_PROTOCOL_MAGIC;
+    rspHdr->version = XRM_BINARY_PROTOCOL_VERSION_1;
+    rspHdr->opcode = reqHdr->opcode;
+    rspHdr->requestId = reqHdr->requestId;
+    rspHdr->length = rspLen;
+}
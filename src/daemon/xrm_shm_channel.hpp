@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2019-2021, Xilinx Inc - All rights reserved
+ *
+ * Copyright (C) 2023, Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Xilinx Resource Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef _XRM_SHM_CHANNEL_HPP_
+#define _XRM_SHM_CHANNEL_HPP_
+
+#include <memory>
+#include <boost/asio.hpp>
+#include "xrm_command_registry.hpp"
+#include "xrm_shm_ring.hpp"
+#include "xrm_system.hpp"
+
+namespace xrm {
+
+/*
+ * Daemon side of the shared memory transport of one client context. The requests on the
+ * ring are processed on the strand of the session owning the channel, so they are serialized
+ * with the session close and resource recycle.
+ */
+class shmChannel : public std::enable_shared_from_this<shmChannel> {
+   public:
+    typedef boost::asio::strand<boost::asio::generic::stream_protocol::socket::executor_type> strand_type;
+
+    shmChannel(strand_type strand, xrm::system* sys, xrm::commandRegistry* registry)
+        : m_eventDesc(strand), m_system(sys), m_registry(registry) {}
+    ~shmChannel();
+
+    int32_t attach(pid_t clientProcessId, int32_t shmFd, int32_t requestEventFd, int32_t responseEventFd);
+    void start();
+    void stop();
+
+   private:
+    void handleRequest();
+    void doWait();
+    void processSlot(const char* reqSlot, char* rspSlot);
+
+    boost::asio::posix::stream_descriptor m_eventDesc; // request eventfd, signalled by client
+    int32_t m_responseEventFd = -1;                     // response eventfd, signalled to client
+    shmRingPair* m_rings = NULL;
+    uint64_t m_eventValue = 0;
+    pid_t m_clientProcessId = 0; // from SO_PEERCRED of the attaching connection
+    bool m_stopped = false;
+    xrm::system* m_system;
+    xrm::commandRegistry* m_registry;
+};
+} // namespace xrm
+
+#endif // _XRM_SHM_CHANNEL_HPP_
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2019-2021, Xilinx Inc - All rights reserved
+ *
+ * Copyright (C) 2023, Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Xilinx Resource Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef _XRM_SHM_RING_HPP_
+#define _XRM_SHM_RING_HPP_
+
+#include <stdint.h>
+#include <atomic>
+#include "xrm_binary_protocol.hpp"
+
+/*
+ * Shared memory transport between libxrm and xrmd for the clients on the same host.
+ *
+ * The client creates one memfd holding shmRingPair and two eventfds per context, then asks
+ * the daemon to attach them with shmAttach json request on the unix domain socket. The
+ * daemon gets the file descriptors of the client through pidfd with the peer process id
+ * from kernel. The socket is still used for context setup and tells the liveness of both
+ * sides.
+ *
+ * Each ring is single producer single consumer, the slot holds binaryFrameHeader + record.
+ * Consumer sets consumerWaiting before sleeping on the eventfd and checks the ring again,
+ * producer only signals the eventfd when consumerWaiting is set, so there is no syscall
+ * while the consumer is busy or polling.
+ */
+
+#define XRM_SHM_RING_MAGIC 0x53525842 // "BXRS"
+#define XRM_SHM_RING_SLOT_NUM 16
+#define XRM_SHM_RING_SLOT_SIZE 4096
+
+static_assert(ATOMIC_INT_LOCK_FREE == 2, "atomic in shared memory must be lock free");
+
+namespace xrm {
+
+struct shmRing {
+    std::atomic<uint32_t> head; // next slot to be written, updated by producer
+    char pad0[60];
+    std::atomic<uint32_t> tail;            // next slot to be read, updated by consumer
+    std::atomic<uint32_t> consumerWaiting; // consumer is going to sleep on the eventfd
+    char pad1[56];
+    char slots[XRM_SHM_RING_SLOT_NUM][XRM_SHM_RING_SLOT_SIZE];
+
+    bool isEmpty() { return (head.load() == tail.load()); }
+    bool isFull() { return (head.load() - tail.load() >= XRM_SHM_RING_SLOT_NUM); }
+    char* producerSlot() { return (slots[head.load(std::memory_order_relaxed) % XRM_SHM_RING_SLOT_NUM]); }
+    void produce() { head.fetch_add(1); }
+    char* consumerSlot() { return (slots[tail.load(std::memory_order_relaxed) % XRM_SHM_RING_SLOT_NUM]); }
+    void consume() { tail.fetch_add(1); }
+};
+
+struct shmRingPair {
+    uint32_t magic;
+    uint32_t size;
+    char pad[56];
+    shmRing request;  // libxrm -> xrmd
+    shmRing response; // xrmd -> libxrm
+};
+
+/*
+ * Only the single cu commands go through the ring, the record must fit into one slot.
+ */
+inline bool isShmRingOpcode(uint16_t opcode) {
+    return (opcode == XRM_BINARY_OP_CU_ALLOC_V2 || opcode == XRM_BINARY_OP_CU_RELEASE_V2 ||
+            opcode == XRM_BINARY_OP_CU_CHECK_STATUS);
+}
+
+static_assert(sizeof(binaryFrameHeader) + sizeof(binaryCuAllocV2Request) <= XRM_SHM_RING_SLOT_SIZE &&
+                  sizeof(binaryFrameHeader) + sizeof(binaryCuAllocV2Response) <= XRM_SHM_RING_SLOT_SIZE &&
+                  sizeof(binaryFrameHeader) + sizeof(binaryCuReleaseV2Request) <= XRM_SHM_RING_SLOT_SIZE &&
+                  sizeof(binaryFrameHeader) + sizeof(binaryCuCheckStatusRequest) <= XRM_SHM_RING_SLOT_SIZE &&
+                  sizeof(binaryFrameHeader) + sizeof(binaryCuCheckStatusResponse) <= XRM_SHM_RING_SLOT_SIZE,
+              "shared memory ring slot is too small");
+
+} // namespace xrm
+
+#endif // _XRM_SHM_RING_HPP_
@@ -20,7 +20,9 @@
 
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
 #include <vector>
+#include <tuple>
 #include <fstream>
 #include <boost/archive/text_iarchive.hpp>
 #include <boost/archive/text_oarchive.hpp>
@@ -29,6 +31,8 @@
 
 #include "xrm_system.hpp"
 #include "xrm_config.hpp"
+#include "xrm_event_hub.hpp"
+#include "xrm_wait_queue.hpp"
 
 /*
  * All system / resource related operation should be protected by the system lock.
@@ -108,9 +112,8 @@ void xrm::system::initConfig() {
     m_logLevel = xrm::config::getVerbosity();
     if (m_logLevel > XRM_MAX_LOG_LEVEL) m_logLevel = XRM_DEFAULT_LOG_LEVEL;
     logMsg(XRM_LOG_NOTICE, "%s : logLevel = %d", __func__, m_logLevel);
+    /* capped to XRM_MAX_LIMIT_CONCURRENT_CLIENT by config, same as admission control */
     m_limitConcurrentClient = xrm::config::getLimitConcurrentClient();
-    if (m_limitConcurrentClient > XRM_MAX_LIMIT_CONCURRENT_CLIENT)
-        m_limitConcurrentClient = XRM_MAX_LIMIT_CONCURRENT_CLIENT;
     logMsg(XRM_LOG_NOTICE, "%s : limitConcurrentClient = %d", __func__, m_limitConcurrentClient);
     m_xrtVersionFileFullPathName = xrm::config::getXrtVersionFileFullPathName();
     logMsg(XRM_LOG_NOTICE, "%s : xrtVersionFileFullPathName = %s", __func__, m_xrtVersionFileFullPathName.c_str());
@@ -228,6 +231,29 @@ void xrm::system::initDevices() {
         m_devList[devId].devLoadInfo.init(devId);
         openDevice(devId);
     }
+    rebuildDevLoadRanking();
+}
+
+/*
+ * The devices are kept in m_devLoadRanking ordered by load rate and device id, so the device
+ * load policies walk the devices in order without sorting them for each request. The load of
+ * devices are updated in parallel under the device locks, so m_devLoadLock is taken. The
+ * readers are holding the system lock exclusively.
+ */
+void xrm::system::updateDeviceLoad(int32_t devId, int64_t loadIncreased, int64_t setLoadVal) {
+    deviceLoadInfo* loadInfo = &m_devList[devId].devLoadInfo;
+
+    pthread_mutex_lock(&m_devLoadLock);
+    m_devLoadRanking.erase(std::make_pair(loadInfo->devLoadRate, devId));
+    m_devList[devId].updateDeviceLoad(loadIncreased, setLoadVal);
+    m_devLoadRanking.insert(std::make_pair(loadInfo->devLoadRate, devId));
+    pthread_mutex_unlock(&m_devLoadLock);
+}
+
+void xrm::system::rebuildDevLoadRanking() {
+    m_devLoadRanking.clear();
+    for (int32_t devId = 0; devId < m_numDevice; devId++)
+        m_devLoadRanking.insert(std::make_pair(m_devList[devId].devLoadInfo.devLoadRate, devId));
 }
 
 /*
@@ -405,6 +431,7 @@ int32_t xrm::system::resetDevice(int32_t devId) {
     uint32_t i;
     if (m_devList[devId].deviceHandle) {
         logMsg(XRM_LOG_DEBUG, "%s : reset device %d\n", __func__, devId);
+        publishEvent(XRM_EVENT_DEVICE_OFFLINE, devId);
 
         /* clean all the clients which are using the device */
         std::vector<uint64_t> clientIdVect;
@@ -437,6 +464,7 @@ int32_t xrm::system::resetDevice(int32_t devId) {
 
         /* close the device, clean device handler */
         closeDevice(devId);
+        publishEvent(XRM_EVENT_DEVICE_RESET, devId);
     } else {
         logMsg(XRM_LOG_ERROR, "%s : device handle is not valid\n", __func__);
         ret = XRM_ERROR;
@@ -711,6 +739,9 @@ int32_t xrm::system::deviceLoadXclbin(int32_t devId, std::string& xclbin, std::s
     /* Update state */
     m_devList[devId].xclbinName = xclbin;
     m_devList[devId].isLoaded = true;
+    rebuildCuIndex();
+    publishEvent(XRM_EVENT_XCLBIN_LOADED, devId);
+    notifyAllReleased();
 
 #if 0
     /* For testing only */
@@ -762,14 +793,20 @@ void xrm::system::flushDevData(int32_t devId) {
             cu->cuName = "";
             cu->instanceName = "";
             cu->kernelPluginFileName = "";
+            cu->kernelNameId = XRM_NAME_ID_NONE;
+            cu->kernelAliasId = XRM_NAME_ID_NONE;
+            cu->cuNameId = XRM_NAME_ID_NONE;
+            cu->instanceNameId = XRM_NAME_ID_NONE;
             cu->maxCapacity = 0;
             cu->baseAddr = 0;
             cu->membankId = 0;
             cu->membankType = 0;
             cu->membankSize = 0;
             cu->membankBaseAddr = 0;
+            cuDropChannelsFromIndex(cu);
             memset(cu->channels, 0, sizeof(channelData) * XRM_MAX_KERNEL_CHANNELS);
             cu->numChanInuse = 0;
+            memset(cu->chanInuseMap, 0, sizeof(cu->chanInuseMap));
             memset(cu->clients, 0, sizeof(uint64_t) * XRM_MAX_KERNEL_CHANNELS);
             cu->numClient = 0;
             cu->totalUsedLoadUnified = 0; // will set dev load when numCu is set
@@ -819,6 +856,7 @@ bool xrm::system::deviceClearInfo(int32_t devId) {
         deviceInfo = dev->deviceInfo;
 
         flushDevData(devId);
+        rebuildCuIndex();
 
         /* restore the info */
         dev->devId = devId;
@@ -1087,6 +1125,7 @@ void xrm::system::cuInitChannels(cuData* cu) {
         return;
     }
 
+    cuDropChannelsFromIndex(cu);
     for (i = 0; i < XRM_MAX_KERNEL_CHANNELS; i++) {
         cu->channels[i].channelId = i;
         cu->channels[i].allocServiceId = 0;
@@ -1097,6 +1136,84 @@ void xrm::system::cuInitChannels(cuData* cu) {
         cu->channels[i].channelLoadOriginal = 0;
     }
     cu->numChanInuse = 0;
+    memset(cu->chanInuseMap, 0, sizeof(cu->chanInuseMap));
+}
+
+/*
+ * The bit of cu->chanInuseMap is set when the channel is given load (channelLoadUnified is not 0)
+ * and cleared when the load is released, so the free channel is found with the first zero bit
+ * instead of walking all the channels. The bits beyond XRM_MAX_KERNEL_CHANNELS are never set.
+ *
+ * The channel is also added to / removed from the allocation service id index, so
+ * cuSetChannelInuse() should be called after the allocServiceId of the channel is set, and
+ * cuSetChannelFree() before it is cleared.
+ */
+void xrm::system::cuSetChannelInuse(cuData* cu, int32_t chanId) {
+    cu->chanInuseMap[chanId / 64] |= (1ULL << (chanId % 64));
+    allocServiceIndexAdd(cu, chanId);
+}
+
+void xrm::system::cuSetChannelFree(cuData* cu, int32_t chanId) {
+    allocServiceIndexRemove(cu, chanId);
+    cu->chanInuseMap[chanId / 64] &= ~(1ULL << (chanId % 64));
+}
+
+/*
+ * The channels of different devices are allocated and released in parallel under the device
+ * locks, so the index is updated with m_allocServiceLock held. The readers are holding the
+ * system lock exclusively, no index update can happen at the same time.
+ */
+void xrm::system::allocServiceIndexAdd(cuData* cu, int32_t chanId) {
+    uint64_t allocServiceId = cu->channels[chanId].allocServiceId;
+    if (allocServiceId == 0) return;
+
+    allocServiceEntry entry = {cu->deviceId, cu->cuId, chanId};
+    auto entryLess = [](const allocServiceEntry& a, const allocServiceEntry& b) {
+        return (std::tie(a.deviceId, a.cuId, a.channelId) < std::tie(b.deviceId, b.cuId, b.channelId));
+    };
+    pthread_mutex_lock(&m_allocServiceLock);
+    std::vector<allocServiceEntry>& entries = m_allocServiceIndex[allocServiceId];
+    entries.insert(std::upper_bound(entries.begin(), entries.end(), entry, entryLess), entry);
+    pthread_mutex_unlock(&m_allocServiceLock);
+}
+
+void xrm::system::allocServiceIndexRemove(cuData* cu, int32_t chanId) {
+    uint64_t allocServiceId = cu->channels[chanId].allocServiceId;
+    if (allocServiceId == 0) return;
+
+    pthread_mutex_lock(&m_allocServiceLock);
+    auto it = m_allocServiceIndex.find(allocServiceId);
+    if (it != m_allocServiceIndex.end()) {
+        std::vector<allocServiceEntry>& entries = it->second;
+        for (auto e = entries.begin(); e != entries.end(); e++) {
+            if (e->deviceId == cu->deviceId && e->cuId == cu->cuId && e->channelId == chanId) {
+                entries.erase(e);
+                break;
+            }
+        }
+        if (entries.empty()) m_allocServiceIndex.erase(it);
+    }
+    pthread_mutex_unlock(&m_allocServiceLock);
+}
+
+/*
+ * remove the channels in use from the index before the channels of the cu are reset in bulk
+ */
+void xrm::system::cuDropChannelsFromIndex(cuData* cu) {
+    for (int32_t w = 0; w < XRM_CHAN_INUSE_MAP_WORDS; w++) {
+        for (uint64_t bits = cu->chanInuseMap[w]; bits; bits &= bits - 1)
+            allocServiceIndexRemove(cu, w * 64 + __builtin_ctzll(bits));
+    }
+}
+
+/*
+ * rebuild the bitmap from the channels, the bitmap is not saved with the channels
+ */
+void xrm::system::cuSyncChannelMap(cuData* cu) {
+    memset(cu->chanInuseMap, 0, sizeof(cu->chanInuseMap));
+    for (int32_t i = 0; i < XRM_MAX_KERNEL_CHANNELS; i++) {
+        if (cu->channels[i].channelLoadUnified) cuSetChannelInuse(cu, i);
+    }
 }
 
 /*
@@ -1104,23 +1221,35 @@ void xrm::system::cuInitChannels(cuData* cu) {
  *    : -1, no free channel
  */
 int32_t xrm::system::cuFindFreeChannelId(cuData* cu) {
-    int32_t i;
     int32_t ret = -1;
 
     if (cu == NULL) return (ret);
 
     if (cu->numChanInuse >= XRM_MAX_KERNEL_CHANNELS) return (ret);
 
-    for (i = 0; i < XRM_MAX_KERNEL_CHANNELS; i++) {
+    for (int32_t w = 0; w < XRM_CHAN_INUSE_MAP_WORDS; w++) {
+        uint64_t freeBits = ~cu->chanInuseMap[w];
+        if (freeBits == 0) continue;
         /* channelLoadUnified is 0, clientId are also 0 */
-        if (cu->channels[i].channelLoadUnified == 0) {
-            ret = i;
-            break;
-        }
+        int32_t i = w * 64 + __builtin_ctzll(freeBits);
+        if (i < XRM_MAX_KERNEL_CHANNELS) ret = i;
+        break;
     }
     return (ret);
 }
 
+/*
+ * Check whether the client still holds any channel of the cu, only the channels in use are checked.
+ */
+bool xrm::system::cuIsClientUsingChannel(cuData* cu, uint64_t clientId) {
+    for (int32_t w = 0; w < XRM_CHAN_INUSE_MAP_WORDS; w++) {
+        for (uint64_t bits = cu->chanInuseMap[w]; bits; bits &= bits - 1) {
+            if (cu->channels[w * 64 + __builtin_ctzll(bits)].clientId == clientId) return (true);
+        }
+    }
+    return (false);
+}
+
 /*
  * To convert bin array to hex string.
  */
@@ -1456,10 +1585,7 @@ uint64_t xrm::system::getCuMaxCapacity(cuProperty* cuProp) {
     uint64_t maxCapacityWithAlias = 0;
     std::string name = cuProp->kernelName;
     std::string alias = cuProp->kernelAlias;
-    deviceData* dev;
     cuData* cu;
-    int32_t devId, cuId;
-    bool found;
 
     if ((name[0] == '\0') && (alias[0] == '\0')) {
         logMsg(XRM_LOG_ERROR, "%s : neither name nor alias are presented", __func__);
@@ -1468,22 +1594,9 @@ uint64_t xrm::system::getCuMaxCapacity(cuProperty* cuProp) {
 
     if (name[0] != '\0') {
         /* kernel name is presented */
-        found = false;
-        for (devId = 0; devId < m_numDevice; devId++) {
-            dev = &m_devList[devId];
-            if (dev->isLoaded) {
-                for (cuId = 0; cuId < dev->xclbinInfo.numCu; cuId++) {
-                    cu = &dev->xclbinInfo.cuList[cuId];
-                    if (name.compare(cu->kernelName.c_str()) == 0) {
-                        found = true;
-                        maxCapacity = cu->maxCapacity;
-                        break;
-                    }
-                }
-            }
-            if (found) break;
-        }
-        if (found) {
+        cu = findFirstCu(m_kernelNameIndex, m_nameTable.find(cuProp->kernelName));
+        if (cu != NULL) {
+            maxCapacity = cu->maxCapacity;
             logMsg(XRM_LOG_NOTICE, "%s : maxCapacity with name is %lu", __func__, maxCapacity);
         } else {
             logMsg(XRM_LOG_NOTICE, "%s : cu name%s not found", __func__, name.c_str());
@@ -1491,22 +1604,9 @@ uint64_t xrm::system::getCuMaxCapacity(cuProperty* cuProp) {
 
         /* kernel alias is also presented */
         if (alias[0] != '\0') {
-            found = false;
-            for (devId = 0; devId < m_numDevice; devId++) {
-                dev = &m_devList[devId];
-                if (dev->isLoaded) {
-                    for (cuId = 0; cuId < dev->xclbinInfo.numCu; cuId++) {
-                        cu = &dev->xclbinInfo.cuList[cuId];
-                        if (alias.compare(cu->kernelAlias.c_str()) == 0) {
-                            found = true;
-                            maxCapacityWithAlias = cu->maxCapacity;
-                            break;
-                        }
-                    }
-                }
-                if (found) break;
-            }
-            if (found) {
+            cu = findFirstCu(m_kernelAliasIndex, m_nameTable.find(cuProp->kernelAlias));
+            if (cu != NULL) {
+                maxCapacityWithAlias = cu->maxCapacity;
                 logMsg(XRM_LOG_NOTICE, "%s : maxCapacity with alias is %lu", __func__, maxCapacityWithAlias);
             } else {
                 logMsg(XRM_LOG_NOTICE, "%s : cu alias%s not found", __func__, alias.c_str());
@@ -1520,22 +1620,9 @@ uint64_t xrm::system::getCuMaxCapacity(cuProperty* cuProp) {
     } else // alias[0] != '\0'
     {
         /* kernel alias is presented */
-        found = false;
-        for (devId = 0; devId < m_numDevice; devId++) {
-            dev = &m_devList[devId];
-            if (dev->isLoaded) {
-                for (cuId = 0; cuId < dev->xclbinInfo.numCu; cuId++) {
-                    cu = &dev->xclbinInfo.cuList[cuId];
-                    if (alias.compare(cu->kernelAlias.c_str()) == 0) {
-                        found = true;
-                        maxCapacityWithAlias = cu->maxCapacity;
-                        break;
-                    }
-                }
-            }
-            if (found) break;
-        }
-        if (found) {
+        cu = findFirstCu(m_kernelAliasIndex, m_nameTable.find(cuProp->kernelAlias));
+        if (cu != NULL) {
+            maxCapacityWithAlias = cu->maxCapacity;
             logMsg(XRM_LOG_NOTICE, "%s : maxCapacity with alias is %lu", __func__, maxCapacityWithAlias);
         } else {
             logMsg(XRM_LOG_NOTICE, "%s : cu alias%s not found", __func__, alias.c_str());
@@ -1546,25 +1633,323 @@ uint64_t xrm::system::getCuMaxCapacity(cuProperty* cuProp) {
     return (maxCapacity);
 }
 
+/*
+ * Rebuild the index of the cus on loaded devices by kernel name, kernel alias and cu name.
+ * It's called whenever the cu list of one device is changed, that is xclbin is loaded to or
+ * cleared from the device, so the allocation only looks at the cus which may match. The names
+ * of the cus are interned here, so they are resolved once per xclbin load.
+ *
+ * Lock: should enter lock before calling the function
+ */
+void xrm::system::rebuildCuIndex() {
+    m_kernelNameIndex.clear();
+    m_kernelAliasIndex.clear();
+    m_cuNameIndex.clear();
+    for (int32_t devId = 0; devId < m_numDevice; devId++) {
+        deviceData* dev = &m_devList[devId];
+        if (!dev->isLoaded) continue;
+        for (int32_t cuId = 0; cuId < XRM_MAX_XILINX_KERNELS && cuId < dev->xclbinInfo.numCu; cuId++) {
+            cuData* cu = &dev->xclbinInfo.cuList[cuId];
+            cu->kernelNameId = m_nameTable.intern(cu->kernelName);
+            cu->kernelAliasId = m_nameTable.intern(cu->kernelAlias);
+            cu->cuNameId = m_nameTable.intern(cu->cuName);
+            cu->instanceNameId = m_nameTable.intern(cu->instanceName);
+            if (cu->kernelNameId != XRM_NAME_ID_NONE) m_kernelNameIndex[cu->kernelNameId].cuIds[devId].push_back(cuId);
+            if (cu->kernelAliasId != XRM_NAME_ID_NONE)
+                m_kernelAliasIndex[cu->kernelAliasId].cuIds[devId].push_back(cuId);
+            if (cu->cuNameId != XRM_NAME_ID_NONE) m_cuNameIndex[cu->cuNameId].cuIds[devId].push_back(cuId);
+            cu->loadKey = cuCurrentLoadKey(cu);
+            if (cu->kernelNameId != XRM_NAME_ID_NONE)
+                m_kernelNameIndex[cu->kernelNameId].byLoad[devId].insert(cu->loadKey);
+            if (cu->kernelAliasId != XRM_NAME_ID_NONE)
+                m_kernelAliasIndex[cu->kernelAliasId].byLoad[devId].insert(cu->loadKey);
+            if (cu->cuNameId != XRM_NAME_ID_NONE) m_cuNameIndex[cu->cuNameId].byLoad[devId].insert(cu->loadKey);
+        }
+    }
+}
+
+/*
+ * Get the ids of the cus on the device which may match the request property, it's the
+ * shortest one of the lists indexed by the presented kernel name, kernel alias and cu name.
+ * The caller still needs to check the cu with isCuMatching().
+ *
+ * return: cu ids in ascending order, empty if none of the cus on the device matches
+ */
+const std::vector<int32_t>& xrm::system::cuCandidatesOnDev(int32_t devId, cuProperty* cuProp) {
+    static const std::vector<int32_t> noCu;
+
+    if (devId < 0 || devId >= XRM_MAX_XILINX_DEVICES) return (noCu);
+    cuIndexEntry* entry = cuShortestIndexEntry(devId, cuProp);
+    return (entry ? entry->cuIds[devId] : noCu);
+}
+
+/*
+ * The index entry with the shortest cu list on the device among the presented kernel name,
+ * kernel alias and cu name.
+ *
+ * return: NULL if none of the names is presented or one of them is not indexed
+ */
+xrm::cuIndexEntry* xrm::system::cuShortestIndexEntry(int32_t devId, cuProperty* cuProp) {
+    cuIndexEntry* shortest = NULL;
+
+    const std::pair<std::unordered_map<uint32_t, cuIndexEntry>*, uint32_t> keys[] = {
+        {&m_cuNameIndex, cuProp->cuNameId},
+        {&m_kernelNameIndex, cuProp->kernelNameId},
+        {&m_kernelAliasIndex, cuProp->kernelAliasId},
+    };
+    for (auto& key : keys) {
+        if (key.second == XRM_NAME_ID_NONE) continue;
+        auto it = key.first->find(key.second);
+        if (it == key.first->end()) return (NULL);
+        if (shortest == NULL || it->second.cuIds[devId].size() < shortest->cuIds[devId].size())
+            shortest = &it->second;
+    }
+    return (shortest);
+}
+
+/*
+ * The cus in each index entry are also kept in cuIndexEntry::byLoad ordered by cuLoadKey, so
+ * the most used or least used cu is found without walking all the cus. The key is updated by
+ * cuUpdateLoadIndex() when the used load or the clients of the cu are changed.
+ */
+xrm::cuLoadKey xrm::system::cuCurrentLoadKey(cuData* cu) {
+    cuLoadKey key = {cu->totalUsedLoadUnified, cu->numClient > 0 ? 0 : 1, cu->cuId};
+    return (key);
+}
+
+void xrm::system::cuUpdateLoadIndex(cuData* cu) {
+    cuLoadKey key = cuCurrentLoadKey(cu);
+    if (key == cu->loadKey) return;
+
+    const std::pair<std::unordered_map<uint32_t, cuIndexEntry>*, uint32_t> keys[] = {
+        {&m_kernelNameIndex, cu->kernelNameId},
+        {&m_kernelAliasIndex, cu->kernelAliasId},
+        {&m_cuNameIndex, cu->cuNameId},
+    };
+    for (auto& k : keys) {
+        if (k.second == XRM_NAME_ID_NONE) continue;
+        auto it = k.first->find(k.second);
+        if (it == k.first->end()) continue;
+        std::set<cuLoadKey>& byLoad = it->second.byLoad[cu->deviceId];
+        /* the cu is not indexed (device not loaded), nothing to move */
+        if (byLoad.erase(cu->loadKey) == 0) continue;
+        byLoad.insert(key);
+    }
+    cu->loadKey = key;
+}
+
+/*
+ * Whether the request load fits in the cu, from the reserve pool if the pool id is set. The cu
+ * also needs a free channel, the small loads may use up the channels before the load.
+ */
+bool xrm::system::cuFitsLoad(cuData* cu, cuProperty* cuProp) {
+    if (cu->numChanInuse >= XRM_MAX_KERNEL_CHANNELS) return (false);
+    if (cuProp->poolId) {
+        int32_t reserveIdx = isReservePoolUsingCu(cu, cuProp->poolId);
+        if (reserveIdx == -1 || !cu->reserves[reserveIdx].clientIsActive) return (false);
+        return (cu->reserves[reserveIdx].reserveUsedLoadUnified + cuProp->requestLoadUnified <=
+                cu->reserves[reserveIdx].reserveLoadUnified);
+    }
+    return (cu->totalUsedLoadUnified + cuProp->requestLoadUnified <= XRM_MAX_CHAN_LOAD_GRANULARITY_1000000);
+}
+
+/*
+ * Score of the cu under the most used / least used policy, the lower is the better:
+ * most used first: the cu with most used load, so the load is packed to less cus
+ * least used first: the cu with least used load
+ * From the reserve pool, the used load of the reserve is compared instead, and most used first
+ * prefers the reserve with least remaining load after the allocation.
+ * On the same load, the cu already used by some client is preferred.
+ */
+std::pair<int64_t, int32_t> xrm::system::cuLoadScore(cuData* cu, cuProperty* cuProp, uint64_t policyInfo) {
+    bool mostUsed = (policyInfo == XRM_POLICY_INFO_CONSTRAINT_TYPE_CU_MOST_USED_FIRST ||
+                     policyInfo == XRM_POLICY_INFO_CONSTRAINT_TYPE_DEV_MOST_USED_FIRST);
+    int32_t rank = cu->numClient > 0 ? 0 : 1;
+    int64_t load;
+
+    if (cuProp->poolId) {
+        reserveData* reserve = &cu->reserves[isReservePoolUsingCu(cu, cuProp->poolId)];
+        if (mostUsed)
+            load = (int64_t)reserve->reserveLoadUnified - reserve->reserveUsedLoadUnified - cuProp->requestLoadUnified;
+        else
+            load = reserve->reserveUsedLoadUnified;
+    } else {
+        load = mostUsed ? -(int64_t)cu->totalUsedLoadUnified : cu->totalUsedLoadUnified;
+    }
+    return (std::make_pair(load, rank));
+}
+
+/*
+ * Find the best cu on the device for the request under the most used / least used policy,
+ * see cuLoadScore(). On the same score the cu with smaller id is selected. Without the
+ * policy, it's the first cu the request fits.
+ *
+ * Out of reserve pool, the cus are looked up from the load ordered index: for most used first,
+ * it starts from the highest used load the request still fits; for least used first, from the
+ * lowest used load. The cus without free channel are skipped in both. From the reserve pool,
+ * the matching cus are walked since the order is decided by the reserve.
+ *
+ * return: NULL if no cu on the device fits the request
+ */
+xrm::cuData* xrm::system::findCuByLoad(int32_t devId, cuProperty* cuProp, uint64_t policyInfo) {
+    deviceData* dev = &m_devList[devId];
+    cuData* best = NULL;
+
+    cuIndexEntry* entry = cuShortestIndexEntry(devId, cuProp);
+    if (entry == NULL) return (NULL);
+
+    bool mostUsed = (policyInfo == XRM_POLICY_INFO_CONSTRAINT_TYPE_CU_MOST_USED_FIRST ||
+                     policyInfo == XRM_POLICY_INFO_CONSTRAINT_TYPE_DEV_MOST_USED_FIRST);
+    bool leastUsed = (policyInfo == XRM_POLICY_INFO_CONSTRAINT_TYPE_CU_LEAST_USED_FIRST ||
+                      policyInfo == XRM_POLICY_INFO_CONSTRAINT_TYPE_DEV_LEAST_USED_FIRST);
+    if (!mostUsed && !leastUsed) {
+        /* no policy: the first cu fits, re-use the cus already used by some client first */
+        for (int32_t rank = 0; rank < 2; rank++) {
+            for (int32_t cuId : entry->cuIds[devId]) {
+                cuData* cu = &dev->xclbinInfo.cuList[cuId];
+                if ((cu->numClient > 0 ? 0 : 1) != rank) continue;
+                if (isCuMatching(cu, cuProp) && cuFitsLoad(cu, cuProp)) return (cu);
+            }
+        }
+        return (NULL);
+    }
+
+    if (cuProp->poolId) {
+        for (int32_t cuId : entry->cuIds[devId]) {
+            cuData* cu = &dev->xclbinInfo.cuList[cuId];
+            if (!isCuMatching(cu, cuProp) || !cuFitsLoad(cu, cuProp)) continue;
+            if (best == NULL || cuLoadScore(cu, cuProp, policyInfo) < cuLoadScore(best, cuProp, policyInfo)) best = cu;
+        }
+        return (best);
+    }
+
+    std::set<cuLoadKey>& byLoad = entry->byLoad[devId];
+    if (leastUsed) {
+        for (auto it = byLoad.begin(); it != byLoad.end(); it++) {
+            cuData* cu = &dev->xclbinInfo.cuList[it->cuId];
+            if (!isCuMatching(cu, cuProp)) continue;
+            if (cu->numChanInuse >= XRM_MAX_KERNEL_CHANNELS) continue;
+            /* the following cus are more loaded */
+            return (cuFitsLoad(cu, cuProp) ? cu : NULL);
+        }
+        return (NULL);
+    }
+
+    /* most used first: walk down the used load from the highest one the request fits */
+    cuLoadKey limit = {XRM_MAX_CHAN_LOAD_GRANULARITY_1000000 - cuProp->requestLoadUnified, INT32_MAX, INT32_MAX};
+    auto groupEnd = byLoad.upper_bound(limit);
+    while (groupEnd != byLoad.begin()) {
+        /* the cus with the same used load, in order of rank and cu id */
+        cuLoadKey groupKey = {std::prev(groupEnd)->usedLoad, INT32_MIN, INT32_MIN};
+        auto groupBegin = byLoad.lower_bound(groupKey);
+        for (auto it = groupBegin; it != groupEnd; it++) {
+            cuData* cu = &dev->xclbinInfo.cuList[it->cuId];
+            if (isCuMatching(cu, cuProp) && cu->numChanInuse < XRM_MAX_KERNEL_CHANNELS) return (cu);
+        }
+        groupEnd = groupBegin;
+    }
+    return (NULL);
+}
+
+/*
+ * The first cu in the order of device id and cu id with the name in the index
+ *
+ * return: NULL if no cu is found
+ */
+xrm::cuData* xrm::system::findFirstCu(std::unordered_map<uint32_t, cuIndexEntry>& index, uint32_t nameId) {
+    auto it = index.find(nameId);
+    if (it == index.end()) return (NULL);
+    for (int32_t devId = 0; devId < m_numDevice; devId++) {
+        const std::vector<int32_t>& cuIds = it->second.cuIds[devId];
+        if (!cuIds.empty()) return (&m_devList[devId].xclbinInfo.cuList[cuIds[0]]);
+    }
+    return (NULL);
+}
+
+/*
+ * Resolve the kernel name, kernel alias and cu name of the request property to the ids in
+ * name table. It's done once when the request enters the allocation, then the cus are matched
+ * with isCuMatching() and cuCandidatesOnDev() by the ids. Since the name not in the table is
+ * resolved to XRM_NAME_ID_UNKNOWN, it needs to be done again after new xclbin is loaded.
+ */
+void xrm::system::resolveCuPropertyNames(cuProperty* cuProp) {
+    cuProp->kernelNameId = m_nameTable.find(cuProp->kernelName);
+    cuProp->kernelAliasId = m_nameTable.find(cuProp->kernelAlias);
+    cuProp->cuNameId = m_nameTable.find(cuProp->cuName);
+}
+
+/*
+ * Check whether the cu matches the request property, the kernel name, kernel alias and
+ * cu name are compared only when they are presented.
+ */
+bool xrm::system::isCuMatching(cuData* cu, cuProperty* cuProp) {
+    if (cuProp->kernelNameId != XRM_NAME_ID_NONE && cu->kernelNameId != cuProp->kernelNameId) return (false);
+    if (cuProp->kernelAliasId != XRM_NAME_ID_NONE && cu->kernelAliasId != cuProp->kernelAliasId) return (false);
+    if (cuProp->cuNameId != XRM_NAME_ID_NONE && cu->cuNameId != cuProp->cuNameId) return (false);
+    return (true);
+}
+
 void xrm::system::initLock() {
-    pthread_mutex_init(&m_lock, NULL);
+    pthread_rwlock_init(&m_lock, NULL);
+    for (int32_t devId = 0; devId < XRM_MAX_XILINX_DEVICES; devId++) pthread_mutex_init(&m_devLock[devId], NULL);
+    pthread_mutex_init(&m_allocServiceLock, NULL);
+    pthread_mutex_init(&m_clientOwnershipLock, NULL);
+    pthread_mutex_init(&m_devLoadLock, NULL);
 }
 
 /*
- * Considering the xrmadm cli and xrm lib are using asio to do the IPC with xrmd deamon,
- * So the daemon is running as a single process there is no need to use lock in xrmd
- * daemon to protect the resource pool data.
+ * The daemon is serving the requests with a pool of io threads, so the resource pool
+ * data is protected with two levels of lock:
+ *
+ * enterLock() / exitLock(): take the system lock exclusively, the holder can access
+ * all the resource data. It's used by the operations touching the system wide data,
+ * like context create/destroy, load/unload xclbin, allocation and client recycle.
+ *
+ * enterDeviceLock() / exitDeviceLock(): take the system lock as shared, then the lock
+ * of one device. The holder can only access the data of that device, so the operations
+ * on different devices can be processed in parallel.
+ *
+ * enterDeviceListLock() / exitDeviceListLock(): same as device lock, but for operations
+ * spanning multiple devices. The device locks are always taken in ascending order of
+ * device id to avoid dead lock, one thread never holds more than one device lock outside
+ * of this interface.
  */
 void xrm::system::enterLock() {
-#if 1
-    pthread_mutex_lock(&m_lock);
-#endif
+    pthread_rwlock_wrlock(&m_lock);
 }
 
 void xrm::system::exitLock() {
-#if 1
-    pthread_mutex_unlock(&m_lock);
-#endif
+    pthread_rwlock_unlock(&m_lock);
+}
+
+void xrm::system::enterDeviceLock(int32_t devId) {
+    pthread_rwlock_rdlock(&m_lock);
+    /* invalid device id will be rejected by the resource operation, system lock is enough */
+    if (devId >= 0 && devId < XRM_MAX_XILINX_DEVICES) pthread_mutex_lock(&m_devLock[devId]);
+}
+
+void xrm::system::exitDeviceLock(int32_t devId) {
+    if (devId >= 0 && devId < XRM_MAX_XILINX_DEVICES) pthread_mutex_unlock(&m_devLock[devId]);
+    pthread_rwlock_unlock(&m_lock);
+}
+
+/*
+ * devIds will be sorted and de-duplicated, the same list should be passed to exitDeviceListLock()
+ */
+void xrm::system::enterDeviceListLock(std::vector<int32_t>& devIds) {
+    std::sort(devIds.begin(), devIds.end());
+    devIds.erase(std::unique(devIds.begin(), devIds.end()), devIds.end());
+    pthread_rwlock_rdlock(&m_lock);
+    for (auto devId : devIds) {
+        if (devId >= 0 && devId < XRM_MAX_XILINX_DEVICES) pthread_mutex_lock(&m_devLock[devId]);
+    }
+}
+
+void xrm::system::exitDeviceListLock(const std::vector<int32_t>& devIds) {
+    for (auto it = devIds.rbegin(); it != devIds.rend(); it++) {
+        if (*it >= 0 && *it < XRM_MAX_XILINX_DEVICES) pthread_mutex_unlock(&m_devLock[*it]);
+    }
+    pthread_rwlock_unlock(&m_lock);
 }
 
 inline void xrm::system::save() {
@@ -1592,9 +1977,22 @@ bool xrm::system::restore() {
         ar&* this;
         initConfig();
         initLibVersionDepFunctions();
+        m_allocServiceIndex.clear();
         for (int32_t devId = 0; devId < m_numDevice; devId++) {
-            if (!m_devList[devId].isDisabled) openDevice(devId);
+            deviceData* dev = &m_devList[devId];
+            if (!dev->isDisabled) openDevice(devId);
+            /* the device load is not saved, sum it from the cus */
+            int64_t devLoad = 0;
+            for (int32_t cuId = 0; cuId < dev->xclbinInfo.numCu; cuId++) {
+                cuSyncChannelMap(&dev->xclbinInfo.cuList[cuId]);
+                devLoad += dev->xclbinInfo.cuList[cuId].totalUsedLoadUnified;
+            }
+            dev->devLoadInfo.init(devId);
+            if (dev->xclbinInfo.numCu > 0) dev->updateDeviceLoad(0, devLoad);
         }
+        rebuildDevLoadRanking();
+        rebuildCuIndex();
+        rebuildClientOwnership();
         rc = true;
     } else
         logMsg(XRM_LOG_NOTICE, "No database found, starting from fresh state");
@@ -1681,6 +2079,7 @@ int32_t xrm::system::unloadOneDevice(const int32_t& devId, std::string& errmsg)
         }
 
         deviceClearInfo(devId);
+        publishEvent(XRM_EVENT_XCLBIN_UNLOADED, devId);
         return (XRM_SUCCESS);
     }
     errmsg = "Invalid device id [" + std::to_string(devId) + "] passed in";
@@ -1701,6 +2100,7 @@ int32_t xrm::system::enableOneDevice(const int32_t& devId, std::string& errmsg)
         deviceData* dev = &m_devList[devId];
 
         dev->isDisabled = false;
+        notifyAllReleased();
         return (XRM_SUCCESS);
     }
     errmsg = "Invalid device id [" + std::to_string(devId) + "] passed in";
@@ -1759,44 +2159,22 @@ int32_t xrm::system::disableOneDevice(const int32_t& devId, std::string& errmsg)
 bool xrm::system::resIsCuExistingOnDev(int32_t devId, cuProperty* cuProp) {
     deviceData* dev;
     cuData* cu;
-    bool kernelNameEqual, kernelAliasEqual, cuNameEqual;
-    int32_t cuId;
     bool cuFound = false;
 
     if ((cuProp->kernelName[0] == '\0') && (cuProp->kernelAlias[0] == '\0') && (cuProp->cuName[0] == '\0')) {
         logMsg(XRM_LOG_ERROR, "None of kernel name, kernel alias and cu name are presented\n");
         return (cuFound);
     }
+    resolveCuPropertyNames(cuProp);
 
     dev = &m_devList[devId];
-    /*
-     * Now check whether matching cu is on allocated device
-     * if not, free device, increment dev count, re-loop
-     */
-    for (cuId = 0; cuId < XRM_MAX_XILINX_KERNELS && cuId < dev->xclbinInfo.numCu && !cuFound; cuId++) {
+    /* Now check whether matching cu is on the device */
+    for (int32_t cuId : cuCandidatesOnDev(devId, cuProp)) {
         cu = &dev->xclbinInfo.cuList[cuId];
 
-        /*
-         * compare, 0: equal
-         *
-         * kernel name is presented, compare it; otherwise no need to compare
-         */
-        kernelNameEqual = true;
-        if (cuProp->kernelName[0] != '\0') {
-            if (cu->kernelName.compare(cuProp->kernelName)) kernelNameEqual = false;
-        }
-        /* kernel alias is presented, compare it; otherwise no need to compare */
-        kernelAliasEqual = true;
-        if (cuProp->kernelAlias[0] != '\0') {
-            if (cu->kernelAlias.compare(cuProp->kernelAlias)) kernelAliasEqual = false;
-        }
-        /* cu name is presented, compare it; otherwise no need to compare */
-        cuNameEqual = true;
-        if (cuProp->cuName[0] != '\0') {
-            if (cu->cuName.compare(cuProp->cuName)) cuNameEqual = false;
-        }
-        if (!(kernelNameEqual && kernelAliasEqual && cuNameEqual)) continue;
+        if (!isCuMatching(cu, cuProp)) continue;
         cuFound = true;
+        break;
     }
     return (cuFound);
 }
@@ -1935,74 +2313,495 @@ bool xrm::system::resIsCuGroupExisting(cuGroupProperty* cuGroupProp) {
 }
 
 /*
- * Alloc one cu (compute unit) based on the request property.
+ * Whether the client could get the request on the device now, it's the check of
+ * getNextFreeDevForClient() and allocClientFromDev() without registering the client.
+ */
+bool xrm::system::isDevAvailableForClient(int32_t devId, cuProperty* cuProp) {
+    deviceData* dev = &m_devList[devId];
+    uint64_t clientId = cuProp->clientId;
+    bool registered = false;
+    bool hasEmptySlot = false;
+
+    if (!dev->isLoaded) return (false);
+    if (dev->isExcl) return (dev->clientProcs[0].clientId == clientId);
+    for (int32_t pidIdx = 0; pidIdx < XRM_MAX_DEV_CLIENTS; pidIdx++) {
+        uint64_t slotClientId = dev->clientProcs[pidIdx].clientId;
+        if (slotClientId == clientId)
+            registered = true;
+        else if (slotClientId == 0)
+            hasEmptySlot = true;
+        else if (cuProp->devExcl)
+            return (false); /* used by other client, can not be exclusive */
+    }
+    return (cuProp->devExcl || registered || hasEmptySlot);
+}
+
+/*
+ * Number of times the request fits in the cu as it is now, the cu is not changed.
  *
- * XRM_SUCCESS: allocated resouce is recorded by cuRes
- * Otherwise: failed to allocate the cu resource
+ * allocation: limited by the free load of the default pool, or of the reserve if the pool id is
+ * set, and by the free channels of the cu.
+ * reserve: the load could be reserved into a new reserve pool, which needs a free reserve slot.
+ */
+int64_t xrm::system::cuAvailableNum(cuData* cu, cuProperty* cuProp, bool reserve) {
+    int32_t requestLoadUnified = cuProp->requestLoadUnified;
+    int64_t freeLoad;
+
+    if (reserve) {
+        if (cu->numReserve >= XRM_MAX_KERNEL_RESERVES) return (0);
+        freeLoad = XRM_MAX_CHAN_LOAD_GRANULARITY_1000000 -
+                   std::max(cu->totalUsedLoadUnified, cu->totalReservedLoadUnified);
+        return (freeLoad > 0 ? freeLoad / requestLoadUnified : 0);
+    }
+    if (cuProp->poolId) {
+        int32_t reserveIdx = isReservePoolUsingCu(cu, cuProp->poolId);
+        if (reserveIdx == -1 || !cu->reserves[reserveIdx].clientIsActive) return (0);
+        reserveData* reserve = &cu->reserves[reserveIdx];
+        freeLoad = (int64_t)reserve->reserveLoadUnified - reserve->reserveUsedLoadUnified;
+    } else {
+        freeLoad = XRM_MAX_CHAN_LOAD_GRANULARITY_1000000 - cu->totalUsedLoadUnified;
+    }
+    if (freeLoad <= 0) return (0);
+    return (std::min<int64_t>(freeLoad / requestLoadUnified, XRM_MAX_KERNEL_CHANNELS - cu->numChanInuse));
+}
+
+/*
+ * Number of times the request could be allocated (or reserved) from the devices in range of
+ * [devBegin, devEnd) as they are now. The load of each cu is independent, so the number doesn't
+ * depend on the order the cus are selected, it's the sum of all the matching cus. Out of reserve
+ * pool, only the cus in the load ordered index with room for the request are looked at.
  *
- * Lock: should enter lock during the cu allocation
+ * The names of the request property should be resolved before.
  */
-int32_t xrm::system::resAllocCu(cuProperty* cuProp, cuResource* cuRes, bool updateId) {
-    deviceData* dev;
-    cuData* cu;
-    int32_t ret = 0;
-    bool kernelNameEqual, kernelAliasEqual, cuNameEqual;
-    uint64_t clientId = cuProp->clientId;
-    int32_t devId, cuId;
-    bool cuAcquired = false;
-    /* First pass will look for kernels already in-use by proc */
-    bool cuAffinityPass = true;
+int64_t xrm::system::cuAvailableNumOnDevs(cuProperty* cuProp, int32_t devBegin, int32_t devEnd, bool reserve) {
+    int64_t availableNum = 0;
 
-    if ((cuProp == NULL) || (cuRes == NULL)) {
-        logMsg(XRM_LOG_ERROR, "cuProp or cuRes is NULL\n");
+    /* the load is validated by the callers, just not to divide by it when it's invalid */
+    if (cuProp->requestLoadUnified <= 0 || cuProp->requestLoadUnified > XRM_MAX_CHAN_LOAD_GRANULARITY_1000000)
+        return (0);
+    for (int32_t devId = devBegin; devId < devEnd; devId++) {
+        /* the reserve doesn't register the client on the device */
+        if (!reserve && !isDevAvailableForClient(devId, cuProp)) continue;
+        cuIndexEntry* entry = cuShortestIndexEntry(devId, cuProp);
+        if (entry == NULL) continue;
+        deviceData* dev = &m_devList[devId];
+
+        if (!reserve && cuProp->poolId) {
+            for (int32_t cuId : entry->cuIds[devId]) {
+                cuData* cu = &dev->xclbinInfo.cuList[cuId];
+                if (isCuMatching(cu, cuProp)) availableNum += cuAvailableNum(cu, cuProp, reserve);
+            }
+            continue;
+        }
+        /* the following cus are too loaded to take the request */
+        cuLoadKey limit = {XRM_MAX_CHAN_LOAD_GRANULARITY_1000000 - cuProp->requestLoadUnified, INT32_MAX, INT32_MAX};
+        std::set<cuLoadKey>& byLoad = entry->byLoad[devId];
+        for (auto it = byLoad.begin(); it != byLoad.end() && !(limit < *it); it++) {
+            cuData* cu = &dev->xclbinInfo.cuList[it->cuId];
+            if (isCuMatching(cu, cuProp)) availableNum += cuAvailableNum(cu, cuProp, reserve);
+        }
+    }
+    return (availableNum);
+}
+
+/*
+ * Upper limit of how many times the cu list could be allocated (or reserved, listNum times per
+ * pool) as the system is now. Each request in the list takes the capacity of its own kernel once
+ * for every identical request in the list. devIds[i] is the device the i-th request is bound to,
+ * -1 for any device, or all are -1 if devIds is NULL.
+ *
+ * return: -1 if the list is not valid to get the limit, the caller should try it instead
+ */
+int64_t xrm::system::cuListAvailableLimit(
+    cuProperty* cuProps, const int32_t* devIds, int32_t cuNum, int64_t listNum, bool reserve) {
+    int64_t limit = -1;
+
+    for (int32_t i = 0; i < cuNum; i++) {
+        cuProperty* cuProp = &cuProps[i];
+        int32_t devId = (devIds != NULL) ? devIds[i] : -1;
+        int64_t sameNum = 0;
+
+        if ((cuProp->kernelName[0] == '\0') && (cuProp->kernelAlias[0] == '\0') && (cuProp->cuName[0] == '\0'))
+            return (-1);
+        if (devId < -1 || devId >= m_numDevice) return (-1);
+        for (int32_t j = 0; j < cuNum; j++) {
+            cuProperty* other = &cuProps[j];
+            if (!strcmp(cuProp->kernelName, other->kernelName) && !strcmp(cuProp->kernelAlias, other->kernelAlias) &&
+                !strcmp(cuProp->cuName, other->cuName) && cuProp->requestLoadUnified == other->requestLoadUnified &&
+                cuProp->poolId == other->poolId && devId == ((devIds != NULL) ? devIds[j] : -1))
+                sameNum++;
+        }
+        resolveCuPropertyNames(cuProp);
+        int64_t availableNum = (devId == -1) ? cuAvailableNumOnDevs(cuProp, 0, m_numDevice, reserve)
+                                             : cuAvailableNumOnDevs(cuProp, devId, devId + 1, reserve);
+        availableNum /= sameNum * listNum;
+        if (limit < 0 || availableNum < limit) limit = availableNum;
+    }
+    return (limit);
+}
+
+/*
+ * Count how many times the request could be got by trying it, up to the limit (-1: no limit).
+ * All the trial results are given back at the end, and the allocation service id and reserve
+ * pool id are restored, so the ids are not used up by the trials.
+ *
+ * XRM_SUCCESS: the number is filled into availableNum
+ * Otherwise: the request is invalid, the error of the first trial
+ */
+int32_t xrm::system::countByTrial(int64_t limit,
+                                  size_t resSize,
+                                  const trialFunc& tryOnce,
+                                  const trialReleaseFunc& release,
+                                  int32_t* availableNum) {
+    std::vector<void*> trialRes;
+    uint64_t allocServiceId = m_allocServiceId;
+    uint64_t reservePoolId = m_reservePoolId;
+    int32_t ret = XRM_ERROR_NO_KERNEL;
+
+    while ((limit < 0 || (int64_t)trialRes.size() < limit) && trialRes.size() < INT32_MAX) {
+        void* res = malloc(resSize);
+        memset(res, 0, resSize);
+        ret = tryOnce(res);
+        if (ret != XRM_SUCCESS) {
+            free(res);
+            break;
+        }
+        trialRes.push_back(res);
+    }
+    for (void* res : trialRes) {
+        release(res);
+        free(res);
+    }
+    m_allocServiceId = allocServiceId;
+    m_reservePoolId = reservePoolId;
+
+    *availableNum = trialRes.size();
+    if (trialRes.empty() && ret == XRM_ERROR_INVALID) return (XRM_ERROR_INVALID);
+    return (XRM_SUCCESS);
+}
+
+/*
+ * Check how many times the cu could be allocated now, without allocating it. The number is the
+ * free capacity of the matching cus on the devices available for the client.
+ *
+ * XRM_SUCCESS: the number is filled into availableNum
+ * Otherwise: the request property is invalid
+ *
+ * Lock: should enter lock during the check
+ */
+int32_t xrm::system::resCheckCuAvailableNum(cuProperty* cuProp, int32_t* availableNum) {
+    if ((cuProp == NULL) || (availableNum == NULL)) {
+        logMsg(XRM_LOG_ERROR, "cuProp or availableNum is NULL\n");
         return (XRM_ERROR_INVALID);
     }
     if ((cuProp->kernelName[0] == '\0') && (cuProp->kernelAlias[0] == '\0') && (cuProp->cuName[0] == '\0')) {
         logMsg(XRM_LOG_ERROR, "None of kernel name, kernel alias and cu name are presented\n");
         return (XRM_ERROR_INVALID);
     }
+    if (cuProp->requestLoadUnified <= 0 || cuProp->requestLoadUnified > XRM_MAX_CHAN_LOAD_GRANULARITY_1000000) {
+        logMsg(XRM_LOG_ERROR, "invalid request load (%d)\n", cuProp->requestLoadUnified);
+        return (XRM_ERROR_INVALID);
+    }
+    resolveCuPropertyNames(cuProp);
+    *availableNum = std::min<int64_t>(cuAvailableNumOnDevs(cuProp, 0, m_numDevice, false), INT32_MAX);
+    return (XRM_SUCCESS);
+}
 
-cu_alloc_loop:
-    for (devId = -1; !cuAcquired && (devId < m_numDevice);) {
-        devId = allocDevForClient(&devId, cuProp);
-        if (devId < 0) {
-            break;
-        }
-
-        ret = allocClientFromDev(devId, cuProp);
-        if (ret < 0) {
-            continue;
-        }
-        dev = &m_devList[devId];
-        /*
+/*
+ * Check how many times the cu could be allocated now based on the request property version 2.
+ * The policy only decides which cu is allocated first, so it doesn't change the number.
+ *
+ * XRM_SUCCESS: the number is filled into availableNum
+ * Otherwise: the request property is invalid
+ *
+ * Lock: should enter lock during the check
+ */
+int32_t xrm::system::resCheckCuAvailableNumV2(cuPropertyV2* cuPropV2, int32_t* availableNum) {
+    if ((cuPropV2 == NULL) || (availableNum == NULL)) {
+        logMsg(XRM_LOG_ERROR, "cuProp or availableNum is NULL\n");
+        return (XRM_ERROR_INVALID);
+    }
+    if ((cuPropV2->kernelName[0] == '\0') && (cuPropV2->kernelAlias[0] == '\0') && (cuPropV2->cuName[0] == '\0')) {
+        logMsg(XRM_LOG_ERROR, "None of kernel name, kernel alias and cu name are presented\n");
+        return (XRM_ERROR_INVALID);
+    }
+    if (cuPropV2->requestLoadUnified <= 0 || cuPropV2->requestLoadUnified > XRM_MAX_CHAN_LOAD_GRANULARITY_1000000) {
+        logMsg(XRM_LOG_ERROR, "invalid request load (%d)\n", cuPropV2->requestLoadUnified);
+        return (XRM_ERROR_INVALID);
+    }
+    uint64_t deviceInfoConstraintType =
+        (cuPropV2->deviceInfo >> XRM_DEVICE_INFO_CONSTRAINT_TYPE_SHIFT) & XRM_DEVICE_INFO_CONSTRAINT_TYPE_MASK;
+    uint64_t deviceInfoDeviceIndex =
+        (cuPropV2->deviceInfo >> XRM_DEVICE_INFO_DEVICE_INDEX_SHIFT) & XRM_DEVICE_INFO_DEVICE_INDEX_MASK;
+    cuProperty cuProp;
+    cuPropertyCopyFromV2(&cuProp, cuPropV2);
+    int32_t devBegin, devEnd;
+    switch (deviceInfoConstraintType) {
+        case XRM_DEVICE_INFO_CONSTRAINT_TYPE_NULL: {
+            devBegin = 0;
+            devEnd = m_numDevice;
+            break;
+        }
+        case XRM_DEVICE_INFO_CONSTRAINT_TYPE_HARDWARE_DEVICE_INDEX: {
+            if (deviceInfoDeviceIndex >= (uint64_t)m_numDevice) {
+                logMsg(XRM_LOG_ERROR, "deviceId (%lu) is out of range\n", deviceInfoDeviceIndex);
+                return (XRM_ERROR_INVALID);
+            }
+            devBegin = deviceInfoDeviceIndex;
+            devEnd = devBegin + 1;
+            break;
+        }
+        default: {
+            logMsg(XRM_LOG_ERROR, "invalid device info constraint type\n");
+            return (XRM_ERROR_INVALID);
+        }
+    }
+    *availableNum = std::min<int64_t>(cuAvailableNumOnDevs(&cuProp, devBegin, devEnd, false), INT32_MAX);
+    return (XRM_SUCCESS);
+}
+
+/*
+ * Check how many times the cu list could be allocated now. The lists are tried up to the limit
+ * from the free capacity, so nothing is tried if any cu of the list is not available.
+ *
+ * XRM_SUCCESS: the number is filled into availableNum
+ * Otherwise: the request property is invalid
+ *
+ * Lock: should enter lock during the check
+ */
+int32_t xrm::system::resCheckCuListAvailableNum(cuListProperty* cuListProp, int32_t* availableNum) {
+    if (cuListProp == NULL || availableNum == NULL) return (XRM_ERROR_INVALID);
+    if (cuListProp->cuNum <= 0 || cuListProp->cuNum > XRM_MAX_LIST_CU_NUM) return (XRM_ERROR_INVALID);
+
+    int64_t limit = cuListAvailableLimit(cuListProp->cuProps, NULL, cuListProp->cuNum, 1, false);
+    return (countByTrial(
+        limit, sizeof(cuListResource),
+        [&](void* res) { return (resAllocCuList(cuListProp, (cuListResource*)res)); },
+        [&](void* res) { resReleaseCuList((cuListResource*)res); }, availableNum));
+}
+
+/*
+ * The cu properties of the list V2 and the devices they are bound to, for cuListAvailableLimit().
+ * The cus of the same virtual device index are on any device.
+ *
+ * return: false if the device constraint of any cu is not valid
+ */
+bool xrm::system::cuListPropertiesFromV2(cuListPropertyV2* cuListPropV2,
+                                         std::vector<cuProperty>& cuProps,
+                                         std::vector<int32_t>& devIds) {
+    cuProps.resize(cuListPropV2->cuNum);
+    devIds.resize(cuListPropV2->cuNum);
+    for (int32_t i = 0; i < cuListPropV2->cuNum; i++) {
+        cuPropertyV2* cuPropV2 = &cuListPropV2->cuProps[i];
+        uint64_t deviceInfoConstraintType =
+            (cuPropV2->deviceInfo >> XRM_DEVICE_INFO_CONSTRAINT_TYPE_SHIFT) & XRM_DEVICE_INFO_CONSTRAINT_TYPE_MASK;
+        uint64_t deviceInfoDeviceIndex =
+            (cuPropV2->deviceInfo >> XRM_DEVICE_INFO_DEVICE_INDEX_SHIFT) & XRM_DEVICE_INFO_DEVICE_INDEX_MASK;
+        memset(&cuProps[i], 0, sizeof(cuProperty));
+        cuPropertyCopyFromV2(&cuProps[i], cuPropV2);
+        if (deviceInfoConstraintType == XRM_DEVICE_INFO_CONSTRAINT_TYPE_HARDWARE_DEVICE_INDEX) {
+            if (deviceInfoDeviceIndex >= (uint64_t)m_numDevice) return (false);
+            devIds[i] = deviceInfoDeviceIndex;
+        } else if (deviceInfoConstraintType == XRM_DEVICE_INFO_CONSTRAINT_TYPE_NULL ||
+                   deviceInfoConstraintType == XRM_DEVICE_INFO_CONSTRAINT_TYPE_VIRTUAL_DEVICE_INDEX) {
+            devIds[i] = -1;
+        } else {
+            return (false);
+        }
+    }
+    return (true);
+}
+
+/*
+ * Check how many times the cu list could be allocated now based on the request property version 2.
+ *
+ * Lock: should enter lock during the check
+ */
+int32_t xrm::system::resCheckCuListAvailableNumV2(cuListPropertyV2* cuListPropV2, int32_t* availableNum) {
+    std::vector<cuProperty> cuProps;
+    std::vector<int32_t> devIds;
+    int64_t limit = -1;
+
+    if (cuListPropV2 == NULL || availableNum == NULL) return (XRM_ERROR_INVALID);
+    if (cuListPropV2->cuNum <= 0 || cuListPropV2->cuNum > XRM_MAX_LIST_CU_NUM_V2) return (XRM_ERROR_INVALID);
+
+    if (cuListPropertiesFromV2(cuListPropV2, cuProps, devIds))
+        limit = cuListAvailableLimit(cuProps.data(), devIds.data(), cuListPropV2->cuNum, 1, false);
+    return (countByTrial(
+        limit, sizeof(cuListResourceV2),
+        [&](void* res) { return (resAllocCuListV2(cuListPropV2, (cuListResourceV2*)res)); },
+        [&](void* res) { resReleaseCuListV2((cuListResourceV2*)res); }, availableNum));
+}
+
+/*
+ * Check how many times the cu group could be allocated now. Each group is allocated from one of
+ * the option cu lists, so the limit is the sum of the limits of all the option lists.
+ *
+ * Lock: should enter lock during the check
+ */
+int32_t xrm::system::resCheckCuGroupAvailableNum(cuGroupProperty* cuGroupProp, int32_t* availableNum) {
+    cuListProperty cuListProp;
+    int64_t limit = 0;
+
+    if (cuGroupProp == NULL || availableNum == NULL) return (XRM_ERROR_INVALID);
+    int32_t udfCuGroupIdx = findUdfCuGroup(cuGroupProp->udfCuGroupName);
+    if (udfCuGroupIdx == -1) {
+        logMsg(XRM_LOG_ERROR, "%s : user defined cu group is not declared\n", __func__);
+        return (XRM_ERROR_INVALID);
+    }
+    for (int32_t cuListIdx = 0; cuListIdx < m_udfCuGroups[udfCuGroupIdx].optionUdfCuListNum && limit >= 0;
+         cuListIdx++) {
+        udfCuGroupOptionToCuList(udfCuGroupIdx, cuListIdx, cuGroupProp, &cuListProp);
+        int64_t listLimit = cuListAvailableLimit(cuListProp.cuProps, NULL, cuListProp.cuNum, 1, false);
+        limit = (listLimit < 0) ? -1 : limit + listLimit;
+    }
+    return (countByTrial(
+        limit, sizeof(cuGroupResource),
+        [&](void* res) { return (resAllocCuGroup(cuGroupProp, (cuGroupResource*)res)); },
+        [&](void* res) { resReleaseCuGroup((cuGroupResource*)res); }, availableNum));
+}
+
+/*
+ * Check how many times the cu group could be allocated now based on the request property version 2.
+ *
+ * Lock: should enter lock during the check
+ */
+int32_t xrm::system::resCheckCuGroupAvailableNumV2(cuGroupPropertyV2* cuGroupPropV2, int32_t* availableNum) {
+    cuListPropertyV2* cuListProp;
+    std::vector<cuProperty> cuProps;
+    std::vector<int32_t> devIds;
+    int64_t limit = 0;
+
+    if (cuGroupPropV2 == NULL || availableNum == NULL) return (XRM_ERROR_INVALID);
+    int32_t udfCuGroupIdx = findUdfCuGroupV2(cuGroupPropV2->udfCuGroupName);
+    if (udfCuGroupIdx == -1) {
+        logMsg(XRM_LOG_ERROR, "%s : user defined cu group is not declared\n", __func__);
+        return (XRM_ERROR_INVALID);
+    }
+    cuListProp = (cuListPropertyV2*)malloc(sizeof(cuListPropertyV2));
+    for (int32_t cuListIdx = 0; cuListIdx < m_udfCuGroupsV2[udfCuGroupIdx].optionUdfCuListNum && limit >= 0;
+         cuListIdx++) {
+        udfCuGroupOptionToCuListV2(udfCuGroupIdx, cuListIdx, cuGroupPropV2, cuListProp);
+        int64_t listLimit = -1;
+        if (cuListProp->cuNum > 0 && cuListProp->cuNum <= XRM_MAX_LIST_CU_NUM_V2 &&
+            cuListPropertiesFromV2(cuListProp, cuProps, devIds))
+            listLimit = cuListAvailableLimit(cuProps.data(), devIds.data(), cuListProp->cuNum, 1, false);
+        limit = (listLimit < 0) ? -1 : limit + listLimit;
+    }
+    free(cuListProp);
+    return (countByTrial(
+        limit, sizeof(cuGroupResourceV2),
+        [&](void* res) { return (resAllocCuGroupV2(cuGroupPropV2, (cuGroupResourceV2*)res)); },
+        [&](void* res) { resReleaseCuGroupV2((cuGroupResourceV2*)res); }, availableNum));
+}
+
+/*
+ * Check how many cu pools could be reserved now. The limit is from the cu list of the pool, the
+ * load of each cu could be reserved is counted, the reserve of whole xclbin only takes more.
+ *
+ * Lock: should enter lock during the check
+ */
+int32_t xrm::system::resCheckCuPoolAvailableNum(cuPoolProperty* cuPoolProp, int32_t* availableNum) {
+    cuListProperty* cuListProp;
+    int64_t limit = -1;
+
+    if (cuPoolProp == NULL || availableNum == NULL) return (XRM_ERROR_INVALID);
+    cuListProp = &cuPoolProp->cuListProp;
+    if (cuPoolProp->cuListNum > 0 && cuListProp->cuNum > 0 && cuListProp->cuNum <= XRM_MAX_LIST_CU_NUM)
+        limit = cuListAvailableLimit(cuListProp->cuProps, NULL, cuListProp->cuNum, cuPoolProp->cuListNum, true);
+    return (countByTrial(
+        limit, sizeof(uint64_t),
+        [&](void* res) {
+            *(uint64_t*)res = resReserveCuPool(cuPoolProp);
+            return (*(uint64_t*)res != 0 ? XRM_SUCCESS : XRM_ERROR_NO_KERNEL);
+        },
+        [&](void* res) { resRelinquishCuPool(*(uint64_t*)res); }, availableNum));
+}
+
+/*
+ * Check how many cu pools could be reserved now based on the request property version 2.
+ *
+ * Lock: should enter lock during the check
+ */
+int32_t xrm::system::resCheckCuPoolAvailableNumV2(cuPoolPropertyV2* cuPoolProp, int32_t* availableNum) {
+    cuListPropertyV2* cuListProp;
+    cuPoolResInforV2* cuPoolResInfor;
+    std::vector<cuProperty> cuProps;
+    std::vector<int32_t> devIds;
+    int64_t limit = -1;
+
+    if (cuPoolProp == NULL || availableNum == NULL) return (XRM_ERROR_INVALID);
+    cuListProp = &cuPoolProp->cuListProp;
+    if (cuPoolProp->cuListNum > 0 && cuListProp->cuNum > 0 && cuListProp->cuNum <= XRM_MAX_LIST_CU_NUM_V2 &&
+        cuListPropertiesFromV2(cuListProp, cuProps, devIds))
+        limit = cuListAvailableLimit(cuProps.data(), devIds.data(), cuListProp->cuNum, cuPoolProp->cuListNum, true);
+    /* the reserve information of the trials is not needed */
+    cuPoolResInfor = (cuPoolResInforV2*)malloc(sizeof(cuPoolResInforV2));
+    memset(cuPoolResInfor, 0, sizeof(cuPoolResInforV2));
+    int32_t ret = countByTrial(
+        limit, sizeof(uint64_t),
+        [&](void* res) {
+            *(uint64_t*)res = resReserveCuPoolV2(cuPoolProp, cuPoolResInfor);
+            return (*(uint64_t*)res != 0 ? XRM_SUCCESS : XRM_ERROR_NO_KERNEL);
+        },
+        [&](void* res) { resRelinquishCuPoolV2(*(uint64_t*)res); }, availableNum);
+    free(cuPoolResInfor);
+    return (ret);
+}
+
+/*
+ * Alloc one cu (compute unit) based on the request property.
+ *
+ * XRM_SUCCESS: allocated resouce is recorded by cuRes
+ * Otherwise: failed to allocate the cu resource
+ *
+ * Lock: should enter lock during the cu allocation
+ */
+int32_t xrm::system::resAllocCu(cuProperty* cuProp, cuResource* cuRes, bool updateId) {
+    deviceData* dev;
+    cuData* cu;
+    int32_t ret = 0;
+    uint64_t clientId = cuProp->clientId;
+    int32_t devId, cuId;
+    bool cuAcquired = false;
+    /* First pass will look for kernels already in-use by proc */
+    bool cuAffinityPass = true;
+
+    if ((cuProp == NULL) || (cuRes == NULL)) {
+        logMsg(XRM_LOG_ERROR, "cuProp or cuRes is NULL\n");
+        return (XRM_ERROR_INVALID);
+    }
+    if ((cuProp->kernelName[0] == '\0') && (cuProp->kernelAlias[0] == '\0') && (cuProp->cuName[0] == '\0')) {
+        logMsg(XRM_LOG_ERROR, "None of kernel name, kernel alias and cu name are presented\n");
+        return (XRM_ERROR_INVALID);
+    }
+    resolveCuPropertyNames(cuProp);
+
+cu_alloc_loop:
+    for (devId = -1; !cuAcquired && (devId < m_numDevice);) {
+        devId = allocDevForClient(&devId, cuProp);
+        if (devId < 0) {
+            break;
+        }
+
+        /* none of the cus on this device matches, no need to register client */
+        if (cuCandidatesOnDev(devId, cuProp).empty()) continue;
+        ret = allocClientFromDev(devId, cuProp);
+        if (ret < 0) {
+            continue;
+        }
+        dev = &m_devList[devId];
+        /*
          * Now check whether matching cu is on allocated device
          * if not, free device, increment dev count, re-loop
          */
-        for (cuId = 0; cuId < XRM_MAX_XILINX_KERNELS && cuId < dev->xclbinInfo.numCu && !cuAcquired; cuId++) {
+        for (int32_t candidate : cuCandidatesOnDev(devId, cuProp)) {
+            cuId = candidate;
             cu = &dev->xclbinInfo.cuList[cuId];
 
             /* first attempt to re-use existing kernels; else, use a new kernel */
             if ((cuAffinityPass && cu->numClient == 0) || (!cuAffinityPass && cu->numClient > 0)) continue;
-            /*
-             * compare, 0: equal
-             *
-             * kernel name is presented, compare it; otherwise no need to compare
-             */
-            kernelNameEqual = true;
-            if (cuProp->kernelName[0] != '\0') {
-                if (cu->kernelName.compare(cuProp->kernelName)) kernelNameEqual = false;
-            }
-            /* kernel alias is presented, compare it; otherwise no need to compare */
-            kernelAliasEqual = true;
-            if (cuProp->kernelAlias[0] != '\0') {
-                if (cu->kernelAlias.compare(cuProp->kernelAlias)) kernelAliasEqual = false;
-            }
-            /* cu name is presented, compare it; otherwise no need to compare */
-            cuNameEqual = true;
-            if (cuProp->cuName[0] != '\0') {
-                if (cu->cuName.compare(cuProp->cuName)) cuNameEqual = false;
-            }
-            if (!(kernelNameEqual && kernelAliasEqual && cuNameEqual)) continue;
+            if (!isCuMatching(cu, cuProp)) continue;
             /* alloc channel and register client id */
             ret = allocChanClientFromCu(cu, cuProp, cuRes);
             if (ret != XRM_SUCCESS) {
@@ -2014,6 +2813,7 @@ cu_alloc_loop:
             strncpy(cuRes->xclbinFileName, dev->xclbinName.c_str(), XRM_MAX_NAME_LEN - 1);
             strncpy(cuRes->uuidStr, dev->xclbinInfo.uuidStr.c_str(), XRM_MAX_NAME_LEN - 1);
             cuAcquired = true;
+            break;
         }
 
         if (!cuAcquired) {
@@ -2056,17 +2856,7 @@ int32_t xrm::system::resAllocCuV2(cuPropertyV2* cuPropV2, cuResource* cuRes, boo
     uint64_t deviceInfoDeviceIndex =
         (cuPropV2->deviceInfo >> XRM_DEVICE_INFO_DEVICE_INDEX_SHIFT) & XRM_DEVICE_INFO_DEVICE_INDEX_MASK;
     cuProperty cuProp;
-    strncpy(cuProp.kernelName, cuPropV2->kernelName, XRM_MAX_NAME_LEN - 1);
-    cuProp.kernelName[XRM_MAX_NAME_LEN - 1] = '\0';
-    strncpy(cuProp.kernelAlias, cuPropV2->kernelAlias, XRM_MAX_NAME_LEN - 1);
-    cuProp.kernelAlias[XRM_MAX_NAME_LEN - 1] = '\0';
-    strcpy(cuProp.cuName, "");
-    cuProp.devExcl = cuPropV2->devExcl;
-    cuProp.requestLoadUnified = cuPropV2->requestLoadUnified;
-    cuProp.requestLoadOriginal = cuPropV2->requestLoadOriginal;
-    cuProp.clientId = cuPropV2->clientId;
-    cuProp.clientProcessId = cuPropV2->clientProcessId;
-    cuProp.poolId = cuPropV2->poolId;
+    cuPropertyCopyFromV2(&cuProp, cuPropV2);
     switch (deviceInfoConstraintType) {
         case XRM_DEVICE_INFO_CONSTRAINT_TYPE_NULL: {
             if (cuPropV2->policyInfo == XRM_POLICY_INFO_CONSTRAINT_TYPE_DEV_MOST_USED_FIRST ||
@@ -2100,7 +2890,6 @@ int32_t xrm::system::resAllocCuFromDev(int32_t deviceId, cuProperty* cuProp, cuR
     deviceData* dev;
     cuData* cu;
     int32_t ret = 0;
-    bool kernelNameEqual, kernelAliasEqual, cuNameEqual;
     uint64_t clientId = cuProp->clientId;
     int32_t cuId;
     bool cuAcquired = false;
@@ -2119,6 +2908,7 @@ int32_t xrm::system::resAllocCuFromDev(int32_t deviceId, cuProperty* cuProp, cuR
         logMsg(XRM_LOG_ERROR, "None of kernel name, kernel alias and cu name are presented\n");
         return (XRM_ERROR_INVALID);
     }
+    resolveCuPropertyNames(cuProp);
 
     dev = &m_devList[deviceId];
     if (!dev->isLoaded) {
@@ -2138,31 +2928,13 @@ cu_alloc_from_dev_loop:
      * Now check whether matching cu is on allocated device
      * and try to allocate requested cu.
      */
-    for (cuId = 0; cuId < XRM_MAX_XILINX_KERNELS && cuId < dev->xclbinInfo.numCu && !cuAcquired; cuId++) {
+    for (int32_t candidate : cuCandidatesOnDev(deviceId, cuProp)) {
+        cuId = candidate;
         cu = &dev->xclbinInfo.cuList[cuId];
 
         /* first attempt to re-use existing kernels; else, use a new kernel */
         if ((cuAffinityPass && cu->numClient == 0) || (!cuAffinityPass && cu->numClient > 0)) continue;
-        /*
-         * compare, 0: equal
-         *
-         * kernel name is presented, compare it; otherwise no need to compare
-         */
-        kernelNameEqual = true;
-        if (cuProp->kernelName[0] != '\0') {
-            if (cu->kernelName.compare(cuProp->kernelName)) kernelNameEqual = false;
-        }
-        /* kernel alias is presented, compare it; otherwise no need to compare */
-        kernelAliasEqual = true;
-        if (cuProp->kernelAlias[0] != '\0') {
-            if (cu->kernelAlias.compare(cuProp->kernelAlias)) kernelAliasEqual = false;
-        }
-        /* cu name is presented, compare it; otherwise no need to compare */
-        cuNameEqual = true;
-        if (cuProp->cuName[0] != '\0') {
-            if (cu->cuName.compare(cuProp->cuName)) cuNameEqual = false;
-        }
-        if (!(kernelNameEqual && kernelAliasEqual && cuNameEqual)) continue;
+        if (!isCuMatching(cu, cuProp)) continue;
         /* alloc channel and register client id */
         ret = allocChanClientFromCu(cu, cuProp, cuRes);
         if (ret != XRM_SUCCESS) {
@@ -2174,6 +2946,7 @@ cu_alloc_from_dev_loop:
         strncpy(cuRes->xclbinFileName, dev->xclbinName.c_str(), XRM_MAX_NAME_LEN - 1);
         strncpy(cuRes->uuidStr, dev->xclbinInfo.uuidStr.c_str(), XRM_MAX_NAME_LEN - 1);
         cuAcquired = true;
+        break;
     }
 
     if (!cuAcquired && cuAffinityPass) {
@@ -2205,7 +2978,6 @@ int32_t xrm::system::resAllocLeastUsedCuFromDev(int32_t deviceId,
     deviceData* dev;
     cuData* cu;
     int32_t ret = 0;
-    bool kernelNameEqual, kernelAliasEqual, cuNameEqual;
     uint64_t clientId = cuProp->clientId;
     int32_t cuId;
     std::vector<std::tuple<int32_t, int32_t> > leastUsedCus;
@@ -2223,6 +2995,7 @@ int32_t xrm::system::resAllocLeastUsedCuFromDev(int32_t deviceId,
         logMsg(XRM_LOG_ERROR, "None of kernel name, kernel alias and cu name are presented\n");
         return (XRM_ERROR_INVALID);
     }
+    resolveCuPropertyNames(cuProp);
 
     dev = &m_devList[deviceId];
     if (!dev->isLoaded) {
@@ -2241,31 +3014,13 @@ int32_t xrm::system::resAllocLeastUsedCuFromDev(int32_t deviceId,
      * Now check whether matching cu is on allocated device
      * and try to allocate requested cu.
      */
-    for (cuId = 0; cuId < XRM_MAX_XILINX_KERNELS && cuId < dev->xclbinInfo.numCu && !cuAcquired; cuId++) {
+    for (int32_t candidate : cuCandidatesOnDev(deviceId, cuProp)) {
+        cuId = candidate;
         cu = &dev->xclbinInfo.cuList[cuId];
 
         /* first attempt to use a new kernel */
         if (cu->numClient > 0) continue;
-        /*
-         * compare, 0: equal
-         *
-         * kernel name is presented, compare it; otherwise no need to compare
-         */
-        kernelNameEqual = true;
-        if (cuProp->kernelName[0] != '\0') {
-            if (cu->kernelName.compare(cuProp->kernelName)) kernelNameEqual = false;
-        }
-        /* kernel alias is presented, compare it; otherwise no need to compare */
-        kernelAliasEqual = true;
-        if (cuProp->kernelAlias[0] != '\0') {
-            if (cu->kernelAlias.compare(cuProp->kernelAlias)) kernelAliasEqual = false;
-        }
-        /* cu name is presented, compare it; otherwise no need to compare */
-        cuNameEqual = true;
-        if (cuProp->cuName[0] != '\0') {
-            if (cu->cuName.compare(cuProp->cuName)) cuNameEqual = false;
-        }
-        if (!(kernelNameEqual && kernelAliasEqual && cuNameEqual)) continue;
+        if (!isCuMatching(cu, cuProp)) continue;
         /* alloc channel and register client id */
         ret = allocChanClientFromCu(cu, cuProp, cuRes);
         if (ret != XRM_SUCCESS) {
@@ -2277,6 +3032,7 @@ int32_t xrm::system::resAllocLeastUsedCuFromDev(int32_t deviceId,
         strncpy(cuRes->xclbinFileName, dev->xclbinName.c_str(), XRM_MAX_NAME_LEN - 1);
         strncpy(cuRes->uuidStr, dev->xclbinInfo.uuidStr.c_str(), XRM_MAX_NAME_LEN - 1);
         cuAcquired = true;
+        break;
     }
 
     if (!cuAcquired) {
@@ -2292,29 +3048,11 @@ int32_t xrm::system::resAllocLeastUsedCuFromDev(int32_t deviceId,
     }
 
 cu_alloc_from_dev_loop:
-    for (cuId = 0; cuId < XRM_MAX_XILINX_KERNELS && cuId < dev->xclbinInfo.numCu; cuId++) {
+    for (int32_t candidate : cuCandidatesOnDev(deviceId, cuProp)) {
+        cuId = candidate;
         cu = &dev->xclbinInfo.cuList[cuId];
 
-        /*
-         * compare, 0: equal
-         *
-         * kernel name is presented, compare it; otherwise no need to compare
-         */
-        kernelNameEqual = true;
-        if (cuProp->kernelName[0] != '\0') {
-            if (cu->kernelName.compare(cuProp->kernelName)) kernelNameEqual = false;
-        }
-        /* kernel alias is presented, compare it; otherwise no need to compare */
-        kernelAliasEqual = true;
-        if (cuProp->kernelAlias[0] != '\0') {
-            if (cu->kernelAlias.compare(cuProp->kernelAlias)) kernelAliasEqual = false;
-        }
-        /* cu name is presented, compare it; otherwise no need to compare */
-        cuNameEqual = true;
-        if (cuProp->cuName[0] != '\0') {
-            if (cu->cuName.compare(cuProp->cuName)) cuNameEqual = false;
-        }
-        if (!(kernelNameEqual && kernelAliasEqual && cuNameEqual)) continue;
+        if (!isCuMatching(cu, cuProp)) continue;
 
         int64_t resultLoad = cuProp->requestLoadUnified + cu->totalUsedLoadUnified;
         if (resultLoad <= XRM_MAX_CHAN_LOAD_GRANULARITY_1000000) {
@@ -2361,7 +3099,6 @@ int32_t xrm::system::resAllocCuWithLoad(cuProperty* cuProp, std::string xclbin,
     deviceData* dev;
     cuData* cu;
     int32_t ret = 0;
-    bool kernelNameEqual, kernelAliasEqual, cuNameEqual;
     uint64_t clientId = cuProp->clientId;
     int32_t devId, cuId;
     bool cuAcquired = false;
@@ -2376,6 +3113,7 @@ int32_t xrm::system::resAllocCuWithLoad(cuProperty* cuProp, std::string xclbin,
         logMsg(XRM_LOG_ERROR, "None of kernel name, kernel alias and cu name are presented\n");
         return (XRM_ERROR_INVALID);
     }
+    resolveCuPropertyNames(cuProp);
 
     /*
      * try to allocate the cu from existing resource pool
@@ -2387,6 +3125,8 @@ cu_acquire_loop:
             break;
         }
 
+        /* none of the cus on this device matches, no need to register client */
+        if (cuCandidatesOnDev(devId, cuProp).empty()) continue;
         ret = allocClientFromDev(devId, cuProp);
         if (ret < 0) {
             continue;
@@ -2396,31 +3136,13 @@ cu_acquire_loop:
          * Now check whether matching cu is on allocated device
          * if not, free device, increment dev count, re-loop
          */
-        for (cuId = 0; cuId < XRM_MAX_XILINX_KERNELS && cuId < dev->xclbinInfo.numCu && !cuAcquired; cuId++) {
+        for (int32_t candidate : cuCandidatesOnDev(devId, cuProp)) {
+            cuId = candidate;
             cu = &dev->xclbinInfo.cuList[cuId];
 
             /* first attempt to re-use existing kernels; else, use a new kernel */
             if ((cuAffinityPass && cu->numClient == 0) || (!cuAffinityPass && cu->numClient > 0)) continue;
-            /*
-             * compare, 0: equal
-             *
-             * kernel name is presented, compare it; otherwise no need to compare
-             */
-            kernelNameEqual = true;
-            if (cuProp->kernelName[0] != '\0') {
-                if (cu->kernelName.compare(cuProp->kernelName)) kernelNameEqual = false;
-            }
-            /* kernel alias is presented, compare it; otherwise no need to compare */
-            kernelAliasEqual = true;
-            if (cuProp->kernelAlias[0] != '\0') {
-                if (cu->kernelAlias.compare(cuProp->kernelAlias)) kernelAliasEqual = false;
-            }
-            /* cu name is presented, compare it; otherwise no need to compare */
-            cuNameEqual = true;
-            if (cuProp->cuName[0] != '\0') {
-                if (cu->cuName.compare(cuProp->cuName)) cuNameEqual = false;
-            }
-            if (!(kernelNameEqual && kernelAliasEqual && cuNameEqual)) continue;
+            if (!isCuMatching(cu, cuProp)) continue;
             /* alloc channel and register client id */
             ret = allocChanClientFromCu(cu, cuProp, cuRes);
             if (ret != XRM_SUCCESS) {
@@ -2432,6 +3154,7 @@ cu_acquire_loop:
             strncpy(cuRes->xclbinFileName, dev->xclbinName.c_str(), XRM_MAX_NAME_LEN - 1);
             strncpy(cuRes->uuidStr, dev->xclbinInfo.uuidStr.c_str(), XRM_MAX_NAME_LEN - 1);
             cuAcquired = true;
+            break;
         }
 
         if (!cuAcquired) {
@@ -2459,6 +3182,8 @@ cu_acquire_loop:
         logMsg(XRM_LOG_NOTICE, "%s fail to load xclbin to any device\n", __func__);
         goto cu_acquire_exit;
     }
+    /* names of the new xclbin are in name table now */
+    resolveCuPropertyNames(cuProp);
 
     /*
      * try to allocate the cu from the device loaded with xclbin file
@@ -2469,31 +3194,13 @@ cu_acquire_loop:
     }
     dev = &m_devList[devId];
     /* Now check whether matching cu is on allocated device, if not, free device. */
-    for (cuId = 0; cuId < XRM_MAX_XILINX_KERNELS && cuId < dev->xclbinInfo.numCu && !cuAcquired; cuId++) {
+    for (int32_t candidate : cuCandidatesOnDev(devId, cuProp)) {
+        cuId = candidate;
         cu = &dev->xclbinInfo.cuList[cuId];
 
         /* first attempt to re-use existing kernels; else, use a new kernel */
         if ((cuAffinityPass && cu->numClient == 0) || (!cuAffinityPass && cu->numClient > 0)) continue;
-        /*
-         * compare, 0: equal
-         *
-         * kernel name is presented, compare it; otherwise no need to compare
-         */
-        kernelNameEqual = true;
-        if (cuProp->kernelName[0] != '\0') {
-            if (cu->kernelName.compare(cuProp->kernelName)) kernelNameEqual = false;
-        }
-        /* kernel alias is presented, compare it; otherwise no need to compare */
-        kernelAliasEqual = true;
-        if (cuProp->kernelAlias[0] != '\0') {
-            if (cu->kernelAlias.compare(cuProp->kernelAlias)) kernelAliasEqual = false;
-        }
-        /* cu name is presented, compare it; otherwise no need to compare */
-        cuNameEqual = true;
-        if (cuProp->cuName[0] != '\0') {
-            if (cu->cuName.compare(cuProp->cuName)) cuNameEqual = false;
-        }
-        if (!(kernelNameEqual && kernelAliasEqual && cuNameEqual)) continue;
+        if (!isCuMatching(cu, cuProp)) continue;
         /* alloc channel and register client id */
         ret = allocChanClientFromCu(cu, cuProp, cuRes);
         if (ret != XRM_SUCCESS) {
@@ -2505,6 +3212,7 @@ cu_acquire_loop:
         strncpy(cuRes->xclbinFileName, dev->xclbinName.c_str(), XRM_MAX_NAME_LEN - 1);
         strncpy(cuRes->uuidStr, dev->xclbinInfo.uuidStr.c_str(), XRM_MAX_NAME_LEN - 1);
         cuAcquired = true;
+        break;
     }
 
     if (cuAcquired) {
@@ -2538,7 +3246,6 @@ int32_t xrm::system::resAllocCuLeastUsedWithLoad(cuProperty* cuProp,
     deviceData* dev;
     cuData* cu;
     int32_t ret = 0;
-    bool kernelNameEqual, kernelAliasEqual, cuNameEqual;
     uint64_t clientId = cuProp->clientId;
     int32_t devId, cuId;
     bool cuAcquired = false;
@@ -2554,6 +3261,7 @@ int32_t xrm::system::resAllocCuLeastUsedWithLoad(cuProperty* cuProp,
         logMsg(XRM_LOG_ERROR, "None of kernel name, kernel alias and cu name are presented\n");
         return (XRM_ERROR_INVALID);
     }
+    resolveCuPropertyNames(cuProp);
 
     /*
      * try to allocate the cu from existing resource pool
@@ -2567,6 +3275,8 @@ int32_t xrm::system::resAllocCuLeastUsedWithLoad(cuProperty* cuProp,
         // If user's requested xclbin does not match, keep searching
         if (m_devList[devId].xclbinName != xclbin) continue;
 
+        /* none of the cus on this device matches, no need to register client */
+        if (cuCandidatesOnDev(devId, cuProp).empty()) continue;
         ret = allocClientFromDev(devId, cuProp);
         if (ret < 0) {
             continue;
@@ -2576,31 +3286,13 @@ int32_t xrm::system::resAllocCuLeastUsedWithLoad(cuProperty* cuProp,
          * Now check whether matching cu is on allocated device
          * if not, free device, increment dev count, re-loop
          */
-        for (cuId = 0; cuId < XRM_MAX_XILINX_KERNELS && cuId < dev->xclbinInfo.numCu && !cuAcquired; cuId++) {
+        for (int32_t candidate : cuCandidatesOnDev(devId, cuProp)) {
+            cuId = candidate;
             cu = &dev->xclbinInfo.cuList[cuId];
 
             /* first attempt to use a new kernel */
             if (cu->numClient > 0) continue;
-            /*
-             * compare, 0: equal
-             *
-             * kernel name is presented, compare it; otherwise no need to compare
-             */
-            kernelNameEqual = true;
-            if (cuProp->kernelName[0] != '\0') {
-                if (cu->kernelName.compare(cuProp->kernelName)) kernelNameEqual = false;
-            }
-            /* kernel alias is presented, compare it; otherwise no need to compare */
-            kernelAliasEqual = true;
-            if (cuProp->kernelAlias[0] != '\0') {
-                if (cu->kernelAlias.compare(cuProp->kernelAlias)) kernelAliasEqual = false;
-            }
-            /* cu name is presented, compare it; otherwise no need to compare */
-            cuNameEqual = true;
-            if (cuProp->cuName[0] != '\0') {
-                if (cu->cuName.compare(cuProp->cuName)) cuNameEqual = false;
-            }
-            if (!(kernelNameEqual && kernelAliasEqual && cuNameEqual)) continue;
+            if (!isCuMatching(cu, cuProp)) continue;
             /* alloc channel and register client id */
             ret = allocChanClientFromCu(cu, cuProp, cuRes);
             if (ret != XRM_SUCCESS) {
@@ -2612,6 +3304,7 @@ int32_t xrm::system::resAllocCuLeastUsedWithLoad(cuProperty* cuProp,
             strncpy(cuRes->xclbinFileName, dev->xclbinName.c_str(), XRM_MAX_NAME_LEN - 1);
             strncpy(cuRes->uuidStr, dev->xclbinInfo.uuidStr.c_str(), XRM_MAX_NAME_LEN - 1);
             cuAcquired = true;
+            break;
         }
 
         if (!cuAcquired) {
@@ -2634,6 +3327,8 @@ int32_t xrm::system::resAllocCuLeastUsedWithLoad(cuProperty* cuProp,
         logMsg(XRM_LOG_NOTICE, "%s fail to load xclbin to any device\n", __func__);
         goto cu_acquire_least_used_loop;
     }
+    /* names of the new xclbin are in name table now */
+    resolveCuPropertyNames(cuProp);
 
     /*
      * try to allocate the cu from the device loaded with xclbin file
@@ -2644,29 +3339,11 @@ int32_t xrm::system::resAllocCuLeastUsedWithLoad(cuProperty* cuProp,
     }
     dev = &m_devList[devId];
     /* Now check whether matching cu is on allocated device, if not, free device. */
-    for (cuId = 0; cuId < XRM_MAX_XILINX_KERNELS && cuId < dev->xclbinInfo.numCu && !cuAcquired; cuId++) {
+    for (int32_t candidate : cuCandidatesOnDev(devId, cuProp)) {
+        cuId = candidate;
         cu = &dev->xclbinInfo.cuList[cuId];
 
-        /*
-         * compare, 0: equal
-         *
-         * kernel name is presented, compare it; otherwise no need to compare
-         */
-        kernelNameEqual = true;
-        if (cuProp->kernelName[0] != '\0') {
-            if (cu->kernelName.compare(cuProp->kernelName)) kernelNameEqual = false;
-        }
-        /* kernel alias is presented, compare it; otherwise no need to compare */
-        kernelAliasEqual = true;
-        if (cuProp->kernelAlias[0] != '\0') {
-            if (cu->kernelAlias.compare(cuProp->kernelAlias)) kernelAliasEqual = false;
-        }
-        /* cu name is presented, compare it; otherwise no need to compare */
-        cuNameEqual = true;
-        if (cuProp->cuName[0] != '\0') {
-            if (cu->cuName.compare(cuProp->cuName)) cuNameEqual = false;
-        }
-        if (!(kernelNameEqual && kernelAliasEqual && cuNameEqual)) continue;
+        if (!isCuMatching(cu, cuProp)) continue;
         /* alloc channel and register client id */
         ret = allocChanClientFromCu(cu, cuProp, cuRes);
         if (ret != XRM_SUCCESS) {
@@ -2678,6 +3355,7 @@ int32_t xrm::system::resAllocCuLeastUsedWithLoad(cuProperty* cuProp,
         strncpy(cuRes->xclbinFileName, dev->xclbinName.c_str(), XRM_MAX_NAME_LEN - 1);
         strncpy(cuRes->uuidStr, dev->xclbinInfo.uuidStr.c_str(), XRM_MAX_NAME_LEN - 1);
         cuAcquired = true;
+        break;
     }
 
     if (cuAcquired) {
@@ -2701,6 +3379,8 @@ cu_acquire_least_used_loop:
         // If user's requested xclbin does not match, keep searching
         if (m_devList[devId].xclbinName != xclbin) continue;
 
+        /* none of the cus on this device matches, no need to register client */
+        if (cuCandidatesOnDev(devId, cuProp).empty()) continue;
         ret = allocClientFromDev(devId, cuProp);
         if (ret < 0) {
             continue;
@@ -2711,29 +3391,11 @@ cu_acquire_least_used_loop:
          * if not, free device, increment dev count, re-loop
          */
         // Search all possible cus
-        for (cuId = 0; cuId < XRM_MAX_XILINX_KERNELS && cuId < dev->xclbinInfo.numCu; cuId++) {
+        for (int32_t candidate : cuCandidatesOnDev(devId, cuProp)) {
+            cuId = candidate;
             cu = &dev->xclbinInfo.cuList[cuId];
 
-            /*
-             * compare, 0: equal
-             *
-             * kernel name is presented, compare it; otherwise no need to compare
-             */
-            kernelNameEqual = true;
-            if (cuProp->kernelName[0] != '\0') {
-                if (cu->kernelName.compare(cuProp->kernelName)) kernelNameEqual = false;
-            }
-            /* kernel alias is presented, compare it; otherwise no need to compare */
-            kernelAliasEqual = true;
-            if (cuProp->kernelAlias[0] != '\0') {
-                if (cu->kernelAlias.compare(cuProp->kernelAlias)) kernelAliasEqual = false;
-            }
-            /* cu name is presented, compare it; otherwise no need to compare */
-            cuNameEqual = true;
-            if (cuProp->cuName[0] != '\0') {
-                if (cu->cuName.compare(cuProp->cuName)) cuNameEqual = false;
-            }
-            if (!(kernelNameEqual && kernelAliasEqual && cuNameEqual)) continue;
+            if (!isCuMatching(cu, cuProp)) continue;
 
             int64_t resultLoad = cuProp->requestLoadUnified + cu->totalUsedLoadUnified;
             if (resultLoad <= XRM_MAX_CHAN_LOAD_GRANULARITY_1000000) {
@@ -2864,7 +3526,7 @@ int32_t xrm::system::resAllocCuList(cuListProperty* cuListProp, cuListResource*
 }
 
 /*
- * copy cu property from src prop (V2) to des prop.
+ * copy cu property from src prop (V2) to des prop, the names are resolved to the ids in name table.
  */
 void xrm::system::cuPropertyCopyFromV2(cuProperty* desCuProp, cuPropertyV2* srcCuPropV2) {
     if (desCuProp != NULL && srcCuPropV2 != NULL) {
@@ -2879,6 +3541,7 @@ void xrm::system::cuPropertyCopyFromV2(cuProperty* desCuProp, cuPropertyV2* srcC
         desCuProp->clientId = srcCuPropV2->clientId;
         desCuProp->clientProcessId = srcCuPropV2->clientProcessId;
         desCuProp->poolId = srcCuPropV2->poolId;
+        resolveCuPropertyNames(desCuProp);
     }
 }
 
@@ -3227,6 +3890,7 @@ int32_t xrm::system::resLoadAndAllocAllCu(std::string xclbin,
     dev->clientProcs[0].clientId = clientId;
     dev->clientProcs[0].clientProcessId = clientProcessId;
     dev->clientProcs[0].ref = 1;
+    clientOwnershipAddSlot(clientId, devId, 0);
     if (dev->xclbinInfo.numCu < XRM_MAX_LIST_CU_NUM)
         cuListRes->cuNum = dev->xclbinInfo.numCu;
     else
@@ -3265,10 +3929,13 @@ int32_t xrm::system::resLoadAndAllocAllCu(std::string xclbin,
         cu->numChanInuse = 1;
         cu->clients[0] = clientId;
         cu->numClient = 1;
+        cuUpdateLoadIndex(cu);
+        clientOwnershipAddCu(clientId, cu);
         channel = &cu->channels[0];
         channel->channelLoadUnified = XRM_MAX_CHAN_LOAD_GRANULARITY_1000000;
         channel->channelLoadOriginal = XRM_MAX_CHAN_LOAD_GRANULARITY_100;
         channel->allocServiceId = allocServiceId;
+        cuSetChannelInuse(cu, 0);
         channel->clientId = clientId;
         channel->clientProcessId = clientProcessId;
     }
@@ -3505,6 +4172,87 @@ int32_t xrm::system::resUdfCuGroupUndeclareV2(udfCuGroupInformationV2* udfCuGrou
     return (XRM_SUCCESS);
 }
 
+/*
+ * Find the user defined cu group by name.
+ *
+ * return: index of the cu group in m_udfCuGroups[], -1 if it's not declared
+ */
+int32_t xrm::system::findUdfCuGroup(const std::string& udfCuGroupName) {
+    for (uint32_t cuGroupIdx = 0; cuGroupIdx < m_numUdfCuGroup; cuGroupIdx++) {
+        /* compare, 0: equal */
+        if (!m_udfCuGroups[cuGroupIdx].udfCuGroupName.compare(udfCuGroupName.c_str())) return (cuGroupIdx);
+    }
+    return (-1);
+}
+
+/*
+ * Fill the cu list property from one option cu list of the user defined cu group and the request.
+ */
+void xrm::system::udfCuGroupOptionToCuList(int32_t udfCuGroupIdx,
+                                           int32_t cuListIdx,
+                                           cuGroupProperty* cuGroupProp,
+                                           cuListProperty* cuListProp) {
+    cuListProperty* udfCuListProp = &m_udfCuGroups[udfCuGroupIdx].optionUdfCuListProps[cuListIdx];
+    cuProperty* cuProp;
+    cuProperty* udfCuProp;
+
+    memset(cuListProp, 0, sizeof(cuListProperty));
+    cuListProp->cuNum = udfCuListProp->cuNum;
+    cuListProp->sameDevice = udfCuListProp->sameDevice;
+    for (int32_t i = 0; i < cuListProp->cuNum; i++) {
+        cuProp = &cuListProp->cuProps[i];
+        udfCuProp = &udfCuListProp->cuProps[i];
+        strncpy(cuProp->cuName, udfCuProp->cuName, XRM_MAX_NAME_LEN - 1);
+        cuProp->devExcl = udfCuProp->devExcl;
+        cuProp->requestLoadUnified = udfCuProp->requestLoadUnified;
+        cuProp->requestLoadOriginal = udfCuProp->requestLoadOriginal;
+        cuProp->clientId = cuGroupProp->clientId;
+        cuProp->clientProcessId = cuGroupProp->clientProcessId;
+        cuProp->poolId = cuGroupProp->poolId;
+    }
+}
+
+/*
+ * Find the user defined cu group V2 by name.
+ *
+ * return: index of the cu group in m_udfCuGroupsV2[], -1 if it's not declared
+ */
+int32_t xrm::system::findUdfCuGroupV2(const std::string& udfCuGroupName) {
+    for (uint32_t cuGroupIdx = 0; cuGroupIdx < m_numUdfCuGroupV2; cuGroupIdx++) {
+        /* compare, 0: equal */
+        if (!m_udfCuGroupsV2[cuGroupIdx].udfCuGroupName.compare(udfCuGroupName.c_str())) return (cuGroupIdx);
+    }
+    return (-1);
+}
+
+/*
+ * Fill the cu list property V2 from one option cu list of the user defined cu group V2 and the request.
+ */
+void xrm::system::udfCuGroupOptionToCuListV2(int32_t udfCuGroupIdx,
+                                             int32_t cuListIdx,
+                                             cuGroupPropertyV2* cuGroupPropV2,
+                                             cuListPropertyV2* cuListProp) {
+    cuListPropertyV2* udfCuListProp = &m_udfCuGroupsV2[udfCuGroupIdx].optionUdfCuListProps[cuListIdx];
+    cuPropertyV2* cuProp;
+    cuPropertyV2* udfCuProp;
+
+    memset(cuListProp, 0, sizeof(cuListPropertyV2));
+    cuListProp->cuNum = udfCuListProp->cuNum;
+    for (int32_t i = 0; i < cuListProp->cuNum; i++) {
+        cuProp = &cuListProp->cuProps[i];
+        udfCuProp = &udfCuListProp->cuProps[i];
+        strncpy(cuProp->cuName, udfCuProp->cuName, XRM_MAX_NAME_LEN - 1);
+        cuProp->devExcl = udfCuProp->devExcl;
+        cuProp->deviceInfo = udfCuProp->deviceInfo;
+        cuProp->memoryInfo = udfCuProp->memoryInfo;
+        cuProp->requestLoadUnified = udfCuProp->requestLoadUnified;
+        cuProp->requestLoadOriginal = udfCuProp->requestLoadOriginal;
+        cuProp->clientId = cuGroupPropV2->clientId;
+        cuProp->clientProcessId = cuGroupPropV2->clientProcessId;
+        cuProp->poolId = cuGroupPropV2->poolId;
+    }
+}
+
 /*
  * Alloc one cu group based on the request property.
  *
@@ -3516,41 +4264,18 @@ int32_t xrm::system::resUdfCuGroupUndeclareV2(udfCuGroupInformationV2* udfCuGrou
 int32_t xrm::system::resAllocCuGroup(cuGroupProperty* cuGroupProp, cuGroupResource* cuGroupRes) {
     int32_t ret = XRM_ERROR;
     cuListProperty cuListProp;
-    cuListProperty* udfCuListProp;
-    cuProperty* cuProp;
-    cuProperty* udfCuProp;
     int32_t udfCuGroupIdx = -1;
 
     if (cuGroupProp == NULL || cuGroupRes == NULL) {
         return (XRM_ERROR_INVALID);
     }
-    for (uint32_t cuGroupIdx = 0; cuGroupIdx < m_numUdfCuGroup; cuGroupIdx++) {
-        /* compare, 0: equal */
-        if (!m_udfCuGroups[cuGroupIdx].udfCuGroupName.compare(cuGroupProp->udfCuGroupName.c_str())) {
-            udfCuGroupIdx = cuGroupIdx;
-            break;
-        }
-    }
+    udfCuGroupIdx = findUdfCuGroup(cuGroupProp->udfCuGroupName);
     if (udfCuGroupIdx == -1) {
         logMsg(XRM_LOG_ERROR, "%s : user defined cu group is not declared\n", __func__);
         return (XRM_ERROR_INVALID);
     }
     for (int32_t cuListIdx = 0; cuListIdx < m_udfCuGroups[udfCuGroupIdx].optionUdfCuListNum; cuListIdx++) {
-        memset(&cuListProp, 0, sizeof(cuListProperty));
-        udfCuListProp = &m_udfCuGroups[udfCuGroupIdx].optionUdfCuListProps[cuListIdx];
-        cuListProp.cuNum = udfCuListProp->cuNum;
-        cuListProp.sameDevice = udfCuListProp->sameDevice;
-        for (int32_t i = 0; i < cuListProp.cuNum; i++) {
-            cuProp = &cuListProp.cuProps[i];
-            udfCuProp = &udfCuListProp->cuProps[i];
-            strncpy(cuProp->cuName, udfCuProp->cuName, XRM_MAX_NAME_LEN - 1);
-            cuProp->devExcl = udfCuProp->devExcl;
-            cuProp->requestLoadUnified = udfCuProp->requestLoadUnified;
-            cuProp->requestLoadOriginal = udfCuProp->requestLoadOriginal;
-            cuProp->clientId = cuGroupProp->clientId;
-            cuProp->clientProcessId = cuGroupProp->clientProcessId;
-            cuProp->poolId = cuGroupProp->poolId;
-        }
+        udfCuGroupOptionToCuList(udfCuGroupIdx, cuListIdx, cuGroupProp, &cuListProp);
         memset(cuGroupRes, 0, sizeof(cuGroupResource));
         /*
          * NOTE: here since the cuListResource has same member of cuGroupResource, so it's fine to
@@ -3573,42 +4298,18 @@ int32_t xrm::system::resAllocCuGroup(cuGroupProperty* cuGroupProp, cuGroupResour
 int32_t xrm::system::resAllocCuGroupV2(cuGroupPropertyV2* cuGroupPropV2, cuGroupResourceV2* cuGroupResV2) {
     int32_t ret = XRM_ERROR;
     cuListPropertyV2 cuListProp;
-    cuListPropertyV2* udfCuListProp;
-    cuPropertyV2* cuProp;
-    cuPropertyV2* udfCuProp;
     int32_t udfCuGroupIdx = -1;
 
     if (cuGroupPropV2 == NULL || cuGroupResV2 == NULL) {
         return (XRM_ERROR_INVALID);
     }
-    for (uint32_t cuGroupIdx = 0; cuGroupIdx < m_numUdfCuGroupV2; cuGroupIdx++) {
-        /* compare, 0: equal */
-        if (!m_udfCuGroupsV2[cuGroupIdx].udfCuGroupName.compare(cuGroupPropV2->udfCuGroupName.c_str())) {
-            udfCuGroupIdx = cuGroupIdx;
-            break;
-        }
-    }
+    udfCuGroupIdx = findUdfCuGroupV2(cuGroupPropV2->udfCuGroupName);
     if (udfCuGroupIdx == -1) {
         logMsg(XRM_LOG_ERROR, "%s : user defined cu group is not declared\n", __func__);
         return (XRM_ERROR_INVALID);
     }
     for (int32_t cuListIdx = 0; cuListIdx < m_udfCuGroupsV2[udfCuGroupIdx].optionUdfCuListNum; cuListIdx++) {
-        memset(&cuListProp, 0, sizeof(cuListPropertyV2));
-        udfCuListProp = &m_udfCuGroupsV2[udfCuGroupIdx].optionUdfCuListProps[cuListIdx];
-        cuListProp.cuNum = udfCuListProp->cuNum;
-        for (int32_t i = 0; i < cuListProp.cuNum; i++) {
-            cuProp = &cuListProp.cuProps[i];
-            udfCuProp = &udfCuListProp->cuProps[i];
-            strncpy(cuProp->cuName, udfCuProp->cuName, XRM_MAX_NAME_LEN - 1);
-            cuProp->devExcl = udfCuProp->devExcl;
-            cuProp->deviceInfo = udfCuProp->deviceInfo;
-            cuProp->memoryInfo = udfCuProp->memoryInfo;
-            cuProp->requestLoadUnified = udfCuProp->requestLoadUnified;
-            cuProp->requestLoadOriginal = udfCuProp->requestLoadOriginal;
-            cuProp->clientId = cuGroupPropV2->clientId;
-            cuProp->clientProcessId = cuGroupPropV2->clientProcessId;
-            cuProp->poolId = cuGroupPropV2->poolId;
-        }
+        udfCuGroupOptionToCuListV2(udfCuGroupIdx, cuListIdx, cuGroupPropV2, &cuListProp);
         memset(cuGroupResV2, 0, sizeof(cuGroupResourceV2));
         /*
          * NOTE: here since the cuListResource has same member of cuGroupResource, so it's fine to
@@ -3633,7 +4334,7 @@ int32_t xrm::system::resReleaseCu(cuResource* cuRes) {
     int32_t devId, cuId, chanId;
     uint64_t allocServiceId;
     uint64_t clientId = cuRes->clientId;
-    int32_t i, reserveIdx, procChanCnt = 0;
+    int32_t i, reserveIdx;
     int32_t ret;
 
     devId = cuRes->deviceId;
@@ -3641,7 +4342,7 @@ int32_t xrm::system::resReleaseCu(cuResource* cuRes) {
     cuId = cuRes->cuId;
     if (cuId < 0 || cuId > XRM_MAX_XILINX_KERNELS) return (XRM_ERROR_INVALID);
     chanId = cuRes->channelId;
-    if (chanId < 0 || chanId > XRM_MAX_KERNEL_CHANNELS) return (XRM_ERROR_INVALID);
+    if (chanId < 0 || chanId >= XRM_MAX_KERNEL_CHANNELS) return (XRM_ERROR_INVALID);
     allocServiceId = cuRes->allocServiceId;
 
     ret = XRM_ERROR;
@@ -3654,14 +4355,10 @@ int32_t xrm::system::resReleaseCu(cuResource* cuRes) {
     }
     cu = &dev->xclbinInfo.cuList[cuId];
 
-    for (i = 0; i < XRM_MAX_KERNEL_CHANNELS; i++) {
-        if (cu->channels[i].allocServiceId != allocServiceId || cu->channels[i].poolId != cuRes->poolId ||
-            cu->channels[i].clientId != clientId || cu->channels[i].channelId != chanId) {
-            if (cu->channels[i].clientId == clientId) /* count how many other channel used by the same client */
-                procChanCnt++;
-            continue;
-        }
-
+    /* the channel is addressed by the channel id directly */
+    i = chanId;
+    if (cu->channels[i].allocServiceId == allocServiceId && cu->channels[i].poolId == cuRes->poolId &&
+        cu->channels[i].clientId == clientId) {
         /*
          * For the release cu:
          * if not from reserve pool, then return to Big pool
@@ -3678,19 +4375,23 @@ int32_t xrm::system::resReleaseCu(cuResource* cuRes) {
                 } else {
                     /* From reserve pool, reserve client is NOT active, return resource to default pool */
                     cu->totalUsedLoadUnified -= cu->channels[i].channelLoadUnified;
+                    cuUpdateLoadIndex(cu);
                     updateDeviceLoad(cu->deviceId, -cu->channels[i].channelLoadUnified, -1);
                 }
             } else {
                 /* From reserve pool, reserve client is NOT active, return resource to default pool */
                 cu->totalUsedLoadUnified -= cu->channels[i].channelLoadUnified;
+                cuUpdateLoadIndex(cu);
                 updateDeviceLoad(cu->deviceId, -cu->channels[i].channelLoadUnified, -1);
             }
         } else {
             /* return the resource into default pool */
             cu->totalUsedLoadUnified -= cu->channels[i].channelLoadUnified;
+            cuUpdateLoadIndex(cu);
             updateDeviceLoad(cu->deviceId, -cu->channels[i].channelLoadUnified, -1);
         }
         cu->numChanInuse--;
+        cuSetChannelFree(cu, i);
         cu->channels[i].allocServiceId = 0;
         cu->channels[i].poolId = 0;
         cu->channels[i].clientId = 0;
@@ -3705,10 +4406,11 @@ int32_t xrm::system::resReleaseCu(cuResource* cuRes) {
     }
 
     /* If there is NO other channel used by the same client */
-    if (!procChanCnt) {
+    if (!cuIsClientUsingChannel(cu, clientId)) {
         /* update cu->clients */
         removeClientOnCu(cu, clientId);
     }
+    if (ret == XRM_SUCCESS) notifyCuReleased(cu);
 
     return (ret);
 }
@@ -3898,6 +4600,7 @@ int32_t xrm::system::allocClientFromDev(int32_t devId, cuProperty* cuProp) {
         deviceList[devId].clientProcs[0].clientId = clientId;
         deviceList[devId].clientProcs[0].clientProcessId = clientProcessId;
         deviceList[devId].clientProcs[0].ref = ref + 1;
+        clientOwnershipAddSlot(clientId, devId, 0);
         return (XRM_SUCCESS);
     }
 
@@ -3916,6 +4619,7 @@ int32_t xrm::system::allocClientFromDev(int32_t devId, cuProperty* cuProp) {
             deviceList[devId].clientProcs[pidIdx].clientId = clientId;
             deviceList[devId].clientProcs[pidIdx].clientProcessId = clientProcessId;
             deviceList[devId].clientProcs[pidIdx].ref = 1;
+            clientOwnershipAddSlot(clientId, devId, pidIdx);
             return (XRM_SUCCESS);
         }
 
@@ -3955,7 +4659,6 @@ int32_t xrm::system::allocCuFromDev(int32_t devId, cuProperty* cuProp, cuResourc
     deviceData* dev;
     cuData* cu;
     int32_t ret = 0;
-    bool kernelNameEqual, kernelAliasEqual, cuNameEqual;
     int32_t cuId;
     bool cuAcquired = false;
     /* First pass will look for kernels already in-use by proc */
@@ -3972,6 +4675,7 @@ int32_t xrm::system::allocCuFromDev(int32_t devId, cuProperty* cuProp, cuResourc
         logMsg(XRM_LOG_ERROR, "None of kernel name, kernel alias and cu name are presented\n");
         return (XRM_ERROR_INVALID);
     }
+    resolveCuPropertyNames(cuProp);
 
     dev = &m_devList[devId];
 cu_alloc_again:
@@ -3980,31 +4684,13 @@ cu_alloc_again:
          * Now check whether matching cu is on allocated device
          * if not, free device, increment dev count, re-loop
          */
-        for (cuId = 0; cuId < XRM_MAX_XILINX_KERNELS && cuId < dev->xclbinInfo.numCu && !cuAcquired; cuId++) {
+        for (int32_t candidate : cuCandidatesOnDev(devId, cuProp)) {
+            cuId = candidate;
             cu = &dev->xclbinInfo.cuList[cuId];
 
             /* first attempt to re-use existing kernels; else, use a new kernel */
             if ((cuAffinityPass && cu->numClient == 0) || (!cuAffinityPass && cu->numClient > 0)) continue;
-            /*
-             * compare, 0: equal
-             *
-             * kernel name is presented, compare it; otherwise no need to compare
-             */
-            kernelNameEqual = true;
-            if (cuProp->kernelName[0] != '\0') {
-                if (cu->kernelName.compare(cuProp->kernelName)) kernelNameEqual = false;
-            }
-            /* kernel alias is presented, compare it; otherwise no need to compare */
-            kernelAliasEqual = true;
-            if (cuProp->kernelAlias[0] != '\0') {
-                if (cu->kernelAlias.compare(cuProp->kernelAlias)) kernelAliasEqual = false;
-            }
-            /* cu name is presented, compare it; otherwise no need to compare */
-            cuNameEqual = true;
-            if (cuProp->cuName[0] != '\0') {
-                if (cu->cuName.compare(cuProp->cuName)) cuNameEqual = false;
-            }
-            if (!(kernelNameEqual && kernelAliasEqual && cuNameEqual)) continue;
+            if (!isCuMatching(cu, cuProp)) continue;
             /* alloc channel and register client id */
             ret = allocChanClientFromCu(cu, cuProp, cuRes);
             if (ret != XRM_SUCCESS) continue;
@@ -4014,6 +4700,7 @@ cu_alloc_again:
             strncpy(cuRes->xclbinFileName, dev->xclbinName.c_str(), XRM_MAX_NAME_LEN - 1);
             strncpy(cuRes->uuidStr, dev->xclbinInfo.uuidStr.c_str(), XRM_MAX_NAME_LEN - 1);
             cuAcquired = true;
+            break;
         }
     }
 
@@ -4034,12 +4721,10 @@ cu_alloc_again:
  *
  * Alloc channel from cu, update cu resource pool.
  * if reservation id is set, then allocate the resource from reserve pool.
- * if the policyInfo is set, current cu load is better than precu load, it
- * will update precu to current cu and return XRM_FURTHER_CHECK
+ * The cu of most used / least used policy is selected by findCuByLoad() before.
  *
  */
-int32_t xrm::system::allocChanClientFromCu(
-    cuData* cu, cuProperty* cuProp, cuResource* cuRes, uint64_t policyInfo, cuData** preCu) {
+int32_t xrm::system::allocChanClientFromCu(cuData* cu, cuProperty* cuProp, cuResource* cuRes) {
     uint64_t clientId = cuProp->clientId;
     pid_t clientProcessId = cuProp->clientProcessId;
     int32_t requestLoadUnified = cuProp->requestLoadUnified;
@@ -4064,46 +4749,10 @@ int32_t xrm::system::allocChanClientFromCu(
             cu->reserves[reserveIdx].reserveLoadUnified) {
             return (XRM_ERROR_NO_KERNEL);
         }
-
-        if ((policyInfo == XRM_POLICY_INFO_CONSTRAINT_TYPE_CU_MOST_USED_FIRST ||
-             policyInfo == XRM_POLICY_INFO_CONSTRAINT_TYPE_DEV_MOST_USED_FIRST) &&
-            cu->reserves[reserveIdx].reserveUsedLoadUnified + requestLoadUnified !=
-                cu->reserves[reserveIdx].reserveLoadUnified) { // most used case
-            if (*preCu == NULL || (cu->reserves[reserveIdx].reserveUsedLoadUnified + requestLoadUnified) >
-                                      (*preCu)->reserves[reserveIdx].reserveUsedLoadUnified) {
-                *preCu = cu;
-            }
-            return XRM_FURTHER_CHECK;
-        }
-        if ((policyInfo == XRM_POLICY_INFO_CONSTRAINT_TYPE_CU_LEAST_USED_FIRST ||
-             policyInfo == XRM_POLICY_INFO_CONSTRAINT_TYPE_DEV_LEAST_USED_FIRST) &&
-            cu->reserves[reserveIdx].reserveUsedLoadUnified != 0) { // least used case
-            if (*preCu == NULL || (cu->reserves[reserveIdx].reserveUsedLoadUnified + requestLoadUnified) <
-                                      (*preCu)->reserves[reserveIdx].reserveUsedLoadUnified) {
-                *preCu = cu;
-            }
-            return XRM_FURTHER_CHECK;
-        }
     } else {
         if (cu->totalUsedLoadUnified + requestLoadUnified > XRM_MAX_CHAN_LOAD_GRANULARITY_1000000) {
             return (XRM_ERROR_NO_KERNEL);
         }
-        if ((policyInfo == XRM_POLICY_INFO_CONSTRAINT_TYPE_CU_MOST_USED_FIRST ||
-             policyInfo == XRM_POLICY_INFO_CONSTRAINT_TYPE_DEV_MOST_USED_FIRST) &&
-            cu->totalUsedLoadUnified + requestLoadUnified != XRM_MAX_CHAN_LOAD_GRANULARITY_1000000) {
-            if (*preCu == NULL || (cu->totalUsedLoadUnified > (*preCu)->totalUsedLoadUnified)) {
-                *preCu = cu;
-            }
-            return XRM_FURTHER_CHECK;
-        }
-        if ((policyInfo == XRM_POLICY_INFO_CONSTRAINT_TYPE_CU_LEAST_USED_FIRST ||
-             policyInfo == XRM_POLICY_INFO_CONSTRAINT_TYPE_DEV_LEAST_USED_FIRST) &&
-            cu->totalUsedLoadUnified != 0) {
-            if (*preCu == NULL || (cu->totalUsedLoadUnified < (*preCu)->totalUsedLoadUnified)) {
-                *preCu = cu;
-            }
-            return XRM_FURTHER_CHECK;
-        }
     }
     if (cu->numChanInuse == 0) { /* unused kernel */
         chanId = 0;
@@ -4114,10 +4763,12 @@ int32_t xrm::system::allocChanClientFromCu(
         uint64_t allocServiceId = getNextAllocServiceId();
         cu->channels[chanId].allocServiceId = allocServiceId;
         cu->channels[chanId].poolId = reservePoolId;
+        cuSetChannelInuse(cu, chanId);
         if (reservePoolId)
             cu->reserves[reserveIdx].reserveUsedLoadUnified += requestLoadUnified;
         else {
             cu->totalUsedLoadUnified += requestLoadUnified;
+            cuUpdateLoadIndex(cu);
             updateDeviceLoad(cu->deviceId, requestLoadUnified, -1);
         }
         cu->numChanInuse++;
@@ -4158,10 +4809,12 @@ int32_t xrm::system::allocChanClientFromCu(
         uint64_t allocServiceId = getNextAllocServiceId();
         cu->channels[chanId].allocServiceId = allocServiceId;
         cu->channels[chanId].poolId = reservePoolId;
+        cuSetChannelInuse(cu, chanId);
         if (reservePoolId)
             cu->reserves[reserveIdx].reserveUsedLoadUnified += requestLoadUnified;
         else {
             cu->totalUsedLoadUnified += requestLoadUnified;
+            cuUpdateLoadIndex(cu);
             updateDeviceLoad(cu->deviceId, requestLoadUnified, -1);
         }
         cu->numChanInuse++;
@@ -4215,6 +4868,8 @@ void xrm::system::addClientToCu(cuData* cu, uint64_t clientId) {
 
     cu->clients[i] = clientId;
     cu->numClient++;
+    cuUpdateLoadIndex(cu);
+    clientOwnershipAddCu(clientId, cu);
 
     return;
 }
@@ -4258,6 +4913,8 @@ int32_t xrm::system::releaseClientOnDev(int32_t devId, uint64_t clientId) {
             deviceList[devId].isExcl = false;
             deviceList[devId].clientProcs[0].clientId = 0;
             deviceList[devId].clientProcs[0].clientProcessId = 0;
+            /* all the cu on the device are available to others */
+            notifyAllReleased();
         }
         return (XRM_SUCCESS);
     } else {
@@ -4279,29 +4936,35 @@ int32_t xrm::system::releaseClientOnDev(int32_t devId, uint64_t clientId) {
  * The cu->channels and cu->clients are updated
  */
 void xrm::system::releaseAllCuChanClientOnDev(deviceData* dev, uint64_t clientId) {
-    int32_t i, j;
-
     if (dev == NULL) return;
 
-    for (i = 0; i < XRM_MAX_XILINX_KERNELS && i < dev->xclbinInfo.numCu; i++) {
-        cuData* cu = &dev->xclbinInfo.cuList[i];
+    for (int32_t i = 0; i < XRM_MAX_XILINX_KERNELS && i < dev->xclbinInfo.numCu; i++)
+        releaseCuChanClient(&dev->xclbinInfo.cuList[i], clientId);
+}
 
-        /*
-         * for each CU:
-         * 1) resource NOT allocated from reserve pool: return to Big pool (default pool)
-         * 2) resource allocated from reserve pool:
-         *    2.1) reserve pool is active: return to reserver pool
-         *    2.2) reserve pool is in-active: return to Big pool (default pool)
-         */
+/*
+ * Release the channels of one cu with specified client id
+ * The cu->channels and cu->clients are updated
+ */
+void xrm::system::releaseCuChanClient(cuData* cu, uint64_t clientId) {
+    /*
+     * for each CU:
+     * 1) resource NOT allocated from reserve pool: return to Big pool (default pool)
+     * 2) resource allocated from reserve pool:
+     *    2.1) reserve pool is active: return to reserver pool
+     *    2.2) reserve pool is in-active: return to Big pool (default pool)
+     */
 
-        /* Determine if client is using this cu */
-        if (clientId && (isClientUsingCu(cu, clientId) < 0)) continue;
+    /* Determine if client is using this cu */
+    if (clientId && (isClientUsingCu(cu, clientId) < 0)) return;
 
-        /* Update cu->clients, no empty slot in cu->clients */
-        removeClientOnCu(cu, clientId);
+    /* Update cu->clients, no empty slot in cu->clients */
+    removeClientOnCu(cu, clientId);
 
-        /* clear the channel entries, there maybe empty slot in cu->channels */
-        for (j = 0; j < XRM_MAX_KERNEL_CHANNELS; j++) {
+    /* clear the channel entries, only the channels in use are checked, see cuSetChannelInuse() */
+    for (int32_t w = 0; w < XRM_CHAN_INUSE_MAP_WORDS; w++) {
+        for (uint64_t bits = cu->chanInuseMap[w]; bits; bits &= bits - 1) {
+            int32_t j = w * 64 + __builtin_ctzll(bits);
             uint64_t cu_client = cu->channels[j].clientId;
 
             /* clientId is 0, the channelLoadUnified are also 0 */
@@ -4315,12 +4978,14 @@ void xrm::system::releaseAllCuChanClientOnDev(deviceData* dev, uint64_t clientId
             if (cu->channels[j].poolId == 0) {
                 /* Not allocated from reserve pool, then return to Big pool */
                 cu->totalUsedLoadUnified -= cu->channels[j].channelLoadUnified;
+                cuUpdateLoadIndex(cu);
                 updateDeviceLoad(cu->deviceId, -cu->channels[j].channelLoadUnified, -1);
                 cu->numChanInuse--;
                 cu->channels[j].clientId = 0;
                 cu->channels[j].clientProcessId = 0;
                 cu->channels[j].channelLoadUnified = 0;
                 cu->channels[j].channelLoadOriginal = 0;
+                cuSetChannelFree(cu, j);
                 cu->channels[j].allocServiceId = 0;
                 cu->channels[j].poolId = 0;
             } else {
@@ -4342,23 +5007,26 @@ void xrm::system::releaseAllCuChanClientOnDev(deviceData* dev, uint64_t clientId
                     cu->channels[j].clientProcessId = 0;
                     cu->channels[j].channelLoadUnified = 0;
                     cu->channels[j].channelLoadOriginal = 0;
+                    cuSetChannelFree(cu, j);
                     cu->channels[j].allocServiceId = 0;
                     cu->channels[j].poolId = 0;
                 } else {
                     /* from reserve pool, reserve pool is in-active, return to Big pool */
                     cu->totalUsedLoadUnified -= cu->channels[j].channelLoadUnified;
+                    cuUpdateLoadIndex(cu);
                     updateDeviceLoad(cu->deviceId, -cu->channels[j].channelLoadUnified, -1);
                     cu->numChanInuse--;
                     cu->channels[j].clientId = 0;
                     cu->channels[j].clientProcessId = 0;
                     cu->channels[j].channelLoadUnified = 0;
                     cu->channels[j].channelLoadOriginal = 0;
+                    cuSetChannelFree(cu, j);
                     cu->channels[j].allocServiceId = 0;
                     cu->channels[j].poolId = 0;
                 }
             } // end from reserve pool
-        }     /* end channel clearing loop */
-    }         /* end cu loop */
+        }
+    } /* end channel clearing loop */
 }
 
 /*
@@ -4385,10 +5053,48 @@ void xrm::system::removeClientOnCu(cuData* cu, uint64_t clientId) {
     /* Zero the last item on the old list after defrag */
     cu->clients[i] = 0;
     cu->numClient--;
+    cuUpdateLoadIndex(cu);
+    clientOwnershipRemoveCu(clientId, cu);
 
     return;
 }
 
+/*
+ * The capacity of the cu is freed, wake up the blocking allocations waiting for the kernel.
+ * Called while holding lock.
+ */
+void xrm::system::notifyCuReleased(cuData* cu) {
+    if (m_waitQueue) m_waitQueue->notify(cu->kernelName, cu->kernelAlias);
+    publishEvent(XRM_EVENT_CU_AVAILABLE, cu->deviceId, 0, cu);
+}
+
+/*
+ * The capacity of more than one kernel may be freed, wake up all the blocking allocations.
+ * Called while holding lock.
+ */
+void xrm::system::notifyAllReleased() {
+    if (m_waitQueue) m_waitQueue->notifyAll();
+    publishEvent(XRM_EVENT_CU_AVAILABLE, -1);
+}
+
+/*
+ * Push the event to the subscribed connections. Called while holding lock.
+ */
+void xrm::system::publishEvent(xrmEventType type, int32_t devId, uint64_t poolId, cuData* cu) {
+    xrmEvent event;
+
+    if (m_eventHub == NULL) return;
+    memset(&event, 0, sizeof(event));
+    event.type = type;
+    event.deviceId = devId;
+    event.poolId = poolId;
+    if (cu) {
+        strncpy(event.kernelName, cu->kernelName.c_str(), XRM_MAX_NAME_LEN - 1);
+        strncpy(event.kernelAlias, cu->kernelAlias.c_str(), XRM_MAX_NAME_LEN - 1);
+    }
+    m_eventHub->publish(event);
+}
+
 /*
  * check cu stat
  *
@@ -4481,22 +5187,51 @@ void xrm::system::updateAllocServiceId() {
         m_allocServiceId++;
 }
 
+/*
+ * Fill the cu resource of one channel given to the allocation service id.
+ */
+void xrm::system::fillAllocatedCuResource(const allocServiceEntry& entry, cuResource* cuRes) {
+    deviceData* dev = &m_devList[entry.deviceId];
+    cuData* cu = &dev->xclbinInfo.cuList[entry.cuId];
+    channelData* chan = &cu->channels[entry.channelId];
+
+    strncpy(cuRes->xclbinFileName, dev->xclbinName.c_str(), XRM_MAX_NAME_LEN - 1);
+    strncpy(cuRes->uuidStr, dev->xclbinInfo.uuidStr.c_str(), XRM_MAX_NAME_LEN - 1);
+    strncpy(cuRes->kernelPluginFileName, cu->kernelPluginFileName.c_str(), XRM_MAX_NAME_LEN - 1);
+    strncpy(cuRes->kernelName, cu->kernelName.c_str(), XRM_MAX_NAME_LEN - 1);
+    strncpy(cuRes->instanceName, cu->instanceName.c_str(), XRM_MAX_NAME_LEN - 1);
+    strncpy(cuRes->kernelAlias, cu->kernelAlias.c_str(), XRM_MAX_NAME_LEN - 1);
+    strncpy(cuRes->cuName, cu->cuName.c_str(), XRM_MAX_NAME_LEN - 1);
+    cuRes->cuType = cu->cuType;
+    cuRes->baseAddr = cu->baseAddr;
+    cuRes->membankId = cu->membankId;
+    cuRes->membankType = cu->membankType;
+    cuRes->membankSize = cu->membankSize;
+    cuRes->membankBaseAddr = cu->membankBaseAddr;
+    cuRes->deviceId = entry.deviceId;
+    cuRes->cuId = entry.cuId;
+    cuRes->channelId = entry.channelId;
+    cuRes->allocServiceId = chan->allocServiceId;
+    cuRes->poolId = chan->poolId;
+    cuRes->clientId = chan->clientId;
+    cuRes->channelLoadUnified = chan->channelLoadUnified;
+    cuRes->channelLoadOriginal = chan->channelLoadOriginal;
+}
+
 /*
  * Query allocated cu resource from system based on the query property.
  *
+ * The channels of the allocation service id are looked up from m_allocServiceIndex, in the
+ * same order as walking all the devices, cus and channels.
+ *
  * XRM_SUCCESS: queried resouces are filled into cuListRes
  * Otherwise: failed to query the allocated resource
  *
  * Lock: should enter lock during the resource allocation query
  */
 int32_t xrm::system::resAllocationQuery(allocationQueryInfo* allocQuery, cuListResource* cuListRes) {
-    int32_t devId, cuId, chanId;
     uint64_t allocServiceId;
-    bool kernelNameEqual, kernelAliasEqual;
-    deviceData* dev = NULL;
     cuData* cu = NULL;
-    channelData* chan = NULL;
-    cuResource* cuRes = NULL;
     int32_t cuNum;
 
     if (allocQuery == NULL || cuListRes == NULL) {
@@ -4509,57 +5244,21 @@ int32_t xrm::system::resAllocationQuery(allocationQueryInfo* allocQuery, cuListR
 
     cuNum = 0;
     memset(cuListRes, 0, sizeof(cuListResource));
-    /* Check all the devices */
-    for (devId = 0; devId < m_numDevice; devId++) {
-        dev = &m_devList[devId];
-        /* Check all the cu on this device */
-        for (cuId = 0; cuId < dev->xclbinInfo.numCu; cuId++) {
-            cu = &dev->xclbinInfo.cuList[cuId];
+    auto it = m_allocServiceIndex.find(allocServiceId);
+    if (it != m_allocServiceIndex.end()) {
+        for (const allocServiceEntry& entry : it->second) {
+            cu = &m_devList[entry.deviceId].xclbinInfo.cuList[entry.cuId];
             /* kernel name is presented, compare it; otherwise no need to compare */
-            kernelNameEqual = true;
-            if (allocQuery->kernelName[0] != '\0') {
-                if (cu->kernelName.compare(allocQuery->kernelName)) kernelNameEqual = false;
-            }
+            if (allocQuery->kernelName[0] != '\0' && cu->kernelName.compare(allocQuery->kernelName)) continue;
             /* kernel alias is presented, compare it; otherwise no need to compare */
-            kernelAliasEqual = true;
-            if (allocQuery->kernelAlias[0] != '\0') {
-                if (cu->kernelAlias.compare(allocQuery->kernelAlias)) kernelAliasEqual = false;
-            }
-            if (!(kernelNameEqual && kernelAliasEqual)) continue;
-            /* Check all the channels on this cu */
-            for (chanId = 0; chanId < XRM_MAX_KERNEL_CHANNELS; chanId++) {
-                chan = &cu->channels[chanId];
-                if (chan->allocServiceId == allocServiceId) {
-                    /* out of cu list limitation */
-                    if (cuNum >= XRM_MAX_LIST_CU_NUM) {
-                        memset(cuListRes, 0, sizeof(cuListResource));
-                        return (XRM_ERROR);
-                    }
-                    cuRes = &cuListRes->cuResources[cuNum];
-                    strncpy(cuRes->xclbinFileName, dev->xclbinName.c_str(), XRM_MAX_NAME_LEN - 1);
-                    strncpy(cuRes->uuidStr, dev->xclbinInfo.uuidStr.c_str(), XRM_MAX_NAME_LEN - 1);
-                    strncpy(cuRes->kernelPluginFileName, cu->kernelPluginFileName.c_str(), XRM_MAX_NAME_LEN - 1);
-                    strncpy(cuRes->kernelName, cu->kernelName.c_str(), XRM_MAX_NAME_LEN - 1);
-                    strncpy(cuRes->instanceName, cu->instanceName.c_str(), XRM_MAX_NAME_LEN - 1);
-                    strncpy(cuRes->kernelAlias, cu->kernelAlias.c_str(), XRM_MAX_NAME_LEN - 1);
-                    strncpy(cuRes->cuName, cu->cuName.c_str(), XRM_MAX_NAME_LEN - 1);
-                    cuRes->cuType = cu->cuType;
-                    cuRes->baseAddr = cu->baseAddr;
-                    cuRes->membankId = cu->membankId;
-                    cuRes->membankType = cu->membankType;
-                    cuRes->membankSize = cu->membankSize;
-                    cuRes->membankBaseAddr = cu->membankBaseAddr;
-                    cuRes->deviceId = devId;
-                    cuRes->cuId = cuId;
-                    cuRes->channelId = chanId;
-                    cuRes->allocServiceId = allocServiceId;
-                    cuRes->poolId = chan->poolId;
-                    cuRes->clientId = chan->clientId;
-                    cuRes->channelLoadUnified = chan->channelLoadUnified;
-                    cuRes->channelLoadOriginal = chan->channelLoadOriginal;
-                    cuNum++;
-                }
+            if (allocQuery->kernelAlias[0] != '\0' && cu->kernelAlias.compare(allocQuery->kernelAlias)) continue;
+            /* out of cu list limitation */
+            if (cuNum >= XRM_MAX_LIST_CU_NUM) {
+                memset(cuListRes, 0, sizeof(cuListResource));
+                return (XRM_ERROR);
             }
+            fillAllocatedCuResource(entry, &cuListRes->cuResources[cuNum]);
+            cuNum++;
         }
     }
     cuListRes->cuNum = cuNum;
@@ -4575,178 +5274,135 @@ int32_t xrm::system::resAllocationQuery(allocationQueryInfo* allocQuery, cuListR
  * Lock: should enter lock during the resource allocation query
  */
 int32_t xrm::system::resAllocationQueryV2(allocationQueryInfoV2* allocQueryV2, cuListResourceV2* cuListResV2) {
-    int32_t devId, cuId, chanId;
     uint64_t allocServiceId;
-    bool kernelNameEqual, kernelAliasEqual;
-    deviceData* dev = NULL;
     cuData* cu = NULL;
-    channelData* chan = NULL;
-    cuResource* cuRes = NULL;
     int32_t cuNum;
-
-    if (allocQueryV2 == NULL || cuListResV2 == NULL) {
-        return (XRM_ERROR_INVALID);
-    }
-    allocServiceId = allocQueryV2->allocServiceId;
-    if (allocServiceId == 0) {
-        return (XRM_ERROR_INVALID);
-    }
-
-    cuNum = 0;
-    memset(cuListResV2, 0, sizeof(cuListResourceV2));
-    /* Check all the devices */
-    for (devId = 0; devId < m_numDevice; devId++) {
-        dev = &m_devList[devId];
-        /* Check all the cu on this device */
-        for (cuId = 0; cuId < dev->xclbinInfo.numCu; cuId++) {
-            cu = &dev->xclbinInfo.cuList[cuId];
-            /* kernel name is presented, compare it; otherwise no need to compare */
-            kernelNameEqual = true;
-            if (allocQueryV2->kernelName[0] != '\0') {
-                if (cu->kernelName.compare(allocQueryV2->kernelName)) kernelNameEqual = false;
-            }
-            /* kernel alias is presented, compare it; otherwise no need to compare */
-            kernelAliasEqual = true;
-            if (allocQueryV2->kernelAlias[0] != '\0') {
-                if (cu->kernelAlias.compare(allocQueryV2->kernelAlias)) kernelAliasEqual = false;
-            }
-            if (!(kernelNameEqual && kernelAliasEqual)) continue;
-            /* Check all the channels on this cu */
-            for (chanId = 0; chanId < XRM_MAX_KERNEL_CHANNELS; chanId++) {
-                chan = &cu->channels[chanId];
-                if (chan->allocServiceId == allocServiceId) {
-                    /* out of cu list limitation */
-                    if (cuNum >= XRM_MAX_LIST_CU_NUM_V2) {
-                        memset(cuListResV2, 0, sizeof(cuListResource));
-                        return (XRM_ERROR);
-                    }
-                    cuRes = &cuListResV2->cuResources[cuNum];
-                    strncpy(cuRes->xclbinFileName, dev->xclbinName.c_str(), XRM_MAX_NAME_LEN - 1);
-                    strncpy(cuRes->uuidStr, dev->xclbinInfo.uuidStr.c_str(), XRM_MAX_NAME_LEN - 1);
-                    strncpy(cuRes->kernelPluginFileName, cu->kernelPluginFileName.c_str(), XRM_MAX_NAME_LEN - 1);
-                    strncpy(cuRes->kernelName, cu->kernelName.c_str(), XRM_MAX_NAME_LEN - 1);
-                    strncpy(cuRes->instanceName, cu->instanceName.c_str(), XRM_MAX_NAME_LEN - 1);
-                    strncpy(cuRes->kernelAlias, cu->kernelAlias.c_str(), XRM_MAX_NAME_LEN - 1);
-                    strncpy(cuRes->cuName, cu->cuName.c_str(), XRM_MAX_NAME_LEN - 1);
-                    cuRes->cuType = cu->cuType;
-                    cuRes->baseAddr = cu->baseAddr;
-                    cuRes->membankId = cu->membankId;
-                    cuRes->membankType = cu->membankType;
-                    cuRes->membankSize = cu->membankSize;
-                    cuRes->membankBaseAddr = cu->membankBaseAddr;
-                    cuRes->deviceId = devId;
-                    cuRes->cuId = cuId;
-                    cuRes->channelId = chanId;
-                    cuRes->allocServiceId = allocServiceId;
-                    cuRes->poolId = chan->poolId;
-                    cuRes->clientId = chan->clientId;
-                    cuRes->channelLoadUnified = chan->channelLoadUnified;
-                    cuRes->channelLoadOriginal = chan->channelLoadOriginal;
-                    cuNum++;
-                }
+
+    if (allocQueryV2 == NULL || cuListResV2 == NULL) {
+        return (XRM_ERROR_INVALID);
+    }
+    allocServiceId = allocQueryV2->allocServiceId;
+    if (allocServiceId == 0) {
+        return (XRM_ERROR_INVALID);
+    }
+
+    cuNum = 0;
+    memset(cuListResV2, 0, sizeof(cuListResourceV2));
+    auto it = m_allocServiceIndex.find(allocServiceId);
+    if (it != m_allocServiceIndex.end()) {
+        for (const allocServiceEntry& entry : it->second) {
+            cu = &m_devList[entry.deviceId].xclbinInfo.cuList[entry.cuId];
+            /* kernel name is presented, compare it; otherwise no need to compare */
+            if (allocQueryV2->kernelName[0] != '\0' && cu->kernelName.compare(allocQueryV2->kernelName)) continue;
+            /* kernel alias is presented, compare it; otherwise no need to compare */
+            if (allocQueryV2->kernelAlias[0] != '\0' && cu->kernelAlias.compare(allocQueryV2->kernelAlias)) continue;
+            /* out of cu list limitation */
+            if (cuNum >= XRM_MAX_LIST_CU_NUM_V2) {
+                memset(cuListResV2, 0, sizeof(cuListResourceV2));
+                return (XRM_ERROR);
             }
+            fillAllocatedCuResource(entry, &cuListResV2->cuResources[cuNum]);
+            cuNum++;
         }
     }
     cuListResV2->cuNum = cuNum;
     return (XRM_SUCCESS);
 }
 
+/*
+ * Release all the cu resource given to one allocation service id, the client doesn't need
+ * to keep the device id, cu id and channel id of each channel.
+ *
+ * XRM_SUCCESS: all the channels are released, the number of them is returned in cuNum
+ * XRM_ERROR_INVALID: invalid client id or allocation service id
+ * XRM_ERROR: no channel is given to the allocation service id, or some of them are not owned
+ *            by the client, nothing is released
+ *
+ * Lock: should enter lock during the release, the channels may be on different devices
+ */
+int32_t xrm::system::resReleaseAllocServiceV2(uint64_t clientId, uint64_t allocServiceId, int32_t* cuNum) {
+    if (cuNum == NULL || clientId == 0 || allocServiceId == 0) return (XRM_ERROR_INVALID);
+    *cuNum = 0;
+
+    auto it = m_allocServiceIndex.find(allocServiceId);
+    if (it == m_allocServiceIndex.end()) return (XRM_ERROR);
+    /* resReleaseCu() removes the entries from the index, so work on a copy */
+    std::vector<allocServiceEntry> entries = it->second;
+    std::vector<cuResource> cuRes(entries.size());
+    for (size_t i = 0; i < entries.size(); i++) {
+        memset(&cuRes[i], 0, sizeof(cuResource));
+        fillAllocatedCuResource(entries[i], &cuRes[i]);
+        if (cuRes[i].clientId != clientId) return (XRM_ERROR);
+    }
+    for (size_t i = 0; i < cuRes.size(); i++) {
+        if (resReleaseCu(&cuRes[i]) == XRM_SUCCESS) (*cuNum)++;
+    }
+    return (XRM_SUCCESS);
+}
+
 /*
  * Recycle all resource from client whose connection is broken.
  */
 void xrm::system::recycleResource(uint64_t clientId) {
     deviceData* dev = NULL;
-    cuData* cu = NULL;
     int32_t devId;
-    int64_t tmp_sum = 0;
 
-    /* Check all the devices */
-    for (devId = 0; devId < m_numDevice; devId++) {
-        dev = &m_devList[devId];
-        if (!dev->isLoaded) continue;
+    auto it = m_clientOwnership.find(clientId);
+    if (it != m_clientOwnership.end()) {
+        /* the release below updates the record, so take it out first */
+        clientOwnership owned = std::move(it->second);
+        m_clientOwnership.erase(it);
 
-        /* relinquish all reserved resource from the client */
-        /*
-         * for each CU:
-         * 1) no resource still allocated from pool of this client: reserved resource back to
-         *    Big pool (default pool), de-active the client and remove reserve pool
-         * 2) resource allocated from pool of this client: reserved but not allocated back
-         *    to Big pool (default pool), de-active the client and remove reserve pool
-         */
-        for (int32_t cuId = 0; cuId < dev->xclbinInfo.numCu; cuId++) {
-            cu = &dev->xclbinInfo.cuList[cuId];
-            for (int32_t reserveIdx = 0; reserveIdx < cu->numReserve; reserveIdx++) {
-                if (!cu->reserves[reserveIdx].clientIsActive) continue;
-                if (cu->reserves[reserveIdx].clientId == clientId) {
-                    int64_t tmp =
-                        cu->reserves[reserveIdx].reserveLoadUnified - cu->reserves[reserveIdx].reserveUsedLoadUnified;
-                    cu->totalUsedLoadUnified -= tmp;
-                    tmp_sum -= tmp;
-                    cu->totalReservedLoadUnified -= cu->reserves[reserveIdx].reserveLoadUnified;
-                    /*
-                     * To de-active the client and remove reserve pool.
-                     * The allocated resource from this reserve pool will be directly return
-                     * to Big pool in future (either during release or recycle) since the pool is de-active.
-                     */
-                    cu->reserves[reserveIdx].clientIsActive = false;
-                    cu->reserves[reserveIdx].reserveLoadUnified = 0;
+        uint32_t devMask = owned.devMask;
+        for (const auto& loc : owned.cus) devMask |= (1u << loc.first);
+        for (const auto& loc : owned.reserveCus) devMask |= (1u << loc.first);
 
-                    /* switch the slot until the last one */
-                    int32_t i;
-                    for (i = reserveIdx; i < cu->numReserve - 1; i++) {
-                        cu->reserves[i].reserveLoadUnified = cu->reserves[i + 1].reserveLoadUnified;
-                        cu->reserves[i].reserveUsedLoadUnified = cu->reserves[i + 1].reserveUsedLoadUnified;
-                        cu->reserves[i].reservePoolId = cu->reserves[i + 1].reservePoolId;
-                        cu->reserves[i].clientIsActive = cu->reserves[i + 1].clientIsActive;
-                        cu->reserves[i].clientId = cu->reserves[i + 1].clientId;
-                        cu->reserves[i].clientProcessId = cu->reserves[i + 1].clientProcessId;
-                    }
-                    /* empty the last slot */
-                    cu->reserves[i].reserveLoadUnified = 0;
-                    cu->reserves[i].reserveUsedLoadUnified = 0;
-                    cu->reserves[i].reservePoolId = 0;
-                    cu->reserves[i].clientIsActive = false;
-                    cu->reserves[i].clientId = 0;
-                    cu->reserves[i].clientProcessId = 0;
-                    cu->numReserve--;
-                    /* removed one slot, so set the reserveIdx to the right one */
-                    reserveIdx--;
-                }
+        /* Check the devices the client ever used */
+        for (devId = 0; devId < m_numDevice; devId++) {
+            if (!(devMask & (1u << devId))) continue;
+            dev = &m_devList[devId];
+            if (!dev->isLoaded) continue;
+            auto cuBegin = std::make_pair(devId, 0);
+            auto cuEnd = std::make_pair(devId + 1, 0);
+
+            /* relinquish all reserved resource from the client */
+            int64_t loadRelinquished = 0;
+            for (auto loc = owned.reserveCus.lower_bound(cuBegin); loc != owned.reserveCus.lower_bound(cuEnd);
+                 loc++) {
+                if (loc->second >= dev->xclbinInfo.numCu) continue;
+                loadRelinquished += relinquishCuReserveClient(&dev->xclbinInfo.cuList[loc->second], clientId);
             }
-        } // endif relinquish
+            if (loadRelinquished) updateDeviceLoad(devId, -loadRelinquished, -1);
 
-        updateDeviceLoad(devId, tmp_sum, 0);
-        /* release all allocated resource from the client */
-        /*
-         * for each CU:
-         * 1) resource NOT allocated from reserve pool: return to Big pool (default pool)
-         * 2) resource allocated from reserve pool:
-         *    2.1) reserve pool is active: return to reserver pool
-         *    2.2) reserve pool is in-active: return to Big pool (default pool)
-         */
-        if (dev->isExcl) {
-            if (dev->clientProcs[0].ref == 0) break;
+            /* release all allocated resource from the client */
+            /*
+             * for each CU:
+             * 1) resource NOT allocated from reserve pool: return to Big pool (default pool)
+             * 2) resource allocated from reserve pool:
+             *    2.1) reserve pool is active: return to reserver pool
+             *    2.2) reserve pool is in-active: return to Big pool (default pool)
+             */
+            if (!(owned.devMask & (1u << devId))) continue;
+            int32_t slot = dev->isExcl ? 0 : owned.devSlot[devId];
+            if (dev->clientProcs[slot].ref == 0 || dev->clientProcs[slot].clientId != clientId) continue;
             /* recycle the resource from the client */
-            if (dev->clientProcs[0].clientId == clientId) {
-                releaseAllCuChanClientOnDev(dev, clientId);
+            for (auto loc = owned.cus.lower_bound(cuBegin); loc != owned.cus.lower_bound(cuEnd); loc++) {
+                if (loc->second >= dev->xclbinInfo.numCu) continue;
+                releaseCuChanClient(&dev->xclbinInfo.cuList[loc->second], clientId);
+            }
+            if (dev->isExcl) {
                 dev->isExcl = false;
                 memset(dev->clientProcs, 0, sizeof(clientData) * XRM_MAX_DEV_CLIENTS);
-            }
-        } else {
-            for (int32_t i = 0; i < XRM_MAX_DEV_CLIENTS; i++) {
-                if (dev->clientProcs[i].ref == 0) continue;
-                /* recycle the resource from the client */
-                if (dev->clientProcs[i].clientId == clientId) {
-                    releaseAllCuChanClientOnDev(dev, clientId);
-                    dev->clientProcs[i].clientId = 0;
-                    dev->clientProcs[i].clientProcessId = 0;
-                    dev->clientProcs[i].ref = 0;
-                }
+            } else {
+                dev->clientProcs[slot].clientId = 0;
+                dev->clientProcs[slot].clientProcessId = 0;
+                dev->clientProcs[slot].ref = 0;
             }
         } // end of release
     }
 
     decNumConcurrentClient();
+    notifyAllReleased();
     /* The save() function is time cost operation, so decide to not it here. */
     // save();
 }
@@ -4776,6 +5432,113 @@ void xrm::system::updateReservePoolId() {
         m_reservePoolId++;
 }
 
+/*
+ * Relinquish all the reserves of the client on the cu:
+ * 1) no resource still allocated from pool of this client: reserved resource back to
+ *    Big pool (default pool), de-active the client and remove reserve pool
+ * 2) resource allocated from pool of this client: reserved but not allocated back
+ *    to Big pool (default pool), de-active the client and remove reserve pool
+ *
+ * return: the load given back to Big pool, the caller updates the device load
+ */
+int64_t xrm::system::relinquishCuReserveClient(cuData* cu, uint64_t clientId) {
+    int64_t loadRelinquished = 0;
+
+    for (int32_t reserveIdx = 0; reserveIdx < cu->numReserve; reserveIdx++) {
+        if (!cu->reserves[reserveIdx].clientIsActive) continue;
+        if (cu->reserves[reserveIdx].clientId == clientId) {
+            int64_t tmp = cu->reserves[reserveIdx].reserveLoadUnified - cu->reserves[reserveIdx].reserveUsedLoadUnified;
+            cu->totalUsedLoadUnified -= tmp;
+            cuUpdateLoadIndex(cu);
+            loadRelinquished += tmp;
+            cu->totalReservedLoadUnified -= cu->reserves[reserveIdx].reserveLoadUnified;
+            /*
+             * To de-active the client and remove reserve pool.
+             * The allocated resource from this reserve pool will be directly return
+             * to Big pool in future (either during release or recycle) since the pool is de-active.
+             */
+            cu->reserves[reserveIdx].clientIsActive = false;
+            cu->reserves[reserveIdx].reserveLoadUnified = 0;
+
+            /* switch the slot until the last one */
+            int32_t i;
+            for (i = reserveIdx; i < cu->numReserve - 1; i++) {
+                cu->reserves[i].reserveLoadUnified = cu->reserves[i + 1].reserveLoadUnified;
+                cu->reserves[i].reserveUsedLoadUnified = cu->reserves[i + 1].reserveUsedLoadUnified;
+                cu->reserves[i].reservePoolId = cu->reserves[i + 1].reservePoolId;
+                cu->reserves[i].clientIsActive = cu->reserves[i + 1].clientIsActive;
+                cu->reserves[i].clientId = cu->reserves[i + 1].clientId;
+                cu->reserves[i].clientProcessId = cu->reserves[i + 1].clientProcessId;
+            }
+            /* empty the last slot */
+            cu->reserves[i].reserveLoadUnified = 0;
+            cu->reserves[i].reserveUsedLoadUnified = 0;
+            cu->reserves[i].reservePoolId = 0;
+            cu->reserves[i].clientIsActive = false;
+            cu->reserves[i].clientId = 0;
+            cu->reserves[i].clientProcessId = 0;
+            cu->numReserve--;
+            /* removed one slot, so set the reserveIdx to the right one */
+            reserveIdx--;
+        }
+    }
+    return (loadRelinquished);
+}
+
+/*
+ * The record of resource held by each client, see clientOwnership. The allocations on
+ * different devices update it in parallel under the device locks, so m_clientOwnershipLock
+ * is taken. recycleResource() is holding the system lock exclusively.
+ */
+void xrm::system::clientOwnershipAddSlot(uint64_t clientId, int32_t devId, int32_t slot) {
+    pthread_mutex_lock(&m_clientOwnershipLock);
+    clientOwnership& owned = m_clientOwnership[clientId];
+    owned.devMask |= (1u << devId);
+    owned.devSlot[devId] = slot;
+    pthread_mutex_unlock(&m_clientOwnershipLock);
+}
+
+void xrm::system::clientOwnershipAddCu(uint64_t clientId, cuData* cu) {
+    pthread_mutex_lock(&m_clientOwnershipLock);
+    m_clientOwnership[clientId].cus.insert(std::make_pair(cu->deviceId, cu->cuId));
+    pthread_mutex_unlock(&m_clientOwnershipLock);
+}
+
+void xrm::system::clientOwnershipRemoveCu(uint64_t clientId, cuData* cu) {
+    pthread_mutex_lock(&m_clientOwnershipLock);
+    auto it = m_clientOwnership.find(clientId);
+    if (it != m_clientOwnership.end()) it->second.cus.erase(std::make_pair(cu->deviceId, cu->cuId));
+    pthread_mutex_unlock(&m_clientOwnershipLock);
+}
+
+void xrm::system::clientOwnershipAddReserve(uint64_t clientId, cuData* cu) {
+    pthread_mutex_lock(&m_clientOwnershipLock);
+    m_clientOwnership[clientId].reserveCus.insert(std::make_pair(cu->deviceId, cu->cuId));
+    pthread_mutex_unlock(&m_clientOwnershipLock);
+}
+
+/*
+ * rebuild the record of all the clients from the resource data, the record is not saved
+ */
+void xrm::system::rebuildClientOwnership() {
+    m_clientOwnership.clear();
+    for (int32_t devId = 0; devId < m_numDevice; devId++) {
+        deviceData* dev = &m_devList[devId];
+        for (int32_t slot = 0; slot < XRM_MAX_DEV_CLIENTS; slot++) {
+            if (dev->clientProcs[slot].clientId) clientOwnershipAddSlot(dev->clientProcs[slot].clientId, devId, slot);
+        }
+        for (int32_t cuId = 0; cuId < dev->xclbinInfo.numCu; cuId++) {
+            cuData* cu = &dev->xclbinInfo.cuList[cuId];
+            for (int32_t i = 0; i < cu->numClient && i < XRM_MAX_KERNEL_CHANNELS; i++)
+                clientOwnershipAddCu(cu->clients[i], cu);
+            for (int32_t reserveIdx = 0; reserveIdx < cu->numReserve; reserveIdx++) {
+                if (cu->reserves[reserveIdx].clientIsActive)
+                    clientOwnershipAddReserve(cu->reserves[reserveIdx].clientId, cu);
+            }
+        }
+    }
+}
+
 /*
  * check reservation pool id is using the cu or not
  *
@@ -4819,6 +5582,7 @@ int32_t xrm::system::reserveLoadFromCu(uint64_t reservePoolId, cuData* cu, cuPro
         if (reserveIdx != -1) {
             /* in use, update the existing reserve slot to record the information */
             cu->totalUsedLoadUnified += requestLoadUnified;
+            cuUpdateLoadIndex(cu);
             updateDeviceLoad(cu->deviceId, requestLoadUnified, -1);
             cu->totalReservedLoadUnified += requestLoadUnified;
             cu->reserves[reserveIdx].reserveLoadUnified += requestLoadUnified;
@@ -4826,6 +5590,7 @@ int32_t xrm::system::reserveLoadFromCu(uint64_t reservePoolId, cuData* cu, cuPro
         } else if (cu->numReserve < XRM_MAX_KERNEL_RESERVES) {
             /* not in use, get a new reserve slot to record the information */
             cu->totalUsedLoadUnified += requestLoadUnified;
+            cuUpdateLoadIndex(cu);
             updateDeviceLoad(cu->deviceId, requestLoadUnified, -1);
             cu->totalReservedLoadUnified += requestLoadUnified;
             cu->reserves[cu->numReserve].reserveLoadUnified = requestLoadUnified;
@@ -4834,6 +5599,7 @@ int32_t xrm::system::reserveLoadFromCu(uint64_t reservePoolId, cuData* cu, cuPro
             cu->reserves[cu->numReserve].clientId = cuProp->clientId;
             cu->reserves[cu->numReserve].clientProcessId = cuProp->clientProcessId;
             cu->numReserve++;
+            clientOwnershipAddReserve(cuProp->clientId, cu);
             return (XRM_SUCCESS);
         }
     }
@@ -5337,6 +6103,7 @@ int32_t xrm::system::relinquishCuFromDev(uint64_t reservePoolId, int32_t devId,
                     continue;
                 }
                 cu->totalUsedLoadUnified -= cu->reserves[i].reserveLoadUnified;
+                cuUpdateLoadIndex(cu);
                 updateDeviceLoad(devId, -cu->reserves[i].reserveLoadUnified, -1);
                 cu->totalReservedLoadUnified -= cu->reserves[i].reserveLoadUnified;
                 /* switch the slot until the last one */
@@ -5389,6 +6156,7 @@ int32_t xrm::system::resRelinquishCuList(uint64_t reservePoolId) {
                         return (XRM_ERROR);
                     }
                     cu->totalUsedLoadUnified -= cu->reserves[i].reserveLoadUnified;
+                    cuUpdateLoadIndex(cu);
                     updateDeviceLoad(devId, -cu->reserves[i].reserveLoadUnified, -1);
                     cu->totalReservedLoadUnified -= cu->reserves[i].reserveLoadUnified;
                     /* switch the slot until the last one */
@@ -5413,6 +6181,8 @@ int32_t xrm::system::resRelinquishCuList(uint64_t reservePoolId) {
             }
         }
     }
+    publishEvent(XRM_EVENT_POOL_RELINQUISHED, -1, reservePoolId);
+    notifyAllReleased();
     return (XRM_SUCCESS);
 }
 
@@ -5461,6 +6231,7 @@ int32_t xrm::system::resReserveCuOfXclbin(
         for (cuId = 0; cuId < dev->xclbinInfo.numCu; cuId++) {
             cu = &dev->xclbinInfo.cuList[cuId];
             cu->totalUsedLoadUnified = XRM_MAX_CU_LOAD_GRANULARITY_1000000; // will update dev load at end of loop
+            cuUpdateLoadIndex(cu);
             cu->totalReservedLoadUnified = XRM_MAX_CU_LOAD_GRANULARITY_1000000;
             cu->reserves[0].reserveLoadUnified = XRM_MAX_CU_LOAD_GRANULARITY_1000000;
             cu->reserves[0].reserveUsedLoadUnified = 0;
@@ -5469,6 +6240,7 @@ int32_t xrm::system::resReserveCuOfXclbin(
             cu->reserves[0].clientId = clientId;
             cu->reserves[0].clientProcessId = clientProcessId;
             cu->numReserve = 1;
+            clientOwnershipAddReserve(clientId, cu);
         }
         updateDeviceLoad(devId, 0, dev->xclbinInfo.numCu * XRM_MAX_CU_LOAD_GRANULARITY_1000000);
         *fromDevId = devId;
@@ -5517,6 +6289,7 @@ int32_t xrm::system::resReserveDevice(uint64_t reservePoolId,
     for (cuId = 0; cuId < dev->xclbinInfo.numCu; cuId++) {
         cu = &dev->xclbinInfo.cuList[cuId];
         cu->totalUsedLoadUnified = XRM_MAX_CU_LOAD_GRANULARITY_1000000; // end of loop for dev load
+        cuUpdateLoadIndex(cu);
         cu->totalReservedLoadUnified = XRM_MAX_CU_LOAD_GRANULARITY_1000000;
         cu->reserves[0].reserveLoadUnified = XRM_MAX_CU_LOAD_GRANULARITY_1000000;
         cu->reserves[0].reserveUsedLoadUnified = 0;
@@ -5525,6 +6298,7 @@ int32_t xrm::system::resReserveDevice(uint64_t reservePoolId,
         cu->reserves[0].clientId = clientId;
         cu->reserves[0].clientProcessId = clientProcessId;
         cu->numReserve = 1;
+        clientOwnershipAddReserve(clientId, cu);
     }
     updateDeviceLoad(devId, 0, dev->xclbinInfo.numCu * XRM_MAX_CU_LOAD_GRANULARITY_1000000);
     return (XRM_SUCCESS);
@@ -5703,6 +6477,7 @@ int32_t xrm::system::resRelinquishCuPool(uint64_t reservePoolId) {
                         return (XRM_ERROR);
                     }
                     cu->totalUsedLoadUnified -= cu->reserves[i].reserveLoadUnified;
+                    cuUpdateLoadIndex(cu);
                     updateDeviceLoad(devId, -cu->reserves[i].reserveLoadUnified, -1);
                     cu->totalReservedLoadUnified -= cu->reserves[i].reserveLoadUnified;
                     /* switch the slot until the last one */
@@ -5727,6 +6502,8 @@ int32_t xrm::system::resRelinquishCuPool(uint64_t reservePoolId) {
             }
         }
     }
+    publishEvent(XRM_EVENT_POOL_RELINQUISHED, -1, reservePoolId);
+    notifyAllReleased();
     return (XRM_SUCCESS);
 }
 
@@ -6228,93 +7005,49 @@ int32_t xrm::system::wrapUnlockDevice(xclDeviceHandle handle) {
 int32_t xrm::system::resAllocCuByDevLoad(cuPropertyV2* cuPropV2, cuResource* cuRes, bool updateId) {
     deviceData* dev;
     cuData* cu;
-    cuData* preCu = NULL;
     int32_t ret = 0;
-    bool kernelNameEqual, kernelAliasEqual, cuNameEqual;
     uint64_t clientId = cuPropV2->clientId;
-    int32_t devId, cuId;
-    int32_t preDevId = -1, preCuId = -1;
-    bool cuAcquired = false;
-    /* First pass will look for kernels already in-use by proc */
+    int32_t devId;
     cuProperty tmpProp;
     cuProperty* cuProp = &tmpProp;
     // no need to check cuPropV2 or cuRes as it should be checked already
     cuPropertyCopyFromV2(cuProp, cuPropV2);
-    std::vector<xrm::deviceLoadInfo> devLoadArray(m_numDevice);
-    for (int i = 0; i < m_numDevice; i++) {
-        devLoadArray[i] = m_devList[i].devLoadInfo;
-    }
-    std::sort(devLoadArray.begin(), devLoadArray.end());
+    /*
+     * take the device order from the ranking first, the allocation below updates the ranking.
+     * most used first walks the ranking from the highest load rate.
+     */
+    int32_t devOrder[XRM_MAX_XILINX_DEVICES];
+    int32_t numDevOrder = 0;
+    for (auto& rank : m_devLoadRanking) devOrder[numDevOrder++] = rank.second;
+    if (cuPropV2->policyInfo != XRM_POLICY_INFO_CONSTRAINT_TYPE_DEV_LEAST_USED_FIRST)
+        std::reverse(devOrder, devOrder + numDevOrder);
+
+    for (int32_t i = 0; i < numDevOrder; i++) {
+        devId = devOrder[i];
+        /* none of the cus on this device matches, no need to register client */
+        if (cuCandidatesOnDev(devId, cuProp).empty()) continue;
+        if (!isDevAvailableForClient(devId, cuProp)) continue;
 
-    for (int i = m_numDevice - 1; i >= 0 && !cuAcquired; i--) {
-        devId = devLoadArray[i].deviceId;
-        if (cuPropV2->policyInfo == XRM_POLICY_INFO_CONSTRAINT_TYPE_DEV_LEAST_USED_FIRST)
-            devId = devLoadArray[m_numDevice - 1 - i].deviceId;
+        /*
+         * the most used / least used cu on the device, as the policy of device. The client is
+         * registered only when the cu is found, so no device is released for nothing.
+         */
+        cu = findCuByLoad(devId, cuProp, cuPropV2->policyInfo);
+        if (cu == NULL) continue;
         ret = allocClientFromDev(devId, cuProp);
         if (ret < 0) {
             continue;
         }
         dev = &m_devList[devId];
-
-        /*
-         * Now check whether matching cu is on allocated device
-         * if not, free device, increment dev count, re-loop
-         */
-        for (cuId = 0; cuId < XRM_MAX_XILINX_KERNELS && cuId < dev->xclbinInfo.numCu && !cuAcquired; cuId++) {
-            cu = &dev->xclbinInfo.cuList[cuId];
-
-            kernelNameEqual = true;
-            if (cuProp->kernelName[0] != '\0') {
-                if (cu->kernelName.compare(cuProp->kernelName)) kernelNameEqual = false;
-            }
-            /* kernel alias is presented, compare it; otherwise no need to compare */
-            kernelAliasEqual = true;
-            if (cuProp->kernelAlias[0] != '\0') {
-                if (cu->kernelAlias.compare(cuProp->kernelAlias)) kernelAliasEqual = false;
-            }
-            /* cu name is presented, compare it; otherwise no need to compare */
-            cuNameEqual = true;
-            if (cuProp->cuName[0] != '\0') {
-                if (cu->cuName.compare(cuProp->cuName)) cuNameEqual = false;
-            }
-            if (!(kernelNameEqual && kernelAliasEqual && cuNameEqual)) continue;
-            cuData* tmpCu = preCu;
-            /* alloc channel and register client id */
-            ret = allocChanClientFromCu(cu, cuProp, cuRes, cuPropV2->policyInfo, &preCu);
-            if (ret != XRM_SUCCESS) {
-                if (tmpCu != preCu) {
-                    preDevId = devId;
-                    preCuId = cuId;
-                }
-                continue;
-            }
-
-            preCu = NULL;
+        if (allocChanClientFromCu(cu, cuProp, cuRes) == XRM_SUCCESS) {
             cuRes->deviceId = devId;
-            cuRes->cuId = cuId;
-            strncpy(cuRes->xclbinFileName, dev->xclbinName.c_str(), XRM_MAX_NAME_LEN - 1);
-            strncpy(cuRes->uuidStr, dev->xclbinInfo.uuidStr.c_str(), XRM_MAX_NAME_LEN - 1);
-            cuAcquired = true;
-        } // cu loop
-
-        if (preCu) {
-            dev = &m_devList[preDevId];
-            cu = &dev->xclbinInfo.cuList[preCuId];
-            ret = allocChanClientFromCu(cu, cuProp, cuRes);
-            cuRes->deviceId = preDevId;
-            cuRes->cuId = preCuId;
+            cuRes->cuId = cu->cuId;
             strncpy(cuRes->xclbinFileName, dev->xclbinName.c_str(), XRM_MAX_NAME_LEN - 1);
             strncpy(cuRes->uuidStr, dev->xclbinInfo.uuidStr.c_str(), XRM_MAX_NAME_LEN - 1);
-            cuAcquired = true;
-        }
-        if (cuAcquired) {
             if (updateId) updateAllocServiceId();
             return (XRM_SUCCESS);
         }
-
-        if (!cuAcquired) {
-            releaseClientOnDev(devId, clientId);
-        }
+        releaseClientOnDev(devId, clientId);
     }
     return (XRM_ERROR_NO_KERNEL);
 }
@@ -6332,104 +7065,54 @@ int32_t xrm::system::resAllocCuByDevLoad(cuPropertyV2* cuPropV2, cuResource* cuR
 int32_t xrm::system::resAllocCuByCuLoad(cuPropertyV2* cuPropV2, cuResource* cuRes, bool updateId) {
     deviceData* dev;
     cuData* cu;
-    cuData* preCu = NULL;
+    cuData* bestCu = NULL;
     int32_t ret = 0;
-    bool kernelNameEqual, kernelAliasEqual, cuNameEqual;
     uint64_t clientId = cuPropV2->clientId;
-    int32_t devId, cuId;
-    int32_t preDevId = -1, preCuId = -1;
-    bool cuAcquired = false;
-    /* First pass will look for kernels already in-use by proc */
-    bool cuAffinityPass = true;
+    int32_t devId;
+    int32_t bestDevId = -1;
     cuProperty tmpProp;
     cuProperty* cuProp = &tmpProp;
     // no need to check cuPropV2 or cuRes as it should be checked already
     cuPropertyCopyFromV2(cuProp, cuPropV2);
-cu_alloc_loop:
-    for (devId = -1; !cuAcquired && (devId < m_numDevice);) {
+
+    /*
+     * Find the best cu of each device the client could get, without registering the client,
+     * then register the client only on the device of the best cu. Registering and releasing the
+     * client on the other devices would wake up the waiters of the released devices for nothing.
+     * On the same score the earlier device is selected.
+     */
+    for (devId = -1; devId < m_numDevice;) {
         devId = allocDevForClient(&devId, cuProp);
         if (devId < 0) {
             break;
         }
 
-        ret = allocClientFromDev(devId, cuProp);
-        if (ret < 0) {
-            continue;
-        }
-        dev = &m_devList[devId];
-        /*
-         * Now check whether matching cu is on allocated device
-         * if not, free device, increment dev count, re-loop
-         */
-        for (cuId = 0; cuId < XRM_MAX_XILINX_KERNELS && cuId < dev->xclbinInfo.numCu && !cuAcquired; cuId++) {
-            cu = &dev->xclbinInfo.cuList[cuId];
-
-            /* first attempt to re-use existing kernels; else, use a new kernel */
-            if ((cuAffinityPass && cu->numClient == 0) || (!cuAffinityPass && cu->numClient > 0)) continue;
-            /*
-             * compare, 0: equal
-             *
-             * kernel name is presented, compare it; otherwise no need to compare
-             */
-            kernelNameEqual = true;
-            if (cuProp->kernelName[0] != '\0') {
-                if (cu->kernelName.compare(cuProp->kernelName)) kernelNameEqual = false;
-            }
-            /* kernel alias is presented, compare it; otherwise no need to compare */
-            kernelAliasEqual = true;
-            if (cuProp->kernelAlias[0] != '\0') {
-                if (cu->kernelAlias.compare(cuProp->kernelAlias)) kernelAliasEqual = false;
-            }
-            /* cu name is presented, compare it; otherwise no need to compare */
-            cuNameEqual = true;
-            if (cuProp->cuName[0] != '\0') {
-                if (cu->cuName.compare(cuProp->cuName)) cuNameEqual = false;
-            }
-            if (!(kernelNameEqual && kernelAliasEqual && cuNameEqual)) continue;
-            cuData* tmpCu = preCu;
-            /* alloc channel and register client id */
-            ret = allocChanClientFromCu(cu, cuProp, cuRes, cuPropV2->policyInfo, &preCu);
-            if (ret != XRM_SUCCESS) {
-                if (tmpCu != preCu) {
-                    preDevId = devId;
-                    preCuId = cuId;
-                }
-                continue;
-            }
-
-            preCu = NULL;
-            cuRes->deviceId = devId;
-            cuRes->cuId = cuId;
-            strncpy(cuRes->xclbinFileName, dev->xclbinName.c_str(), XRM_MAX_NAME_LEN - 1);
-            strncpy(cuRes->uuidStr, dev->xclbinInfo.uuidStr.c_str(), XRM_MAX_NAME_LEN - 1);
-            cuAcquired = true;
-        }
-
-        if (!cuAcquired) {
-            releaseClientOnDev(devId, clientId);
+        /* none of the cus on this device matches */
+        if (cuCandidatesOnDev(devId, cuProp).empty()) continue;
+        if (!isDevAvailableForClient(devId, cuProp)) continue;
+        cu = findCuByLoad(devId, cuProp, cuPropV2->policyInfo);
+        if (cu != NULL && (bestCu == NULL || cuLoadScore(cu, cuProp, cuPropV2->policyInfo) <
+                                                 cuLoadScore(bestCu, cuProp, cuPropV2->policyInfo))) {
+            bestCu = cu;
+            bestDevId = devId;
         }
     }
 
-    if (!cuAcquired && cuAffinityPass) {
-        cuAffinityPass = false; /* open up search to all kernels */
-        goto cu_alloc_loop;
-    }
-    if (preCu) {
-        dev = &m_devList[preDevId];
-        cu = &dev->xclbinInfo.cuList[preCuId];
-        ret = allocChanClientFromCu(cu, cuProp, cuRes);
-        cuRes->deviceId = preDevId;
-        cuRes->cuId = preCuId;
-        strncpy(cuRes->xclbinFileName, dev->xclbinName.c_str(), XRM_MAX_NAME_LEN - 1);
-        strncpy(cuRes->uuidStr, dev->xclbinInfo.uuidStr.c_str(), XRM_MAX_NAME_LEN - 1);
-        cuAcquired = true;
-    }
-    if (cuAcquired) {
-        if (updateId) updateAllocServiceId();
-        return (XRM_SUCCESS);
+    if (bestCu == NULL) return (XRM_ERROR_NO_KERNEL);
+    ret = allocClientFromDev(bestDevId, cuProp);
+    if (ret < 0) return (XRM_ERROR_NO_KERNEL);
+    dev = &m_devList[bestDevId];
+    ret = allocChanClientFromCu(bestCu, cuProp, cuRes);
+    if (ret != XRM_SUCCESS) {
+        releaseClientOnDev(bestDevId, clientId);
+        return (XRM_ERROR_NO_KERNEL);
     }
-
-    return (XRM_ERROR_NO_KERNEL);
+    cuRes->deviceId = bestDevId;
+    cuRes->cuId = bestCu->cuId;
+    strncpy(cuRes->xclbinFileName, dev->xclbinName.c_str(), XRM_MAX_NAME_LEN - 1);
+    strncpy(cuRes->uuidStr, dev->xclbinInfo.uuidStr.c_str(), XRM_MAX_NAME_LEN - 1);
+    if (updateId) updateAllocServiceId();
+    return (XRM_SUCCESS);
 }
 
 int32_t xrm::system::resAllocCuFromDevByCuLoad(int32_t deviceId,
@@ -6438,15 +7121,8 @@ int32_t xrm::system::resAllocCuFromDevByCuLoad(int32_t deviceId,
                                                bool updateId) {
     deviceData* dev;
     cuData* cu;
-    cuData* preCu = NULL;
     int32_t ret = 0;
-    bool kernelNameEqual, kernelAliasEqual, cuNameEqual;
     uint64_t clientId = cuPropV2->clientId;
-    int32_t cuId;
-    int32_t preCuId = -1;
-    bool cuAcquired = false;
-    // * First pass will look for kernels already in-use by proc
-    bool cuAffinityPass = true;
     cuProperty tmpProp;
     cuProperty* cuProp = &tmpProp;
     // no need to check cuPropV2 or cuRes as it should be checked already
@@ -6478,69 +7154,13 @@ int32_t xrm::system::resAllocCuFromDevByCuLoad(int32_t deviceId,
         return (XRM_ERROR_NO_DEV);
     }
 
-cu_alloc_from_dev_loop:
-    //*
-    // * Now check whether matching cu is on allocated device
-    // * and try to allocate requested cu.
-    //
-    for (cuId = 0; cuId < XRM_MAX_XILINX_KERNELS && cuId < dev->xclbinInfo.numCu && !cuAcquired; cuId++) {
-        cu = &dev->xclbinInfo.cuList[cuId];
-
-        /* first attempt to re-use existing kernels; else, use a new kernel */
-        if ((cuAffinityPass && cu->numClient == 0) || (!cuAffinityPass && cu->numClient > 0)) continue;
-        /*
-         * compare, 0: equal
-         *
-         * kernel name is presented, compare it; otherwise no need to compare
-         */
-        kernelNameEqual = true;
-        if (cuProp->kernelName[0] != '\0') {
-            if (cu->kernelName.compare(cuProp->kernelName)) kernelNameEqual = false;
-        }
-        /* kernel alias is presented, compare it; otherwise no need to compare */
-        kernelAliasEqual = true;
-        if (cuProp->kernelAlias[0] != '\0') {
-            if (cu->kernelAlias.compare(cuProp->kernelAlias)) kernelAliasEqual = false;
-        }
-        /* cu name is presented, compare it; otherwise no need to compare */
-        cuNameEqual = true;
-        if (cuProp->cuName[0] != '\0') {
-            if (cu->cuName.compare(cuProp->cuName)) cuNameEqual = false;
-        }
-        if (!(kernelNameEqual && kernelAliasEqual && cuNameEqual)) continue;
-        cuData* tmpCu = preCu;
-        /* alloc channel and register client id */
-        ret = allocChanClientFromCu(cu, cuProp, cuRes, cuPropV2->policyInfo, &preCu);
-        if (ret != XRM_SUCCESS) {
-            if (tmpCu != preCu) {
-                preCuId = cuId;
-            }
-            continue;
-        }
-
-        preCu = NULL;
-        cuRes->deviceId = deviceId;
-        cuRes->cuId = cuId;
-        strncpy(cuRes->xclbinFileName, dev->xclbinName.c_str(), XRM_MAX_NAME_LEN - 1);
-        strncpy(cuRes->uuidStr, dev->xclbinInfo.uuidStr.c_str(), XRM_MAX_NAME_LEN - 1);
-        cuAcquired = true;
-    }
-
-    if (!cuAcquired && cuAffinityPass) {
-        cuAffinityPass = false; /* open up search to all kernels */
-        goto cu_alloc_from_dev_loop;
-    }
-    if (preCu) {
-        cu = &dev->xclbinInfo.cuList[preCuId];
-        ret = allocChanClientFromCu(cu, cuProp, cuRes);
+    /* the most used / least used cu on the device */
+    cu = findCuByLoad(deviceId, cuProp, cuPropV2->policyInfo);
+    if (cu != NULL && allocChanClientFromCu(cu, cuProp, cuRes) == XRM_SUCCESS) {
         cuRes->deviceId = deviceId;
-        cuRes->cuId = preCuId;
+        cuRes->cuId = cu->cuId;
         strncpy(cuRes->xclbinFileName, dev->xclbinName.c_str(), XRM_MAX_NAME_LEN - 1);
         strncpy(cuRes->uuidStr, dev->xclbinInfo.uuidStr.c_str(), XRM_MAX_NAME_LEN - 1);
-        cuAcquired = true;
-    }
-
-    if (cuAcquired) {
         if (updateId) updateAllocServiceId();
         return (XRM_SUCCESS);
     } else {
@@ -23,7 +23,11 @@
 
 #include <vector>
 #include <map>
+#include <set>
+#include <tuple>
+#include <functional>
 #include <string>
+#include <unordered_map>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <unistd.h>
@@ -49,10 +53,11 @@
 #include "xrm_limits.h"
 #include "xrm_error.h"
 #include "xrm.h"
+#include "xrm_name_table.hpp"
 
 namespace pt = boost::property_tree;
-// XRM_FURTHER_CHECK is used when it can't decide if current cu is best candidate.
-#define XRM_FURTHER_CHECK (-1)
+// words of the bitmap of channels in use on one cu
+#define XRM_CHAN_INUSE_MAP_WORDS ((XRM_MAX_KERNEL_CHANNELS + 63) / 64)
 
 namespace xrm {
 
@@ -86,6 +91,9 @@ typedef struct cuProperty {
                           * the system default resource pool id is 0.
                           */
     uint8_t extData[64]; // for future extension
+    uint32_t kernelNameId;  // ids of the names in daemon name table, see resolveCuPropertyNames()
+    uint32_t kernelAliasId;
+    uint32_t cuNameId;
 
     template <class Archive>
     void serialize(Archive& ar, const unsigned int version) {
@@ -469,9 +477,28 @@ typedef struct deviceLoadInfo {
         devCurrentLoad = 0;
     }
     deviceLoadInfo() {}
-    bool operator<(const deviceLoadInfo& b) { return devLoadRate < b.devLoadRate || deviceId < b.deviceId; }
+    bool operator<(const deviceLoadInfo& b) const {
+        return (std::tie(devLoadRate, deviceId) < std::tie(b.devLoadRate, b.deviceId));
+    }
 } deviceLoadInfo;
 
+/*
+ * The position of one cu in the load ordered index: by used load, then the cus already used by
+ * some client (rank 0) before the idle ones (rank 1), then cu id.
+ */
+typedef struct cuLoadKey {
+    int32_t usedLoad;
+    int32_t rank;
+    int32_t cuId;
+
+    bool operator<(const cuLoadKey& b) const {
+        return (std::tie(usedLoad, rank, cuId) < std::tie(b.usedLoad, b.rank, b.cuId));
+    }
+    bool operator==(const cuLoadKey& b) const {
+        return (usedLoad == b.usedLoad && rank == b.rank && cuId == b.cuId);
+    }
+} cuLoadKey;
+
 /* compute unit data */
 typedef struct cuData {
     int32_t cuId;          // index on one device, start from 0
@@ -482,6 +509,10 @@ typedef struct cuData {
     std::string cuName;       // kernel_name:instance_name (for IP kernel)
     std::string instanceName; // instance name
     std::string kernelPluginFileName;
+    uint32_t kernelNameId;   // ids of the names in daemon name table, set when xclbin is loaded
+    uint32_t kernelAliasId;
+    uint32_t cuNameId;
+    uint32_t instanceNameId;
     uint64_t maxCapacity;
     uint64_t baseAddr;        // the base address of the CU
     uint32_t membankId;       // connected memory bank id
@@ -490,6 +521,7 @@ typedef struct cuData {
     uint64_t membankBaseAddr; // connected memory bank base address
     channelData channels[XRM_MAX_KERNEL_CHANNELS];
     int32_t numChanInuse;
+    uint64_t chanInuseMap[XRM_CHAN_INUSE_MAP_WORDS]; // bit set for the channel with load, see cuFindFreeChannelId()
     uint64_t clients[XRM_MAX_KERNEL_CHANNELS]; // client id attached to cu
     int32_t numClient;                         // current number of processes attached to cu
     reserveData reserves[XRM_MAX_KERNEL_RESERVES];
@@ -499,6 +531,7 @@ typedef struct cuData {
     int32_t totalReservedUsedLoadUnified; // granularity of 1,000,000, used load in reserved load
 
     int32_t deviceId;
+    cuLoadKey loadKey; // position in the load ordered index, not saved, see cuUpdateLoadIndex()
 
     template <class Archive>
     void serialize(Archive& ar, const unsigned int version) {
@@ -711,6 +744,40 @@ struct DevLoad {
     uint64_t curDevLoad;
 };
 
+/*
+ * The cus sharing one kernel name, kernel alias or cu name id, the cu ids on each device are
+ * in ascending order, so the lookup keeps the order of walking the cu list.
+ */
+typedef struct cuIndexEntry {
+    std::vector<int32_t> cuIds[XRM_MAX_XILINX_DEVICES];
+    std::set<cuLoadKey> byLoad[XRM_MAX_XILINX_DEVICES]; // same cus ordered by load, for the cu load policies
+} cuIndexEntry;
+
+/*
+ * One channel given to an allocation service id, the entries of one service id are kept in
+ * ascending order of (deviceId, cuId, channelId), the order of walking the devices.
+ */
+typedef struct allocServiceEntry {
+    int32_t deviceId;
+    int32_t cuId;
+    int32_t channelId;
+} allocServiceEntry;
+
+/*
+ * What one client holds in the resource pool, so the client is recycled by visiting only
+ * these places. The record may be stale after unload or release, every place is checked
+ * against the resource data before use.
+ */
+typedef struct clientOwnership {
+    uint32_t devMask;                                 // devices the client got a slot in clientProcs
+    int32_t devSlot[XRM_MAX_XILINX_DEVICES];          // the slot index in clientProcs of each device
+    std::set<std::pair<int32_t, int32_t>> cus;        // (deviceId, cuId) listing the client in cu->clients
+    std::set<std::pair<int32_t, int32_t>> reserveCus; // (deviceId, cuId) with reserve of the client
+} clientOwnership;
+
+class waitQueue;
+class eventHub;
+
 class system {
    public:
     system() {}
@@ -745,6 +812,10 @@ class system {
     void initLock();
     void enterLock();
     void exitLock();
+    void enterDeviceLock(int32_t devId);
+    void exitDeviceLock(int32_t devId);
+    void enterDeviceListLock(std::vector<int32_t>& devIds);
+    void exitDeviceListLock(const std::vector<int32_t>& devIds);
     void logMsg(xrmLogLevelType logLevel, const char* format, ...);
 
     void save();
@@ -761,6 +832,16 @@ class system {
     bool resIsCuListExisting(cuListProperty* cuListProp);
     bool resIsCuGroupExisting(cuGroupProperty* cuGroupProp);
 
+    /* functions to check how many times the request could be got now, need to do lock protect */
+    int32_t resCheckCuAvailableNum(cuProperty* cuProp, int32_t* availableNum);
+    int32_t resCheckCuAvailableNumV2(cuPropertyV2* cuPropV2, int32_t* availableNum);
+    int32_t resCheckCuListAvailableNum(cuListProperty* cuListProp, int32_t* availableNum);
+    int32_t resCheckCuListAvailableNumV2(cuListPropertyV2* cuListPropV2, int32_t* availableNum);
+    int32_t resCheckCuGroupAvailableNum(cuGroupProperty* cuGroupProp, int32_t* availableNum);
+    int32_t resCheckCuGroupAvailableNumV2(cuGroupPropertyV2* cuGroupPropV2, int32_t* availableNum);
+    int32_t resCheckCuPoolAvailableNum(cuPoolProperty* cuPoolProp, int32_t* availableNum);
+    int32_t resCheckCuPoolAvailableNumV2(cuPoolPropertyV2* cuPoolProp, int32_t* availableNum);
+
     /* following alloc and free function need to do lock protect */
     int32_t resAllocCuV2(cuPropertyV2* cuPropV2, cuResource* cuRes, bool updateId);
     int32_t resAllocCuByDevLoad(cuPropertyV2* cuPropV2, cuResource* cuRes, bool updateId);
@@ -772,6 +853,7 @@ class system {
     int32_t resAllocCuListV2(cuListPropertyV2* cuListPropV2, cuListResourceV2* cuListResV2);
     int32_t resAllocationQueryV2(allocationQueryInfoV2* allocQueryV2, cuListResourceV2* cuListResV2);
     int32_t resReleaseCuV2(cuResource* cuRes);
+    int32_t resReleaseAllocServiceV2(uint64_t clientId, uint64_t allocServiceId, int32_t* cuNum);
     int32_t resReleaseCuListV2(cuListResourceV2* cuListResV2);
     int32_t resUdfCuGroupDeclareV2(udfCuGroupInformationV2* udfCuGroupInfoV2);
     int32_t resUdfCuGroupUndeclareV2(udfCuGroupInformationV2* udfCuGroupInfoV2);
@@ -840,9 +922,14 @@ class system {
     int32_t wrapIPName2Index(xclDeviceHandle handle, const char* ipName);
     int32_t wrapLockDevice(xclDeviceHandle handle);
     int32_t wrapUnlockDevice(xclDeviceHandle handle);
-    void updateDeviceLoad(int32_t devId, int64_t loadIncreased, int64_t setLoadVal) {
-        m_devList[devId].updateDeviceLoad(loadIncreased, setLoadVal);
-    }
+    void updateDeviceLoad(int32_t devId, int64_t loadIncreased, int64_t setLoadVal);
+    void rebuildDevLoadRanking();
+
+    /* blocking allocations waiting for the freed capacity */
+    void setWaitQueue(waitQueue* waitQ) { m_waitQueue = waitQ; }
+
+    /* connections subscribed to the resource events */
+    void setEventHub(eventHub* hub) { m_eventHub = hub; }
 
    private:
     int32_t xclbinLoadToDevice(int32_t devId, std::string& errmsg);
@@ -869,24 +956,77 @@ class system {
     int32_t deviceLockXclbin(int32_t devId);
     int32_t deviceUnlockXclbin(int32_t devId);
 
+    void rebuildCuIndex();
+    const std::vector<int32_t>& cuCandidatesOnDev(int32_t devId, cuProperty* cuProp);
+    cuIndexEntry* cuShortestIndexEntry(int32_t devId, cuProperty* cuProp);
+    cuLoadKey cuCurrentLoadKey(cuData* cu);
+    void cuUpdateLoadIndex(cuData* cu);
+    bool cuFitsLoad(cuData* cu, cuProperty* cuProp);
+    std::pair<int64_t, int32_t> cuLoadScore(cuData* cu, cuProperty* cuProp, uint64_t policyInfo);
+    cuData* findCuByLoad(int32_t devId, cuProperty* cuProp, uint64_t policyInfo);
+    void resolveCuPropertyNames(cuProperty* cuProp);
+    bool isCuMatching(cuData* cu, cuProperty* cuProp);
+    bool isDevAvailableForClient(int32_t devId, cuProperty* cuProp);
+    int64_t cuAvailableNum(cuData* cu, cuProperty* cuProp, bool reserve);
+    int64_t cuAvailableNumOnDevs(cuProperty* cuProp, int32_t devBegin, int32_t devEnd, bool reserve);
+    int64_t cuListAvailableLimit(
+        cuProperty* cuProps, const int32_t* devIds, int32_t cuNum, int64_t listNum, bool reserve);
+    bool cuListPropertiesFromV2(cuListPropertyV2* cuListPropV2,
+                                std::vector<cuProperty>& cuProps,
+                                std::vector<int32_t>& devIds);
+    /* one trial of the request into the result buffer, and to give it back */
+    typedef std::function<int32_t(void*)> trialFunc;
+    typedef std::function<void(void*)> trialReleaseFunc;
+    int32_t countByTrial(int64_t limit,
+                         size_t resSize,
+                         const trialFunc& tryOnce,
+                         const trialReleaseFunc& release,
+                         int32_t* availableNum);
+    int32_t findUdfCuGroup(const std::string& udfCuGroupName);
+    int32_t findUdfCuGroupV2(const std::string& udfCuGroupName);
+    void udfCuGroupOptionToCuList(int32_t udfCuGroupIdx,
+                                  int32_t cuListIdx,
+                                  cuGroupProperty* cuGroupProp,
+                                  cuListProperty* cuListProp);
+    void udfCuGroupOptionToCuListV2(int32_t udfCuGroupIdx,
+                                    int32_t cuListIdx,
+                                    cuGroupPropertyV2* cuGroupPropV2,
+                                    cuListPropertyV2* cuListProp);
+    cuData* findFirstCu(std::unordered_map<uint32_t, cuIndexEntry>& index, uint32_t nameId);
+
     int32_t cuFindFreeChannelId(cuData* cu);
     void cuInitChannels(cuData* cu);
+    void cuSetChannelInuse(cuData* cu, int32_t chanId);
+    void cuSetChannelFree(cuData* cu, int32_t chanId);
+    void cuSyncChannelMap(cuData* cu);
+    bool cuIsClientUsingChannel(cuData* cu, uint64_t clientId);
+    void allocServiceIndexAdd(cuData* cu, int32_t chanId);
+    void allocServiceIndexRemove(cuData* cu, int32_t chanId);
+    void cuDropChannelsFromIndex(cuData* cu);
+    void fillAllocatedCuResource(const allocServiceEntry& entry, cuResource* cuRes);
 
     int32_t allocDevForClient(int32_t* devId, cuProperty* cuProp);
     int32_t getNextFreeDevForClient(int32_t* devId, cuProperty* cuProp);
     int32_t verifyProcess(pid_t pid);
     int32_t allocClientFromDev(int32_t devId, cuProperty* cuProp);
     int32_t allocCuFromDev(int32_t devId, cuProperty* cuProp, cuResource* cuRes);
-    // allocChanClientFromCu is compatible with previous version (no policy support for allocating cu) if default last
-    // two parameters
-    int32_t allocChanClientFromCu(
-        cuData* cu, cuProperty* cuProp, cuResource* cuRes, uint64_t policyVal = 0, cuData** preCu = NULL);
+    int32_t allocChanClientFromCu(cuData* cu, cuProperty* cuProp, cuResource* cuRes);
     void addClientToCu(cuData* cu, uint64_t clientId);
     int isClientUsingCu(cuData* cu, uint64_t clientId);
 
     int32_t releaseClientOnDev(int32_t devId, uint64_t clientId);
     void releaseAllCuChanClientOnDev(deviceData* dev, uint64_t clientId);
+    void releaseCuChanClient(cuData* cu, uint64_t clientId);
+    int64_t relinquishCuReserveClient(cuData* cu, uint64_t clientId);
+    void clientOwnershipAddSlot(uint64_t clientId, int32_t devId, int32_t slot);
+    void clientOwnershipAddCu(uint64_t clientId, cuData* cu);
+    void clientOwnershipRemoveCu(uint64_t clientId, cuData* cu);
+    void clientOwnershipAddReserve(uint64_t clientId, cuData* cu);
+    void rebuildClientOwnership();
     void removeClientOnCu(cuData* cu, uint64_t clientId);
+    void notifyCuReleased(cuData* cu);
+    void notifyAllReleased();
+    void publishEvent(xrmEventType type, int32_t devId, uint64_t poolId = 0, cuData* cu = NULL);
 
     uint64_t getNextAllocServiceId();
     void updateAllocServiceId();
@@ -915,8 +1055,25 @@ class system {
     std::string m_libXrtCoreFileFullPathName;
     uint64_t m_allocServiceId;
     uint64_t m_reservePoolId;
-    pthread_mutex_t m_lock;
+    pthread_rwlock_t m_lock;                           // system lock, shared while device locks are held
+    pthread_mutex_t m_devLock[XRM_MAX_XILINX_DEVICES]; // per device lock
+    pthread_mutex_t m_allocServiceLock;                // protect m_allocServiceIndex under device locks
+    pthread_mutex_t m_clientOwnershipLock;             // protect m_clientOwnership under device locks
+    pthread_mutex_t m_devLoadLock;                     // protect m_devLoadRanking under device locks
     bool m_devicesInited;
+    waitQueue* m_waitQueue = NULL;
+    eventHub* m_eventHub = NULL;
+    nameTable m_nameTable; // names of the cus ever loaded
+    /* cus on loaded devices by kernel name, kernel alias and cu name id, see rebuildCuIndex() */
+    std::unordered_map<uint32_t, cuIndexEntry> m_kernelNameIndex;
+    std::unordered_map<uint32_t, cuIndexEntry> m_kernelAliasIndex;
+    std::unordered_map<uint32_t, cuIndexEntry> m_cuNameIndex;
+    /* channels in use by allocation service id, see allocServiceIndexAdd() */
+    std::unordered_map<uint64_t, std::vector<allocServiceEntry>> m_allocServiceIndex;
+    /* (devLoadRate, deviceId) of all the devices in ascending order, see updateDeviceLoad() */
+    std::set<std::pair<int32_t, int32_t>> m_devLoadRanking;
+    /* resource held by each client, see recycleResource() */
+    std::unordered_map<uint64_t, clientOwnership> m_clientOwnership;
 
     friend class boost::serialization::access;
 
@@ -18,11 +18,74 @@
  * under the License.
  */
 
+#include <sys/stat.h>
 #include "xrm_tcp_session.hpp"
 #include "xrm_tcp_server.hpp"
 
 using boost::asio::ip::tcp;
 
+xrm::server::~server() {
+    if (!m_unixSocketPath.empty()) unlink(m_unixSocketPath.c_str());
+}
+
+/*
+ * Listen on the unix domain socket in addition to the tcp port. Local clients
+ * prefer this path, it skips the loopback tcp stack and the peer credentials
+ * of the client process are available from the kernel.
+ *
+ * The empty path disables the unix domain socket.
+ */
+int32_t xrm::server::openUnixSocket(const std::string& path) {
+    struct stat statBuf;
+    boost::system::error_code ec;
+
+    if (path.empty()) return (XRM_SUCCESS);
+
+    /* remove the stale socket left by previous daemon, but never touch other kind of file */
+    if (stat(path.c_str(), &statBuf) == 0) {
+        if (!S_ISSOCK(statBuf.st_mode)) {
+            m_system->logMsg(XRM_LOG_ERROR, "%s: %s is existing and not a socket", __func__, path.c_str());
+            return (XRM_ERROR);
+        }
+        unlink(path.c_str());
+    }
+
+    try {
+        stream_protocol::endpoint endpoint(path);
+        m_localAcceptor.open(endpoint.protocol(), ec);
+        if (!ec) m_localAcceptor.bind(endpoint, ec);
+        if (!ec) m_localAcceptor.listen(m_backlog, ec);
+    } catch (std::exception& e) {
+        m_system->logMsg(XRM_LOG_ERROR, "%s: %s, exception: %s", __func__, path.c_str(), e.what());
+        return (XRM_ERROR);
+    }
+    if (ec) {
+        m_system->logMsg(XRM_LOG_ERROR, "%s: %s, error %s = %d, %s", __func__, path.c_str(), ec.category().name(),
+                         ec.value(), ec.message().c_str());
+        boost::system::error_code closeEc;
+        m_localAcceptor.close(closeEc);
+        return (XRM_ERROR);
+    }
+    /* same access as the tcp port which is open to all local users */
+    chmod(path.c_str(), 0666);
+    m_unixSocketPath = path;
+    m_system->logMsg(XRM_LOG_NOTICE, "%s: listening on %s", __func__, path.c_str());
+
+    doLocalAccept();
+    return (XRM_SUCCESS);
+}
+
+void xrm::server::startSession(boost::asio::generic::stream_protocol::socket socket) {
+    auto thisSession = std::make_shared<xrm::session>(std::move(socket));
+    thisSession->setSystem(m_system);
+    thisSession->setRegistry(m_registry);
+    thisSession->setBufferPool(m_bufferPool);
+    thisSession->setAdmission(m_admission);
+    thisSession->setWaitQueue(m_waitQueue);
+    thisSession->setEventHub(m_eventHub);
+    thisSession->start();
+}
+
 void xrm::server::doAccept() {
     m_acceptor.async_accept(m_socket, [this](boost::system::error_code ec) {
         if (ec) {
@@ -32,12 +95,22 @@ void xrm::server::doAccept() {
             // m_system->logMsg(XRM_LOG_ERROR, "%s: doAccept(), numConcurrentClient = %lu", __func__,
             // numConcurrentClient);
         } else {
-            auto thisSession = std::make_shared<xrm::session>(std::move(m_socket));
-            thisSession->setSystem(m_system);
-            thisSession->setRegistry(m_registry);
-            thisSession->start();
+            startSession(std::move(m_socket));
         }
 
         doAccept();
     });
 }
+
+void xrm::server::doLocalAccept() {
+    m_localAcceptor.async_accept(m_localSocket, [this](boost::system::error_code ec) {
+        if (ec) {
+            m_system->logMsg(XRM_LOG_ERROR, "%s: error %s = %d, %s", __func__, ec.category().name(), ec.value(),
+                ec.message().c_str());
+        } else {
+            startSession(std::move(m_localSocket));
+        }
+
+        doLocalAccept();
+    });
+}
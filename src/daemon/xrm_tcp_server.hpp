@@ -24,32 +24,66 @@
 #include <cstdlib>
 #include <iostream>
 #include <memory>
+#include <string>
 #include <utility>
 #include <boost/asio.hpp>
+#include "xrm_admission.hpp"
+#include "xrm_buffer_pool.hpp"
 #include "xrm_command.hpp"
+#include "xrm_event_hub.hpp"
 #include "xrm_system.hpp"
+#include "xrm_wait_queue.hpp"
 
 using boost::asio::ip::tcp;
+using boost::asio::local::stream_protocol;
 
 namespace xrm {
 class server {
    public:
-    server(boost::asio::io_service& ioService, short port)
-        : m_acceptor(ioService, tcp::endpoint(tcp::v4(), port)), m_socket(ioService) {
+    server(boost::asio::io_service& ioService, short port, int backlog)
+        : m_acceptor(ioService), m_socket(ioService), m_localAcceptor(ioService), m_localSocket(ioService) {
+        tcp::endpoint endpoint(tcp::v4(), port);
+        m_backlog = backlog;
+        m_acceptor.open(endpoint.protocol());
+        m_acceptor.set_option(tcp::acceptor::reuse_address(true));
+        m_acceptor.bind(endpoint);
+        m_acceptor.listen(m_backlog);
         doAccept();
     }
 
+    ~server();
+
     void setSystem(xrm::system* sys) { m_system = sys; }
 
     void setRegistry(xrm::commandRegistry* registry) { m_registry = registry; }
 
+    void setBufferPool(std::shared_ptr<xrm::bufferPool> bufferPool) { m_bufferPool = bufferPool; }
+
+    void setWaitQueue(xrm::waitQueue* waitQ) { m_waitQueue = waitQ; }
+
+    void setAdmission(std::shared_ptr<xrm::admission> admission) { m_admission = admission; }
+
+    void setEventHub(xrm::eventHub* hub) { m_eventHub = hub; }
+
+    int32_t openUnixSocket(const std::string& path);
+
    private:
     void doAccept();
+    void doLocalAccept();
+    void startSession(boost::asio::generic::stream_protocol::socket socket);
 
     tcp::acceptor m_acceptor;
     tcp::socket m_socket;
+    stream_protocol::acceptor m_localAcceptor;
+    stream_protocol::socket m_localSocket;
+    std::string m_unixSocketPath;
+    int m_backlog; // connections not accepted yet, the new one is refused by kernel over it
     xrm::system* m_system;
     xrm::commandRegistry* m_registry;
+    std::shared_ptr<xrm::bufferPool> m_bufferPool;
+    xrm::waitQueue* m_waitQueue;
+    std::shared_ptr<xrm::admission> m_admission;
+    xrm::eventHub* m_eventHub = NULL;
 };
 } // namespace xrm
 
@@ -18,78 +18,366 @@
  * under the License.
  */
 
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 #include "xrm_tcp_session.hpp"
 
+#ifndef SYS_pidfd_open
+#define SYS_pidfd_open 434
+#endif
+
+xrm::session::~session() {
+    if (m_admitted) m_admission->releaseConnection(m_peerProcessId > 0, m_peerUserId, m_hasContext);
+}
+
+/*
+ * The daemon is saturated, answer the first request with XRM_ERROR_DAEMON_IS_BUSY without
+ * reading it and close the connection. The client gets it as the response of context creating.
+ */
+void xrm::session::rejectConnection() {
+    auto self(shared_from_this());
+    buffer_ptr out = busyResponse();
+
+    m_system->logMsg(XRM_LOG_NOTICE, "%s: connection is rejected, peer pid = %d, uid = %d", __func__,
+                     m_peerProcessId, m_peerUserId);
+    m_closed = true;
+    boost::asio::async_write(m_socket, boost::asio::buffer(*out),
+                             boost::asio::bind_executor(m_strand, [this, self, out](boost::system::error_code const&,
+                                                                                    std::size_t /*length*/) {
+                                 boost::system::error_code ec;
+                                 m_socket.shutdown(boost::asio::socket_base::shutdown_both, ec);
+                                 m_socket.close(ec);
+                             }));
+}
+
+/*
+ * The client id 0 fails the context creating as the limit of concurrent client does.
+ */
+xrm::session::buffer_ptr xrm::session::busyResponse() {
+    boost::property_tree::ptree outrsp;
+
+    outrsp.put("response.status.value", XRM_ERROR_DAEMON_IS_BUSY);
+    outrsp.put("response.data.clientId", 0);
+    outrsp.put("response.data.failed", "daemon is busy");
+    return (jsonResponse(encodeResponse(outrsp, sizeof(int))));
+}
+
+/*
+ * For the connection from unix domain socket, get the process id and user id of the
+ * peer from kernel. Nothing to do for the connection from tcp port.
+ */
+void xrm::session::getPeerCredentials() {
+    boost::system::error_code ec;
+    struct ucred cred;
+    socklen_t len = sizeof(cred);
+
+    auto endpoint = m_socket.local_endpoint(ec);
+    if (ec || endpoint.protocol().family() != AF_UNIX) return;
+
+    if (getsockopt(m_socket.native_handle(), SOL_SOCKET, SO_PEERCRED, &cred, &len) == 0) {
+        m_peerProcessId = cred.pid;
+        m_peerUserId = cred.uid;
+        m_system->logMsg(XRM_LOG_DEBUG, "%s: peer pid = %d, uid = %d", __func__, m_peerProcessId, m_peerUserId);
+    }
+}
+
+/*
+ * Watch the client process through pidfd, which becomes readable once the process exits.
+ * The connection is closed and the resource of the client is recycled then, even if the
+ * socket is kept open by another process, e.g. a child inheriting it. Only the process id
+ * from SO_PEERCRED is watched, the one reported by tcp client may be from another pid
+ * namespace. Called on the strand.
+ */
+void xrm::session::watchProcess() {
+    auto self(shared_from_this());
+    int32_t pidFd;
+
+    if (m_closed || m_pidDesc || m_peerProcessId <= 0) return;
+    pidFd = syscall(SYS_pidfd_open, m_peerProcessId, 0);
+    if (pidFd < 0) {
+        /* kernel without pidfd, the resource is recycled when the connection is closed */
+        m_system->logMsg(XRM_LOG_DEBUG, "%s: fail to open pidfd of process %d, errno %d", __func__,
+                         m_peerProcessId, errno);
+        return;
+    }
+    m_pidDesc = std::make_shared<boost::asio::posix::stream_descriptor>(m_socket.get_executor(), pidFd);
+    m_pidDesc->async_wait(boost::asio::posix::stream_descriptor::wait_read,
+                          boost::asio::bind_executor(m_strand, [this, self](boost::system::error_code const& ec) {
+                              /* aborted when the session is closed */
+                              if (ec || m_closed) return;
+                              m_system->logMsg(XRM_LOG_NOTICE, "%s: process %d exited, clientId = %lu", __func__,
+                                               m_peerProcessId, getClientId());
+                              boost::system::error_code closeEc;
+                              m_socket.close(closeEc);
+                              closeSession();
+                          }));
+}
+
+/*
+ * Wait for the socket being readable without holding any buffer, the buffer is taken from
+ * the pool when the data arrives.
+ */
 void xrm::session::doRead() {
     auto self(shared_from_this());
-    m_socket.async_read_some(boost::asio::buffer(m_indata, max_length),
-                             [this, self](boost::system::error_code const& ec, std::size_t length) {
-                                 if (ec) {
-                                     /* please note that XRM_LOG_DEBUG may NOT be print out on CentOS */
-                                     m_system->logMsg(XRM_LOG_DEBUG, "doRead(): ec %s = %d", ec.category().name(),
-                                                      ec.value());
-                                 }
-                                 if ((boost::asio::error::eof == ec) || (boost::asio::error::connection_reset == ec)) {
-                                     uint64_t clientId = this->getClientId();
-                                     /* please note that XRM_LOG_DEBUG may NOT be print out on CentOS */
-                                     m_system->logMsg(XRM_LOG_DEBUG, "doRead(): clintId = %lu", clientId);
-                                     m_system->enterLock();
-                                     if (clientId) m_system->recycleResource(clientId);
-                                     m_system->exitLock();
-                                 }
-                                 if (length == 0) {
-                                     m_system->logMsg(XRM_LOG_DEBUG, "doRead(): receive 0 length on read, ignored");
-                                 } else {
-                                     handleCmd(length);
-                                 }
-                             });
-}
-
-void xrm::session::doWrite(std::size_t length) {
+    m_socket.async_wait(boost::asio::socket_base::wait_read,
+                        boost::asio::bind_executor(m_strand, [this, self](boost::system::error_code const& ec) {
+                            if (ec) {
+                                /* please note that XRM_LOG_DEBUG may NOT be print out on CentOS */
+                                m_system->logMsg(XRM_LOG_DEBUG, "doRead(): ec %s = %d, clientId = %lu",
+                                                 ec.category().name(), ec.value(), getClientId());
+                                closeSession();
+                                return;
+                            }
+                            readAvailable();
+                        }));
+}
+
+/*
+ * Read the available data into the buffer, the buffer grows for the large request and
+ * keeps the incomplete frame from previous read.
+ */
+void xrm::session::readAvailable() {
+    boost::system::error_code ec;
+    std::size_t available = m_socket.available(ec);
+    /* 0 available on readable socket means the peer closed, let read_some report it */
+    std::size_t need = std::min(m_inLength + std::max(available, (std::size_t)1), (std::size_t)max_length);
+
+    if (!m_inbuf || m_inbuf->capacity() < need) {
+        buffer_ptr buf = m_bufferPool->get(need);
+        if (m_inLength) memcpy(buf->data(), m_inbuf->data(), m_inLength);
+        m_inbuf = buf;
+    }
+    m_inbuf->resize(m_inbuf->capacity());
+
+    std::size_t length =
+        m_socket.read_some(boost::asio::buffer(m_inbuf->data() + m_inLength, m_inbuf->size() - m_inLength), ec);
+    if (ec == boost::asio::error::would_block || ec == boost::asio::error::try_again) {
+        doRead();
+        return;
+    }
+    if (ec) {
+        /* please note that XRM_LOG_DEBUG may NOT be print out on CentOS */
+        m_system->logMsg(XRM_LOG_DEBUG, "readAvailable(): ec %s = %d, clientId = %lu", ec.category().name(),
+                         ec.value(), getClientId());
+        closeSession();
+        return;
+    }
+    m_inLength += length;
+    handleRead();
+}
+
+/*
+ * Split the received data into requests. Complete binary frames are posted to the io thread
+ * pool, the incomplete one is kept for next read. Data without binary framing is from the
+ * client sending json request and waiting for the response, it's handled in place.
+ */
+void xrm::session::handleRead() {
+    auto self(shared_from_this());
+    std::size_t offset = 0;
+
+    while (offset < m_inLength) {
+        char* data = m_inbuf->data() + offset;
+        std::size_t length = m_inLength - offset;
+
+        if (!isBinaryFrame(data, length)) {
+            buffer_ptr req = m_bufferPool->get(length);
+            memcpy(req->data(), data, length);
+            m_inLength = 0;
+            m_inbuf.reset();
+            /* reading is resumed once it's answered, so the responses are in order */
+            submitCmd(req);
+            return;
+        }
+        if (length < sizeof(binaryFrameHeader)) break;
+
+        binaryFrameHeader* reqHdr = (binaryFrameHeader*)data;
+        std::size_t frameLength = sizeof(binaryFrameHeader) + reqHdr->length;
+        if (frameLength > max_length) {
+            m_system->logMsg(XRM_LOG_ERROR, "%s: binary frame length %lu is out of range", __func__, frameLength);
+            closeSession();
+            return;
+        }
+        if (length < frameLength) break;
+
+        buffer_ptr frame = m_bufferPool->get(frameLength);
+        memcpy(frame->data(), data, frameLength);
+        m_numPendingRequest++;
+        boost::asio::post(m_socket.get_executor(), [this, self, frame]() { handleBinaryCmd(frame); });
+        offset += frameLength;
+    }
+    if (offset > 0) {
+        m_inLength -= offset;
+        if (m_inLength) memmove(m_inbuf->data(), m_inbuf->data() + offset, m_inLength);
+    }
+    /* give the buffer back to pool while the connection is idle */
+    if (m_inLength == 0) m_inbuf.reset();
+    doRead();
+}
+
+/*
+ * Write the responses in the order they are queued, called on the strand. The responses
+ * queued while writing are gathered into the next write.
+ */
+void xrm::session::queueWrite(buffer_ptr out) {
+    if (m_closed) return;
+    m_writeQueue.push_back(out);
+    if (m_writeQueue.size() == 1) doWrite();
+}
+
+void xrm::session::doWrite() {
     auto self(shared_from_this());
-    boost::asio::async_write(m_socket, boost::asio::buffer(m_outdata, length),
-                             [this, self](boost::system::error_code const& ec, std::size_t /*length*/) {
-                                 if (ec) {
-                                     uint64_t clientId = this->getClientId();
-                                     /* please note that XRM_LOG_DEBUG may NOT be print out on CentOS */
-                                     m_system->logMsg(XRM_LOG_DEBUG, "doWrite(): ec %s = %d, clientId = %lu",
-                                                      ec.category().name(), ec.value(), clientId);
-                                     m_system->enterLock();
-                                     if (clientId) m_system->recycleResource(clientId);
-                                     m_system->exitLock();
-                                 } else {
-                                     doRead();
-                                 }
-                             });
-}
-
-void xrm::session::handleCmd(std::size_t length) {
+    std::vector<boost::asio::const_buffer> outBufs;
+
+    /* the buffers stay in the queue until they are written */
+    m_numWriting = std::min(m_writeQueue.size(), (std::size_t)max_gather_write);
+    outBufs.reserve(m_numWriting);
+    for (std::size_t i = 0; i < m_numWriting; i++) outBufs.push_back(boost::asio::buffer(*m_writeQueue[i]));
+    boost::asio::async_write(
+        m_socket, outBufs,
+        boost::asio::bind_executor(m_strand, [this, self](boost::system::error_code const& ec,
+                                                          std::size_t /*length*/) {
+            if (ec) {
+                /* please note that XRM_LOG_DEBUG may NOT be print out on CentOS */
+                m_system->logMsg(XRM_LOG_DEBUG, "doWrite(): ec %s = %d, clientId = %lu", ec.category().name(),
+                                 ec.value(), getClientId());
+                m_writeQueue.clear();
+                closeSession();
+                return;
+            }
+            m_writeQueue.erase(m_writeQueue.begin(), m_writeQueue.begin() + m_numWriting);
+            m_numWriting = 0;
+            if (!m_writeQueue.empty()) doWrite();
+        }));
+}
+
+/*
+ * One frame is done, called on the strand.
+ */
+void xrm::session::finishRequest() {
+    m_numPendingRequest--;
+    if (m_closed) closeSession();
+}
+
+/*
+ * The connection is broken, recycle the resource of the client once no frame is being
+ * processed, otherwise the resource allocated by the in flight frame would be leaked.
+ * Called on the strand.
+ */
+void xrm::session::closeSession() {
+    m_closed = true;
+    if (m_pidDesc) {
+        boost::system::error_code ec;
+        m_pidDesc->close(ec);
+        m_pidDesc.reset();
+    }
+    if (m_shmChannel) {
+        m_shmChannel->stop();
+        m_shmChannel.reset();
+    }
+    /* the parked requests are answered to nobody, they're finished after this */
+    if (m_waitQueue && m_numPendingRequest) m_waitQueue->cancel(this);
+    unsubscribeEvent();
+    if (m_numPendingRequest || m_recycled) return;
+    m_recycled = true;
+
+    uint64_t clientId = getClientId();
+    /* please note that XRM_LOG_DEBUG may NOT be print out on CentOS */
+    m_system->logMsg(XRM_LOG_DEBUG, "closeSession(): clientId = %lu", clientId);
+    if (clientId) {
+        m_system->enterLock();
+        m_system->recycleResource(clientId);
+        m_system->exitLock();
+    }
+}
+
+/*
+ * The json request without framing runs in a slot of admission control, it waits in the
+ * queue of admission control when all the slots are taken. Called on the strand.
+ */
+void xrm::session::submitCmd(buffer_ptr req) {
     auto self(shared_from_this());
 
-    std::stringstream instr;
-    std::stringstream outstr;
-    std::string name, strRequestId, recordClientId;
+    if (!m_admission) {
+        handleCmd(req->data(), req->size());
+        doRead();
+        return;
+    }
+    bool queued = m_admission->submitCommand([this, self, req]() {
+        boost::asio::post(m_strand, [this, self, req]() {
+            /* the resource allocated for the closed connection would never be recycled */
+            if (!m_closed) handleCmd(req->data(), req->size());
+            m_admission->finishCommand();
+            if (!m_closed) doRead();
+        });
+    });
+    if (!queued) {
+        queueWrite(busyResponse());
+        doRead();
+    }
+}
+
+void xrm::session::handleCmd(const char* data, std::size_t length) {
+    queueWrite(jsonResponse(processJson(data, length, sizeof(int))));
+}
+
+/*
+ * Encode the response into a buffer from the pool after headroom bytes, which are left for
+ * the length and frame header, so the text is not copied again before it's written. The
+ * buffer grows for the large response, it's not recycled then.
+ */
+xrm::session::buffer_ptr xrm::session::encodeResponse(const boost::property_tree::ptree& rsp,
+                                                      std::size_t headroom) {
+    buffer_ptr out = m_bufferPool->get(headroom);
+
+    xrm::getJsonCodec().encode(rsp, *out);
+    return (out);
+}
+
+/*
+ * The json response without framing is prefixed with its length, fill it into the 4 bytes
+ * reserved by encodeResponse().
+ */
+xrm::session::buffer_ptr xrm::session::jsonResponse(buffer_ptr out) {
+    std::size_t rspLength = out->size() - sizeof(int);
+
+    (*out)[0] = rspLength & 0xff;
+    (*out)[1] = (rspLength >> 8) & 0xff;
+    (*out)[2] = (rspLength >> 16) & 0xff;
+    (*out)[3] = (rspLength >> 24) & 0xff;
+    return (out);
+}
 
-    m_indata[length] = 0;
-    instr << m_indata;
+/*
+ * Process one json request and return the response encoded after headroom bytes. The blocking
+ * allocation is parked in the wait queue when the request can be answered later by deferred,
+ * then NULL is returned and deferred is called with the response once the allocation is done.
+ */
+xrm::session::buffer_ptr xrm::session::processJson(const char* data,
+                                                   std::size_t length,
+                                                   std::size_t headroom,
+                                                   responseFunc deferred) {
+    const xrm::jsonCodec& codec = xrm::getJsonCodec();
+    std::string name, strRequestId, recordClientId, errmsg;
+    boost::property_tree::ptree cmdtree;
     boost::property_tree::ptree outrsp;
-    try {
-        boost::property_tree::read_json(instr, m_cmdtree);
-    } catch (const boost::property_tree::json_parser_error& e) {
+
+    length = strnlen(data, length);
+    if (codec.decode(data, length, cmdtree, errmsg) != XRM_SUCCESS) {
         outrsp.put("response.status", "failed");
-        outrsp.put("response.data.failed", "Input Json file format error: " + e.message());
-        outrsp.put("response.data.indata", instr.str());
+        outrsp.put("response.data.failed", "Input Json file format error: " + errmsg);
+        outrsp.put("response.data.indata", std::string(data, length));
         goto end_of_cmd;
     }
 
-    name = m_cmdtree.get<std::string>("request.name", "");
+    name = cmdtree.get<std::string>("request.name", "");
     if (name.c_str()[0] == '\0') {
         outrsp.put("response.status", "failed");
         outrsp.put("response.data.failed", "request name is not provided");
         goto end_of_cmd;
     }
 
-    strRequestId = m_cmdtree.get<std::string>("request.requestId", "");
+    strRequestId = cmdtree.get<std::string>("request.requestId", "");
     if (strRequestId.c_str()[0] == '\0') {
         outrsp.put("response.status", "failed");
         outrsp.put("response.data.failed", "request requestId is not provided");
@@ -103,19 +391,262 @@ void xrm::session::handleCmd(std::size_t length) {
      * NOTE: During xrm context creating call, the client id will be recorded. It will be used
      * for resource automatic recycle when host application closes connection to XRM daemon.
      */
-    recordClientId = m_cmdtree.get<std::string>("request.parameters.recordClientId", "");
+    /*
+     * The process id reported by kernel is trusted over the one provided by the client.
+     */
+    if (m_peerProcessId > 0 && cmdtree.get_optional<pid_t>("request.parameters.clientProcessId"))
+        cmdtree.put("request.parameters.clientProcessId", m_peerProcessId);
+
+    recordClientId = cmdtree.get<std::string>("request.parameters.recordClientId", "");
     if (recordClientId.c_str()[0] != '\0') {
-        m_clientId = m_cmdtree.get<uint64_t>("request.parameters.clientId");
-        m_clientProcessId = m_cmdtree.get<pid_t>("request.parameters.clientProcessId");
+        m_clientId = cmdtree.get<uint64_t>("request.parameters.clientId");
+        m_clientProcessId = cmdtree.get<pid_t>("request.parameters.clientProcessId");
+        if (m_admitted && !m_hasContext.exchange(true) && !m_admission->enterContext()) m_hasContext = false;
+        auto self(shared_from_this());
+        boost::asio::post(m_strand, [this, self]() { watchProcess(); });
+    }
+    /* shared memory transport belongs to the connection, not a registry command */
+    if (name == "shmAttach") {
+        attachShm(cmdtree, outrsp);
+    } else if (name == "eventSubscribe") {
+        subscribeEvent(cmdtree, outrsp);
+    } else if (name == "eventUnsubscribe") {
+        unsubscribeEvent();
+        outrsp.put("response.name", name);
+        outrsp.put("response.requestId", strRequestId);
+        outrsp.put("response.status.value", XRM_SUCCESS);
+    } else if (name == "eventWait" && deferred) {
+        if (waitEvent(strRequestId, deferred)) return (NULL);
+        outrsp.put("response.name", name);
+        outrsp.put("response.requestId", strRequestId);
+        outrsp.put("response.status.value", XRM_ERROR_INVALID);
+        outrsp.put("response.data.failed", "events are not subscribed");
+    } else if (deferred && m_waitQueue && isBlockingCmd(name, cmdtree)) {
+        waitCmd(name, cmdtree, deferred);
+        return (NULL);
+    } else {
+        m_registry->dispatch(name, cmdtree, outrsp);
+        /* the connection may be kept in the connection pool of client without context */
+        if (name == "destroyContext" && m_admitted && m_hasContext.exchange(false)) m_admission->leaveContext();
     }
-    m_registry->dispatch(name, m_cmdtree, outrsp);
 
 end_of_cmd:
-    boost::property_tree::write_json(outstr, outrsp);
-    *m_outdata = outstr.str().length() & 0xff;
-    *(m_outdata + 1) = (outstr.str().length() >> 8) & 0xff;
-    *(m_outdata + 2) = (outstr.str().length() >> 16) & 0xff;
-    *(m_outdata + 3) = (outstr.str().length() >> 24) & 0xff;
-    std::strncpy(m_outdata + sizeof(int), outstr.str().c_str(), max_length - 1 - sizeof(int));
-    doWrite(outstr.str().length() + sizeof(int));
+    return (encodeResponse(outrsp, headroom));
+}
+
+/*
+ * Attach the shared memory ring of the client context to this connection. Only the client
+ * connected through unix domain socket is supported, the process id from kernel is used to
+ * get the file descriptors of the client.
+ */
+void xrm::session::attachShm(boost::property_tree::ptree& cmdtree, boost::property_tree::ptree& outrsp) {
+    auto self(shared_from_this());
+    int32_t ret = XRM_ERROR_INVALID;
+
+    auto shmFd = cmdtree.get<int32_t>("request.parameters.shmFd", -1);
+    auto requestEventFd = cmdtree.get<int32_t>("request.parameters.requestEventFd", -1);
+    auto responseEventFd = cmdtree.get<int32_t>("request.parameters.responseEventFd", -1);
+    if (m_peerProcessId > 0 && shmFd >= 0 && requestEventFd >= 0 && responseEventFd >= 0) {
+        auto channel = std::make_shared<xrm::shmChannel>(m_strand, m_system, m_registry);
+        ret = channel->attach(m_peerProcessId, shmFd, requestEventFd, responseEventFd);
+        if (ret == XRM_SUCCESS) {
+            /* posted before the response, so the channel is running when client gets the response */
+            boost::asio::post(m_strand, [this, self, channel]() {
+                if (m_shmChannel) m_shmChannel->stop();
+                m_shmChannel = channel;
+                if (m_closed)
+                    closeSession();
+                else
+                    m_shmChannel->start();
+            });
+        }
+    }
+    outrsp.put("response.status.value", ret);
+}
+
+/*
+ * The allocation asking for waiting in daemon with waitPriority instead of polling from client.
+ */
+bool xrm::session::isBlockingCmd(const std::string& name, boost::property_tree::ptree& cmdtree) {
+    if (name != "cuAlloc" && name != "cuListAlloc" && name != "cuGroupAlloc") return (false);
+    return (cmdtree.get_optional<int32_t>("request.parameters.waitPriority").is_initialized());
+}
+
+/*
+ * Park the blocking allocation in the wait queue, it's retried when the capacity of the kernel
+ * is freed. The response is the one of the last try, so it's the failure when timed out.
+ * The cu group may be of any kernel, so it's retried on every release.
+ */
+void xrm::session::waitCmd(const std::string& name, boost::property_tree::ptree& cmdtree, responseFunc deferred) {
+    auto self(shared_from_this());
+    std::vector<xrm::waitQueue::kernelKey> kernels;
+
+    auto priority = cmdtree.get<int32_t>("request.parameters.waitPriority");
+    auto timeout = cmdtree.get<uint64_t>("request.parameters.waitTimeout", 0);
+    if (name == "cuAlloc") {
+        kernels.push_back({cmdtree.get<std::string>("request.parameters.kernelName", ""),
+                           cmdtree.get<std::string>("request.parameters.kernelAlias", "")});
+    } else if (name == "cuListAlloc") {
+        auto cuNum = cmdtree.get<int32_t>("request.parameters.cuNum", 0);
+        for (int32_t i = 0; i < cuNum && i < XRM_MAX_LIST_CU_NUM; i++)
+            kernels.push_back({cmdtree.get<std::string>("request.parameters.kernelName" + std::to_string(i), ""),
+                               cmdtree.get<std::string>("request.parameters.kernelAlias" + std::to_string(i), "")});
+    }
+
+    auto cmd = std::make_shared<boost::property_tree::ptree>(cmdtree);
+    auto rsp = std::make_shared<boost::property_tree::ptree>();
+    m_waitQueue->wait(
+        this, kernels, priority, timeout,
+        [this, self, name, cmd, rsp]() {
+            std::string cmdName = name;
+            rsp->clear();
+            m_registry->dispatch(cmdName, *cmd, *rsp);
+            int32_t ret = rsp->get<int32_t>("response.status.value", XRM_ERROR);
+            /* the invalid request never succeeds, no need to wait */
+            return (ret == XRM_SUCCESS || ret == XRM_ERROR_INVALID);
+        },
+        [rsp, deferred]() { deferred(*rsp); });
+}
+
+/*
+ * Subscribe the events of eventMask for this connection, 0 to unsubscribe. The events are
+ * pushed to the client as the responses of its event wait requests.
+ */
+void xrm::session::subscribeEvent(boost::property_tree::ptree& cmdtree, boost::property_tree::ptree& outrsp) {
+    auto mask = cmdtree.get<uint32_t>("request.parameters.eventMask", 0);
+
+    outrsp.put("response.name", "eventSubscribe");
+    outrsp.put("response.requestId", cmdtree.get<std::string>("request.requestId"));
+    if (m_eventHub == NULL) {
+        outrsp.put("response.status.value", XRM_ERROR_INVALID);
+        outrsp.put("response.data.failed", "events are not supported");
+        return;
+    }
+    if (mask == 0) {
+        unsubscribeEvent();
+    } else {
+        m_eventSub->setMask(mask & XRM_EVENT_ALL);
+        m_eventHub->subscribe(m_eventSub);
+    }
+    outrsp.put("response.status.value", XRM_SUCCESS);
+}
+
+/*
+ * The parked event wait is answered with no event, so the frame is finished.
+ */
+void xrm::session::unsubscribeEvent() {
+    if (m_eventHub) m_eventHub->unsubscribe(m_eventSub.get());
+    m_eventSub->cancel();
+}
+
+/*
+ * Park the event wait request until there are events for the connection. The events are
+ * handed over under system locks, the response is built and sent on the io thread pool.
+ * Return false if the connection is not subscribed.
+ */
+bool xrm::session::waitEvent(const std::string& requestId, responseFunc deferred) {
+    auto self(shared_from_this());
+
+    return (m_eventSub->wait([this, self, requestId, deferred](const std::vector<xrmEvent>& events) {
+        boost::asio::post(m_socket.get_executor(), [events, requestId, deferred]() {
+            boost::property_tree::ptree rsp;
+
+            rsp.put("response.name", "eventWait");
+            rsp.put("response.requestId", requestId);
+            rsp.put("response.status.value", XRM_SUCCESS);
+            rsp.put("response.data.eventNum", events.size());
+            for (std::size_t i = 0; i < events.size(); i++) {
+                std::string idx = std::to_string(i);
+                rsp.put("response.data.type" + idx, (uint32_t)events[i].type);
+                rsp.put("response.data.deviceId" + idx, events[i].deviceId);
+                rsp.put("response.data.poolId" + idx, events[i].poolId);
+                rsp.put("response.data.kernelName" + idx, events[i].kernelName);
+                rsp.put("response.data.kernelAlias" + idx, events[i].kernelAlias);
+            }
+            deferred(rsp);
+        });
+    }));
+}
+
+/*
+ * The json request always starts with '{', the binary frame starts with the magic. The
+ * magic may be split by the read, so only the received part is checked.
+ */
+bool xrm::session::isBinaryFrame(const char* data, std::size_t length) {
+    uint32_t magic = XRM_BINARY_PROTOCOL_MAGIC;
+
+    return (memcmp(data, &magic, std::min(length, sizeof(magic))) == 0);
+}
+
+/*
+ * Process one binary frame, called on the io thread pool.
+ */
+void xrm::session::handleBinaryCmd(buffer_ptr frame) {
+    static_assert(sizeof(int) + sizeof(binaryFrameHeader) + sizeof(binaryCuListAllocV2Response) <= max_length,
+                  "binary response does not fit into session buffer");
+    auto self(shared_from_this());
+    const binaryFrameHeader* reqHdr = (const binaryFrameHeader*)frame->data();
+    const char* req = frame->data() + sizeof(binaryFrameHeader);
+    buffer_ptr out;
+    uint32_t rspLen = 0;
+    int32_t ret = XRM_ERROR_INVALID;
+
+    if (reqHdr->version == XRM_BINARY_PROTOCOL_VERSION_1 && reqHdr->opcode == XRM_BINARY_OP_JSON) {
+        const std::size_t headroom = sizeof(int) + sizeof(binaryFrameHeader);
+        out = processJson(req, reqHdr->length, headroom,
+                          [this, self, frame, headroom](const boost::property_tree::ptree& deferredRsp) {
+                              sendJsonFrame(frame, encodeResponse(deferredRsp, headroom));
+                          });
+        /* NULL when parked in wait queue, the frame stays pending until it's answered */
+        if (out) sendJsonFrame(frame, out);
+        return;
+    }
+
+    out = m_bufferPool->get(max_length);
+    char* rsp = out->data() + sizeof(int) + sizeof(binaryFrameHeader);
+    /* same as json request, the process id from kernel is trusted over the one in frame */
+    binaryOverrideProcessId(reqHdr->opcode, frame->data() + sizeof(binaryFrameHeader), reqHdr->length,
+                            m_peerProcessId);
+    if (reqHdr->version == XRM_BINARY_PROTOCOL_VERSION_1)
+        ret = m_registry->dispatchBinary(reqHdr->opcode, req, reqHdr->length, rsp, &rspLen);
+    if (ret != XRM_SUCCESS) {
+        binaryStatusResponse* statusRsp = (binaryStatusResponse*)rsp;
+        statusRsp->status = ret;
+        statusRsp->reserved = 0;
+        rspLen = sizeof(binaryStatusResponse);
+    }
+    out->resize(sizeof(int) + sizeof(binaryFrameHeader) + rspLen);
+    sendFrame(frame, out, rspLen);
+}
+
+/*
+ * The json response is encoded after the room of length and frame header by encodeResponse().
+ */
+void xrm::session::sendJsonFrame(buffer_ptr frame, buffer_ptr out) {
+    sendFrame(frame, out, out->size() - sizeof(int) - sizeof(binaryFrameHeader));
+}
+
+/*
+ * Fill the frame header of the response to the request frame and queue it for writing, the
+ * request is finished then. Called on the io thread pool.
+ */
+void xrm::session::sendFrame(buffer_ptr frame, buffer_ptr out, uint32_t rspLen) {
+    auto self(shared_from_this());
+    const binaryFrameHeader* reqHdr = (const binaryFrameHeader*)frame->data();
+    binaryFrameHeader* rspHdr = (binaryFrameHeader*)(out->data() + sizeof(int));
+    rspHdr->magic = XRM_BINARY_PROTOCOL_MAGIC;
+    rspHdr->version = XRM_BINARY_PROTOCOL_VERSION_1;
+    rspHdr->opcode = reqHdr->opcode;
+    rspHdr->requestId = reqHdr->requestId;
+    rspHdr->length = rspLen;
+
+    std::size_t outLength = sizeof(binaryFrameHeader) + rspLen;
+    (*out)[0] = outLength & 0xff;
+    (*out)[1] = (outLength >> 8) & 0xff;
+    (*out)[2] = (outLength >> 16) & 0xff;
+    (*out)[3] = (outLength >> 24) & 0xff;
+    boost::asio::post(m_strand, [this, self, out]() {
+        queueWrite(out);
+        finishRequest();
+    });
 }
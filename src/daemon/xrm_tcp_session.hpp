@@ -21,48 +21,132 @@
 #ifndef _XRM_TCP_SESSION_HPP_
 #define _XRM_TCP_SESSION_HPP_
 
+#include <atomic>
 #include <cstdlib>
+#include <deque>
+#include <functional>
 #include <iostream>
 #include <sstream>
 #include <memory>
 #include <utility>
+#include <vector>
 #include <boost/asio.hpp>
+#include "xrm_admission.hpp"
+#include "xrm_buffer_pool.hpp"
 #include "xrm_command.hpp"
 #include "xrm_command_registry.hpp"
+#include "xrm_event_hub.hpp"
+#include "xrm_json_codec.hpp"
+#include "xrm_shm_channel.hpp"
 #include "xrm_system.hpp"
+#include "xrm_wait_queue.hpp"
 
 using boost::asio::ip::tcp;
 
 namespace xrm {
 
+/*
+ * One session per client connection, the connection is either from tcp port or
+ * from unix domain socket.
+ *
+ * The socket read / write and the session state are serialized on the strand. The binary
+ * frames are processed on the io thread pool, so the requests pipelined on one connection
+ * are handled concurrently and the responses are queued for writing as they complete.
+ * The json request without framing is handled in order as before.
+ */
 class session : public std::enable_shared_from_this<session> {
    public:
-    session(tcp::socket socket) : m_socket(std::move(socket)) {}
+    session(boost::asio::generic::stream_protocol::socket socket)
+        : m_socket(std::move(socket)), m_strand(boost::asio::make_strand(m_socket.get_executor())) {}
 
-    void start() { doRead(); }
+    ~session();
+
+    void start() {
+        boost::system::error_code ec;
+        getPeerCredentials();
+        if (m_admission && !m_admission->admitConnection(m_peerProcessId > 0, m_peerUserId)) {
+            rejectConnection();
+            return;
+        }
+        m_admitted = true;
+        /* data is read only when socket is readable, see readAvailable() */
+        m_socket.non_blocking(true, ec);
+        doRead();
+    }
 
     void setSystem(xrm::system* sys) { m_system = sys; }
 
     void setRegistry(xrm::commandRegistry* registry) { m_registry = registry; }
 
+    void setBufferPool(std::shared_ptr<xrm::bufferPool> bufferPool) { m_bufferPool = bufferPool; }
+
+    void setAdmission(std::shared_ptr<xrm::admission> admission) { m_admission = admission; }
+
+    void setWaitQueue(xrm::waitQueue* waitQ) { m_waitQueue = waitQ; }
+
+    void setEventHub(xrm::eventHub* hub) { m_eventHub = hub; }
+
     uint64_t getClientId() const { return m_clientId; }
     pid_t getClientProcessId() const { return m_clientProcessId; }
 
    private:
+    typedef xrm::bufferPool::buffer_ptr buffer_ptr;
+    // answers the request parked in wait queue
+    typedef std::function<void(const boost::property_tree::ptree&)> responseFunc;
+
+    void getPeerCredentials();
+    void watchProcess();
     void doRead();
-    void handleCmd(std::size_t length);
-    void doWrite(std::size_t length);
+    void readAvailable();
+    void handleRead();
+    void rejectConnection();
+    buffer_ptr busyResponse();
+    buffer_ptr encodeResponse(const boost::property_tree::ptree& rsp, std::size_t headroom);
+    buffer_ptr jsonResponse(buffer_ptr out);
+    void submitCmd(buffer_ptr req);
+    void handleCmd(const char* data, std::size_t length);
+    buffer_ptr processJson(const char* data, std::size_t length, std::size_t headroom, responseFunc deferred = nullptr);
+    void attachShm(boost::property_tree::ptree& cmdtree, boost::property_tree::ptree& outrsp);
+    bool isBlockingCmd(const std::string& name, boost::property_tree::ptree& cmdtree);
+    void waitCmd(const std::string& name, boost::property_tree::ptree& cmdtree, responseFunc deferred);
+    void subscribeEvent(boost::property_tree::ptree& cmdtree, boost::property_tree::ptree& outrsp);
+    void unsubscribeEvent();
+    bool waitEvent(const std::string& requestId, responseFunc deferred);
+    bool isBinaryFrame(const char* data, std::size_t length);
+    void handleBinaryCmd(buffer_ptr frame);
+    void sendJsonFrame(buffer_ptr frame, buffer_ptr out);
+    void sendFrame(buffer_ptr frame, buffer_ptr out, uint32_t rspLen);
+    void queueWrite(buffer_ptr out);
+    void doWrite();
+    void finishRequest();
+    void closeSession();
 
-    enum { max_length = 131072 };
+    enum { max_length = 131072, max_gather_write = 64 };
 
-    tcp::socket m_socket;
-    uint64_t m_clientId = 0;
-    pid_t m_clientProcessId = 0;
-    char m_indata[max_length];
-    char m_outdata[max_length];
-    boost::property_tree::ptree m_cmdtree;
+    boost::asio::generic::stream_protocol::socket m_socket;
+    boost::asio::strand<boost::asio::generic::stream_protocol::socket::executor_type> m_strand;
+    std::atomic<uint64_t> m_clientId{0};
+    std::atomic<pid_t> m_clientProcessId{0};
+    pid_t m_peerProcessId = 0; // from SO_PEERCRED, only for unix domain socket
+    uid_t m_peerUserId = 0;
+    std::shared_ptr<boost::asio::posix::stream_descriptor> m_pidDesc; // pidfd of the peer process, on the strand
+    buffer_ptr m_inbuf;                   // from buffer pool, only held while there is data not handled
+    std::size_t m_inLength = 0;           // data in m_inbuf not handled yet
+    std::deque<buffer_ptr> m_writeQueue;  // responses to be written, front m_numWriting ones are being written
+    std::size_t m_numWriting = 0;
+    uint32_t m_numPendingRequest = 0;     // frames being processed on the io thread pool or parked in wait queue
+    bool m_closed = false;
+    bool m_admitted = false; // counted by admission control
+    std::atomic<bool> m_hasContext{false}; // counted as connection with client context by admission control
+    bool m_recycled = false;
+    std::shared_ptr<xrm::shmChannel> m_shmChannel; // shared memory transport, accessed on the strand
     xrm::system* m_system;
     xrm::commandRegistry* m_registry;
+    std::shared_ptr<xrm::bufferPool> m_bufferPool;
+    std::shared_ptr<xrm::admission> m_admission;
+    xrm::waitQueue* m_waitQueue = NULL;
+    xrm::eventHub* m_eventHub = NULL;
+    std::shared_ptr<xrm::eventSubscription> m_eventSub = std::make_shared<xrm::eventSubscription>();
 };
 } // namespace xrm
 
@@ -0,0 +1,194 @@
+/*
+ * Copyright (C) 2019-2021, Xilinx Inc - All rights reserved
+ *
+ * Copyright (C) 2023, Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Xilinx Resource Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "xrm_wait_queue.hpp"
+
+/*
+ * Try the request, park it if it can not be done now. The done function is called once, from
+ * here if the first try is done, otherwise from the retry pass, the timer or cancel().
+ *
+ * timeout: in microseconds, 0 means waiting until the request is done or canceled
+ */
+void xrm::waitQueue::wait(const void* owner,
+                          const std::vector<kernelKey>& kernels,
+                          int32_t priority,
+                          uint64_t timeout,
+                          tryFunc tryAlloc,
+                          doneFunc done) {
+    uint64_t generation = m_generation.load();
+
+    if (tryAlloc()) {
+        done();
+        return;
+    }
+
+    auto w = std::make_shared<waiter>();
+    w->owner = owner;
+    w->kernels = kernels;
+    w->tryAlloc = tryAlloc;
+    w->done = done;
+
+    std::unique_lock<std::mutex> lock(m_lock);
+    waiterOrder order(-priority, m_sequence++);
+    if (timeout) {
+        w->timer.reset(new boost::asio::steady_timer(m_ioService));
+        w->timer->expires_after(std::chrono::microseconds(timeout));
+        w->timer->async_wait([this, order](const boost::system::error_code& ec) {
+            if (!ec) expire(order);
+        });
+    }
+    m_waiters.emplace(order, w);
+    m_numWaiter++;
+    lock.unlock();
+
+    /* the capacity freed after the first try is not seen by any retry pass, so retry it */
+    if (m_generation.load() != generation) notifyAll();
+}
+
+/*
+ * Drop all the waiters of the owner, called when the connection of the owner is broken.
+ */
+void xrm::waitQueue::cancel(const void* owner) {
+    std::vector<doneFunc> doneList;
+
+    std::unique_lock<std::mutex> lock(m_lock);
+    for (auto it = m_waiters.begin(); it != m_waiters.end();) {
+        if (it->second->owner != owner) {
+            ++it;
+            continue;
+        }
+        if (it->second->timer) it->second->timer->cancel();
+        doneList.push_back(it->second->done);
+        it = m_waiters.erase(it);
+    }
+    m_numWaiter = m_waiters.size();
+    lock.unlock();
+
+    for (auto& done : doneList) done();
+}
+
+/*
+ * The capacity of the kernel is freed, called under system / device locks.
+ */
+void xrm::waitQueue::notify(const std::string& kernelName, const std::string& kernelAlias) {
+    m_generation++;
+    if (m_numWaiter == 0) return;
+
+    std::unique_lock<std::mutex> lock(m_notifyLock);
+    m_notified.push_back({kernelName, kernelAlias});
+    postRetry();
+}
+
+/*
+ * The capacity of more than one kernel may be freed, retry all the waiters.
+ */
+void xrm::waitQueue::notifyAll() {
+    m_generation++;
+    if (m_numWaiter == 0) return;
+
+    std::unique_lock<std::mutex> lock(m_notifyLock);
+    m_notifiedAll = true;
+    postRetry();
+}
+
+/*
+ * Post one retry pass for all the notifies coming before it runs, called with m_notifyLock.
+ */
+void xrm::waitQueue::postRetry() {
+    if (m_retryPosted) return;
+    m_retryPosted = true;
+    boost::asio::post(m_ioService, [this]() { retry(); });
+}
+
+/*
+ * Retry the waiters of the notified kernels in order, called on the io thread pool.
+ */
+void xrm::waitQueue::retry() {
+    std::vector<kernelKey> notified;
+    std::vector<kernelKey> blocked;
+    std::vector<doneFunc> doneList;
+    bool notifiedAll;
+
+    std::unique_lock<std::mutex> notifyLock(m_notifyLock);
+    notified.swap(m_notified);
+    notifiedAll = m_notifiedAll;
+    m_notifiedAll = false;
+    m_retryPosted = false;
+    notifyLock.unlock();
+
+    std::unique_lock<std::mutex> lock(m_lock);
+    for (auto it = m_waiters.begin(); it != m_waiters.end();) {
+        waiter* w = it->second.get();
+        if (!notifiedAll && !isKernelMatched(w->kernels, notified)) {
+            ++it;
+            continue;
+        }
+        /* the waiter of any kernel neither blocks nor is blocked by others */
+        if (!w->kernels.empty() && isKernelMatched(w->kernels, blocked)) {
+            ++it;
+            continue;
+        }
+        if (!w->tryAlloc()) {
+            /* keep the freed capacity of these kernels for this waiter */
+            blocked.insert(blocked.end(), w->kernels.begin(), w->kernels.end());
+            ++it;
+            continue;
+        }
+        if (w->timer) w->timer->cancel();
+        doneList.push_back(w->done);
+        it = m_waiters.erase(it);
+    }
+    m_numWaiter = m_waiters.size();
+    lock.unlock();
+
+    for (auto& done : doneList) done();
+}
+
+/*
+ * The waiter is timed out, it's answered with the result of its last try.
+ */
+void xrm::waitQueue::expire(waiterOrder order) {
+    doneFunc done;
+
+    std::unique_lock<std::mutex> lock(m_lock);
+    auto it = m_waiters.find(order);
+    if (it == m_waiters.end()) return;
+    done = it->second->done;
+    m_waiters.erase(it);
+    m_numWaiter = m_waiters.size();
+    lock.unlock();
+
+    done();
+}
+
+/*
+ * Whether any of the kernels matches any of the keys by kernel name or alias. The empty kernel
+ * list, from the waiter of any kernel, matches any key.
+ */
+bool xrm::waitQueue::isKernelMatched(const std::vector<kernelKey>& kernels, const std::vector<kernelKey>& keys) {
+    if (kernels.empty()) return (!keys.empty());
+    for (auto& kernel : kernels) {
+        for (auto& key : keys) {
+            if (!kernel.kernelName.empty() && kernel.kernelName == key.kernelName) return (true);
+            if (!kernel.kernelAlias.empty() && kernel.kernelAlias == key.kernelAlias) return (true);
+        }
+    }
+    return (false);
+}
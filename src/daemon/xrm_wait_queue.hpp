@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2019-2021, Xilinx Inc - All rights reserved
+ *
+ * Copyright (C) 2023, Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Xilinx Resource Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"). You may
+ * not use this file except in compliance with the License. A copy of the
+ * License is located at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef _XRM_WAIT_QUEUE_HPP_
+#define _XRM_WAIT_QUEUE_HPP_
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include <boost/asio.hpp>
+
+namespace xrm {
+
+/*
+ * Blocking allocations parked in the daemon instead of being polled by the client. The
+ * waiter is retried when the capacity of the kernel it's waiting for is freed (cu release,
+ * client recycle, pool relinquish, device load), in the order of priority and then arrival.
+ * Once the head waiter of a kernel fails, the waiters behind it for the same kernel are not
+ * retried in that pass, so the capacity is not taken away from the head by later waiters.
+ *
+ * notify() is called from the resource functions under system / device locks, it only posts
+ * the retry pass to the io thread pool. The retry pass calls the try function of the waiter,
+ * which takes the system lock by itself, so no system lock is held while the queue is locked
+ * except through the try function.
+ */
+class waitQueue {
+   public:
+    typedef std::function<bool()> tryFunc;  // true when the request is done, no need to wait
+    typedef std::function<void()> doneFunc; // called once when the waiter is done, expired or canceled
+
+    struct kernelKey {
+        std::string kernelName;
+        std::string kernelAlias;
+    };
+
+    waitQueue(boost::asio::io_service& ioService) : m_ioService(ioService) {}
+
+    void wait(const void* owner,
+              const std::vector<kernelKey>& kernels,
+              int32_t priority,
+              uint64_t timeout,
+              tryFunc tryAlloc,
+              doneFunc done);
+    void cancel(const void* owner);
+    void notify(const std::string& kernelName, const std::string& kernelAlias);
+    void notifyAll();
+
+   private:
+    typedef std::pair<int32_t, uint64_t> waiterOrder; // (-priority, arrival sequence)
+
+    struct waiter {
+        const void* owner;
+        std::vector<kernelKey> kernels; // empty for waiting any kernel, like cu group
+        tryFunc tryAlloc;
+        doneFunc done;
+        std::unique_ptr<boost::asio::steady_timer> timer;
+    };
+
+    void postRetry();
+    void retry();
+    void expire(waiterOrder order);
+    static bool isKernelMatched(const std::vector<kernelKey>& kernels, const std::vector<kernelKey>& keys);
+
+    boost::asio::io_service& m_ioService;
+    std::mutex m_lock; // protects m_waiters, held through the retry pass
+    std::map<waiterOrder, std::shared_ptr<waiter> > m_waiters;
+    uint64_t m_sequence = 0;
+    std::atomic<uint32_t> m_numWaiter{0};
+    std::atomic<uint64_t> m_generation{0}; // bumped on every notify, to catch the release racing with wait
+    std::mutex m_notifyLock;               // protects the notified kernels, never held with other locks
+    std::vector<kernelKey> m_notified;
+    bool m_notifiedAll = false;
+    bool m_retryPosted = false;
+};
+} // namespace xrm
+
+#endif // _XRM_WAIT_QUEUE_HPP_
@@ -18,34 +18,137 @@
  * under the License.
  */
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
+#include <map>
 #include <mutex>
 #include <sstream>
+#include <thread>
+#include <vector>
 #include <boost/asio.hpp>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
 
 #include "xrm.h"
 #include "experimental/xrm_experimental.h"
 #include "xrm_system.hpp"
+#include "xrm_binary_protocol.hpp"
+#include "xrm_json_codec.hpp"
+#include "xrm_shm_ring.hpp"
 
 using boost::asio::ip::tcp;
+using boost::asio::generic::stream_protocol;
 namespace pt = boost::property_tree;
 
-static std::recursive_mutex xrmMutex;
+struct xrmPrivateContext;
+
+/* asynchronous request, referenced by the user handle and by the context until completed */
+struct xrmPrivateRequest {
+    xrmPrivateContext* ctx;
+    uint16_t opcode;
+    void* result; // xrmCuResourceV2 or xrmCuListResourceV2 filled on completion, NULL for release
+    xrmCompletionCallback callback;
+    void* userData;
+    std::atomic<int32_t> refCount;
+    std::mutex lock; // protects the fields below
+    std::condition_variable cond;
+    bool done;
+    int32_t status;
+    int32_t eventFd; // created on demand by xrmRequestGetFd()
+};
+
+/* retry interval (useconds) of blocking allocation when daemon can not park it */
+#define XRM_BLOCKING_ALLOC_POLL_INTERVAL 1000
+
+/* blocking allocation parked in daemon, see XRM_BINARY_PROTOCOL_VERSION_5 */
+struct xrmPrivateWait {
+    int32_t priority;
+    uint64_t timeout; // in microseconds, 0: wait until allocated
+};
 
 struct xrmPrivateContext {
     uint32_t xrmApiVersion;
     xrmLogLevelType xrmLogLevel;
     uint64_t xrmClientId;
-    tcp::socket* socket;
+    stream_protocol::socket* socket; // connected through unix domain socket or tcp
+    uint32_t binaryProtocolVersion;  // negotiated at context creating, 0: json only
+    boost::asio::io_service* ioService;
+    tcp::resolver* resolver;
+    std::mutex jsonLock; // one json request at a time on the connection without framing
+    /* binary frames are pipelined, the responses are matched by request id */
+    std::atomic<uint32_t> nextRequestId;
+    std::mutex sendLock;                                // one frame is written at a time
+    std::mutex rspLock;                                 // protects the response fields below
+    std::condition_variable rspCond;                    // signalled when a response is received
+    bool rspReading;                                    // one thread is reading responses for all
+    bool rspBroken;                                     // connection is broken
+    std::map<uint32_t, std::vector<char> > rspFrames; // received responses not picked up yet
+    /* asynchronous requests, the responses are picked up by the completion thread */
+    std::thread* asyncThread;                              // started with the first asynchronous request
+    bool asyncStop;                                        // protected by rspLock
+    std::map<uint32_t, xrmPrivateRequest*> asyncRequests; // in flight, protected by rspLock
+    /* event subscription, the event wait is kept in flight and answered by the completion thread */
+    xrmEventCallback eventCallback; // protected by rspLock, NULL if not subscribed
+    void* eventUserData;
+    uint32_t eventRequestId;        // event wait in flight, 0 if none
+    bool eventDelivering;           // callback is being called
+    /* shared memory transport, one request in flight on the ring */
+    std::mutex shmLock;
+    xrm::shmRingPair* shmRings;
+    int32_t shmFd;
+    int32_t shmRequestEventFd;  // signalled to daemon
+    int32_t shmResponseEventFd; // signalled by daemon
+};
+
+/*
+ * Connections to daemon kept after the context is destroyed, the context created later
+ * takes one from the pool instead of connecting again. The pool size is set with
+ * environment XRM_CONNECTION_POOL_SIZE, 0 (default) disables the pool. The pool survives
+ * fork(), so the connection records the process pooling it and is only reused by that process.
+ */
+struct xrmConnection {
     boost::asio::io_service* ioService;
+    stream_protocol::socket* socket;
     tcp::resolver* resolver;
+    pid_t processId; // process owning the connection
 };
 
+static std::mutex xrmConnectionPoolLock;
+static std::vector<xrmConnection> xrmConnectionPool;
+
 enum { maxLength = 131072 };
 
 static int32_t xrmJsonRequest(xrmContext context, const char* jsonReq, char* jsonRsp);
+static void xrmJsonEncode(const pt::ptree& tree, std::string& jsonReq);
+static void xrmJsonDecode(const char* jsonRsp, pt::ptree& tree);
+static int32_t xrmConnectUnixSocket(xrmPrivateContext* ctx);
+static int32_t xrmConnect(xrmPrivateContext* ctx);
+static void xrmDisconnect(xrmPrivateContext* ctx);
+static bool xrmGetPooledConnection(xrmPrivateContext* ctx);
+static bool xrmPutPooledConnection(xrmPrivateContext* ctx);
+static void xrmDropInheritedConnection(xrmConnection& conn);
+static void xrmShmAttach(xrmPrivateContext* ctx);
+static void xrmShmDetach(xrmPrivateContext* ctx);
+static int32_t xrmShmRequest(
+    xrmPrivateContext* ctx, uint16_t opcode, const void* req, uint32_t reqLen, void* rsp, uint32_t rspMaxLen);
+static int32_t xrmFrameSend(
+    xrmPrivateContext* ctx, uint16_t opcode, uint32_t requestId, const void* req, uint32_t reqLen);
+static int32_t xrmFrameRequest(
+    xrmPrivateContext* ctx, uint16_t opcode, const void* req, uint32_t reqLen, std::vector<char>& rsp);
+static int32_t xrmAsyncStart(xrmPrivateContext* ctx);
+static void xrmAsyncStop(xrmPrivateContext* ctx);
+static int32_t xrmEventArm(xrmPrivateContext* ctx);
+static int32_t xrmBinaryRequest(
+    xrmContext context, uint16_t opcode, const void* req, uint32_t reqLen, void* rsp, uint32_t rspMaxLen);
+static void xrmBinaryToCuResourceV2(const xrm::binaryCuResource* binCuRes, xrmCuResourceV2* cuRes);
+static int32_t xrmCuPropertyV2ToBinary(
+    xrmPrivateContext* ctx, xrmCuPropertyV2* cuProp, xrm::binaryCuProperty* binCuProp);
+static int32_t xrmCuResourceV2ToBinary(xrmPrivateContext* ctx, xrmCuResourceV2* cuRes, xrm::binaryCuHandle* cuHandle);
 static void hexstrToBin(std::string& inStr, int32_t insz, unsigned char* out);
 static void binToHexstr(unsigned char* in, int32_t insz, std::string& outStr);
 static void xrmLog(xrmLogLevelType contextLogLevel, xrmLogLevelType logLevel, const char* format, ...);
@@ -61,8 +164,6 @@ int32_t xrmRetrieveLoadInfo(int32_t origInputLoad);
  * @return xrmContext, pointer to created context or NULL on fail
  */
 xrmContext xrmCreateContext(uint32_t xrmApiVersion) {
-    std::unique_lock<std::recursive_mutex> lock(xrmMutex);
-
     if (xrmApiVersion != XRM_API_VERSION_1) {
         xrmLog(XRM_LOG_ERROR, XRM_LOG_ERROR, "%s(): wrong XRM API version: %d", __func__, xrmApiVersion);
         return (NULL);
@@ -74,36 +175,26 @@ xrmContext xrmCreateContext(uint32_t xrmApiVersion) {
         return (NULL);
     }
     ctx->xrmApiVersion = XRM_API_VERSION_1;
-
-    try {
-        ctx->ioService = new boost::asio::io_service;
-        ctx->socket = new tcp::socket(*ctx->ioService);
-        ctx->resolver = new tcp::resolver(*ctx->ioService);
-
-        boost::asio::connect(*ctx->socket, ctx->resolver->resolve({"127.0.0.1", "9763"}));
-    } catch (std::exception& e) {
-        xrmLog(XRM_LOG_ERROR, XRM_LOG_ERROR, "%s Exception: %s\n", __func__, e.what());
-        if (ctx->socket) {
-            /* disconnect first, then release resource */
-            boost::system::error_code ec;
-            ctx->socket->shutdown(tcp::socket::shutdown_both, ec);
-            if (ec) {
-                xrmLog(XRM_LOG_ERROR, XRM_LOG_ERROR, "%s: socket shutdown error %s = %d", __func__,
-                       ec.category().name(), ec.value());
-            }
-            delete ctx->socket;
-        }
-        if (ctx->resolver) {
-            ctx->resolver->cancel();
-            delete ctx->resolver;
-        }
-        if (ctx->ioService) {
-            ctx->ioService->stop();
-            delete ctx->ioService;
-        }
-        ctx->socket = NULL;
-        ctx->ioService = NULL;
-        ctx->resolver = NULL;
+    ctx->binaryProtocolVersion = 0;
+    ctx->nextRequestId = 1;
+    ctx->rspReading = false;
+    ctx->rspBroken = false;
+    ctx->asyncThread = NULL;
+    ctx->asyncStop = false;
+    ctx->eventCallback = NULL;
+    ctx->eventUserData = NULL;
+    ctx->eventRequestId = 0;
+    ctx->eventDelivering = false;
+    ctx->shmRings = NULL;
+    ctx->shmFd = -1;
+    ctx->shmRequestEventFd = -1;
+    ctx->shmResponseEventFd = -1;
+    ctx->socket = NULL;
+    ctx->ioService = NULL;
+    ctx->resolver = NULL;
+
+    bool pooled = xrmGetPooledConnection(ctx);
+    if (!pooled && xrmConnect(ctx) != XRM_SUCCESS) {
         delete ctx;
         return (NULL);
     }
@@ -114,23 +205,41 @@ xrmContext xrmCreateContext(uint32_t xrmApiVersion) {
     createContextTree.put("request.name", "createContext");
     createContextTree.put("request.requestId", 1);
     createContextTree.put("request.parameters.context", "readContext");
-    std::stringstream reqstr;
+    createContextTree.put("request.parameters.binaryProtocolVersion", XRM_BINARY_PROTOCOL_VERSION);
+    std::string reqstr;
     /*
      * Need to temporarily set the log level to avoid debug message during context creating.
      */
     ctx->xrmLogLevel = (xrmLogLevelType)XRM_DEFAULT_LOG_LEVEL;
-    boost::property_tree::write_json(reqstr, createContextTree);
-    if (xrmJsonRequest((xrmContext)ctx, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) {
+    xrmJsonEncode(createContextTree, reqstr);
+    int32_t ret = xrmJsonRequest((xrmContext)ctx, reqstr.c_str(), jsonRsp);
+    if (ret != XRM_SUCCESS && pooled) {
+        /* the pooled connection may be closed by daemon, try with a new one */
+        xrmDisconnect(ctx);
+        memset(jsonRsp, 0, maxLength * sizeof(char));
+        if (xrmConnect(ctx) != XRM_SUCCESS) {
+            delete ctx;
+            return (NULL);
+        }
+        ret = xrmJsonRequest((xrmContext)ctx, reqstr.c_str(), jsonRsp);
+    }
+    if (ret != XRM_SUCCESS) {
         xrmDestroyContext(ctx);
         return (NULL);
     }
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
     auto logLevel = rspTree.get<int32_t>("response.status.value");
+    if (logLevel == XRM_ERROR_DAEMON_IS_BUSY) {
+        xrmLog(XRM_LOG_ERROR, XRM_LOG_ERROR, "%s(): daemon is busy, connection is rejected", __func__);
+        xrmDisconnect(ctx);
+        delete ctx;
+        return (NULL);
+    }
     ctx->xrmLogLevel = (xrmLogLevelType)logLevel;
     ctx->xrmClientId = rspTree.get<uint64_t>("response.data.clientId");
+    /* daemon without binary framing support does not answer the version */
+    ctx->binaryProtocolVersion = rspTree.get<uint32_t>("response.data.binaryProtocolVersion", 0);
     if (ctx->xrmClientId == 0) {
         // clientId is 0 means reaching limit of concurrent client
         xrmDestroyContext(ctx);
@@ -147,12 +256,13 @@ xrmContext xrmCreateContext(uint32_t xrmApiVersion) {
     echoContextTree.put("request.parameters.recordClientId", "recordClientId");
     echoContextTree.put("request.parameters.clientId", ctx->xrmClientId);
     echoContextTree.put("request.parameters.clientProcessId", clientProcessId);
-    std::stringstream echoReqstr;
-    boost::property_tree::write_json(echoReqstr, echoContextTree);
-    if (xrmJsonRequest((xrmContext)ctx, echoReqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) {
+    std::string echoReqstr;
+    xrmJsonEncode(echoContextTree, echoReqstr);
+    if (xrmJsonRequest((xrmContext)ctx, echoReqstr.c_str(), jsonRsp) != XRM_SUCCESS) {
         xrmDestroyContext(ctx);
         return (NULL);
     }
+    xrmShmAttach(ctx);
     return (ctx);
 }
 
@@ -165,14 +275,14 @@ xrmContext xrmCreateContext(uint32_t xrmApiVersion) {
 int32_t xrmDestroyContext(xrmContext context) {
     xrmPrivateContext* ctx = (xrmPrivateContext*)context;
 
-    std::unique_lock<std::recursive_mutex> lock(xrmMutex);
-
     if (ctx != NULL) {
         if (ctx->xrmApiVersion != XRM_API_VERSION_1) {
             xrmLog(XRM_LOG_ERROR, XRM_LOG_ERROR, "%s wrong xrm api version %d", __func__, ctx->xrmApiVersion);
             return (XRM_ERROR);
         }
 
+        if (ctx->eventCallback != NULL) xrmEventUnsubscribe(context);
+
         char jsonRsp[maxLength];
         memset(jsonRsp, 0, maxLength * sizeof(char));
         pt::ptree destroyContextTree;
@@ -183,27 +293,12 @@ int32_t xrmDestroyContext(xrmContext context) {
         destroyContextTree.put("request.parameters.echo", "echo");
         destroyContextTree.put("request.parameters.clientId", ctx->xrmClientId);
         destroyContextTree.put("request.parameters.clientProcessId", clientProcessId);
-        std::stringstream reqstr;
-        boost::property_tree::write_json(reqstr, destroyContextTree);
-        xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp);
-
-        if (ctx->socket) {
-            /* disconnect first, then release resource */
-            boost::system::error_code ec;
-            ctx->socket->shutdown(tcp::socket::shutdown_both, ec);
-            delete ctx->socket;
-        }
-        if (ctx->resolver) {
-            ctx->resolver->cancel();
-            delete ctx->resolver;
-        }
-        if (ctx->ioService) {
-            ctx->ioService->stop();
-            delete ctx->ioService;
-        }
-        ctx->socket = NULL;
-        ctx->ioService = NULL;
-        ctx->resolver = NULL;
+        std::string reqstr;
+        xrmJsonEncode(destroyContextTree, reqstr);
+        int32_t ret = xrmJsonRequest(context, reqstr.c_str(), jsonRsp);
+        xrmAsyncStop(ctx);
+        xrmShmDetach(ctx);
+        if (ret != XRM_SUCCESS || !xrmPutPooledConnection(ctx)) xrmDisconnect(ctx);
         delete ctx;
         return (XRM_SUCCESS);
     } else {
@@ -240,6 +335,209 @@ static void xrmLog(xrmLogLevelType contextLogLevel, xrmLogLevelType logLevel, co
     }
 }
 
+/**
+ * Internal function.
+ *
+ * \brief connects to the unix domain socket of XRM daemon. The socket path
+ * can be overridden by environment XRM_UNIX_SOCKET_PATH, empty value disables
+ * the unix domain socket.
+ *
+ * @param ctx the context being created
+ * @return int32_t, 0 on success or appropriate error number
+ **/
+static int32_t xrmConnectUnixSocket(xrmPrivateContext* ctx) {
+    const char* env = std::getenv("XRM_UNIX_SOCKET_PATH");
+    std::string path = (env != NULL) ? env : XRM_DEFAULT_UNIX_SOCKET_PATH;
+    boost::system::error_code ec;
+
+    if (path.empty()) return (XRM_ERROR);
+    try {
+        boost::asio::local::stream_protocol::socket localSocket(*ctx->ioService);
+        localSocket.connect(boost::asio::local::stream_protocol::endpoint(path), ec);
+        if (ec) return (XRM_ERROR);
+        *ctx->socket = std::move(localSocket);
+    } catch (std::exception& e) {
+        return (XRM_ERROR);
+    }
+    return (XRM_SUCCESS);
+}
+
+/**
+ * Internal function.
+ *
+ * \brief connects to the XRM daemon, prefer the unix domain socket and fall back
+ * to tcp loopback.
+ *
+ * @param ctx the context being created
+ * @return int32_t, 0 on success or appropriate error number
+ **/
+static int32_t xrmConnect(xrmPrivateContext* ctx) {
+    try {
+        ctx->ioService = new boost::asio::io_service;
+        ctx->socket = new stream_protocol::socket(*ctx->ioService);
+        ctx->resolver = new tcp::resolver(*ctx->ioService);
+
+        if (xrmConnectUnixSocket(ctx) != XRM_SUCCESS) {
+            tcp::socket tcpSocket(*ctx->ioService);
+            boost::asio::connect(tcpSocket, ctx->resolver->resolve({"127.0.0.1", "9763"}));
+            *ctx->socket = std::move(tcpSocket);
+        }
+    } catch (std::exception& e) {
+        xrmLog(XRM_LOG_ERROR, XRM_LOG_ERROR, "%s Exception: %s\n", __func__, e.what());
+        xrmDisconnect(ctx);
+        return (XRM_ERROR);
+    }
+    return (XRM_SUCCESS);
+}
+
+/**
+ * Internal function.
+ *
+ * \brief disconnects from the XRM daemon and releases the connection resource.
+ *
+ * @param ctx the context
+ * @return void
+ **/
+static void xrmDisconnect(xrmPrivateContext* ctx) {
+    if (ctx->socket) {
+        /* disconnect first, then release resource */
+        boost::system::error_code ec;
+        ctx->socket->shutdown(tcp::socket::shutdown_both, ec);
+        delete ctx->socket;
+    }
+    if (ctx->resolver) {
+        ctx->resolver->cancel();
+        delete ctx->resolver;
+    }
+    if (ctx->ioService) {
+        ctx->ioService->stop();
+        delete ctx->ioService;
+    }
+    ctx->socket = NULL;
+    ctx->ioService = NULL;
+    ctx->resolver = NULL;
+}
+
+/**
+ * Internal function.
+ *
+ * \brief gets the size of connection pool from environment XRM_CONNECTION_POOL_SIZE.
+ *
+ * @return uint32_t, the pool size, 0 means the pool is disabled
+ **/
+static uint32_t xrmGetConnectionPoolSize() {
+    static const uint32_t poolSize = [] {
+        const char* env = std::getenv("XRM_CONNECTION_POOL_SIZE");
+        return ((env != NULL) ? (uint32_t)std::strtoul(env, NULL, 10) : 0);
+    }();
+    return (poolSize);
+}
+
+/**
+ * Internal function.
+ *
+ * \brief takes one connection from the connection pool for the context being created.
+ *
+ * @param ctx the context being created
+ * @return bool, true on success or false if no connection in pool
+ **/
+static bool xrmGetPooledConnection(xrmPrivateContext* ctx) {
+    std::unique_lock<std::mutex> lock(xrmConnectionPoolLock);
+    pid_t processId = getpid();
+
+    while (!xrmConnectionPool.empty()) {
+        xrmConnection conn = xrmConnectionPool.back();
+        xrmConnectionPool.pop_back();
+        /* inherited from the parent over fork(), the stream and the peer pid belong to the parent */
+        if (conn.processId != processId) {
+            xrmDropInheritedConnection(conn);
+            continue;
+        }
+        ctx->ioService = conn.ioService;
+        ctx->socket = conn.socket;
+        ctx->resolver = conn.resolver;
+        return (true);
+    }
+    return (false);
+}
+
+/**
+ * Internal function.
+ *
+ * \brief returns the connection of the context being destroyed to the connection pool.
+ *
+ * @param ctx the context being destroyed
+ * @return bool, true on success or false if the connection is not pooled
+ **/
+static bool xrmPutPooledConnection(xrmPrivateContext* ctx) {
+    if (ctx->socket == NULL || ctx->rspBroken || !ctx->rspFrames.empty()) return (false);
+
+    std::unique_lock<std::mutex> lock(xrmConnectionPoolLock);
+    if (xrmConnectionPool.size() >= xrmGetConnectionPoolSize()) return (false);
+    xrmConnection conn;
+    conn.ioService = ctx->ioService;
+    conn.socket = ctx->socket;
+    conn.resolver = ctx->resolver;
+    conn.processId = getpid();
+    xrmConnectionPool.push_back(conn);
+    ctx->socket = NULL;
+    ctx->ioService = NULL;
+    ctx->resolver = NULL;
+    return (true);
+}
+
+/**
+ * Internal function.
+ *
+ * \brief drops the pooled connection inherited from the parent process, only the copy of
+ * this process is closed. The socket is not shut down since that would break the connection
+ * still used by the parent, and the io service is told about the fork first so the shared
+ * epoll set of the parent is not touched.
+ *
+ * @param conn the connection pooled by the parent process
+ * @return void
+ **/
+static void xrmDropInheritedConnection(xrmConnection& conn) {
+    try {
+        if (conn.ioService) conn.ioService->notify_fork(boost::asio::io_service::fork_child);
+    } catch (std::exception& e) {
+        /* the descriptors of this process are closed below anyway */
+    }
+    delete conn.socket;
+    delete conn.resolver;
+    delete conn.ioService;
+}
+
+/**
+ * Internal function.
+ *
+ * \brief encodes the request tree to JSON request message.
+ *
+ * @param tree the request tree
+ * @param jsonReq JSON request message
+ * @return void
+ **/
+static void xrmJsonEncode(const pt::ptree& tree, std::string& jsonReq) {
+    xrm::getJsonCodec().encode(tree, jsonReq);
+}
+
+/**
+ * Internal function.
+ *
+ * \brief decodes JSON response message to the response tree, it throws
+ * json_parser_error on malformed message as boost parser does.
+ *
+ * @param jsonRsp JSON response message
+ * @param tree the response tree
+ * @return void
+ **/
+static void xrmJsonDecode(const char* jsonRsp, pt::ptree& tree) {
+    std::string errmsg;
+
+    if (xrm::getJsonCodec().decode(jsonRsp, strlen(jsonRsp), tree, errmsg) != XRM_SUCCESS)
+        throw pt::json_parser_error(errmsg, "", 0);
+}
+
 /**
  * Internal function.
  *
@@ -263,7 +561,23 @@ static int32_t xrmJsonRequest(xrmContext context, const char* jsonReq, char* jso
         return (rc);
     }
 
-    std::unique_lock<std::recursive_mutex> lock(xrmMutex);
+    /* json request is pipelined in binary frame if daemon supports it */
+    if (ctx->binaryProtocolVersion >= XRM_BINARY_PROTOCOL_VERSION_2) {
+        std::vector<char> rsp;
+        xrmLog(ctx->xrmLogLevel, XRM_LOG_NOTICE, "Sending %s\n", jsonReq);
+        rc = xrmFrameRequest(ctx, xrm::XRM_BINARY_OP_JSON, jsonReq, std::strlen(jsonReq), rsp);
+        if (rc != XRM_SUCCESS) return (rc);
+        if (rsp.empty() || rsp.size() >= maxLength) {
+            xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s unexpected response length: %lu\n", __func__, rsp.size());
+            return (XRM_ERROR);
+        }
+        std::memcpy(jsonRsp, rsp.data(), rsp.size());
+        jsonRsp[rsp.size()] = '\0';
+        xrmLog(ctx->xrmLogLevel, XRM_LOG_NOTICE, "%s\n", jsonRsp);
+        return (rc);
+    }
+
+    std::unique_lock<std::mutex> lock(ctx->jsonLock);
     try {
         // Send request
         size_t reqLen = std::strlen(jsonReq);
@@ -290,7 +604,8 @@ static int32_t xrmJsonRequest(xrmContext context, const char* jsonReq, char* jso
             if (ec == boost::asio::error::interrupted)
                 continue;
             if (ec) {
-                xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s length reading error: %d\n", __func__, ec);
+                xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s length reading error: %d %s\n", __func__, ec.value(),
+                       ec.message().c_str());
                 return XRM_ERROR;
             }
             break;
@@ -305,7 +620,8 @@ static int32_t xrmJsonRequest(xrmContext context, const char* jsonReq, char* jso
             replyLength = ctx->socket->read_some(boost::asio::buffer(jsonRsp + cur_len, maxLength - cur_len), ec);
             // If the call was interrupted continue reading, exit on any other error
             if (ec && ec != boost::asio::error::interrupted) {
-                xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s read error: %d\n", __func__, ec);
+                xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s read error: %d %s\n", __func__, ec.value(),
+                       ec.message().c_str());
                 return XRM_ERROR;
             }
             cur_len += replyLength;
@@ -319,10 +635,845 @@ static int32_t xrmJsonRequest(xrmContext context, const char* jsonReq, char* jso
         }
     } catch (std::exception& e) {
         xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s Exception: %s\n", __func__, e.what());
-        rc = XRM_ERROR;
+        rc = XRM_ERROR;
+    }
+
+    return (rc);
+}
+
+/**
+ * Internal function.
+ *
+ * \brief reads exactly the length of data from the XRM daemon, retry if the
+ * read is interrupted.
+ *
+ * @param ctx the context created through xrmCreateContext()
+ * @param buf buffer to store the data
+ * @param len length of data to be read
+ * @return int32_t, 0 on success or appropriate error number
+ **/
+static int32_t xrmReadExactly(xrmPrivateContext* ctx, void* buf, size_t len) {
+    boost::system::error_code ec;
+    size_t curLen = 0;
+
+    while (curLen < len) {
+        curLen += ctx->socket->read_some(boost::asio::buffer((char*)buf + curLen, len - curLen), ec);
+        if (ec && ec != boost::asio::error::interrupted) {
+            xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s read error: %d %s\n", __func__, ec.value(),
+                   ec.message().c_str());
+            return (XRM_ERROR);
+        }
+    }
+    return (XRM_SUCCESS);
+}
+
+/**
+ * Internal function.
+ *
+ * \brief reads one frame from the XRM daemon.
+ *
+ * @param ctx the context created through xrmCreateContext()
+ * @param rspHdr header of the frame
+ * @param rsp record of the frame
+ * @return int32_t, 0 on success or appropriate error number
+ **/
+static int32_t xrmReadFrame(xrmPrivateContext* ctx, xrm::binaryFrameHeader* rspHdr, std::vector<char>& rsp) {
+    unsigned char tmp[4];
+
+    try {
+        if (xrmReadExactly(ctx, tmp, 4) != XRM_SUCCESS) return (XRM_ERROR);
+        uint32_t totalLen = tmp[0] | (uint32_t(tmp[1]) << 8) | (uint32_t(tmp[2]) << 16) | (uint32_t(tmp[3]) << 24);
+        if (totalLen < sizeof(xrm::binaryFrameHeader) || totalLen > maxLength) {
+            xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s unexpected response length: %u\n", __func__, totalLen);
+            return (XRM_ERROR);
+        }
+        if (xrmReadExactly(ctx, rspHdr, sizeof(xrm::binaryFrameHeader)) != XRM_SUCCESS) return (XRM_ERROR);
+        if (rspHdr->magic != XRM_BINARY_PROTOCOL_MAGIC ||
+            rspHdr->length != totalLen - sizeof(xrm::binaryFrameHeader)) {
+            xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s unexpected response frame, opcode %d\n", __func__,
+                   rspHdr->opcode);
+            return (XRM_ERROR);
+        }
+        rsp.resize(rspHdr->length);
+        if (xrmReadExactly(ctx, rsp.data(), rsp.size()) != XRM_SUCCESS) return (XRM_ERROR);
+    } catch (std::exception& e) {
+        xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s Exception: %s\n", __func__, e.what());
+        return (XRM_ERROR);
+    }
+    return (XRM_SUCCESS);
+}
+
+/**
+ * Internal function.
+ *
+ * \brief sends a request frame to the XRM daemon.
+ *
+ * @param ctx the context created through xrmCreateContext()
+ * @param opcode opcode of the request
+ * @param requestId request id to match the response
+ * @param req request record
+ * @param reqLen length of the request record
+ * @return int32_t, 0 on success or appropriate error number
+ **/
+static int32_t xrmFrameSend(
+    xrmPrivateContext* ctx, uint16_t opcode, uint32_t requestId, const void* req, uint32_t reqLen) {
+    boost::system::error_code ec;
+    xrm::binaryFrameHeader reqHdr;
+
+    reqHdr.magic = XRM_BINARY_PROTOCOL_MAGIC;
+    reqHdr.version = XRM_BINARY_PROTOCOL_VERSION_1;
+    reqHdr.opcode = opcode;
+    reqHdr.requestId = requestId;
+    reqHdr.length = reqLen;
+
+    // Send request, header and record in one write
+    std::vector<boost::asio::const_buffer> reqBufs;
+    reqBufs.push_back(boost::asio::buffer(&reqHdr, sizeof(reqHdr)));
+    reqBufs.push_back(boost::asio::buffer(req, reqLen));
+    std::unique_lock<std::mutex> lock(ctx->sendLock);
+    boost::asio::write(*ctx->socket, reqBufs, ec);
+    if (ec) {
+        xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s: write error %s = %d", __func__, ec.category().name(),
+               ec.value());
+        return (XRM_ERROR);
+    }
+    return (XRM_SUCCESS);
+}
+
+/**
+ * Internal function.
+ *
+ * \brief waits for the response frame of one of the requests accepted by match,
+ * called with rspLock held.
+ *
+ * Requests from multiple threads are pipelined on the connection. The waiting
+ * thread finding nobody reading the socket becomes the reader, it keeps the
+ * responses of other requests for their owners until its own arrives, then
+ * hands the reading over to one of the other waiting threads.
+ *
+ * @param ctx the context created through xrmCreateContext()
+ * @param lock the holding lock of rspLock
+ * @param match tells whether the response of the request id is waited for
+ * @param requestId request id of the received response
+ * @param rsp response record
+ * @return int32_t, 0 on success or appropriate error number
+ **/
+template <typename matchFunc>
+static int32_t xrmFrameWait(xrmPrivateContext* ctx,
+                            std::unique_lock<std::mutex>& lock,
+                            matchFunc match,
+                            uint32_t* requestId,
+                            std::vector<char>& rsp) {
+    xrm::binaryFrameHeader rspHdr;
+
+    while (true) {
+        for (auto it = ctx->rspFrames.begin(); it != ctx->rspFrames.end(); it++) {
+            if (match(it->first)) {
+                *requestId = it->first;
+                rsp.swap(it->second);
+                ctx->rspFrames.erase(it);
+                return (XRM_SUCCESS);
+            }
+        }
+        if (ctx->rspBroken) return (XRM_ERROR);
+        if (ctx->rspReading) {
+            ctx->rspCond.wait(lock);
+            continue;
+        }
+
+        ctx->rspReading = true;
+        lock.unlock();
+        std::vector<char> frame;
+        int32_t ret = xrmReadFrame(ctx, &rspHdr, frame);
+        lock.lock();
+        ctx->rspReading = false;
+        if (ret != XRM_SUCCESS) {
+            ctx->rspBroken = true;
+        } else if (match(rspHdr.requestId)) {
+            *requestId = rspHdr.requestId;
+            rsp.swap(frame);
+            ctx->rspCond.notify_all();
+            return (XRM_SUCCESS);
+        } else {
+            ctx->rspFrames[rspHdr.requestId].swap(frame);
+        }
+        ctx->rspCond.notify_all();
+    }
+}
+
+/**
+ * Internal function.
+ *
+ * \brief sends a request frame to the XRM daemon and waits for the response
+ * frame with the same request id.
+ *
+ * @param ctx the context created through xrmCreateContext()
+ * @param opcode opcode of the request
+ * @param req request record
+ * @param reqLen length of the request record
+ * @param rsp response record
+ * @return int32_t, 0 on success or appropriate error number
+ **/
+static int32_t xrmFrameRequest(
+    xrmPrivateContext* ctx, uint16_t opcode, const void* req, uint32_t reqLen, std::vector<char>& rsp) {
+    uint32_t requestId = ctx->nextRequestId++;
+    uint32_t rspRequestId;
+
+    if (xrmFrameSend(ctx, opcode, requestId, req, reqLen) != XRM_SUCCESS) return (XRM_ERROR);
+
+    // Get response
+    std::unique_lock<std::mutex> lock(ctx->rspLock);
+    return (xrmFrameWait(ctx, lock, [requestId](uint32_t id) { return (id == requestId); }, &rspRequestId, rsp));
+}
+
+/**
+ * Internal function.
+ *
+ * \brief sends a binary request frame to the XRM daemon and copies the
+ * response record to a caller provided buffer.
+ *
+ * @param context the context created through xrmCreateContext()
+ * @param opcode opcode of the request
+ * @param req request record
+ * @param reqLen length of the request record
+ * @param rsp buffer of the response record
+ * @param rspMaxLen size of the response buffer
+ * @return int32_t, 0 on success or appropriate error number
+ **/
+static int32_t xrmBinaryRequest(
+    xrmContext context, uint16_t opcode, const void* req, uint32_t reqLen, void* rsp, uint32_t rspMaxLen) {
+    xrmPrivateContext* ctx = (xrmPrivateContext*)context;
+    std::vector<char> rspRecord;
+
+    if (ctx == NULL || req == NULL || rsp == NULL) {
+        xrmLog(XRM_LOG_ERROR, XRM_LOG_ERROR, "%s: context, req or rsp pointer is NULL\n", __func__);
+        return (XRM_ERROR_INVALID);
+    }
+    xrmLog(ctx->xrmLogLevel, XRM_LOG_NOTICE, "Sending binary opcode %d, length %d\n", opcode, reqLen);
+    if (xrm::isShmRingOpcode(opcode) && sizeof(xrm::binaryFrameHeader) + reqLen <= XRM_SHM_RING_SLOT_SIZE) {
+        int32_t ret = xrmShmRequest(ctx, opcode, req, reqLen, rsp, rspMaxLen);
+        if (ret != XRM_ERROR_CONNECT_FAIL) return (ret);
+        /* no ring or it's broken, go through the socket */
+    }
+    if (xrmFrameRequest(ctx, opcode, req, reqLen, rspRecord) != XRM_SUCCESS) return (XRM_ERROR);
+    if (rspRecord.size() < sizeof(int32_t) || rspRecord.size() > rspMaxLen) {
+        xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s unexpected response length: %lu\n", __func__,
+               rspRecord.size());
+        return (XRM_ERROR);
+    }
+    std::memcpy(rsp, rspRecord.data(), rspRecord.size());
+    return (XRM_SUCCESS);
+}
+
+/**
+ * Internal function.
+ *
+ * \brief sets up the shared memory transport of the context if it's enabled with
+ * environment XRM_SHM_TRANSPORT=1 and supported by daemon. The context stays on the
+ * socket if any step fails.
+ *
+ * @param ctx the context being created
+ * @return void
+ **/
+static void xrmShmAttach(xrmPrivateContext* ctx) {
+    const char* env = std::getenv("XRM_SHM_TRANSPORT");
+    boost::system::error_code ec;
+    void* addr;
+
+    if (env == NULL || std::strcmp(env, "1") != 0) return;
+    if (ctx->binaryProtocolVersion < XRM_BINARY_PROTOCOL_VERSION_3) return;
+    auto endpoint = ctx->socket->local_endpoint(ec);
+    if (ec || endpoint.protocol().family() != AF_UNIX) return;
+
+    ctx->shmFd = memfd_create("xrm_shm_ring", MFD_CLOEXEC);
+    ctx->shmRequestEventFd = eventfd(0, EFD_CLOEXEC);
+    ctx->shmResponseEventFd = eventfd(0, EFD_CLOEXEC);
+    if (ctx->shmFd < 0 || ctx->shmRequestEventFd < 0 || ctx->shmResponseEventFd < 0 ||
+        ftruncate(ctx->shmFd, sizeof(xrm::shmRingPair)) != 0) {
+        xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s: fail to create shared memory or eventfd, errno %d", __func__,
+               errno);
+        xrmShmDetach(ctx);
+        return;
+    }
+    addr = mmap(NULL, sizeof(xrm::shmRingPair), PROT_READ | PROT_WRITE, MAP_SHARED, ctx->shmFd, 0);
+    if (addr == MAP_FAILED) {
+        xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s: fail to map shared memory, errno %d", __func__, errno);
+        xrmShmDetach(ctx);
+        return;
+    }
+    /* memfd is zero filled, that's the initial state of the rings */
+    ctx->shmRings = (xrm::shmRingPair*)addr;
+    ctx->shmRings->magic = XRM_SHM_RING_MAGIC;
+    ctx->shmRings->size = sizeof(xrm::shmRingPair);
+    ctx->shmRings->request.consumerWaiting.store(1);
+
+    char jsonRsp[maxLength];
+    memset(jsonRsp, 0, maxLength * sizeof(char));
+    pt::ptree shmAttachTree;
+    shmAttachTree.put("request.name", "shmAttach");
+    shmAttachTree.put("request.requestId", 1);
+    shmAttachTree.put("request.parameters.clientId", ctx->xrmClientId);
+    shmAttachTree.put("request.parameters.shmFd", ctx->shmFd);
+    shmAttachTree.put("request.parameters.requestEventFd", ctx->shmRequestEventFd);
+    shmAttachTree.put("request.parameters.responseEventFd", ctx->shmResponseEventFd);
+    std::string reqstr;
+    xrmJsonEncode(shmAttachTree, reqstr);
+    if (xrmJsonRequest(ctx, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) {
+        xrmShmDetach(ctx);
+        return;
+    }
+
+    pt::ptree rspTree;
+    xrmJsonDecode(jsonRsp, rspTree);
+    if (rspTree.get<int32_t>("response.status.value", XRM_ERROR) != XRM_SUCCESS) {
+        xrmLog(ctx->xrmLogLevel, XRM_LOG_NOTICE, "%s: daemon fails to attach shared memory, use socket", __func__);
+        xrmShmDetach(ctx);
+    }
+}
+
+/**
+ * Internal function.
+ *
+ * \brief releases the shared memory transport of the context, daemon releases its
+ * side when the connection is closed or another ring is attached.
+ *
+ * @param ctx the context
+ * @return void
+ **/
+static void xrmShmDetach(xrmPrivateContext* ctx) {
+    if (ctx->shmRings != NULL) munmap(ctx->shmRings, sizeof(xrm::shmRingPair));
+    if (ctx->shmFd >= 0) close(ctx->shmFd);
+    if (ctx->shmRequestEventFd >= 0) close(ctx->shmRequestEventFd);
+    if (ctx->shmResponseEventFd >= 0) close(ctx->shmResponseEventFd);
+    ctx->shmRings = NULL;
+    ctx->shmFd = -1;
+    ctx->shmRequestEventFd = -1;
+    ctx->shmResponseEventFd = -1;
+}
+
+/**
+ * Internal function.
+ *
+ * \brief sends a binary request through the shared memory ring and copies the
+ * response record to a caller provided buffer. It polls the response ring for a
+ * while before sleeping on the eventfd, the socket is watched to detect daemon
+ * exiting.
+ *
+ * @param ctx the context created through xrmCreateContext()
+ * @param opcode opcode of the request
+ * @param req request record
+ * @param reqLen length of the request record
+ * @param rsp buffer of the response record
+ * @param rspMaxLen size of the response buffer
+ * @return int32_t, 0 on success, XRM_ERROR_CONNECT_FAIL if the request is not sent
+ *         through the ring, or other error number
+ **/
+static int32_t xrmShmRequest(
+    xrmPrivateContext* ctx, uint16_t opcode, const void* req, uint32_t reqLen, void* rsp, uint32_t rspMaxLen) {
+    const int32_t spinNum = 10000;
+    uint64_t value = 1;
+
+    std::unique_lock<std::mutex> lock(ctx->shmLock);
+    if (ctx->shmRings == NULL) return (XRM_ERROR_CONNECT_FAIL);
+    xrm::shmRing* reqRing = &ctx->shmRings->request;
+    xrm::shmRing* rspRing = &ctx->shmRings->response;
+    if (reqRing->isFull()) return (XRM_ERROR_CONNECT_FAIL);
+
+    char* slot = reqRing->producerSlot();
+    xrm::binaryFrameHeader* reqHdr = (xrm::binaryFrameHeader*)slot;
+    reqHdr->magic = XRM_BINARY_PROTOCOL_MAGIC;
+    reqHdr->version = XRM_BINARY_PROTOCOL_VERSION_1;
+    reqHdr->opcode = opcode;
+    reqHdr->requestId = ctx->nextRequestId++;
+    reqHdr->length = reqLen;
+    std::memcpy(slot + sizeof(xrm::binaryFrameHeader), req, reqLen);
+    uint32_t requestId = reqHdr->requestId;
+    reqRing->produce();
+    if (reqRing->consumerWaiting.load()) {
+        if (write(ctx->shmRequestEventFd, &value, sizeof(value)) != sizeof(value)) {
+            xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s: fail to signal daemon, errno %d", __func__, errno);
+            xrmShmDetach(ctx);
+            return (XRM_ERROR);
+        }
+    }
+
+    for (int32_t i = 0; rspRing->isEmpty(); i++) {
+        if (i < spinNum) continue;
+        /* announce the sleep then check again, the response may come in between */
+        rspRing->consumerWaiting.store(1);
+        if (rspRing->isEmpty()) {
+            struct pollfd fds[2];
+            fds[0].fd = ctx->shmResponseEventFd;
+            fds[0].events = POLLIN;
+            fds[1].fd = ctx->socket->native_handle();
+            fds[1].events = POLLRDHUP;
+            int32_t rc = poll(fds, 2, -1);
+            if (rc < 0 && errno == EINTR) continue;
+            if (rc < 0 || (fds[1].revents & (POLLRDHUP | POLLHUP | POLLERR))) {
+                /* daemon is gone, the resource is recycled with the connection */
+                xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s: connection to daemon is closed", __func__);
+                xrmShmDetach(ctx);
+                return (XRM_ERROR_CONNECT_FAIL);
+            }
+            if ((fds[0].revents & POLLIN) && read(ctx->shmResponseEventFd, &value, sizeof(value)) < 0) {
+                xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s: fail to read eventfd, errno %d", __func__, errno);
+                xrmShmDetach(ctx);
+                return (XRM_ERROR);
+            }
+        }
+        rspRing->consumerWaiting.store(0);
+    }
+
+    slot = rspRing->consumerSlot();
+    xrm::binaryFrameHeader* rspHdr = (xrm::binaryFrameHeader*)slot;
+    int32_t ret = XRM_SUCCESS;
+    if (rspHdr->requestId != requestId || rspHdr->length < sizeof(int32_t) || rspHdr->length > rspMaxLen ||
+        rspHdr->length > XRM_SHM_RING_SLOT_SIZE - sizeof(xrm::binaryFrameHeader)) {
+        xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s unexpected response, request id %u\n", __func__,
+               rspHdr->requestId);
+        ret = XRM_ERROR;
+    } else {
+        std::memcpy(rsp, slot + sizeof(xrm::binaryFrameHeader), rspHdr->length);
+    }
+    rspRing->consume();
+    return (ret);
+}
+
+/**
+ * Internal function.
+ *
+ * \brief converts the cu resource record of binary framing to the cu resource.
+ *
+ * @param binCuRes the cu resource record from daemon
+ * @param cuRes the cu resource to be filled
+ * @return void
+ **/
+static void xrmBinaryToCuResourceV2(const xrm::binaryCuResource* binCuRes, xrmCuResourceV2* cuRes) {
+    std::string uuidStr(binCuRes->uuidStr, strnlen(binCuRes->uuidStr, XRM_MAX_NAME_LEN));
+
+    strncpy(cuRes->xclbinFileName, binCuRes->xclbinFileName, XRM_MAX_PATH_NAME_LEN - 1);
+    hexstrToBin(uuidStr, 2 * sizeof(uuid_t), (unsigned char*)cuRes->uuid);
+    strncpy(cuRes->kernelPluginFileName, binCuRes->kernelPluginFileName, XRM_MAX_PATH_NAME_LEN - 1);
+    strncpy(cuRes->kernelName, binCuRes->kernelName, XRM_MAX_NAME_LEN - 1);
+    strncpy(cuRes->kernelAlias, binCuRes->kernelAlias, XRM_MAX_NAME_LEN - 1);
+    strncpy(cuRes->instanceName, binCuRes->instanceName, XRM_MAX_NAME_LEN - 1);
+    strncpy(cuRes->cuName, binCuRes->cuName, XRM_MAX_NAME_LEN - 1);
+    cuRes->deviceId = binCuRes->handle.deviceId;
+    cuRes->cuId = binCuRes->handle.cuId;
+    cuRes->channelId = binCuRes->handle.channelId;
+    cuRes->cuType = (xrmCuType)binCuRes->handle.cuType;
+    cuRes->allocServiceId = binCuRes->handle.allocServiceId;
+    cuRes->channelLoad = binCuRes->handle.channelLoadOriginal;
+    cuRes->baseAddr = binCuRes->baseAddr;
+    cuRes->membankId = binCuRes->membankId;
+    cuRes->membankType = binCuRes->membankType;
+    cuRes->membankSize = binCuRes->membankSize;
+    cuRes->membankBaseAddr = binCuRes->membankBaseAddr;
+    cuRes->poolId = binCuRes->handle.poolId;
+}
+
+/**
+ * Internal function.
+ *
+ * \brief converts the cu property to the cu property record of binary framing.
+ *
+ * @param ctx the context created through xrmCreateContext()
+ * @param cuProp the property of requested cu
+ * @param binCuProp the cu property record to be filled
+ * @return int32_t, 0 on success or appropriate error number
+ **/
+static int32_t xrmCuPropertyV2ToBinary(
+    xrmPrivateContext* ctx, xrmCuPropertyV2* cuProp, xrm::binaryCuProperty* binCuProp) {
+    if ((cuProp->kernelName[0] == '\0') && (cuProp->kernelAlias[0] == '\0')) {
+        xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s neither kernel name nor alias are provided", __func__);
+        return (XRM_ERROR_INVALID);
+    }
+    int32_t unifiedLoad = xrmRetrieveLoadInfo(cuProp->requestLoad);
+    if (unifiedLoad < 0) {
+        xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s(): wrong request load: 0x%x", __func__, cuProp->requestLoad);
+        return (XRM_ERROR_INVALID);
+    }
+    memset(binCuProp, 0, sizeof(xrm::binaryCuProperty));
+    strncpy(binCuProp->kernelName, cuProp->kernelName, XRM_MAX_NAME_LEN - 1);
+    strncpy(binCuProp->kernelAlias, cuProp->kernelAlias, XRM_MAX_NAME_LEN - 1);
+    binCuProp->devExcl = cuProp->devExcl ? 1 : 0;
+    binCuProp->deviceInfo = cuProp->deviceInfo;
+    binCuProp->memoryInfo = cuProp->memoryInfo;
+    binCuProp->policyInfo = cuProp->policyInfo;
+    binCuProp->requestLoadUnified = unifiedLoad;
+    binCuProp->requestLoadOriginal = cuProp->requestLoad;
+    binCuProp->poolId = cuProp->poolId;
+    return (XRM_SUCCESS);
+}
+
+/**
+ * Internal function.
+ *
+ * \brief converts the allocated cu resource to the cu handle record of binary framing.
+ *
+ * @param ctx the context created through xrmCreateContext()
+ * @param cuRes the allocated cu resource
+ * @param cuHandle the cu handle record to be filled
+ * @return int32_t, 0 on success or appropriate error number
+ **/
+static int32_t xrmCuResourceV2ToBinary(xrmPrivateContext* ctx, xrmCuResourceV2* cuRes, xrm::binaryCuHandle* cuHandle) {
+    int32_t unifiedLoad = xrmRetrieveLoadInfo(cuRes->channelLoad);
+    if (unifiedLoad < 0) {
+        xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s(): wrong channel load: 0x%x", __func__, cuRes->channelLoad);
+        return (XRM_ERROR_INVALID);
+    }
+    memset(cuHandle, 0, sizeof(xrm::binaryCuHandle));
+    cuHandle->deviceId = cuRes->deviceId;
+    cuHandle->cuId = cuRes->cuId;
+    cuHandle->channelId = cuRes->channelId;
+    cuHandle->cuType = (int32_t)cuRes->cuType;
+    cuHandle->allocServiceId = cuRes->allocServiceId;
+    cuHandle->channelLoadUnified = unifiedLoad;
+    cuHandle->channelLoadOriginal = cuRes->channelLoad;
+    cuHandle->poolId = cuRes->poolId;
+    return (XRM_SUCCESS);
+}
+
+/**
+ * Internal function.
+ *
+ * \brief creates an asynchronous request, referenced by both the user handle and
+ * the context.
+ *
+ * @param ctx the context created through xrmCreateContext()
+ * @param opcode opcode of the request
+ * @param result the resource to be filled on completion, NULL for release
+ * @param callback called on completion
+ * @param userData passed to callback
+ * @return xrmPrivateRequest*, the request or NULL on fail
+ **/
+static xrmPrivateRequest* xrmAsyncCreateRequest(
+    xrmPrivateContext* ctx, uint16_t opcode, void* result, xrmCompletionCallback callback, void* userData) {
+    xrmPrivateRequest* request = new xrmPrivateRequest;
+    if (request == NULL) {
+        xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s(): Fail to alloc request", __func__);
+        return (NULL);
+    }
+    request->ctx = ctx;
+    request->opcode = opcode;
+    request->result = result;
+    request->callback = callback;
+    request->userData = userData;
+    request->refCount = 2;
+    request->done = false;
+    request->status = XRM_ERROR;
+    request->eventFd = -1;
+    return (request);
+}
+
+/**
+ * Internal function.
+ *
+ * \brief drops one reference of the asynchronous request, the request is freed
+ * with the last reference.
+ *
+ * @param request the asynchronous request
+ * @return void
+ **/
+static void xrmAsyncReleaseRequest(xrmPrivateRequest* request) {
+    if (--request->refCount > 0) return;
+    if (request->eventFd >= 0) close(request->eventFd);
+    delete request;
+}
+
+/**
+ * Internal function.
+ *
+ * \brief completes the asynchronous request: sets the status, signals the fd of
+ * the request, wakes up the waiting threads and calls the callback.
+ *
+ * @param request the asynchronous request
+ * @param status status of the request
+ * @return void
+ **/
+static void xrmAsyncComplete(xrmPrivateRequest* request, int32_t status) {
+    {
+        std::unique_lock<std::mutex> lock(request->lock);
+        request->done = true;
+        request->status = status;
+        if (request->eventFd >= 0) {
+            uint64_t value = 1;
+            if (write(request->eventFd, &value, sizeof(value)) != sizeof(value))
+                xrmLog(request->ctx->xrmLogLevel, XRM_LOG_ERROR, "%s: fail to write eventfd, errno %d", __func__,
+                       errno);
+        }
+        request->cond.notify_all();
+    }
+    if (request->callback != NULL) request->callback((xrmRequest)request, status, request->userData);
+    xrmAsyncReleaseRequest(request);
+}
+
+/**
+ * Internal function.
+ *
+ * \brief converts the response record of the asynchronous request to the result
+ * of the request.
+ *
+ * @param request the asynchronous request
+ * @param rsp response record
+ * @return int32_t, status of the request, 0 on success or appropriate error number
+ **/
+static int32_t xrmAsyncDecode(xrmPrivateRequest* request, std::vector<char>& rsp) {
+    xrmPrivateContext* ctx = request->ctx;
+    int32_t status;
+    int32_t i;
+
+    if (rsp.size() < sizeof(status)) {
+        xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s unexpected response length: %lu\n", __func__, rsp.size());
+        return (XRM_ERROR_CONNECT_FAIL);
+    }
+    std::memcpy(&status, rsp.data(), sizeof(status));
+    if (status != XRM_SUCCESS) return (status);
+    switch (request->opcode) {
+        case xrm::XRM_BINARY_OP_CU_ALLOC_V2: {
+            if (rsp.size() < sizeof(xrm::binaryCuAllocV2Response)) break;
+            auto allocRsp = (const xrm::binaryCuAllocV2Response*)rsp.data();
+            xrmBinaryToCuResourceV2(&allocRsp->cuRes, (xrmCuResourceV2*)request->result);
+            return (status);
+        }
+        case xrm::XRM_BINARY_OP_CU_LIST_ALLOC_V2: {
+            auto allocRsp = (const xrm::binaryCuListAllocV2Response*)rsp.data();
+            auto cuListRes = (xrmCuListResourceV2*)request->result;
+            if (rsp.size() < offsetof(xrm::binaryCuListAllocV2Response, cuResources) || allocRsp->cuNum < 0 ||
+                allocRsp->cuNum > XRM_MAX_LIST_CU_NUM_V2 ||
+                rsp.size() < offsetof(xrm::binaryCuListAllocV2Response, cuResources) +
+                                 allocRsp->cuNum * sizeof(xrm::binaryCuResource))
+                break;
+            cuListRes->cuNum = allocRsp->cuNum;
+            for (i = 0; i < cuListRes->cuNum; i++)
+                xrmBinaryToCuResourceV2(&allocRsp->cuResources[i], &cuListRes->cuResources[i]);
+            return (status);
+        }
+        default:
+            return (status);
+    }
+    xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s unexpected response length: %lu\n", __func__, rsp.size());
+    return (XRM_ERROR_CONNECT_FAIL);
+}
+
+/**
+ * Internal function.
+ *
+ * \brief calls the event callback for each event answered to the event wait.
+ *
+ * @param ctx the context created through xrmCreateContext()
+ * @param rsp json response of the event wait
+ * @param callback the event callback
+ * @param userData passed to callback
+ * @return void
+ **/
+static void xrmEventDeliver(xrmPrivateContext* ctx, std::vector<char>& rsp, xrmEventCallback callback, void* userData) {
+    std::string errmsg;
+    pt::ptree rspTree;
+    xrmEvent event;
+
+    if (callback == NULL) return;
+    if (xrm::getJsonCodec().decode(rsp.data(), rsp.size(), rspTree, errmsg) != XRM_SUCCESS) {
+        xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s: event wait response error: %s\n", __func__, errmsg.c_str());
+        return;
+    }
+    if (rspTree.get<int32_t>("response.status.value", XRM_ERROR) != XRM_SUCCESS) return;
+    auto eventNum = rspTree.get<int32_t>("response.data.eventNum", 0);
+    for (int32_t i = 0; i < eventNum; i++) {
+        std::string idx = std::to_string(i);
+        memset(&event, 0, sizeof(event));
+        event.type = (xrmEventType)rspTree.get<uint32_t>("response.data.type" + idx, 0);
+        event.deviceId = rspTree.get<int32_t>("response.data.deviceId" + idx, -1);
+        event.poolId = rspTree.get<uint64_t>("response.data.poolId" + idx, 0);
+        strncpy(event.kernelName, rspTree.get<std::string>("response.data.kernelName" + idx, "").c_str(),
+                XRM_MAX_NAME_LEN - 1);
+        strncpy(event.kernelAlias, rspTree.get<std::string>("response.data.kernelAlias" + idx, "").c_str(),
+                XRM_MAX_NAME_LEN - 1);
+        callback((xrmContext)ctx, &event, userData);
+    }
+}
+
+/**
+ * Internal function.
+ *
+ * \brief sends the event wait to the XRM daemon if the context is subscribed and
+ * no event wait is in flight, it's answered once there are events for the context.
+ *
+ * @param ctx the context created through xrmCreateContext()
+ * @return int32_t, 0 on success or appropriate error number
+ **/
+static int32_t xrmEventArm(xrmPrivateContext* ctx) {
+    uint32_t requestId = ctx->nextRequestId++;
+    pt::ptree eventWaitTree;
+    std::string reqstr;
+
+    eventWaitTree.put("request.name", "eventWait");
+    eventWaitTree.put("request.requestId", requestId);
+    eventWaitTree.put("request.parameters.clientId", ctx->xrmClientId);
+    xrmJsonEncode(eventWaitTree, reqstr);
+    {
+        std::unique_lock<std::mutex> lock(ctx->rspLock);
+        if (ctx->eventCallback == NULL || ctx->eventRequestId != 0) return (XRM_SUCCESS);
+        if (ctx->rspBroken || xrmAsyncStart(ctx) != XRM_SUCCESS) return (XRM_ERROR);
+        /* registered before sending, the response may come at once */
+        ctx->eventRequestId = requestId;
+        ctx->rspCond.notify_all();
+    }
+    if (xrmFrameSend(ctx, xrm::XRM_BINARY_OP_JSON, requestId, reqstr.c_str(), reqstr.length()) != XRM_SUCCESS) {
+        std::unique_lock<std::mutex> lock(ctx->rspLock);
+        ctx->rspBroken = true;
+        ctx->rspCond.notify_all();
+        return (XRM_ERROR);
+    }
+    return (XRM_SUCCESS);
+}
+
+/**
+ * Internal function.
+ *
+ * \brief completion thread of the context, it waits for the responses of the
+ * asynchronous requests in flight and completes them, and delivers the events
+ * answered to the event wait. It takes part in reading the connection only when
+ * there is asynchronous request or event wait in flight, and exits once stopped
+ * and all the requests are completed.
+ *
+ * @param ctx the context created through xrmCreateContext()
+ * @return void
+ **/
+static void xrmAsyncThread(xrmPrivateContext* ctx) {
+    std::unique_lock<std::mutex> lock(ctx->rspLock);
+    uint32_t requestId;
+
+    while (true) {
+        if (ctx->asyncRequests.empty() && ctx->eventRequestId == 0) {
+            if (ctx->asyncStop) return;
+            ctx->rspCond.wait(lock);
+            continue;
+        }
+        std::vector<char> rsp;
+        int32_t ret = xrmFrameWait(
+            ctx, lock,
+            [ctx](uint32_t id) {
+                return (ctx->asyncRequests.count(id) != 0 || (id != 0 && id == ctx->eventRequestId));
+            },
+            &requestId, rsp);
+        if (ret != XRM_SUCCESS) {
+            /* connection is broken, no response will come */
+            std::map<uint32_t, xrmPrivateRequest*> failed;
+            failed.swap(ctx->asyncRequests);
+            ctx->eventRequestId = 0;
+            ctx->rspCond.notify_all();
+            lock.unlock();
+            for (auto& it : failed) xrmAsyncComplete(it.second, XRM_ERROR_CONNECT_FAIL);
+            lock.lock();
+            continue;
+        }
+        if (requestId == ctx->eventRequestId) {
+            xrmEventCallback callback = ctx->eventCallback;
+            void* userData = ctx->eventUserData;
+            ctx->eventRequestId = 0;
+            ctx->eventDelivering = true;
+            lock.unlock();
+            xrmEventDeliver(ctx, rsp, callback, userData);
+            /* the next event wait, unless unsubscribed meanwhile */
+            xrmEventArm(ctx);
+            lock.lock();
+            ctx->eventDelivering = false;
+            ctx->rspCond.notify_all();
+            continue;
+        }
+        auto it = ctx->asyncRequests.find(requestId);
+        xrmPrivateRequest* request = it->second;
+        ctx->asyncRequests.erase(it);
+        lock.unlock();
+        xrmAsyncComplete(request, xrmAsyncDecode(request, rsp));
+        lock.lock();
+    }
+}
+
+/**
+ * Internal function.
+ *
+ * \brief starts the completion thread of the context if it's not running, called
+ * with rspLock held.
+ *
+ * @param ctx the context created through xrmCreateContext()
+ * @return int32_t, 0 on success or appropriate error number
+ **/
+static int32_t xrmAsyncStart(xrmPrivateContext* ctx) {
+    if (ctx->asyncThread != NULL) return (XRM_SUCCESS);
+    try {
+        ctx->asyncThread = new std::thread(xrmAsyncThread, ctx);
+    } catch (std::exception& e) {
+        xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s Exception: %s\n", __func__, e.what());
+        return (XRM_ERROR);
     }
+    return (XRM_SUCCESS);
+}
 
-    return (rc);
+/**
+ * Internal function.
+ *
+ * \brief sends the asynchronous request to the XRM daemon, the response is picked
+ * up by the completion thread which is started here for the first request.
+ *
+ * @param ctx the context created through xrmCreateContext()
+ * @param request the asynchronous request
+ * @param req request record
+ * @param reqLen length of the request record
+ * @return xrmRequest, the request handle
+ **/
+static xrmRequest xrmAsyncSubmit(xrmPrivateContext* ctx, xrmPrivateRequest* request, const void* req, uint32_t reqLen) {
+    uint32_t requestId = ctx->nextRequestId++;
+
+    xrmLog(ctx->xrmLogLevel, XRM_LOG_NOTICE, "Sending async binary opcode %d, length %d\n", request->opcode, reqLen);
+    {
+        std::unique_lock<std::mutex> lock(ctx->rspLock);
+        if (ctx->rspBroken) {
+            lock.unlock();
+            xrmAsyncComplete(request, XRM_ERROR_CONNECT_FAIL);
+            return ((xrmRequest)request);
+        }
+        if (xrmAsyncStart(ctx) != XRM_SUCCESS) {
+            lock.unlock();
+            xrmAsyncComplete(request, XRM_ERROR);
+            return ((xrmRequest)request);
+        }
+        /* registered before sending, the response may come at once */
+        ctx->asyncRequests[requestId] = request;
+    }
+    if (xrmFrameSend(ctx, request->opcode, requestId, req, reqLen) != XRM_SUCCESS) {
+        /* the stream is broken by the failed write, completion thread fails the requests in flight */
+        std::unique_lock<std::mutex> lock(ctx->rspLock);
+        ctx->rspBroken = true;
+        ctx->rspCond.notify_all();
+    }
+    return ((xrmRequest)request);
+}
+
+/**
+ * Internal function.
+ *
+ * \brief stops the completion thread of the context after the asynchronous
+ * requests in flight are completed.
+ *
+ * @param ctx the context created through xrmCreateContext()
+ * @return void
+ **/
+static void xrmAsyncStop(xrmPrivateContext* ctx) {
+    std::thread* asyncThread;
+
+    {
+        std::unique_lock<std::mutex> lock(ctx->rspLock);
+        ctx->asyncStop = true;
+        ctx->rspCond.notify_all();
+        asyncThread = ctx->asyncThread;
+        ctx->asyncThread = NULL;
+    }
+    if (asyncThread != NULL) {
+        asyncThread->join();
+        delete asyncThread;
+    }
 }
 
 /**
@@ -395,14 +1546,12 @@ bool xrmIsDaemonRunning(xrmContext context) {
     loadOneDeviceTree.put("request.parameters.echoClientId", "echo");
     loadOneDeviceTree.put("request.parameters.clientId", ctx->xrmClientId);
 
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, loadOneDeviceTree);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (ret);
+    std::string reqstr;
+    xrmJsonEncode(loadOneDeviceTree, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (ret);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     auto value = rspTree.get<int32_t>("response.status.value");
     if (value == XRM_SUCCESS) {
@@ -439,14 +1588,12 @@ int32_t xrmEnableOneDevice(xrmContext context, int32_t deviceId) {
     enableOneDeviceTree.put("request.parameters.echoClientId", "echo");
     enableOneDeviceTree.put("request.parameters.clientId", ctx->xrmClientId);
 
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, enableOneDeviceTree);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
+    std::string reqstr;
+    xrmJsonEncode(enableOneDeviceTree, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     auto ret = rspTree.get<int32_t>("response.status.value");
     if (ret != XRM_SUCCESS) {
@@ -485,14 +1632,12 @@ int32_t xrmDisableOneDevice(xrmContext context, int32_t deviceId) {
     disableOneDeviceTree.put("request.parameters.echoClientId", "echo");
     disableOneDeviceTree.put("request.parameters.clientId", ctx->xrmClientId);
 
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, disableOneDeviceTree);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
+    std::string reqstr;
+    xrmJsonEncode(disableOneDeviceTree, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     auto ret = rspTree.get<int32_t>("response.status.value");
     if (ret != XRM_SUCCESS) {
@@ -537,14 +1682,12 @@ int32_t xrmLoadOneDevice(xrmContext context, int32_t deviceId, char* xclbinFileN
     loadOneDeviceTree.put("request.parameters.echoClientId", "echo");
     loadOneDeviceTree.put("request.parameters.clientId", ctx->xrmClientId);
 
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, loadOneDeviceTree);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
+    std::string reqstr;
+    xrmJsonEncode(loadOneDeviceTree, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     auto ret = rspTree.get<int32_t>("response.status.value");
     if (ret == XRM_SUCCESS) {
@@ -582,14 +1725,12 @@ int32_t xrmUnloadOneDevice(xrmContext context, int32_t deviceId) {
     unloadOneDeviceTree.put("request.parameters.echoClientId", "echo");
     unloadOneDeviceTree.put("request.parameters.clientId", ctx->xrmClientId);
 
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, unloadOneDeviceTree);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
+    std::string reqstr;
+    xrmJsonEncode(unloadOneDeviceTree, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     auto ret = rspTree.get<int32_t>("response.status.value");
     if (ret != XRM_SUCCESS) {
@@ -645,41 +1786,16 @@ static void binToHexstr(unsigned char* in, int32_t insz, std::string& outStr) {
 }
 
 /**
- * \brief Allocates compute unit with a device, cu, and channel given a
- * kernel name or alias or both and request load. This function also
- * provides the xclbin and kernel plugin loaded on the device.
+ * Internal function.
  *
- * @param context the context created through xrmCreateContext()
- * @param cuProp the property of requested cu.
- *             kernelName: the kernel name requested.
- *             kernelAlias: the alias of kernel name requested.
- *             devExcl: request exclusive device usage for this client.
- *             requestLoad: request load, only one type granularity at one time.
- *                          bit[31 - 28] reserved
- *                          bit[27 -  8] granularity of 1000000 (0 - 1000000)
- *                          bit[ 7 -  0] granularity of 100 (0 - 100)
- *             poolId: request to allocate cu from specified resource pool
- * @param cuRes the cu resource.
- *             xclbinFileName: xclbin (path and name) attached to this device.
- *             kernelPluginFileName: kernel plugin (only name) attached to this device.
- *             kernelName: the kernel name of allocated cu.
- *             kernelAlias: the name alias of allocated cu.
- *             instanceName: the instance name of allocated cu.
- *             cuName: the name of allocated cu (kernelName:instanceName).
- *             uuid: uuid of the loaded xclbin file.
- *             deviceId: device id of this cu.
- *             cuId: cu id of this cu.
- *             channelId: channel id of this cu.
- *             cuType: type of cu, hardware kernel or soft kernel.
- *             allocServiceId: service id for this cu allocation.
- *             channelLoad: allocated load of this cu, only one type granularity at one time.
- *                          bit[31 - 28] reserved
- *                          bit[27 -  8] granularity of 1000000 (0 - 1000000)
- *                          bit[ 7 -  0] granularity of 100 (0 - 100)
- *             poolId: id of the cu pool this cu comes from, the system default pool id is 0.
- * @return int32_t, 0 on success or appropriate error number
- */
-int32_t xrmCuAlloc(xrmContext context, xrmCuProperty* cuProp, xrmCuResource* cuRes) {
+ * \brief allocates compute unit given a kernel name or alias or both and request load, see xrmCuAlloc().
+ *
+ * @param wait NULL for one try, otherwise the request is parked in daemon until allocated or timed out
+ **/
+static int32_t xrmCuAllocRequest(xrmContext context,
+                                 xrmCuProperty* cuProp,
+                                 xrmCuResource* cuRes,
+                                 const xrmPrivateWait* wait) {
     xrmPrivateContext* ctx = (xrmPrivateContext*)context;
     int32_t unifiedLoad; // granularity of 1,000,000
 
@@ -723,14 +1839,18 @@ int32_t xrmCuAlloc(xrmContext context, xrmCuProperty* cuProp, xrmCuResource* cuR
     cuAllocTree.put("request.parameters.requestLoadOriginal", cuProp->requestLoad);
     cuAllocTree.put("request.parameters.poolId", cuProp->poolId);
 
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, cuAllocTree);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
+    if (wait != NULL) {
+        /* parked in daemon until allocated or timed out */
+        cuAllocTree.put("request.parameters.waitPriority", wait->priority);
+        cuAllocTree.put("request.parameters.waitTimeout", wait->timeout);
+    }
+
+    std::string reqstr;
+    xrmJsonEncode(cuAllocTree, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     int32_t ret = rspTree.get<int32_t>("response.status.value");
     if (ret == XRM_SUCCESS) {
@@ -765,6 +1885,45 @@ int32_t xrmCuAlloc(xrmContext context, xrmCuProperty* cuProp, xrmCuResource* cuR
     return (ret);
 }
 
+/**
+ * \brief Allocates compute unit with a device, cu, and channel given a
+ * kernel name or alias or both and request load. This function also
+ * provides the xclbin and kernel plugin loaded on the device.
+ *
+ * @param context the context created through xrmCreateContext()
+ * @param cuProp the property of requested cu.
+ *             kernelName: the kernel name requested.
+ *             kernelAlias: the alias of kernel name requested.
+ *             devExcl: request exclusive device usage for this client.
+ *             requestLoad: request load, only one type granularity at one time.
+ *                          bit[31 - 28] reserved
+ *                          bit[27 -  8] granularity of 1000000 (0 - 1000000)
+ *                          bit[ 7 -  0] granularity of 100 (0 - 100)
+ *             poolId: request to allocate cu from specified resource pool
+ * @param cuRes the cu resource.
+ *             xclbinFileName: xclbin (path and name) attached to this device.
+ *             kernelPluginFileName: kernel plugin (only name) attached to this device.
+ *             kernelName: the kernel name of allocated cu.
+ *             kernelAlias: the name alias of allocated cu.
+ *             instanceName: the instance name of allocated cu.
+ *             cuName: the name of allocated cu (kernelName:instanceName).
+ *             uuid: uuid of the loaded xclbin file.
+ *             deviceId: device id of this cu.
+ *             cuId: cu id of this cu.
+ *             channelId: channel id of this cu.
+ *             cuType: type of cu, hardware kernel or soft kernel.
+ *             allocServiceId: service id for this cu allocation.
+ *             channelLoad: allocated load of this cu, only one type granularity at one time.
+ *                          bit[31 - 28] reserved
+ *                          bit[27 -  8] granularity of 1000000 (0 - 1000000)
+ *                          bit[ 7 -  0] granularity of 100 (0 - 100)
+ *             poolId: id of the cu pool this cu comes from, the system default pool id is 0.
+ * @return int32_t, 0 on success or appropriate error number
+ */
+int32_t xrmCuAlloc(xrmContext context, xrmCuProperty* cuProp, xrmCuResource* cuRes) {
+    return (xrmCuAllocRequest(context, cuProp, cuRes, NULL));
+}
+
 /**
  * \brief Allocates compute unit from specified device given a
  * kernel name or alias or both and request load. This function also
@@ -850,14 +2009,12 @@ int32_t xrmCuAllocFromDev(xrmContext context, int32_t deviceId, xrmCuProperty* c
     cuAllocTree.put("request.parameters.requestLoadOriginal", cuProp->requestLoad);
     cuAllocTree.put("request.parameters.poolId", cuProp->poolId);
 
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, cuAllocTree);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
+    std::string reqstr;
+    xrmJsonEncode(cuAllocTree, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     int32_t ret = rspTree.get<int32_t>("response.status.value");
     if (ret == XRM_SUCCESS) {
@@ -977,14 +2134,12 @@ int32_t xrmCuAllocLeastUsedFromDev(xrmContext context, int32_t deviceId, xrmCuPr
     cuAllocTree.put("request.parameters.requestLoadOriginal", cuProp->requestLoad);
     cuAllocTree.put("request.parameters.poolId", cuProp->poolId);
 
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, cuAllocTree);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
+    std::string reqstr;
+    xrmJsonEncode(cuAllocTree, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     int32_t ret = rspTree.get<int32_t>("response.status.value");
     if (ret == XRM_SUCCESS) {
@@ -1020,20 +2175,16 @@ int32_t xrmCuAllocLeastUsedFromDev(xrmContext context, int32_t deviceId, xrmCuPr
 }
 
 /**
- * \brief Allocates a list of compute unit resource given a list of
- * kernels's property with kernel name or alias or both and request load.
+ * Internal function.
  *
- * @param context the context created through xrmCreateContext()
- * @param cuListProp the property of cu list.
- *             cuProps: cu prop list to fill kernelName, devExcl and requestLoad, starting from cuProps[0], no hole.
- *             cuNum: request number of cu in this list.
- *             sameDevice: request this list of cu from same device.
- * @param cuListRes the cu list resource.
- *             cuResources: cu resource list to fill the allocated cus infor, starting from cuResources[0], no hole.
- *             cuNum: allocated cu number in this list.
- * @return int32_t, 0 on success or appropriate error number
- */
-int32_t xrmCuListAlloc(xrmContext context, xrmCuListProperty* cuListProp, xrmCuListResource* cuListRes) {
+ * \brief allocates a list of compute unit resource, see xrmCuListAlloc().
+ *
+ * @param wait NULL for one try, otherwise the request is parked in daemon until allocated or timed out
+ **/
+static int32_t xrmCuListAllocRequest(xrmContext context,
+                                     xrmCuListProperty* cuListProp,
+                                     xrmCuListResource* cuListRes,
+                                     const xrmPrivateWait* wait) {
     int32_t ret = XRM_ERROR;
     int32_t i;
     xrmCuProperty* cuProp;
@@ -1095,14 +2246,18 @@ int32_t xrmCuListAlloc(xrmContext context, xrmCuListProperty* cuListProp, xrmCuL
         cuListAllocTree.put("request.parameters.poolId" + std::to_string(i), cuProp->poolId);
     }
 
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, cuListAllocTree);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
+    if (wait != NULL) {
+        /* parked in daemon until allocated or timed out */
+        cuListAllocTree.put("request.parameters.waitPriority", wait->priority);
+        cuListAllocTree.put("request.parameters.waitTimeout", wait->timeout);
+    }
+
+    std::string reqstr;
+    xrmJsonEncode(cuListAllocTree, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     ret = rspTree.get<int32_t>("response.status.value");
     if (ret == XRM_SUCCESS) {
@@ -1143,6 +2298,24 @@ int32_t xrmCuListAlloc(xrmContext context, xrmCuListProperty* cuListProp, xrmCuL
     return (ret);
 }
 
+/**
+ * \brief Allocates a list of compute unit resource given a list of
+ * kernels's property with kernel name or alias or both and request load.
+ *
+ * @param context the context created through xrmCreateContext()
+ * @param cuListProp the property of cu list.
+ *             cuProps: cu prop list to fill kernelName, devExcl and requestLoad, starting from cuProps[0], no hole.
+ *             cuNum: request number of cu in this list.
+ *             sameDevice: request this list of cu from same device.
+ * @param cuListRes the cu list resource.
+ *             cuResources: cu resource list to fill the allocated cus infor, starting from cuResources[0], no hole.
+ *             cuNum: allocated cu number in this list.
+ * @return int32_t, 0 on success or appropriate error number
+ */
+int32_t xrmCuListAlloc(xrmContext context, xrmCuListProperty* cuListProp, xrmCuListResource* cuListRes) {
+    return (xrmCuListAllocRequest(context, cuListProp, cuListRes, NULL));
+}
+
 /**
  * \brief Declares user defined cu group type given the specified
  * kernels's property with cu name (kernelName:instanceName) and request load
@@ -1222,14 +2395,12 @@ int32_t xrmUdfCuGroupDeclare(xrmContext context, xrmUdfCuGroupProperty* udfCuGro
         }
     }
 
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, groupDeclareTree);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
+    std::string reqstr;
+    xrmJsonEncode(groupDeclareTree, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     ret = rspTree.get<int32_t>("response.status.value");
     return (ret);
@@ -1272,33 +2443,28 @@ int32_t xrmUdfCuGroupUndeclare(xrmContext context, char* udfCuGroupName) {
     groupUndeclareTree.put("request.parameters.clientId", ctx->xrmClientId);
     groupUndeclareTree.put("request.parameters.udfCuGroupName", udfCuGroupName);
 
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, groupUndeclareTree);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
+    std::string reqstr;
+    xrmJsonEncode(groupUndeclareTree, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     ret = rspTree.get<int32_t>("response.status.value");
     return (ret);
 }
 
 /**
- * \brief Allocates a group of compute unit resource given a user defined group of
- * kernels's property with cu name (kernelName:instanceName) and request load.
+ * Internal function.
  *
- * @param context the context created through xrmCreateContext()
- * @param cuGroupProp the property of cu group.
- *             udfCuGroupName: user defined cu group type name.
- *             poolId: id of the cu pool this group CUs come from, the system default pool id is 0.
- * @param cuGroupRes the cu group resource.
- *             cuResources: cu resource group to fill the allocated cus infor, starting from cuResources[0], no hole.
- *             cuNum: allocated cu number in this group.
- * @return int32_t, 0 on success or appropriate error number
- */
-int32_t xrmCuGroupAlloc(xrmContext context, xrmCuGroupProperty* cuGroupProp, xrmCuGroupResource* cuGroupRes) {
+ * \brief allocates a group of compute unit resource, see xrmCuGroupAlloc().
+ *
+ * @param wait NULL for one try, otherwise the request is parked in daemon until allocated or timed out
+ **/
+static int32_t xrmCuGroupAllocRequest(xrmContext context,
+                                      xrmCuGroupProperty* cuGroupProp,
+                                      xrmCuGroupResource* cuGroupRes,
+                                      const xrmPrivateWait* wait) {
     int32_t ret = XRM_ERROR;
     int32_t i;
     xrmCuProperty* cuProp;
@@ -1333,14 +2499,18 @@ int32_t xrmCuGroupAlloc(xrmContext context, xrmCuGroupProperty* cuGroupProp, xrm
     cuGroupAllocTree.put("request.parameters.clientId", ctx->xrmClientId);
     cuGroupAllocTree.put("request.parameters.clientProcessId", clientProcessId);
 
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, cuGroupAllocTree);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
+    if (wait != NULL) {
+        /* parked in daemon until allocated or timed out */
+        cuGroupAllocTree.put("request.parameters.waitPriority", wait->priority);
+        cuGroupAllocTree.put("request.parameters.waitTimeout", wait->timeout);
+    }
+
+    std::string reqstr;
+    xrmJsonEncode(cuGroupAllocTree, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     ret = rspTree.get<int32_t>("response.status.value");
     if (ret == XRM_SUCCESS) {
@@ -1381,6 +2551,23 @@ int32_t xrmCuGroupAlloc(xrmContext context, xrmCuGroupProperty* cuGroupProp, xrm
     return (ret);
 }
 
+/**
+ * \brief Allocates a group of compute unit resource given a user defined group of
+ * kernels's property with cu name (kernelName:instanceName) and request load.
+ *
+ * @param context the context created through xrmCreateContext()
+ * @param cuGroupProp the property of cu group.
+ *             udfCuGroupName: user defined cu group type name.
+ *             poolId: id of the cu pool this group CUs come from, the system default pool id is 0.
+ * @param cuGroupRes the cu group resource.
+ *             cuResources: cu resource group to fill the allocated cus infor, starting from cuResources[0], no hole.
+ *             cuNum: allocated cu number in this group.
+ * @return int32_t, 0 on success or appropriate error number
+ */
+int32_t xrmCuGroupAlloc(xrmContext context, xrmCuGroupProperty* cuGroupProp, xrmCuGroupResource* cuGroupRes) {
+    return (xrmCuGroupAllocRequest(context, cuGroupProp, cuGroupRes, NULL));
+}
+
 /**
  * \brief Retrieves the maximum capacity associated with a resource
  *
@@ -1417,14 +2604,12 @@ uint64_t xrmCuGetMaxCapacity(xrmContext context, xrmCuProperty* cuProp) {
     cuGetMaxCapacityTree.put("request.parameters.kernelName", cuProp->kernelName);
     cuGetMaxCapacityTree.put("request.parameters.kernelAlias", cuProp->kernelAlias);
 
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, cuGetMaxCapacityTree);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (0);
+    std::string reqstr;
+    xrmJsonEncode(cuGetMaxCapacityTree, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (0);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     auto maxCapacity = rspTree.get<uint64_t>("response.status.value");
     return (maxCapacity);
@@ -1465,6 +2650,26 @@ int32_t xrmCuCheckStatus(xrmContext context, xrmCuResource* cuRes, xrmCuStat* cu
     }
     memset(cuStat, 0, sizeof(xrmCuStat));
 
+    if (ctx->binaryProtocolVersion >= XRM_BINARY_PROTOCOL_VERSION_1) {
+        xrm::binaryCuCheckStatusRequest statusReq;
+        xrm::binaryCuCheckStatusResponse statusRsp;
+        memset(&statusReq, 0, sizeof(statusReq));
+        statusReq.clientId = ctx->xrmClientId;
+        statusReq.cuHandle.deviceId = cuRes->deviceId;
+        statusReq.cuHandle.cuId = cuRes->cuId;
+        statusReq.cuHandle.channelId = cuRes->channelId;
+        statusReq.cuHandle.cuType = (int32_t)cuRes->cuType;
+        statusReq.cuHandle.allocServiceId = cuRes->allocServiceId;
+        if (xrmBinaryRequest(context, xrm::XRM_BINARY_OP_CU_CHECK_STATUS, &statusReq, sizeof(statusReq), &statusRsp,
+                             sizeof(statusRsp)) != XRM_SUCCESS)
+            return (XRM_ERROR_CONNECT_FAIL);
+        if (statusRsp.status == XRM_SUCCESS) {
+            cuStat->isBusy = (statusRsp.isBusy != 0);
+            cuStat->usedLoad = statusRsp.usedLoadOriginal;
+        }
+        return (statusRsp.status);
+    }
+
     char jsonRsp[maxLength];
     memset(jsonRsp, 0, maxLength * sizeof(char));
     pt::ptree cuCheckStatusTree;
@@ -1478,14 +2683,12 @@ int32_t xrmCuCheckStatus(xrmContext context, xrmCuResource* cuRes, xrmCuStat* cu
     cuCheckStatusTree.put("request.parameters.cuType", (int32_t)cuRes->cuType);
     cuCheckStatusTree.put("request.parameters.allocServiceId", cuRes->allocServiceId);
 
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, cuCheckStatusTree);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
+    std::string reqstr;
+    xrmJsonEncode(cuCheckStatusTree, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     auto ret = rspTree.get<int32_t>("response.status.value");
     if (ret == XRM_SUCCESS) {
@@ -1558,14 +2761,12 @@ bool xrmCuRelease(xrmContext context, xrmCuResource* cuRes) {
     xrmCuRelease.put("request.parameters.channelLoadOriginal", cuRes->channelLoad);
     xrmCuRelease.put("request.parameters.poolId", cuRes->poolId);
 
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, xrmCuRelease);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (ret);
+    std::string reqstr;
+    xrmJsonEncode(xrmCuRelease, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (ret);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     auto value = rspTree.get<int32_t>("response.status.value");
     if (value == XRM_SUCCESS) {
@@ -1633,14 +2834,12 @@ bool xrmCuListRelease(xrmContext context, xrmCuListResource* cuListRes) {
         cuListReleaseTree.put("request.parameters.channelLoadOriginal" + std::to_string(i), cuRes->channelLoad);
         cuListReleaseTree.put("request.parameters.poolId" + std::to_string(i), cuRes->poolId);
     }
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, cuListReleaseTree);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (ret);
+    std::string reqstr;
+    xrmJsonEncode(cuListReleaseTree, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (ret);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     auto value = rspTree.get<int32_t>("response.status.value");
     if (value == XRM_SUCCESS) {
@@ -1709,14 +2908,12 @@ bool xrmCuGroupRelease(xrmContext context, xrmCuGroupResource* cuGroupRes) {
         cuGroupReleaseTree.put("request.parameters.channelLoadOriginal" + std::to_string(i), cuRes->channelLoad);
         cuGroupReleaseTree.put("request.parameters.poolId" + std::to_string(i), cuRes->poolId);
     }
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, cuGroupReleaseTree);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (ret);
+    std::string reqstr;
+    xrmJsonEncode(cuGroupReleaseTree, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (ret);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     auto value = rspTree.get<int32_t>("response.status.value");
     if (value == XRM_SUCCESS) {
@@ -1770,14 +2967,12 @@ int32_t xrmAllocationQuery(xrmContext context, xrmAllocationQueryInfo* allocQuer
     allocQueryTree.put("request.parameters.kernelName", allocQuery->kernelName);
     allocQueryTree.put("request.parameters.kernelAlias", allocQuery->kernelAlias);
 
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, allocQueryTree);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
+    std::string reqstr;
+    xrmJsonEncode(allocQueryTree, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     ret = rspTree.get<int32_t>("response.status.value");
     if (ret == XRM_SUCCESS) {
@@ -1856,14 +3051,12 @@ bool xrmIsCuExisting(xrmContext context, xrmCuProperty* cuProp) {
     isCuExistingTree.put("request.parameters.echoClientId", "echo");
     isCuExistingTree.put("request.parameters.clientId", ctx->xrmClientId);
 
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, isCuExistingTree);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (ret);
+    std::string reqstr;
+    xrmJsonEncode(isCuExistingTree, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (ret);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     auto value = rspTree.get<int32_t>("response.status.value");
     if (value == XRM_SUCCESS) {
@@ -1928,14 +3121,12 @@ bool xrmIsCuListExisting(xrmContext context, xrmCuListProperty* cuListProp) {
         isCuListExistingTree.put("request.parameters.kernelAlias" + std::to_string(i), cuProp->kernelAlias);
     }
 
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, isCuListExistingTree);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (ret);
+    std::string reqstr;
+    xrmJsonEncode(isCuListExistingTree, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (ret);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     auto value = rspTree.get<int32_t>("response.status.value");
     if (value == XRM_SUCCESS) {
@@ -1982,14 +3173,12 @@ bool xrmIsCuGroupExisting(xrmContext context, xrmCuGroupProperty* cuGroupProp) {
     checkCuGroupTree.put("request.parameters.echoClientId", "echo");
     checkCuGroupTree.put("request.parameters.clientId", ctx->xrmClientId);
 
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, checkCuGroupTree);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (ret);
+    std::string reqstr;
+    xrmJsonEncode(checkCuGroupTree, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (ret);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     auto value = rspTree.get<int32_t>("response.status.value");
     if (value == XRM_SUCCESS) {
@@ -2059,14 +3248,12 @@ int32_t xrmCheckCuAvailableNum(xrmContext context, xrmCuProperty* cuProp) {
     checkCuAvailableTree.put("request.parameters.clientProcessId", clientProcessId);
     checkCuAvailableTree.put("request.parameters.poolId", cuProp->poolId);
 
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, checkCuAvailableTree);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
+    std::string reqstr;
+    xrmJsonEncode(checkCuAvailableTree, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     ret = rspTree.get<int32_t>("response.status.value");
     if (ret == XRM_SUCCESS) {
@@ -2148,14 +3335,12 @@ int32_t xrmCheckCuListAvailableNum(xrmContext context, xrmCuListProperty* cuList
         checkCuListAvailableNumTree.put("request.parameters.poolId" + std::to_string(i), cuProp->poolId);
     }
 
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, checkCuListAvailableNumTree);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
+    std::string reqstr;
+    xrmJsonEncode(checkCuListAvailableNumTree, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     ret = rspTree.get<int32_t>("response.status.value");
     if (ret == XRM_SUCCESS) {
@@ -2205,14 +3390,12 @@ int32_t xrmCheckCuGroupAvailableNum(xrmContext context, xrmCuGroupProperty* cuGr
     checkCuGroupTree.put("request.parameters.clientId", ctx->xrmClientId);
     checkCuGroupTree.put("request.parameters.clientProcessId", clientProcessId);
 
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, checkCuGroupTree);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
+    std::string reqstr;
+    xrmJsonEncode(checkCuGroupTree, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     ret = rspTree.get<int32_t>("response.status.value");
     if (ret == XRM_SUCCESS) {
@@ -2309,14 +3492,12 @@ int32_t xrmCheckCuPoolAvailableNum(xrmContext context, xrmCuPoolProperty* cuPool
     checkCuPoolTree.put("request.parameters.xclbinUuidStr", uuidStr.c_str());
     checkCuPoolTree.put("request.parameters.xclbinNum", cuPoolProp->xclbinNum);
 
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, checkCuPoolTree);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
+    std::string reqstr;
+    xrmJsonEncode(checkCuPoolTree, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     ret = rspTree.get<int32_t>("response.status.value");
     if (ret == XRM_SUCCESS) {
@@ -2413,14 +3594,12 @@ uint64_t xrmCuPoolReserve(xrmContext context, xrmCuPoolProperty* cuPoolProp) {
     cuPoolReserveTree.put("request.parameters.xclbinUuidStr", uuidStr.c_str());
     cuPoolReserveTree.put("request.parameters.xclbinNum", cuPoolProp->xclbinNum);
 
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, cuPoolReserveTree);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (reserve_poolId);
+    std::string reqstr;
+    xrmJsonEncode(cuPoolReserveTree, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (reserve_poolId);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     auto value = rspTree.get<int32_t>("response.status.value");
     if (value == XRM_SUCCESS) {
@@ -2464,14 +3643,12 @@ bool xrmCuPoolRelinquish(xrmContext context, uint64_t poolId) {
     cuPoolRelinquishTree.put("request.parameters.echoClientId", "echo");
     cuPoolRelinquishTree.put("request.parameters.clientId", ctx->xrmClientId);
 
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, cuPoolRelinquishTree);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (ret);
+    std::string reqstr;
+    xrmJsonEncode(cuPoolRelinquishTree, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (ret);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     auto value = rspTree.get<int32_t>("response.status.value");
     if (value == XRM_SUCCESS) {
@@ -2520,14 +3697,12 @@ int32_t xrmReservationQuery(xrmContext context, uint64_t poolId, xrmCuPoolResour
     reservationQueryTree.put("request.parameters.clientId", ctx->xrmClientId);
     reservationQueryTree.put("request.parameters.poolId", poolId);
 
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, reservationQueryTree);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
+    std::string reqstr;
+    xrmJsonEncode(reservationQueryTree, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     ret = rspTree.get<int32_t>("response.status.value");
     if (ret == XRM_SUCCESS) {
@@ -2603,14 +3778,12 @@ int32_t xrmExecPluginFunc(xrmContext context, char* xrmPluginName, uint32_t func
     execPluginFuncTree.put("request.parameters.funcId", funcId);
     execPluginFuncTree.put("request.parameters.input", param->input);
 
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, execPluginFuncTree);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
+    std::string reqstr;
+    xrmJsonEncode(execPluginFuncTree, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     ret = rspTree.get<int32_t>("response.status.value");
     if (ret == XRM_SUCCESS) {
@@ -2710,14 +3883,12 @@ int32_t xrmCuAllocWithLoad(xrmContext context, xrmCuProperty* cuProp, char* xclb
     cuAllocWithLoadTree.put("request.parameters.poolId", 0);
     cuAllocWithLoadTree.put("request.parameters.xclbinFileName", xclbinFileName);
 
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, cuAllocWithLoadTree);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
+    std::string reqstr;
+    xrmJsonEncode(cuAllocWithLoadTree, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     int32_t ret = rspTree.get<int32_t>("response.status.value");
     if (ret == XRM_SUCCESS) {
@@ -2847,14 +4018,12 @@ int32_t xrmCuAllocLeastUsedWithLoad(xrmContext context,
     cuAllocLeastUsedWithLoadTree.put("request.parameters.poolId", 0);
     cuAllocLeastUsedWithLoadTree.put("request.parameters.xclbinFileName", xclbinFileName);
 
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, cuAllocLeastUsedWithLoadTree);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
+    std::string reqstr;
+    xrmJsonEncode(cuAllocLeastUsedWithLoadTree, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     int32_t ret = rspTree.get<int32_t>("response.status.value");
     if (ret == XRM_SUCCESS) {
@@ -2928,14 +4097,12 @@ int32_t xrmLoadAndAllCuAlloc(xrmContext context, char* xclbinFileName, xrmCuList
     loadAndAllCuAllocTree.put("request.parameters.clientId", ctx->xrmClientId);
     loadAndAllCuAllocTree.put("request.parameters.clientProcessId", clientProcessId);
 
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, loadAndAllCuAllocTree);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
+    std::string reqstr;
+    xrmJsonEncode(loadAndAllCuAllocTree, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     int32_t ret, i;
     ret = rspTree.get<int32_t>("response.status.value");
@@ -2978,6 +4145,34 @@ int32_t xrmLoadAndAllCuAlloc(xrmContext context, char* xclbinFileName, xrmCuList
     return (ret);
 }
 
+/**
+ * Internal function.
+ *
+ * \brief tries the allocation until success, for the daemon not supporting the blocking
+ * allocation parked in daemon.
+ *
+ * @param interval the interval time (useconds) before re-trying, 0 to yield only
+ * @param timeout the time (useconds) to stop trying, 0 to try until success
+ * @param alloc the allocation to try
+ * @return int32_t, 0 on success or the error number of the last try
+ **/
+template <typename allocFunc>
+static int32_t xrmBlockingAllocPoll(uint64_t interval, uint64_t timeout, allocFunc alloc) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(timeout);
+    int32_t ret;
+
+    while (true) {
+        ret = alloc();
+        if (ret == XRM_SUCCESS || ret == XRM_ERROR_CONNECT_FAIL) break;
+        if (timeout && std::chrono::steady_clock::now() >= deadline) break;
+        if (interval)
+            usleep(interval);
+        else
+            sched_yield();
+    }
+    return (ret);
+}
+
 /**
  * \brief Blocking function of xrmCuAlloc(), this function will try to do cu allocation
  * until success.
@@ -3040,18 +4235,55 @@ int32_t xrmCuBlockingAlloc(xrmContext context, xrmCuProperty* cuProp, uint64_t i
     }
 
     if (!xrmIsCuExisting(ctx, cuProp)) return (XRM_ERROR_NO_KERNEL);
-    int32_t ret = XRM_ERROR_NO_KERNEL;
-    if (interval)
-        while ((ret != XRM_SUCCESS) && (ret != XRM_ERROR_CONNECT_FAIL)) {
-            ret = xrmCuAlloc(ctx, cuProp, cuRes);
-            usleep(interval);
-        }
-    else
-        while ((ret != XRM_SUCCESS) && (ret != XRM_ERROR_CONNECT_FAIL)) {
-            ret = xrmCuAlloc(ctx, cuProp, cuRes);
-            sched_yield();
-        }
-    return (ret);
+    if (ctx->binaryProtocolVersion >= XRM_BINARY_PROTOCOL_VERSION_5) {
+        xrmPrivateWait wait = {0, 0};
+        return (xrmCuAllocRequest(ctx, cuProp, cuRes, &wait));
+    }
+    return (xrmBlockingAllocPoll(interval, 0, [&]() { return (xrmCuAlloc(ctx, cuProp, cuRes)); }));
+}
+
+/**
+ * \brief Blocking function of xrmCuAlloc() with priority and timeout, the request waits in
+ * daemon until the cu is allocated or timed out. The waiting requests are served in the order
+ * of priority, and then in the order of arrival.
+ *
+ * @param context the context created through xrmCreateContext()
+ * @param cuProp the property of cu, see xrmCuBlockingAlloc().
+ * @param priority the priority of the request, the higher one is served first.
+ * @param timeout the time (useconds) to wait, 0 means waiting until the cu is allocated.
+ * @param cuRes cu resource, see xrmCuBlockingAlloc().
+ * @return int32_t, 0 on success or the error number of the last try when timed out
+ */
+int32_t xrmCuBlockingAllocWithTimeout(
+    xrmContext context, xrmCuProperty* cuProp, int32_t priority, uint64_t timeout, xrmCuResource* cuRes) {
+    xrmPrivateContext* ctx = (xrmPrivateContext*)context;
+    int32_t unifiedLoad; // granularity of 1,000,000
+
+    if (ctx == NULL || cuProp == NULL || cuRes == NULL) {
+        xrmLog(XRM_LOG_ERROR, XRM_LOG_ERROR, "%s(): context, cu properties or resource pointer is NULL\n", __func__);
+        return (XRM_ERROR_INVALID);
+    }
+    if (ctx->xrmApiVersion != XRM_API_VERSION_1) {
+        xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s wrong xrm api version %d", __func__, ctx->xrmApiVersion);
+        return (XRM_ERROR_INVALID);
+    }
+    if ((cuProp->kernelName[0] == '\0') && (cuProp->kernelAlias[0] == '\0')) {
+        xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s neither kernel name nor alias are provided", __func__);
+        return (XRM_ERROR_INVALID);
+    }
+    unifiedLoad = xrmRetrieveLoadInfo(cuProp->requestLoad);
+    if (unifiedLoad < 0) {
+        xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s(): wrong request load: %d", __func__, cuProp->requestLoad);
+        return (XRM_ERROR_INVALID);
+    }
+
+    if (!xrmIsCuExisting(ctx, cuProp)) return (XRM_ERROR_NO_KERNEL);
+    if (ctx->binaryProtocolVersion >= XRM_BINARY_PROTOCOL_VERSION_5) {
+        xrmPrivateWait wait = {priority, timeout};
+        return (xrmCuAllocRequest(ctx, cuProp, cuRes, &wait));
+    }
+    return (xrmBlockingAllocPoll(XRM_BLOCKING_ALLOC_POLL_INTERVAL, timeout,
+                                 [&]() { return (xrmCuAlloc(ctx, cuProp, cuRes)); }));
 }
 
 /**
@@ -3095,18 +4327,54 @@ int32_t xrmCuListBlockingAlloc(xrmContext context,
     }
 
     if (!xrmIsCuListExisting(ctx, cuListProp)) return (XRM_ERROR_NO_KERNEL);
-    int32_t ret = XRM_ERROR_NO_KERNEL;
-    if (interval)
-        while ((ret != XRM_SUCCESS) && (ret != XRM_ERROR_CONNECT_FAIL)) {
-            ret = xrmCuListAlloc(ctx, cuListProp, cuListRes);
-            usleep(interval);
-        }
-    else
-        while ((ret != XRM_SUCCESS) && (ret != XRM_ERROR_CONNECT_FAIL)) {
-            ret = xrmCuListAlloc(ctx, cuListProp, cuListRes);
-            sched_yield();
-        }
-    return (ret);
+    if (ctx->binaryProtocolVersion >= XRM_BINARY_PROTOCOL_VERSION_5) {
+        xrmPrivateWait wait = {0, 0};
+        return (xrmCuListAllocRequest(ctx, cuListProp, cuListRes, &wait));
+    }
+    return (xrmBlockingAllocPoll(interval, 0, [&]() { return (xrmCuListAlloc(ctx, cuListProp, cuListRes)); }));
+}
+
+/**
+ * \brief Blocking function of xrmCuListAlloc() with priority and timeout, the request waits in
+ * daemon until the cu list is allocated or timed out. The waiting requests are served in the
+ * order of priority, and then in the order of arrival.
+ *
+ * @param context the context created through xrmCreateContext()
+ * @param cuListProp the property of cu list, see xrmCuListBlockingAlloc().
+ * @param priority the priority of the request, the higher one is served first.
+ * @param timeout the time (useconds) to wait, 0 means waiting until the cu list is allocated.
+ * @param cuListRes cu list resource, see xrmCuListBlockingAlloc().
+ * @return int32_t, 0 on success or the error number of the last try when timed out
+ */
+int32_t xrmCuListBlockingAllocWithTimeout(xrmContext context,
+                                          xrmCuListProperty* cuListProp,
+                                          int32_t priority,
+                                          uint64_t timeout,
+                                          xrmCuListResource* cuListRes) {
+    xrmPrivateContext* ctx = (xrmPrivateContext*)context;
+
+    if (ctx == NULL || cuListProp == NULL || cuListRes == NULL) {
+        xrmLog(XRM_LOG_ERROR, XRM_LOG_ERROR, "%s(): context, cu list properties or resource pointer is NULL\n",
+               __func__);
+        return (XRM_ERROR_INVALID);
+    }
+    if (ctx->xrmApiVersion != XRM_API_VERSION_1) {
+        xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s wrong xrm api version %d", __func__, ctx->xrmApiVersion);
+        return (XRM_ERROR_INVALID);
+    }
+    if (cuListProp->cuNum <= 0 || cuListProp->cuNum > XRM_MAX_LIST_CU_NUM) {
+        xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s(): request list prop cuNum is %d, out of range from 1 to %d.\n",
+               __func__, cuListProp->cuNum, XRM_MAX_LIST_CU_NUM);
+        return (XRM_ERROR_INVALID);
+    }
+
+    if (!xrmIsCuListExisting(ctx, cuListProp)) return (XRM_ERROR_NO_KERNEL);
+    if (ctx->binaryProtocolVersion >= XRM_BINARY_PROTOCOL_VERSION_5) {
+        xrmPrivateWait wait = {priority, timeout};
+        return (xrmCuListAllocRequest(ctx, cuListProp, cuListRes, &wait));
+    }
+    return (xrmBlockingAllocPoll(XRM_BLOCKING_ALLOC_POLL_INTERVAL, timeout,
+                                 [&]() { return (xrmCuListAlloc(ctx, cuListProp, cuListRes)); }));
 }
 
 /**
@@ -3151,18 +4419,53 @@ int32_t xrmCuGroupBlockingAlloc(xrmContext context,
     }
 
     if (!xrmIsCuGroupExisting(ctx, cuGroupProp)) return (XRM_ERROR_NO_KERNEL);
-    int32_t ret = XRM_ERROR_NO_KERNEL;
-    if (interval)
-        while ((ret != XRM_SUCCESS) && (ret != XRM_ERROR_CONNECT_FAIL)) {
-            ret = xrmCuGroupAlloc(ctx, cuGroupProp, cuGroupRes);
-            usleep(interval);
-        }
-    else
-        while ((ret != XRM_SUCCESS) && (ret != XRM_ERROR_CONNECT_FAIL)) {
-            ret = xrmCuGroupAlloc(ctx, cuGroupProp, cuGroupRes);
-            sched_yield();
-        }
-    return (ret);
+    if (ctx->binaryProtocolVersion >= XRM_BINARY_PROTOCOL_VERSION_5) {
+        xrmPrivateWait wait = {0, 0};
+        return (xrmCuGroupAllocRequest(ctx, cuGroupProp, cuGroupRes, &wait));
+    }
+    return (xrmBlockingAllocPoll(interval, 0, [&]() { return (xrmCuGroupAlloc(ctx, cuGroupProp, cuGroupRes)); }));
+}
+
+/**
+ * \brief Blocking function of xrmCuGroupAlloc() with priority and timeout, the request waits in
+ * daemon until the cu group is allocated or timed out. The waiting requests are served in the
+ * order of priority, and then in the order of arrival.
+ *
+ * @param context the context created through xrmCreateContext()
+ * @param cuGroupProp the property of cu group, see xrmCuGroupBlockingAlloc().
+ * @param priority the priority of the request, the higher one is served first.
+ * @param timeout the time (useconds) to wait, 0 means waiting until the cu group is allocated.
+ * @param cuGroupRes cu group resource, see xrmCuGroupBlockingAlloc().
+ * @return int32_t, 0 on success or the error number of the last try when timed out
+ */
+int32_t xrmCuGroupBlockingAllocWithTimeout(xrmContext context,
+                                           xrmCuGroupProperty* cuGroupProp,
+                                           int32_t priority,
+                                           uint64_t timeout,
+                                           xrmCuGroupResource* cuGroupRes) {
+    xrmPrivateContext* ctx = (xrmPrivateContext*)context;
+
+    if (ctx == NULL || cuGroupProp == NULL || cuGroupRes == NULL) {
+        xrmLog(XRM_LOG_ERROR, XRM_LOG_ERROR, "%s(): context, cu group property or resource pointer is NULL\n",
+               __func__);
+        return (XRM_ERROR_INVALID);
+    }
+    if (ctx->xrmApiVersion != XRM_API_VERSION_1) {
+        xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s wrong xrm api version %d", __func__, ctx->xrmApiVersion);
+        return (XRM_ERROR_INVALID);
+    }
+    if (cuGroupProp->udfCuGroupName[0] == '\0') {
+        xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s(): invalid input: udfCuGroupName is not provided.\n", __func__);
+        return (XRM_ERROR_INVALID);
+    }
+
+    if (!xrmIsCuGroupExisting(ctx, cuGroupProp)) return (XRM_ERROR_NO_KERNEL);
+    if (ctx->binaryProtocolVersion >= XRM_BINARY_PROTOCOL_VERSION_5) {
+        xrmPrivateWait wait = {priority, timeout};
+        return (xrmCuGroupAllocRequest(ctx, cuGroupProp, cuGroupRes, &wait));
+    }
+    return (xrmBlockingAllocPoll(XRM_BLOCKING_ALLOC_POLL_INTERVAL, timeout,
+                                 [&]() { return (xrmCuGroupAlloc(ctx, cuGroupProp, cuGroupRes)); }));
 }
 
 /**
@@ -3256,6 +4559,20 @@ int32_t xrmCuAllocV2(xrmContext context, xrmCuPropertyV2* cuProp, xrmCuResourceV
 
     memset(cuRes, 0, sizeof(xrmCuResourceV2));
 
+    if (ctx->binaryProtocolVersion >= XRM_BINARY_PROTOCOL_VERSION_1) {
+        xrm::binaryCuAllocV2Request allocReq;
+        xrm::binaryCuAllocV2Response allocRsp;
+        memset(&allocReq, 0, sizeof(allocReq));
+        allocReq.clientId = ctx->xrmClientId;
+        allocReq.clientProcessId = getpid();
+        if (xrmCuPropertyV2ToBinary(ctx, cuProp, &allocReq.cuProp) != XRM_SUCCESS) return (XRM_ERROR_INVALID);
+        if (xrmBinaryRequest(context, xrm::XRM_BINARY_OP_CU_ALLOC_V2, &allocReq, sizeof(allocReq), &allocRsp,
+                             sizeof(allocRsp)) != XRM_SUCCESS)
+            return (XRM_ERROR_CONNECT_FAIL);
+        if (allocRsp.status == XRM_SUCCESS) xrmBinaryToCuResourceV2(&allocRsp.cuRes, cuRes);
+        return (allocRsp.status);
+    }
+
     char jsonRsp[maxLength];
     memset(jsonRsp, 0, maxLength * sizeof(char));
     pt::ptree cuAllocTree;
@@ -3279,14 +4596,12 @@ int32_t xrmCuAllocV2(xrmContext context, xrmCuPropertyV2* cuProp, xrmCuResourceV
     cuAllocTree.put("request.parameters.requestLoadOriginal", cuProp->requestLoad);
     cuAllocTree.put("request.parameters.poolId", cuProp->poolId);
 
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, cuAllocTree);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
+    std::string reqstr;
+    xrmJsonEncode(cuAllocTree, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     int32_t ret = rspTree.get<int32_t>("response.status.value");
     if (ret == XRM_SUCCESS) {
@@ -3370,6 +4685,35 @@ int32_t xrmCuListAllocV2(xrmContext context, xrmCuListPropertyV2* cuListProp, xr
         return (XRM_ERROR_INVALID);
     }
 
+    if (ctx->binaryProtocolVersion >= XRM_BINARY_PROTOCOL_VERSION_1) {
+        xrm::binaryCuListAllocV2Request allocReq;
+        xrm::binaryCuListAllocV2Response allocRsp;
+        memset(&allocReq, 0, sizeof(allocReq));
+        allocReq.clientId = ctx->xrmClientId;
+        allocReq.clientProcessId = getpid();
+        allocReq.cuNum = cuListProp->cuNum;
+        for (i = 0; i < cuListProp->cuNum; i++) {
+            cuProp = &cuListProp->cuProps[i];
+            // as cu/dev most/least used policy will not work for cu list allocation, so force it to 0
+            cuProp->policyInfo = 0;
+            if (xrmCuPropertyV2ToBinary(ctx, cuProp, &allocReq.cuProps[i]) != XRM_SUCCESS) {
+                xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s cuProps[%d] is invalid", __func__, i);
+                return (XRM_ERROR_INVALID);
+            }
+        }
+        uint32_t reqLen =
+            offsetof(xrm::binaryCuListAllocV2Request, cuProps) + allocReq.cuNum * sizeof(xrm::binaryCuProperty);
+        if (xrmBinaryRequest(context, xrm::XRM_BINARY_OP_CU_LIST_ALLOC_V2, &allocReq, reqLen, &allocRsp,
+                             sizeof(allocRsp)) != XRM_SUCCESS)
+            return (XRM_ERROR_CONNECT_FAIL);
+        if (allocRsp.status == XRM_SUCCESS) {
+            cuListRes->cuNum = allocRsp.cuNum;
+            for (i = 0; i < cuListRes->cuNum && i < XRM_MAX_LIST_CU_NUM_V2; i++)
+                xrmBinaryToCuResourceV2(&allocRsp.cuResources[i], &cuListRes->cuResources[i]);
+        }
+        return (allocRsp.status);
+    }
+
     char jsonRsp[maxLength];
     memset(jsonRsp, 0, maxLength * sizeof(char));
     pt::ptree cuListAllocTree;
@@ -3411,14 +4755,12 @@ int32_t xrmCuListAllocV2(xrmContext context, xrmCuListPropertyV2* cuListProp, xr
         cuListAllocTree.put("request.parameters.poolId" + std::to_string(i), cuProp->poolId);
     }
 
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, cuListAllocTree);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
+    std::string reqstr;
+    xrmJsonEncode(cuListAllocTree, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     ret = rspTree.get<int32_t>("response.status.value");
     if (ret == XRM_SUCCESS) {
@@ -3502,6 +4844,18 @@ bool xrmCuReleaseV2(xrmContext context, xrmCuResourceV2* cuRes) {
         return (XRM_ERROR_INVALID);
     }
 
+    if (ctx->binaryProtocolVersion >= XRM_BINARY_PROTOCOL_VERSION_1) {
+        xrm::binaryCuReleaseV2Request releaseReq;
+        xrm::binaryStatusResponse releaseRsp;
+        memset(&releaseReq, 0, sizeof(releaseReq));
+        releaseReq.clientId = ctx->xrmClientId;
+        if (xrmCuResourceV2ToBinary(ctx, cuRes, &releaseReq.cuHandle) != XRM_SUCCESS) return (ret);
+        if (xrmBinaryRequest(context, xrm::XRM_BINARY_OP_CU_RELEASE_V2, &releaseReq, sizeof(releaseReq),
+                             &releaseRsp, sizeof(releaseRsp)) != XRM_SUCCESS)
+            return (ret);
+        return (releaseRsp.status == XRM_SUCCESS);
+    }
+
     char jsonRsp[maxLength];
     memset(jsonRsp, 0, maxLength * sizeof(char));
     pt::ptree xrmCuRelease;
@@ -3518,14 +4872,12 @@ bool xrmCuReleaseV2(xrmContext context, xrmCuResourceV2* cuRes) {
     xrmCuRelease.put("request.parameters.channelLoadOriginal", cuRes->channelLoad);
     xrmCuRelease.put("request.parameters.poolId", cuRes->poolId);
 
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, xrmCuRelease);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (ret);
+    std::string reqstr;
+    xrmJsonEncode(xrmCuRelease, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (ret);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     auto value = rspTree.get<int32_t>("response.status.value");
     if (value == XRM_SUCCESS) {
@@ -3569,6 +4921,24 @@ bool xrmCuListReleaseV2(xrmContext context, xrmCuListResourceV2* cuListRes) {
     }
 
     /* will release all the resource */
+    if (ctx->binaryProtocolVersion >= XRM_BINARY_PROTOCOL_VERSION_1) {
+        xrm::binaryCuListReleaseV2Request releaseReq;
+        xrm::binaryStatusResponse releaseRsp;
+        memset(&releaseReq, 0, sizeof(releaseReq));
+        releaseReq.clientId = ctx->xrmClientId;
+        releaseReq.cuNum = cuListRes->cuNum;
+        for (i = 0; i < cuListRes->cuNum; i++) {
+            if (xrmCuResourceV2ToBinary(ctx, &cuListRes->cuResources[i], &releaseReq.cuHandles[i]) != XRM_SUCCESS)
+                return (ret);
+        }
+        uint32_t reqLen =
+            offsetof(xrm::binaryCuListReleaseV2Request, cuHandles) + releaseReq.cuNum * sizeof(xrm::binaryCuHandle);
+        if (xrmBinaryRequest(context, xrm::XRM_BINARY_OP_CU_LIST_RELEASE_V2, &releaseReq, reqLen, &releaseRsp,
+                             sizeof(releaseRsp)) != XRM_SUCCESS)
+            return (ret);
+        return (releaseRsp.status == XRM_SUCCESS);
+    }
+
     char jsonRsp[maxLength];
     memset(jsonRsp, 0, maxLength * sizeof(char));
     pt::ptree cuListReleaseTree;
@@ -3593,14 +4963,12 @@ bool xrmCuListReleaseV2(xrmContext context, xrmCuListResourceV2* cuListRes) {
         cuListReleaseTree.put("request.parameters.channelLoadOriginal" + std::to_string(i), cuRes->channelLoad);
         cuListReleaseTree.put("request.parameters.poolId" + std::to_string(i), cuRes->poolId);
     }
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, cuListReleaseTree);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (ret);
+    std::string reqstr;
+    xrmJsonEncode(cuListReleaseTree, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (ret);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     auto value = rspTree.get<int32_t>("response.status.value");
     if (value == XRM_SUCCESS) {
@@ -3610,6 +4978,379 @@ bool xrmCuListReleaseV2(xrmContext context, xrmCuListResourceV2* cuListRes) {
     return (ret);
 }
 
+/**
+ * \brief Asynchronous version of xrmCuAllocV2(). The request is sent and the
+ * function returns without waiting for the response. On completion cuRes is
+ * filled, the callback (if any) is called and the fd of the request becomes
+ * readable. cuProp is no longer used once this function returns, cuRes must stay
+ * valid until the request is completed.
+ *
+ * The requests are pipelined on the connection of the context. With a daemon
+ * not supporting pipelining, the request is done inside this function and it's
+ * already completed when returned.
+ *
+ * @param context the context created through xrmCreateContext().
+ * @param cuProp the property of requested cu, see xrmCuAllocV2().
+ * @param cuRes the cu resource to be filled on completion.
+ * @param callback called on completion, can be NULL.
+ * @param userData passed to callback.
+ * @return xrmRequest, the request handle or NULL if the request is invalid.
+ */
+xrmRequest xrmCuAllocV2Async(xrmContext context,
+                             xrmCuPropertyV2* cuProp,
+                             xrmCuResourceV2* cuRes,
+                             xrmCompletionCallback callback,
+                             void* userData) {
+    xrmPrivateContext* ctx = (xrmPrivateContext*)context;
+    xrm::binaryCuAllocV2Request allocReq;
+
+    if (ctx == NULL || cuProp == NULL || cuRes == NULL) {
+        xrmLog(XRM_LOG_ERROR, XRM_LOG_ERROR, "%s(): context, cu properties or resource pointer is NULL\n", __func__);
+        return (NULL);
+    }
+    if (ctx->xrmApiVersion != XRM_API_VERSION_1) {
+        xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s wrong xrm api version %d", __func__, ctx->xrmApiVersion);
+        return (NULL);
+    }
+    memset(&allocReq, 0, sizeof(allocReq));
+    allocReq.clientId = ctx->xrmClientId;
+    allocReq.clientProcessId = getpid();
+    if (xrmCuPropertyV2ToBinary(ctx, cuProp, &allocReq.cuProp) != XRM_SUCCESS) return (NULL);
+
+    xrmPrivateRequest* request =
+        xrmAsyncCreateRequest(ctx, xrm::XRM_BINARY_OP_CU_ALLOC_V2, cuRes, callback, userData);
+    if (request == NULL) return (NULL);
+    if (ctx->binaryProtocolVersion < XRM_BINARY_PROTOCOL_VERSION_2) {
+        xrmAsyncComplete(request, xrmCuAllocV2(context, cuProp, cuRes));
+        return ((xrmRequest)request);
+    }
+    memset(cuRes, 0, sizeof(xrmCuResourceV2));
+    return (xrmAsyncSubmit(ctx, request, &allocReq, sizeof(allocReq)));
+}
+
+/**
+ * \brief Asynchronous version of xrmCuListAllocV2(), see xrmCuAllocV2Async().
+ *
+ * @param context the context created through xrmCreateContext().
+ * @param cuListProp the property of cu list, see xrmCuListAllocV2().
+ * @param cuListRes the cu list resource to be filled on completion.
+ * @param callback called on completion, can be NULL.
+ * @param userData passed to callback.
+ * @return xrmRequest, the request handle or NULL if the request is invalid.
+ */
+xrmRequest xrmCuListAllocV2Async(xrmContext context,
+                                 xrmCuListPropertyV2* cuListProp,
+                                 xrmCuListResourceV2* cuListRes,
+                                 xrmCompletionCallback callback,
+                                 void* userData) {
+    xrmPrivateContext* ctx = (xrmPrivateContext*)context;
+    xrm::binaryCuListAllocV2Request allocReq;
+    int32_t i;
+
+    if (ctx == NULL || cuListProp == NULL || cuListRes == NULL) {
+        xrmLog(XRM_LOG_ERROR, XRM_LOG_ERROR, "%s(): context, cu list properties or resource pointer is NULL\n",
+               __func__);
+        return (NULL);
+    }
+    if (ctx->xrmApiVersion != XRM_API_VERSION_1) {
+        xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s wrong xrm api version %d", __func__, ctx->xrmApiVersion);
+        return (NULL);
+    }
+    if (cuListProp->cuNum <= 0 || cuListProp->cuNum > XRM_MAX_LIST_CU_NUM_V2) {
+        xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s(): request list prop cuNum is %d, out of range from 1 to %d.\n",
+               __func__, cuListProp->cuNum, XRM_MAX_LIST_CU_NUM_V2);
+        return (NULL);
+    }
+    memset(&allocReq, 0, offsetof(xrm::binaryCuListAllocV2Request, cuProps));
+    allocReq.clientId = ctx->xrmClientId;
+    allocReq.clientProcessId = getpid();
+    allocReq.cuNum = cuListProp->cuNum;
+    for (i = 0; i < cuListProp->cuNum; i++) {
+        // as cu/dev most/least used policy will not work for cu list allocation, so force it to 0
+        cuListProp->cuProps[i].policyInfo = 0;
+        if (xrmCuPropertyV2ToBinary(ctx, &cuListProp->cuProps[i], &allocReq.cuProps[i]) != XRM_SUCCESS) {
+            xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s cuProps[%d] is invalid", __func__, i);
+            return (NULL);
+        }
+    }
+
+    xrmPrivateRequest* request =
+        xrmAsyncCreateRequest(ctx, xrm::XRM_BINARY_OP_CU_LIST_ALLOC_V2, cuListRes, callback, userData);
+    if (request == NULL) return (NULL);
+    if (ctx->binaryProtocolVersion < XRM_BINARY_PROTOCOL_VERSION_2) {
+        xrmAsyncComplete(request, xrmCuListAllocV2(context, cuListProp, cuListRes));
+        return ((xrmRequest)request);
+    }
+    memset(cuListRes, 0, sizeof(xrmCuListResourceV2));
+    uint32_t reqLen =
+        offsetof(xrm::binaryCuListAllocV2Request, cuProps) + allocReq.cuNum * sizeof(xrm::binaryCuProperty);
+    return (xrmAsyncSubmit(ctx, request, &allocReq, reqLen));
+}
+
+/**
+ * \brief Asynchronous version of xrmCuReleaseV2(), see xrmCuAllocV2Async().
+ * cuRes is no longer used once this function returns.
+ *
+ * @param context the context created through xrmCreateContext().
+ * @param cuRes the cu resource to be released.
+ * @param callback called on completion, can be NULL.
+ * @param userData passed to callback.
+ * @return xrmRequest, the request handle or NULL if the request is invalid.
+ */
+xrmRequest xrmCuReleaseV2Async(xrmContext context,
+                               xrmCuResourceV2* cuRes,
+                               xrmCompletionCallback callback,
+                               void* userData) {
+    xrmPrivateContext* ctx = (xrmPrivateContext*)context;
+    xrm::binaryCuReleaseV2Request releaseReq;
+
+    if (ctx == NULL || cuRes == NULL) {
+        xrmLog(XRM_LOG_ERROR, XRM_LOG_ERROR, "%s(): context or cu resource pointer is NULL\n", __func__);
+        return (NULL);
+    }
+    if (ctx->xrmApiVersion != XRM_API_VERSION_1) {
+        xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s wrong xrm api version %d", __func__, ctx->xrmApiVersion);
+        return (NULL);
+    }
+    memset(&releaseReq, 0, sizeof(releaseReq));
+    releaseReq.clientId = ctx->xrmClientId;
+    if (xrmCuResourceV2ToBinary(ctx, cuRes, &releaseReq.cuHandle) != XRM_SUCCESS) return (NULL);
+
+    xrmPrivateRequest* request =
+        xrmAsyncCreateRequest(ctx, xrm::XRM_BINARY_OP_CU_RELEASE_V2, NULL, callback, userData);
+    if (request == NULL) return (NULL);
+    if (ctx->binaryProtocolVersion < XRM_BINARY_PROTOCOL_VERSION_2) {
+        xrmAsyncComplete(request, xrmCuReleaseV2(context, cuRes) ? XRM_SUCCESS : XRM_ERROR);
+        return ((xrmRequest)request);
+    }
+    return (xrmAsyncSubmit(ctx, request, &releaseReq, sizeof(releaseReq)));
+}
+
+/**
+ * \brief Asynchronous version of xrmCuListReleaseV2(), see xrmCuAllocV2Async().
+ * cuListRes is no longer used once this function returns.
+ *
+ * @param context the context created through xrmCreateContext().
+ * @param cuListRes the cu list resource to be released.
+ * @param callback called on completion, can be NULL.
+ * @param userData passed to callback.
+ * @return xrmRequest, the request handle or NULL if the request is invalid.
+ */
+xrmRequest xrmCuListReleaseV2Async(xrmContext context,
+                                   xrmCuListResourceV2* cuListRes,
+                                   xrmCompletionCallback callback,
+                                   void* userData) {
+    xrmPrivateContext* ctx = (xrmPrivateContext*)context;
+    xrm::binaryCuListReleaseV2Request releaseReq;
+    int32_t i;
+
+    if (ctx == NULL || cuListRes == NULL) {
+        xrmLog(XRM_LOG_ERROR, XRM_LOG_ERROR, "%s(): context or cu list resource pointer is NULL\n", __func__);
+        return (NULL);
+    }
+    if (ctx->xrmApiVersion != XRM_API_VERSION_1) {
+        xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s wrong xrm api version %d", __func__, ctx->xrmApiVersion);
+        return (NULL);
+    }
+    if (cuListRes->cuNum <= 0 || cuListRes->cuNum > XRM_MAX_LIST_CU_NUM_V2) {
+        xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s(): list resource cuNum is %d, out of range 1 - %d.\n", __func__,
+               cuListRes->cuNum, XRM_MAX_LIST_CU_NUM_V2);
+        return (NULL);
+    }
+    memset(&releaseReq, 0, offsetof(xrm::binaryCuListReleaseV2Request, cuHandles));
+    releaseReq.clientId = ctx->xrmClientId;
+    releaseReq.cuNum = cuListRes->cuNum;
+    for (i = 0; i < cuListRes->cuNum; i++) {
+        if (xrmCuResourceV2ToBinary(ctx, &cuListRes->cuResources[i], &releaseReq.cuHandles[i]) != XRM_SUCCESS)
+            return (NULL);
+    }
+
+    xrmPrivateRequest* request =
+        xrmAsyncCreateRequest(ctx, xrm::XRM_BINARY_OP_CU_LIST_RELEASE_V2, NULL, callback, userData);
+    if (request == NULL) return (NULL);
+    if (ctx->binaryProtocolVersion < XRM_BINARY_PROTOCOL_VERSION_2) {
+        xrmAsyncComplete(request, xrmCuListReleaseV2(context, cuListRes) ? XRM_SUCCESS : XRM_ERROR);
+        return ((xrmRequest)request);
+    }
+    uint32_t reqLen =
+        offsetof(xrm::binaryCuListReleaseV2Request, cuHandles) + releaseReq.cuNum * sizeof(xrm::binaryCuHandle);
+    return (xrmAsyncSubmit(ctx, request, &releaseReq, reqLen));
+}
+
+/**
+ * \brief Gets the file descriptor of an asynchronous request, it becomes readable
+ * (POLLIN) once the request is completed, so it can be added to epoll or other
+ * event loop. The fd is owned by the request and closed by xrmRequestFree().
+ *
+ * @param request the request returned by the asynchronous functions.
+ * @return int32_t, the fd or -1 on fail.
+ */
+int32_t xrmRequestGetFd(xrmRequest request) {
+    xrmPrivateRequest* req = (xrmPrivateRequest*)request;
+
+    if (req == NULL) {
+        xrmLog(XRM_LOG_ERROR, XRM_LOG_ERROR, "%s(): request pointer is NULL\n", __func__);
+        return (-1);
+    }
+    std::unique_lock<std::mutex> lock(req->lock);
+    if (req->eventFd < 0) {
+        /* created on demand, readable at once if the request is already completed */
+        req->eventFd = eventfd(req->done ? 1 : 0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (req->eventFd < 0)
+            xrmLog(req->ctx->xrmLogLevel, XRM_LOG_ERROR, "%s: fail to create eventfd, errno %d", __func__, errno);
+    }
+    return (req->eventFd);
+}
+
+/**
+ * \brief Checks whether an asynchronous request is completed, without blocking.
+ *
+ * @param request the request returned by the asynchronous functions.
+ * @param status filled with the status of the request if it's completed.
+ * @return bool, true if the request is completed or false if it's in progress.
+ */
+bool xrmRequestTest(xrmRequest request, int32_t* status) {
+    xrmPrivateRequest* req = (xrmPrivateRequest*)request;
+
+    if (req == NULL || status == NULL) {
+        xrmLog(XRM_LOG_ERROR, XRM_LOG_ERROR, "%s(): request or status pointer is NULL\n", __func__);
+        return (false);
+    }
+    std::unique_lock<std::mutex> lock(req->lock);
+    if (req->done) *status = req->status;
+    return (req->done);
+}
+
+/**
+ * \brief Waits for an asynchronous request to be completed.
+ *
+ * @param request the request returned by the asynchronous functions.
+ * @return int32_t, status of the request, 0 on success or appropriate error number.
+ */
+int32_t xrmRequestWait(xrmRequest request) {
+    xrmPrivateRequest* req = (xrmPrivateRequest*)request;
+
+    if (req == NULL) {
+        xrmLog(XRM_LOG_ERROR, XRM_LOG_ERROR, "%s(): request pointer is NULL\n", __func__);
+        return (XRM_ERROR_INVALID);
+    }
+    std::unique_lock<std::mutex> lock(req->lock);
+    req->cond.wait(lock, [req] { return (req->done); });
+    return (req->status);
+}
+
+/**
+ * \brief Frees the handle of an asynchronous request. It can be called before the
+ * request is completed (the callback is still called), or from the callback.
+ *
+ * @param request the request returned by the asynchronous functions.
+ * @return void.
+ */
+void xrmRequestFree(xrmRequest request) {
+    if (request == NULL) return;
+    xrmAsyncReleaseRequest((xrmPrivateRequest*)request);
+}
+
+/**
+ * \brief Subscribes the events pushed by the XRM daemon to the context instead of polling
+ * the resource state. Calling it again changes the event types and the callback. The
+ * XRM_EVENT_OVERFLOW event is delivered when events were dropped because they are not
+ * taken quickly enough, the resource state should be read again then.
+ *
+ * @param context the context created through xrmCreateContext().
+ * @param eventMask the event types to be subscribed, bitwise or of xrmEventType.
+ * @param callback called for each event on the completion thread of the context.
+ * @param userData passed to callback.
+ * @return int32_t, 0 on success or appropriate error number.
+ */
+int32_t xrmEventSubscribe(xrmContext context, uint32_t eventMask, xrmEventCallback callback, void* userData) {
+    xrmPrivateContext* ctx = (xrmPrivateContext*)context;
+
+    if (ctx == NULL || callback == NULL) {
+        xrmLog(XRM_LOG_ERROR, XRM_LOG_ERROR, "%s(): context or callback pointer is NULL\n", __func__);
+        return (XRM_ERROR_INVALID);
+    }
+    if (ctx->xrmApiVersion != XRM_API_VERSION_1) {
+        xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s wrong xrm api version %d", __func__, ctx->xrmApiVersion);
+        return (XRM_ERROR_INVALID);
+    }
+    if ((eventMask & XRM_EVENT_ALL) == 0) {
+        xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s(): no event type in mask 0x%x\n", __func__, eventMask);
+        return (XRM_ERROR_INVALID);
+    }
+    if (ctx->binaryProtocolVersion < XRM_BINARY_PROTOCOL_VERSION_6) {
+        xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s(): events are not supported by daemon\n", __func__);
+        return (XRM_ERROR_INVALID);
+    }
+
+    char jsonRsp[maxLength];
+    memset(jsonRsp, 0, maxLength * sizeof(char));
+    pt::ptree subscribeTree;
+    subscribeTree.put("request.name", "eventSubscribe");
+    subscribeTree.put("request.requestId", 1);
+    subscribeTree.put("request.parameters.clientId", ctx->xrmClientId);
+    subscribeTree.put("request.parameters.eventMask", eventMask & XRM_EVENT_ALL);
+    std::string reqstr;
+    xrmJsonEncode(subscribeTree, reqstr);
+    int32_t ret = xrmJsonRequest(context, reqstr.c_str(), jsonRsp);
+    if (ret != XRM_SUCCESS) return (ret);
+    pt::ptree rspTree;
+    xrmJsonDecode(jsonRsp, rspTree);
+    ret = rspTree.get<int32_t>("response.status.value", XRM_ERROR);
+    if (ret != XRM_SUCCESS) return (ret);
+
+    {
+        std::unique_lock<std::mutex> lock(ctx->rspLock);
+        ctx->eventCallback = callback;
+        ctx->eventUserData = userData;
+    }
+    return (xrmEventArm(ctx));
+}
+
+/**
+ * \brief Unsubscribes the events of the context. The callback is not called after it returns,
+ * except it's called from the callback.
+ *
+ * @param context the context created through xrmCreateContext().
+ * @return int32_t, 0 on success or appropriate error number.
+ */
+int32_t xrmEventUnsubscribe(xrmContext context) {
+    xrmPrivateContext* ctx = (xrmPrivateContext*)context;
+
+    if (ctx == NULL) {
+        xrmLog(XRM_LOG_ERROR, XRM_LOG_ERROR, "%s(): context pointer is NULL\n", __func__);
+        return (XRM_ERROR_INVALID);
+    }
+    if (ctx->xrmApiVersion != XRM_API_VERSION_1) {
+        xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s wrong xrm api version %d", __func__, ctx->xrmApiVersion);
+        return (XRM_ERROR_INVALID);
+    }
+    {
+        std::unique_lock<std::mutex> lock(ctx->rspLock);
+        if (ctx->eventCallback == NULL) return (XRM_SUCCESS);
+        ctx->eventCallback = NULL;
+        ctx->eventUserData = NULL;
+    }
+
+    /* the daemon answers the parked event wait with no event */
+    char jsonRsp[maxLength];
+    memset(jsonRsp, 0, maxLength * sizeof(char));
+    pt::ptree unsubscribeTree;
+    unsubscribeTree.put("request.name", "eventUnsubscribe");
+    unsubscribeTree.put("request.requestId", 1);
+    unsubscribeTree.put("request.parameters.clientId", ctx->xrmClientId);
+    std::string reqstr;
+    xrmJsonEncode(unsubscribeTree, reqstr);
+    int32_t ret = xrmJsonRequest(context, reqstr.c_str(), jsonRsp);
+
+    std::unique_lock<std::mutex> lock(ctx->rspLock);
+    if (ctx->asyncThread != NULL && ctx->asyncThread->get_id() == std::this_thread::get_id()) return (ret);
+    ctx->rspCond.wait(lock, [ctx] {
+        return (!ctx->eventDelivering && (ctx->rspBroken || ctx->eventRequestId == 0));
+    });
+    return (ret);
+}
+
 /**
  * \brief Declares user defined cu group type given the specified
  * kernels's property with cu name (kernelName:instanceName) and request load.
@@ -3687,14 +5428,12 @@ int32_t xrmUdfCuGroupDeclareV2(xrmContext context, xrmUdfCuGroupPropertyV2* udfC
         }
     }
 
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, groupDeclareTree);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
+    std::string reqstr;
+    xrmJsonEncode(groupDeclareTree, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     ret = rspTree.get<int32_t>("response.status.value");
     return (ret);
@@ -3734,14 +5473,12 @@ int32_t xrmUdfCuGroupUndeclareV2(xrmContext context, char* udfCuGroupName) {
     groupUndeclareTree.put("request.parameters.clientId", ctx->xrmClientId);
     groupUndeclareTree.put("request.parameters.udfCuGroupName", udfCuGroupName);
 
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, groupUndeclareTree);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
+    std::string reqstr;
+    xrmJsonEncode(groupUndeclareTree, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     ret = rspTree.get<int32_t>("response.status.value");
     return (ret);
@@ -3795,14 +5532,12 @@ int32_t xrmCuGroupAllocV2(xrmContext context, xrmCuGroupPropertyV2* cuGroupProp,
     cuGroupAllocTree.put("request.parameters.clientId", ctx->xrmClientId);
     cuGroupAllocTree.put("request.parameters.clientProcessId", clientProcessId);
 
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, cuGroupAllocTree);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
+    std::string reqstr;
+    xrmJsonEncode(cuGroupAllocTree, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     ret = rspTree.get<int32_t>("response.status.value");
     if (ret == XRM_SUCCESS) {
@@ -3902,14 +5637,12 @@ bool xrmCuGroupReleaseV2(xrmContext context, xrmCuGroupResourceV2* cuGroupRes) {
         cuGroupReleaseTree.put("request.parameters.channelLoadOriginal" + std::to_string(i), cuRes->channelLoad);
         cuGroupReleaseTree.put("request.parameters.poolId" + std::to_string(i), cuRes->poolId);
     }
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, cuGroupReleaseTree);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (ret);
+    std::string reqstr;
+    xrmJsonEncode(cuGroupReleaseTree, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (ret);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     auto value = rspTree.get<int32_t>("response.status.value");
     if (value == XRM_SUCCESS) {
@@ -3963,14 +5696,12 @@ int32_t xrmAllocationQueryV2(xrmContext context, xrmAllocationQueryInfoV2* alloc
     allocQueryTree.put("request.parameters.kernelName", allocQuery->kernelName);
     allocQueryTree.put("request.parameters.kernelAlias", allocQuery->kernelAlias);
 
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, allocQueryTree);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
+    std::string reqstr;
+    xrmJsonEncode(allocQueryTree, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     ret = rspTree.get<int32_t>("response.status.value");
     if (ret == XRM_SUCCESS) {
@@ -4011,6 +5742,221 @@ int32_t xrmAllocationQueryV2(xrmContext context, xrmAllocationQueryInfoV2* alloc
     return (ret);
 }
 
+/**
+ * Internal function.
+ *
+ * \brief does one operation of batch with the single call, for the daemon without
+ * batch support.
+ *
+ * @param context the context created through xrmCreateContext()
+ * @param op the operation
+ * @return int32_t, status of the operation, 0 on success or appropriate error number
+ **/
+static int32_t xrmBatchOpSingle(xrmContext context, xrmBatchOp* op) {
+    xrmCuResource cuRes;
+
+    switch (op->opType) {
+        case XRM_BATCH_OP_CU_ALLOC_V2:
+            return (xrmCuAllocV2(context, op->cuProp, op->cuRes));
+        case XRM_BATCH_OP_CU_RELEASE_V2:
+            return (xrmCuReleaseV2(context, op->cuRes) ? XRM_SUCCESS : XRM_ERROR);
+        case XRM_BATCH_OP_CU_CHECK_STATUS:
+            memset(&cuRes, 0, sizeof(xrmCuResource));
+            cuRes.deviceId = op->cuRes->deviceId;
+            cuRes.cuId = op->cuRes->cuId;
+            cuRes.channelId = op->cuRes->channelId;
+            cuRes.cuType = op->cuRes->cuType;
+            cuRes.allocServiceId = op->cuRes->allocServiceId;
+            return (xrmCuCheckStatus(context, &cuRes, op->cuStat));
+        case XRM_BATCH_OP_ALLOCATION_QUERY_V2:
+            return (xrmAllocationQueryV2(context, op->allocQuery, op->cuListRes));
+        default:
+            return (XRM_ERROR_INVALID);
+    }
+}
+
+/**
+ * \brief Does a batch of independent operations in one round trip to the daemon. The
+ * operations are any mix of cu alloc, cu release, cu status check and allocation query,
+ * they are done in order under one lock acquisition of the daemon, so the batch is not
+ * interleaved with the requests of other clients.
+ *
+ * @param context the context created through xrmCreateContext().
+ * @param ops the operations, starting from ops[0], no hole. Each operation is the same as
+ *            the single call (xrmCuAllocV2(), xrmCuReleaseV2(), xrmCuCheckStatus() and
+ *            xrmAllocationQueryV2()), its result is filled into the status and the output
+ *            field of the operation.
+ * @param opNum number of operations, 1 to XRM_MAX_BATCH_OP_NUM.
+ * @return int32_t, 0 on success (the batch is done, check the status of each operation)
+ *         or appropriate error number.
+ */
+int32_t xrmBatch(xrmContext context, xrmBatchOp* ops, int32_t opNum) {
+    xrmPrivateContext* ctx = (xrmPrivateContext*)context;
+    xrm::binaryBatchRequest batchReq;
+    xrm::binaryBatchResponse batchRsp;
+    xrm::binaryBatchOpHeader opHdr;
+    xrm::binaryCuProperty binCuProp;
+    xrm::binaryCuHandle cuHandle;
+    xrm::binaryAllocationQueryV2Request queryReq;
+    std::vector<char> req;
+    std::vector<char> rsp;
+    const void* opReq;
+    xrmBatchOp* op;
+    int32_t i, j;
+
+    if (ctx == NULL || ops == NULL) {
+        xrmLog(XRM_LOG_ERROR, XRM_LOG_ERROR, "%s(): context or operations pointer is NULL\n", __func__);
+        return (XRM_ERROR_INVALID);
+    }
+    if (ctx->xrmApiVersion != XRM_API_VERSION_1) {
+        xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s wrong xrm api version %d", __func__, ctx->xrmApiVersion);
+        return (XRM_ERROR_INVALID);
+    }
+    if (opNum <= 0 || opNum > XRM_MAX_BATCH_OP_NUM) {
+        xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s(): opNum is %d, out of range from 1 to %d.\n", __func__, opNum,
+               XRM_MAX_BATCH_OP_NUM);
+        return (XRM_ERROR_INVALID);
+    }
+    for (i = 0; i < opNum; i++) {
+        op = &ops[i];
+        op->status = XRM_ERROR;
+        if ((op->opType == XRM_BATCH_OP_CU_ALLOC_V2 && (op->cuProp == NULL || op->cuRes == NULL)) ||
+            (op->opType == XRM_BATCH_OP_CU_RELEASE_V2 && op->cuRes == NULL) ||
+            (op->opType == XRM_BATCH_OP_CU_CHECK_STATUS && (op->cuRes == NULL || op->cuStat == NULL)) ||
+            (op->opType == XRM_BATCH_OP_ALLOCATION_QUERY_V2 && (op->allocQuery == NULL || op->cuListRes == NULL)) ||
+            op->opType < XRM_BATCH_OP_CU_ALLOC_V2 || op->opType > XRM_BATCH_OP_ALLOCATION_QUERY_V2) {
+            xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s(): ops[%d] type %d, wrong type or NULL pointer\n", __func__, i,
+                   op->opType);
+            return (XRM_ERROR_INVALID);
+        }
+    }
+
+    if (ctx->binaryProtocolVersion < XRM_BINARY_PROTOCOL_VERSION_4) {
+        /* daemon without batch support, do the operations one by one */
+        for (i = 0; i < opNum; i++) ops[i].status = xrmBatchOpSingle(context, &ops[i]);
+        return (XRM_SUCCESS);
+    }
+
+    memset(&batchReq, 0, sizeof(batchReq));
+    batchReq.clientId = ctx->xrmClientId;
+    batchReq.clientProcessId = getpid();
+    batchReq.opNum = opNum;
+    req.insert(req.end(), (const char*)&batchReq, (const char*)&batchReq + sizeof(batchReq));
+    for (i = 0; i < opNum; i++) {
+        op = &ops[i];
+        memset(&opHdr, 0, sizeof(opHdr));
+        switch (op->opType) {
+            case XRM_BATCH_OP_CU_ALLOC_V2:
+                if (xrmCuPropertyV2ToBinary(ctx, op->cuProp, &binCuProp) != XRM_SUCCESS) return (XRM_ERROR_INVALID);
+                memset(op->cuRes, 0, sizeof(xrmCuResourceV2));
+                opHdr.opcode = xrm::XRM_BINARY_OP_CU_ALLOC_V2;
+                opHdr.length = sizeof(binCuProp);
+                opReq = &binCuProp;
+                break;
+            case XRM_BATCH_OP_CU_RELEASE_V2:
+                if (xrmCuResourceV2ToBinary(ctx, op->cuRes, &cuHandle) != XRM_SUCCESS) return (XRM_ERROR_INVALID);
+                opHdr.opcode = xrm::XRM_BINARY_OP_CU_RELEASE_V2;
+                opHdr.length = sizeof(cuHandle);
+                opReq = &cuHandle;
+                break;
+            case XRM_BATCH_OP_CU_CHECK_STATUS:
+                memset(&cuHandle, 0, sizeof(cuHandle));
+                cuHandle.deviceId = op->cuRes->deviceId;
+                cuHandle.cuId = op->cuRes->cuId;
+                cuHandle.channelId = op->cuRes->channelId;
+                cuHandle.cuType = (int32_t)op->cuRes->cuType;
+                cuHandle.allocServiceId = op->cuRes->allocServiceId;
+                opHdr.opcode = xrm::XRM_BINARY_OP_CU_CHECK_STATUS;
+                opHdr.length = sizeof(cuHandle);
+                opReq = &cuHandle;
+                break;
+            default:
+                if (op->allocQuery->allocServiceId == 0) {
+                    xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s ops[%d] invalid allocServiceId: 0 ", __func__, i);
+                    return (XRM_ERROR_INVALID);
+                }
+                memset(op->cuListRes, 0, sizeof(xrmCuListResourceV2));
+                memset(&queryReq, 0, sizeof(queryReq));
+                queryReq.allocServiceId = op->allocQuery->allocServiceId;
+                strncpy(queryReq.kernelName, op->allocQuery->kernelName, XRM_MAX_NAME_LEN - 1);
+                strncpy(queryReq.kernelAlias, op->allocQuery->kernelAlias, XRM_MAX_NAME_LEN - 1);
+                opHdr.opcode = xrm::XRM_BINARY_OP_ALLOCATION_QUERY_V2;
+                opHdr.length = sizeof(queryReq);
+                opReq = &queryReq;
+                break;
+        }
+        req.insert(req.end(), (const char*)&opHdr, (const char*)&opHdr + sizeof(opHdr));
+        req.insert(req.end(), (const char*)opReq, (const char*)opReq + opHdr.length);
+    }
+
+    xrmLog(ctx->xrmLogLevel, XRM_LOG_NOTICE, "Sending batch of %d operations, length %lu\n", opNum, req.size());
+    if (xrmFrameRequest(ctx, xrm::XRM_BINARY_OP_BATCH, req.data(), req.size(), rsp) != XRM_SUCCESS)
+        return (XRM_ERROR_CONNECT_FAIL);
+    /* the daemon answers with binaryStatusResponse only if it can not handle the batch */
+    if (rsp.size() < sizeof(batchRsp)) goto batch_unexpected;
+    std::memcpy(&batchRsp, rsp.data(), sizeof(batchRsp));
+    if (batchRsp.status != XRM_SUCCESS) return (batchRsp.status);
+    if (batchRsp.opNum != opNum) goto batch_unexpected;
+
+    {
+        size_t offset = sizeof(batchRsp);
+        for (i = 0; i < opNum; i++) {
+            op = &ops[i];
+            if (rsp.size() - offset < sizeof(opHdr)) goto batch_unexpected;
+            std::memcpy(&opHdr, rsp.data() + offset, sizeof(opHdr));
+            offset += sizeof(opHdr);
+            if (rsp.size() - offset < opHdr.length || opHdr.length < sizeof(int32_t)) goto batch_unexpected;
+            const char* opRsp = rsp.data() + offset;
+            offset += opHdr.length;
+            std::memcpy(&op->status, opRsp, sizeof(int32_t));
+            switch (op->opType) {
+                case XRM_BATCH_OP_CU_ALLOC_V2: {
+                    if (opHdr.opcode != xrm::XRM_BINARY_OP_CU_ALLOC_V2 ||
+                        opHdr.length != sizeof(xrm::binaryCuAllocV2Response))
+                        goto batch_unexpected;
+                    auto allocRsp = (const xrm::binaryCuAllocV2Response*)opRsp;
+                    if (op->status == XRM_SUCCESS) xrmBinaryToCuResourceV2(&allocRsp->cuRes, op->cuRes);
+                    break;
+                }
+                case XRM_BATCH_OP_CU_RELEASE_V2:
+                    if (opHdr.opcode != xrm::XRM_BINARY_OP_CU_RELEASE_V2) goto batch_unexpected;
+                    break;
+                case XRM_BATCH_OP_CU_CHECK_STATUS: {
+                    if (opHdr.opcode != xrm::XRM_BINARY_OP_CU_CHECK_STATUS ||
+                        opHdr.length != sizeof(xrm::binaryCuCheckStatusResponse))
+                        goto batch_unexpected;
+                    auto statusRsp = (const xrm::binaryCuCheckStatusResponse*)opRsp;
+                    if (op->status == XRM_SUCCESS) {
+                        op->cuStat->isBusy = (statusRsp->isBusy != 0);
+                        op->cuStat->usedLoad = statusRsp->usedLoadOriginal;
+                    }
+                    break;
+                }
+                default: {
+                    auto queryRsp = (const xrm::binaryCuListAllocV2Response*)opRsp;
+                    if (opHdr.opcode != xrm::XRM_BINARY_OP_ALLOCATION_QUERY_V2 ||
+                        opHdr.length < offsetof(xrm::binaryCuListAllocV2Response, cuResources) ||
+                        queryRsp->cuNum < 0 || queryRsp->cuNum > XRM_MAX_LIST_CU_NUM_V2 ||
+                        opHdr.length != offsetof(xrm::binaryCuListAllocV2Response, cuResources) +
+                                            queryRsp->cuNum * sizeof(xrm::binaryCuResource))
+                        goto batch_unexpected;
+                    if (op->status == XRM_SUCCESS) {
+                        op->cuListRes->cuNum = queryRsp->cuNum;
+                        for (j = 0; j < queryRsp->cuNum; j++)
+                            xrmBinaryToCuResourceV2(&queryRsp->cuResources[j], &op->cuListRes->cuResources[j]);
+                    }
+                    break;
+                }
+            }
+        }
+    }
+    return (XRM_SUCCESS);
+
+batch_unexpected:
+    xrmLog(ctx->xrmLogLevel, XRM_LOG_ERROR, "%s unexpected response, length: %lu\n", __func__, rsp.size());
+    return (XRM_ERROR_CONNECT_FAIL);
+}
+
 /**
  * \brief To check the available cu num on the system given
  * the kernels's property with kernel name or alias or both and request
@@ -4074,14 +6020,12 @@ int32_t xrmCheckCuAvailableNumV2(xrmContext context, xrmCuPropertyV2* cuProp) {
     checkCuAvailableTree.put("request.parameters.clientProcessId", clientProcessId);
     checkCuAvailableTree.put("request.parameters.poolId", cuProp->poolId);
 
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, checkCuAvailableTree);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
+    std::string reqstr;
+    xrmJsonEncode(checkCuAvailableTree, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     ret = rspTree.get<int32_t>("response.status.value");
     if (ret == XRM_SUCCESS) {
@@ -4168,14 +6112,12 @@ int32_t xrmCheckCuListAvailableNumV2(xrmContext context, xrmCuListPropertyV2* cu
         checkCuListAvailableNumTree.put("request.parameters.poolId" + std::to_string(i), cuProp->poolId);
     }
 
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, checkCuListAvailableNumTree);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
+    std::string reqstr;
+    xrmJsonEncode(checkCuListAvailableNumTree, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     ret = rspTree.get<int32_t>("response.status.value");
     if (ret == XRM_SUCCESS) {
@@ -4224,14 +6166,12 @@ int32_t xrmCheckCuGroupAvailableNumV2(xrmContext context, xrmCuGroupPropertyV2*
     checkCuGroupTree.put("request.parameters.clientId", ctx->xrmClientId);
     checkCuGroupTree.put("request.parameters.clientProcessId", clientProcessId);
 
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, checkCuGroupTree);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
+    std::string reqstr;
+    xrmJsonEncode(checkCuGroupTree, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     ret = rspTree.get<int32_t>("response.status.value");
     if (ret == XRM_SUCCESS) {
@@ -4344,14 +6284,12 @@ int32_t xrmCheckCuPoolAvailableNumV2(xrmContext context, xrmCuPoolPropertyV2* cu
     checkCuPoolTree.put("request.parameters.xclbinUuidStr", uuidStr.c_str());
     checkCuPoolTree.put("request.parameters.xclbinNum", cuPoolProp->xclbinNum);
 
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, checkCuPoolTree);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
+    std::string reqstr;
+    xrmJsonEncode(checkCuPoolTree, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     ret = rspTree.get<int32_t>("response.status.value");
     if (ret == XRM_SUCCESS) {
@@ -4472,14 +6410,12 @@ uint64_t xrmCuPoolReserveV2(xrmContext context, xrmCuPoolPropertyV2* cuPoolProp,
     cuPoolReserveTree.put("request.parameters.xclbinUuidStr", uuidStr.c_str());
     cuPoolReserveTree.put("request.parameters.xclbinNum", cuPoolProp->xclbinNum);
 
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, cuPoolReserveTree);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (reserve_poolId);
+    std::string reqstr;
+    xrmJsonEncode(cuPoolReserveTree, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (reserve_poolId);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     auto value = rspTree.get<int32_t>("response.status.value");
     if (value == XRM_SUCCESS) {
@@ -4545,14 +6481,12 @@ bool xrmCuPoolRelinquishV2(xrmContext context, uint64_t poolId) {
     cuPoolRelinquishTree.put("request.parameters.echoClientId", "echo");
     cuPoolRelinquishTree.put("request.parameters.clientId", ctx->xrmClientId);
 
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, cuPoolRelinquishTree);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (ret);
+    std::string reqstr;
+    xrmJsonEncode(cuPoolRelinquishTree, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (ret);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     auto value = rspTree.get<int32_t>("response.status.value");
     if (value == XRM_SUCCESS) {
@@ -4608,14 +6542,12 @@ int32_t xrmReservationQueryV2(xrmContext context,
     reservationQueryTree.put("request.parameters.kernelAlias", reserveQueryInfo->kernelAlias);
     reservationQueryTree.put("request.parameters.poolId", reserveQueryInfo->poolId);
 
-    std::stringstream reqstr;
-    boost::property_tree::write_json(reqstr, reservationQueryTree);
-    if (xrmJsonRequest(context, reqstr.str().c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
+    std::string reqstr;
+    xrmJsonEncode(reservationQueryTree, reqstr);
+    if (xrmJsonRequest(context, reqstr.c_str(), jsonRsp) != XRM_SUCCESS) return (XRM_ERROR_CONNECT_FAIL);
 
-    std::stringstream rspstr;
-    rspstr << jsonRsp;
     pt::ptree rspTree;
-    boost::property_tree::read_json(rspstr, rspTree);
+    xrmJsonDecode(jsonRsp, rspTree);
 
     ret = rspTree.get<int32_t>("response.status.value");
     if (ret == XRM_SUCCESS) {
@@ -453,6 +453,49 @@ typedef struct xrmReservationQueryInfoV2 {
     uint8_t extData[64];                // for future extension
 } xrmReservationQueryInfoV2;
 
+/* Operation type of batch */
+typedef enum xrmBatchOpType {
+    XRM_BATCH_OP_CU_ALLOC_V2 = 1,
+    XRM_BATCH_OP_CU_RELEASE_V2 = 2,
+    XRM_BATCH_OP_CU_CHECK_STATUS = 3,
+    XRM_BATCH_OP_ALLOCATION_QUERY_V2 = 4
+} xrmBatchOpType;
+
+/* One operation of batch, only the fields used by the operation type need to be set */
+typedef struct xrmBatchOp {
+    xrmBatchOpType opType;
+    int32_t status;                       // result of the operation, 0 on success or appropriate error number
+    xrmCuPropertyV2* cuProp;              // cu alloc: property of requested cu
+    xrmCuResourceV2* cuRes;               // cu alloc: allocated cu; cu release / check status: the cu
+    xrmCuStat* cuStat;                    // cu check status: status of the cu
+    xrmAllocationQueryInfoV2* allocQuery; // allocation query: query information
+    xrmCuListResourceV2* cuListRes;       // allocation query: the allocated cus
+    uint8_t extData[64];                  // for future extension
+} xrmBatchOp;
+
+/* Type of the event pushed by daemon to the subscribed context, see xrmEventSubscribe() */
+typedef enum xrmEventType {
+    XRM_EVENT_CU_AVAILABLE = 0x1,          // capacity of the kernel became available
+    XRM_EVENT_DEVICE_OFFLINE = 0x2,        // device went offline, it's being reset
+    XRM_EVENT_DEVICE_RESET = 0x4,          // device was reset, the resource on it was recycled
+    XRM_EVENT_XCLBIN_LOADED = 0x8,         // xclbin was loaded to the device
+    XRM_EVENT_XCLBIN_UNLOADED = 0x10,      // xclbin was unloaded from the device
+    XRM_EVENT_POOL_RELINQUISHED = 0x20,    // reservation pool was relinquished
+    XRM_EVENT_OVERFLOW = 0x40000000        // events were dropped for the slow subscriber, always subscribed
+} xrmEventType;
+
+#define XRM_EVENT_ALL 0x3f // mask of all the event types
+
+/* Event pushed by daemon, only the fields used by the event type are set */
+typedef struct xrmEvent {
+    xrmEventType type;
+    int32_t deviceId;                   // device of the event, -1 if not for one device
+    uint64_t poolId;                    // pool relinquished: id of the pool
+    char kernelName[XRM_MAX_NAME_LEN];  // cu available: kernel name, empty if capacity of any kernel may be freed
+    char kernelAlias[XRM_MAX_NAME_LEN]; // cu available: alias of kernel name
+    uint8_t extData[64];                // for future extension
+} xrmEvent;
+
 /*
  * plugin related data struct
  */
@@ -485,6 +528,26 @@ typedef enum xrmLogLevelType {
 
 typedef void* xrmContext;
 
+/*
+ * Handle of an asynchronous request, see xrmCuAllocV2Async(). It's valid until
+ * xrmRequestFree() is called.
+ */
+typedef void* xrmRequest;
+
+/*
+ * Called once the asynchronous request is completed, status is what the blocking
+ * call returns (for release, XRM_SUCCESS or error number instead of bool). It runs
+ * on the completion thread of the context, or on the submitting thread if the
+ * request is completed on submit, so it should not block.
+ */
+typedef void (*xrmCompletionCallback)(xrmRequest request, int32_t status, void* userData);
+
+/*
+ * Called for each event pushed to the subscribed context, see xrmEventSubscribe(). It runs
+ * on the completion thread of the context, so it should not block.
+ */
+typedef void (*xrmEventCallback)(xrmContext context, const xrmEvent* event, void* userData);
+
 /**
  * \brief Establishes a connection with the XRM daemon
  *
@@ -970,6 +1033,21 @@ int32_t xrmLoadAndAllCuAlloc(xrmContext context, char* xclbinFileName, xrmCuList
  */
 int32_t xrmCuBlockingAlloc(xrmContext context, xrmCuProperty* cuProp, uint64_t interval, xrmCuResource* cuRes);
 
+/**
+ * \brief Blocking function of xrmCuAlloc() with priority and timeout, the request waits in
+ * daemon until the cu is allocated or timed out. The waiting requests are served in the order
+ * of priority, and then in the order of arrival.
+ *
+ * @param context the context created through xrmCreateContext()
+ * @param cuProp the property of cu, see xrmCuBlockingAlloc().
+ * @param priority the priority of the request, the higher one is served first.
+ * @param timeout the time (useconds) to wait, 0 means waiting until the cu is allocated.
+ * @param cuRes cu resource, see xrmCuBlockingAlloc().
+ * @return int32_t, 0 on success or the error number of the last try when timed out
+ */
+int32_t xrmCuBlockingAllocWithTimeout(
+    xrmContext context, xrmCuProperty* cuProp, int32_t priority, uint64_t timeout, xrmCuResource* cuRes);
+
 /**
  * \brief Blocking function of xrmCuListAlloc(), this function will try to do cu list allocation
  * until success.
@@ -990,6 +1068,24 @@ int32_t xrmCuListBlockingAlloc(xrmContext context,
                                uint64_t interval,
                                xrmCuListResource* cuListRes);
 
+/**
+ * \brief Blocking function of xrmCuListAlloc() with priority and timeout, the request waits in
+ * daemon until the cu list is allocated or timed out. The waiting requests are served in the
+ * order of priority, and then in the order of arrival.
+ *
+ * @param context the context created through xrmCreateContext()
+ * @param cuListProp the property of cu list, see xrmCuListBlockingAlloc().
+ * @param priority the priority of the request, the higher one is served first.
+ * @param timeout the time (useconds) to wait, 0 means waiting until the cu list is allocated.
+ * @param cuListRes cu list resource, see xrmCuListBlockingAlloc().
+ * @return int32_t, 0 on success or the error number of the last try when timed out
+ */
+int32_t xrmCuListBlockingAllocWithTimeout(xrmContext context,
+                                          xrmCuListProperty* cuListProp,
+                                          int32_t priority,
+                                          uint64_t timeout,
+                                          xrmCuListResource* cuListRes);
+
 /**
  * \brief Blocking function of xrmCuGroupAlloc(), this function will try to do cu group
  * allocation until success.
@@ -1009,6 +1105,24 @@ int32_t xrmCuGroupBlockingAlloc(xrmContext context,
                                 uint64_t interval,
                                 xrmCuGroupResource* cuGroupRes);
 
+/**
+ * \brief Blocking function of xrmCuGroupAlloc() with priority and timeout, the request waits in
+ * daemon until the cu group is allocated or timed out. The waiting requests are served in the
+ * order of priority, and then in the order of arrival.
+ *
+ * @param context the context created through xrmCreateContext()
+ * @param cuGroupProp the property of cu group, see xrmCuGroupBlockingAlloc().
+ * @param priority the priority of the request, the higher one is served first.
+ * @param timeout the time (useconds) to wait, 0 means waiting until the cu group is allocated.
+ * @param cuGroupRes cu group resource, see xrmCuGroupBlockingAlloc().
+ * @return int32_t, 0 on success or the error number of the last try when timed out
+ */
+int32_t xrmCuGroupBlockingAllocWithTimeout(xrmContext context,
+                                           xrmCuGroupProperty* cuGroupProp,
+                                           int32_t priority,
+                                           uint64_t timeout,
+                                           xrmCuGroupResource* cuGroupRes);
+
 /**
  * \brief Allocates compute unit with a device, cu, and channel given a
  * kernel name or alias or both and request load. This function also
@@ -1141,6 +1255,135 @@ bool xrmCuReleaseV2(xrmContext context, xrmCuResourceV2* cuRes);
  */
 bool xrmCuListReleaseV2(xrmContext context, xrmCuListResourceV2* cuListRes);
 
+/**
+ * \brief Asynchronous version of xrmCuAllocV2(). The request is sent and the
+ * function returns without waiting for the response. On completion cuRes is
+ * filled, the callback (if any) is called and the fd of the request becomes
+ * readable. cuProp is no longer used once this function returns, cuRes must stay
+ * valid until the request is completed.
+ *
+ * The requests are pipelined on the connection of the context. With a daemon
+ * not supporting pipelining, the request is done inside this function and it's
+ * already completed when returned.
+ *
+ * @param context the context created through xrmCreateContext().
+ * @param cuProp the property of requested cu, see xrmCuAllocV2().
+ * @param cuRes the cu resource to be filled on completion.
+ * @param callback called on completion, can be NULL.
+ * @param userData passed to callback.
+ * @return xrmRequest, the request handle or NULL if the request is invalid.
+ */
+xrmRequest xrmCuAllocV2Async(xrmContext context,
+                             xrmCuPropertyV2* cuProp,
+                             xrmCuResourceV2* cuRes,
+                             xrmCompletionCallback callback,
+                             void* userData);
+
+/**
+ * \brief Asynchronous version of xrmCuListAllocV2(), see xrmCuAllocV2Async().
+ *
+ * @param context the context created through xrmCreateContext().
+ * @param cuListProp the property of cu list, see xrmCuListAllocV2().
+ * @param cuListRes the cu list resource to be filled on completion.
+ * @param callback called on completion, can be NULL.
+ * @param userData passed to callback.
+ * @return xrmRequest, the request handle or NULL if the request is invalid.
+ */
+xrmRequest xrmCuListAllocV2Async(xrmContext context,
+                                 xrmCuListPropertyV2* cuListProp,
+                                 xrmCuListResourceV2* cuListRes,
+                                 xrmCompletionCallback callback,
+                                 void* userData);
+
+/**
+ * \brief Asynchronous version of xrmCuReleaseV2(), see xrmCuAllocV2Async().
+ * cuRes is no longer used once this function returns.
+ *
+ * @param context the context created through xrmCreateContext().
+ * @param cuRes the cu resource to be released.
+ * @param callback called on completion, can be NULL.
+ * @param userData passed to callback.
+ * @return xrmRequest, the request handle or NULL if the request is invalid.
+ */
+xrmRequest xrmCuReleaseV2Async(xrmContext context,
+                               xrmCuResourceV2* cuRes,
+                               xrmCompletionCallback callback,
+                               void* userData);
+
+/**
+ * \brief Asynchronous version of xrmCuListReleaseV2(), see xrmCuAllocV2Async().
+ * cuListRes is no longer used once this function returns.
+ *
+ * @param context the context created through xrmCreateContext().
+ * @param cuListRes the cu list resource to be released.
+ * @param callback called on completion, can be NULL.
+ * @param userData passed to callback.
+ * @return xrmRequest, the request handle or NULL if the request is invalid.
+ */
+xrmRequest xrmCuListReleaseV2Async(xrmContext context,
+                                   xrmCuListResourceV2* cuListRes,
+                                   xrmCompletionCallback callback,
+                                   void* userData);
+
+/**
+ * \brief Gets the file descriptor of an asynchronous request, it becomes readable
+ * (POLLIN) once the request is completed, so it can be added to epoll or other
+ * event loop. The fd is owned by the request and closed by xrmRequestFree().
+ *
+ * @param request the request returned by the asynchronous functions.
+ * @return int32_t, the fd or -1 on fail.
+ */
+int32_t xrmRequestGetFd(xrmRequest request);
+
+/**
+ * \brief Checks whether an asynchronous request is completed, without blocking.
+ *
+ * @param request the request returned by the asynchronous functions.
+ * @param status filled with the status of the request if it's completed.
+ * @return bool, true if the request is completed or false if it's in progress.
+ */
+bool xrmRequestTest(xrmRequest request, int32_t* status);
+
+/**
+ * \brief Waits for an asynchronous request to be completed.
+ *
+ * @param request the request returned by the asynchronous functions.
+ * @return int32_t, status of the request, 0 on success or appropriate error number.
+ */
+int32_t xrmRequestWait(xrmRequest request);
+
+/**
+ * \brief Frees the handle of an asynchronous request. It can be called before the
+ * request is completed (the callback is still called), or from the callback.
+ *
+ * @param request the request returned by the asynchronous functions.
+ * @return void.
+ */
+void xrmRequestFree(xrmRequest request);
+
+/**
+ * \brief Subscribes the events pushed by the XRM daemon to the context instead of polling
+ * the resource state. Calling it again changes the event types and the callback. The
+ * XRM_EVENT_OVERFLOW event is delivered when events were dropped because they are not
+ * taken quickly enough, the resource state should be read again then.
+ *
+ * @param context the context created through xrmCreateContext().
+ * @param eventMask the event types to be subscribed, bitwise or of xrmEventType.
+ * @param callback called for each event on the completion thread of the context.
+ * @param userData passed to callback.
+ * @return int32_t, 0 on success or appropriate error number.
+ */
+int32_t xrmEventSubscribe(xrmContext context, uint32_t eventMask, xrmEventCallback callback, void* userData);
+
+/**
+ * \brief Unsubscribes the events of the context. The callback is not called after it returns,
+ * except it's called from the callback.
+ *
+ * @param context the context created through xrmCreateContext().
+ * @return int32_t, 0 on success or appropriate error number.
+ */
+int32_t xrmEventUnsubscribe(xrmContext context);
+
 /**
  * \brief Declares user defined cu group type given the specified
  * kernels's property with cu name (kernelName:instanceName) and request load.
@@ -1205,6 +1448,23 @@ bool xrmCuGroupReleaseV2(xrmContext context, xrmCuGroupResourceV2* cuGroupRes);
  */
 int32_t xrmAllocationQueryV2(xrmContext context, xrmAllocationQueryInfoV2* allocQuery, xrmCuListResourceV2* cuListRes);
 
+/**
+ * \brief Does a batch of independent operations in one round trip to the daemon. The
+ * operations are any mix of cu alloc, cu release, cu status check and allocation query,
+ * they are done in order under one lock acquisition of the daemon, so the batch is not
+ * interleaved with the requests of other clients.
+ *
+ * @param context the context created through xrmCreateContext().
+ * @param ops the operations, starting from ops[0], no hole. Each operation is the same as
+ *            the single call (xrmCuAllocV2(), xrmCuReleaseV2(), xrmCuCheckStatus() and
+ *            xrmAllocationQueryV2()), its result is filled into the status and the output
+ *            field of the operation.
+ * @param opNum number of operations, 1 to XRM_MAX_BATCH_OP_NUM.
+ * @return int32_t, 0 on success (the batch is done, check the status of each operation)
+ *         or appropriate error number.
+ */
+int32_t xrmBatch(xrmContext context, xrmBatchOp* ops, int32_t opNum);
+
 /**
  * \brief To check the available cu num on the system given
  * the kernels's property with kernel name or alias or both and request
@@ -47,6 +47,7 @@
 #define XRM_MAX_GROUP_CU_NUM_V2 64
 #define XRM_MAX_POOL_CU_NUM_V2 128
 #define XRM_MAX_POOL_CU_LIST_NUM_V2 8
+#define XRM_MAX_BATCH_OP_NUM 32
 #define XRM_MAX_DEV_CLIENTS (XRM_MAX_XILINX_KERNELS * 8)
 #define XRM_MAX_REGS_PER_IP 1
 #define XRM_MAX_CONNECTION_ENTRIES (XRM_MAX_DDR_MAP * XRM_MAX_XILINX_KERNELS * XRM_MAX_REGS_PER_IP)
@@ -63,4 +64,14 @@
 #define XRM_MAX_LIMIT_CONCURRENT_CLIENT 1000000   // max limit concurrent client
 #define XRM_DEFAULT_LIMIT_CONCURRENT_CLIENT 40000 // default limit concurrent client
 
+#define XRM_DEFAULT_UNIX_SOCKET_PATH "/run/xrmd.sock" // default unix domain socket of daemon
+
+#define XRM_MAX_IO_THREAD_NUM 64    // max number of daemon io threads
+#define XRM_DEFAULT_IO_THREAD_NUM 4 // default number of daemon io threads
+
+#define XRM_DEFAULT_ACCEPT_BACKLOG 1024        // default backlog of connections not accepted yet
+#define XRM_DEFAULT_LIMIT_USER_CONNECTION 0    // default limit connections of one user, 0: no limit
+#define XRM_DEFAULT_LIMIT_PENDING_COMMAND 1024 // default limit json requests waiting for a slot
+#define XRM_DEFAULT_LIMIT_IDLE_CONNECTION 1024 // default limit connections without client context
+
 #endif // _XRM_LIMITS_H_
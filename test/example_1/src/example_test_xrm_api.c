@@ -4323,6 +4323,558 @@ void xrmCuAllocReleaseV2ByPolicyLeastUsedFirstTest(xrmContext* ctx, int policyId
     printf("<<<<<<<==  end the xrm allocation test ===>>>>>>>>\n");
 }
 
+/*
+ * Completion of the asynchronous request, counts the callbacks and keeps the last status
+ */
+typedef struct xrmTestCompletion {
+    int32_t count;
+    int32_t status;
+} xrmTestCompletion;
+
+void xrmTestCompletionCallback(xrmRequest request, int32_t status, void* userData) {
+    xrmTestCompletion* completion = (xrmTestCompletion*)userData;
+    __atomic_store_n(&completion->status, status, __ATOMIC_RELEASE);
+    __atomic_add_fetch(&completion->count, 1, __ATOMIC_ACQ_REL);
+}
+
+/*
+ * Wait until the count reaches the expected number, the callbacks run on the completion thread
+ * of the context. Return true if it's reached in timeout (ms).
+ */
+bool xrmTestWaitCount(int32_t* count, int32_t expected, int32_t timeout) {
+    for (int32_t elapsed = 0; elapsed < timeout; elapsed += 10) {
+        if (__atomic_load_n(count, __ATOMIC_ACQUIRE) >= expected) return (true);
+        usleep(10000);
+    }
+    return (__atomic_load_n(count, __ATOMIC_ACQUIRE) >= expected);
+}
+
+void xrmCuAsyncAllocReleaseV2Test(xrmContext* ctx) {
+    int32_t i, ret, status;
+    xrmRequest request;
+    xrmTestCompletion completion;
+    struct pollfd pfd;
+    printf("<<<<<<<==  start the xrm async allocation V2 test ===>>>>>>>>\n");
+    if (ctx == NULL) {
+        printf("ctx is null, fail to do cu async alloc test\n");
+        return;
+    }
+
+    xrmCuPropertyV2 scalerCuProp;
+    xrmCuResourceV2 scalerCuRes;
+
+    memset(&scalerCuProp, 0, sizeof(xrmCuPropertyV2));
+    memset(&scalerCuRes, 0, sizeof(xrmCuResourceV2));
+    strcpy(scalerCuProp.kernelName, "scaler");
+    strcpy(scalerCuProp.kernelAlias, "");
+    scalerCuProp.devExcl = false;
+    scalerCuProp.deviceInfo = 0;
+    scalerCuProp.requestLoad = 45;
+    scalerCuProp.poolId = 0;
+
+    /* completion by callback */
+    printf("Test V2-12-1: async alloc scaler cu, completed by callback\n");
+    memset(&completion, 0, sizeof(completion));
+    request = xrmCuAllocV2Async(ctx, &scalerCuProp, &scalerCuRes, xrmTestCompletionCallback, &completion);
+    if (request == NULL) {
+        printf("xrmCuAllocV2Async: fail to submit scaler cu alloc\n");
+    } else {
+        ret = xrmRequestWait(request);
+        if (!xrmTestWaitCount(&completion.count, 1, 5000))
+            printf("xrmCuAllocV2Async: callback is not called\n");
+        else if (completion.status != ret)
+            printf("xrmCuAllocV2Async: callback status %d is not the request status %d\n", completion.status, ret);
+        else if (ret != XRM_SUCCESS)
+            printf("xrmCuAllocV2Async: fail to alloc scaler cu, ret is %d\n", ret);
+        else
+            printf("xrmCuAllocV2Async: allocated scaler cu: deviceId %d, cuId %d, channelId %d\n",
+                   scalerCuRes.deviceId, scalerCuRes.cuId, scalerCuRes.channelId);
+        xrmRequestFree(request);
+    }
+
+    printf("Test V2-12-2: async release scaler cu, completed by callback\n");
+    memset(&completion, 0, sizeof(completion));
+    request = xrmCuReleaseV2Async(ctx, &scalerCuRes, xrmTestCompletionCallback, &completion);
+    if (request == NULL) {
+        printf("xrmCuReleaseV2Async: fail to submit scaler cu release\n");
+    } else {
+        if (!xrmTestWaitCount(&completion.count, 1, 5000))
+            printf("xrmCuReleaseV2Async: callback is not called\n");
+        else if (completion.status != XRM_SUCCESS)
+            printf("xrmCuReleaseV2Async: fail to release scaler cu, ret is %d\n", completion.status);
+        else
+            printf("success to release scaler cu\n");
+        xrmRequestFree(request);
+    }
+
+    /* completion by polling the fd of the request, as in an event loop */
+    xrmCuListPropertyV2* scalerCuListProp;
+    xrmCuListResourceV2* scalerCuListRes;
+
+    scalerCuListProp = (xrmCuListPropertyV2*)malloc(sizeof(xrmCuListPropertyV2));
+    memset(scalerCuListProp, 0, sizeof(xrmCuListPropertyV2));
+    scalerCuListRes = (xrmCuListResourceV2*)malloc(sizeof(xrmCuListResourceV2));
+    memset(scalerCuListRes, 0, sizeof(xrmCuListResourceV2));
+
+    scalerCuListProp->cuNum = 2;
+    for (i = 0; i < scalerCuListProp->cuNum; i++) {
+        strcpy(scalerCuListProp->cuProps[i].kernelName, "scaler");
+        strcpy(scalerCuListProp->cuProps[i].kernelAlias, "");
+        scalerCuListProp->cuProps[i].devExcl = false;
+        scalerCuListProp->cuProps[i].deviceInfo = 0;
+        scalerCuListProp->cuProps[i].requestLoad = 15;
+        scalerCuListProp->cuProps[i].poolId = 0;
+    }
+
+    printf("Test V2-12-3: async alloc scaler cu list, completed by polling the request fd\n");
+    request = xrmCuListAllocV2Async(ctx, scalerCuListProp, scalerCuListRes, NULL, NULL);
+    if (request == NULL) {
+        printf("xrmCuListAllocV2Async: fail to submit scaler cu list alloc\n");
+    } else {
+        pfd.fd = xrmRequestGetFd(request);
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        if (pfd.fd < 0)
+            printf("xrmRequestGetFd: fail to get the fd of request\n");
+        else if (poll(&pfd, 1, 5000) <= 0)
+            printf("xrmCuListAllocV2Async: request fd is not readable\n");
+        else if (!xrmRequestTest(request, &status))
+            printf("xrmRequestTest: request is not completed while the fd is readable\n");
+        else if (status != XRM_SUCCESS)
+            printf("xrmCuListAllocV2Async: fail to alloc scaler cu list, ret is %d\n", status);
+        else
+            for (i = 0; i < scalerCuListRes->cuNum; i++)
+                printf("xrmCuListAllocV2Async: allocated scaler cu %d: deviceId %d, cuId %d, channelId %d\n", i,
+                       scalerCuListRes->cuResources[i].deviceId, scalerCuListRes->cuResources[i].cuId,
+                       scalerCuListRes->cuResources[i].channelId);
+        xrmRequestFree(request);
+    }
+
+    printf("Test V2-12-4: async release scaler cu list, completed by polling the request fd\n");
+    request = xrmCuListReleaseV2Async(ctx, scalerCuListRes, NULL, NULL);
+    if (request == NULL) {
+        printf("xrmCuListReleaseV2Async: fail to submit scaler cu list release\n");
+    } else {
+        pfd.fd = xrmRequestGetFd(request);
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        if (pfd.fd < 0)
+            printf("xrmRequestGetFd: fail to get the fd of request\n");
+        else if (poll(&pfd, 1, 5000) <= 0)
+            printf("xrmCuListReleaseV2Async: request fd is not readable\n");
+        else if (!xrmRequestTest(request, &status) || status != XRM_SUCCESS)
+            printf("xrmCuListReleaseV2Async: fail to release scaler cu list\n");
+        else
+            printf("success to release scaler cu list\n");
+        xrmRequestFree(request);
+    }
+
+    free(scalerCuListProp);
+    free(scalerCuListRes);
+
+    /* the request is freed before completion, the callback is still called */
+    printf("Test V2-12-5: async alloc scaler cu, request freed before completion\n");
+    memset(&scalerCuRes, 0, sizeof(xrmCuResourceV2));
+    memset(&completion, 0, sizeof(completion));
+    request = xrmCuAllocV2Async(ctx, &scalerCuProp, &scalerCuRes, xrmTestCompletionCallback, &completion);
+    if (request == NULL) {
+        printf("xrmCuAllocV2Async: fail to submit scaler cu alloc\n");
+    } else {
+        xrmRequestFree(request);
+        if (!xrmTestWaitCount(&completion.count, 1, 5000)) {
+            printf("xrmCuAllocV2Async: callback is not called after the request is freed\n");
+        } else if (completion.status != XRM_SUCCESS) {
+            printf("xrmCuAllocV2Async: fail to alloc scaler cu, ret is %d\n", completion.status);
+        } else {
+            printf("xrmCuAllocV2Async: callback is called after the request is freed\n");
+            printf("Test V2-12-6: release scaler cu\n");
+            if (xrmCuReleaseV2(ctx, &scalerCuRes))
+                printf("success to release scaler cu\n");
+            else
+                printf("fail to release scaler cu\n");
+        }
+    }
+
+    printf("<<<<<<<==  end the xrm async allocation V2 test ===>>>>>>>>\n");
+}
+
+void xrmBatchV2Test(xrmContext* ctx) {
+    int32_t i, ret;
+    printf("<<<<<<<==  start the xrm batch V2 test ===>>>>>>>>\n");
+    if (ctx == NULL) {
+        printf("ctx is null, fail to do batch test\n");
+        return;
+    }
+
+    xrmCuPropertyV2 scalerCuProp;
+    xrmCuPropertyV2 unknownCuProp;
+    xrmCuResourceV2 scalerCuRes[2];
+    xrmCuResourceV2 unknownCuRes;
+    xrmCuStat scalerCuStat;
+    xrmAllocationQueryInfoV2 allocQuery;
+    xrmCuListResourceV2* queryCuListRes;
+    xrmBatchOp ops[5];
+
+    memset(&scalerCuProp, 0, sizeof(xrmCuPropertyV2));
+    memset(scalerCuRes, 0, sizeof(scalerCuRes));
+    strcpy(scalerCuProp.kernelName, "scaler");
+    strcpy(scalerCuProp.kernelAlias, "");
+    scalerCuProp.devExcl = false;
+    scalerCuProp.deviceInfo = 0;
+    scalerCuProp.requestLoad = 30;
+    scalerCuProp.poolId = 0;
+
+    memset(&unknownCuProp, 0, sizeof(xrmCuPropertyV2));
+    memset(&unknownCuRes, 0, sizeof(xrmCuResourceV2));
+    strcpy(unknownCuProp.kernelName, "no_such_kernel");
+    strcpy(unknownCuProp.kernelAlias, "");
+    unknownCuProp.devExcl = false;
+    unknownCuProp.deviceInfo = 0;
+    unknownCuProp.requestLoad = 30;
+    unknownCuProp.poolId = 0;
+
+    /* the failing operation in the middle doesn't stop the following ones */
+    printf("Test V2-13-1: batch of cu alloc, the second one fails\n");
+    memset(ops, 0, sizeof(ops));
+    ops[0].opType = XRM_BATCH_OP_CU_ALLOC_V2;
+    ops[0].cuProp = &scalerCuProp;
+    ops[0].cuRes = &scalerCuRes[0];
+    ops[1].opType = XRM_BATCH_OP_CU_ALLOC_V2;
+    ops[1].cuProp = &unknownCuProp;
+    ops[1].cuRes = &unknownCuRes;
+    ops[2].opType = XRM_BATCH_OP_CU_ALLOC_V2;
+    ops[2].cuProp = &scalerCuProp;
+    ops[2].cuRes = &scalerCuRes[1];
+    ret = xrmBatch(ctx, ops, 3);
+    if (ret != XRM_SUCCESS) {
+        printf("xrmBatch: fail to do the batch, ret is %d\n", ret);
+    } else {
+        for (i = 0; i < 3; i++) printf("xrmBatch: op %d status is %d\n", i, ops[i].status);
+        if (ops[0].status == XRM_SUCCESS && ops[1].status != XRM_SUCCESS && ops[2].status == XRM_SUCCESS)
+            printf("success to alloc scaler cus around the failing op\n");
+        else
+            printf("fail to get the expected status of the batch\n");
+    }
+
+    /* mix of check status, allocation query and release, the second release of same cu fails */
+    printf("Test V2-13-2: batch of cu check status, allocation query and release\n");
+    memset(&scalerCuStat, 0, sizeof(xrmCuStat));
+    memset(&allocQuery, 0, sizeof(xrmAllocationQueryInfoV2));
+    allocQuery.allocServiceId = scalerCuRes[0].allocServiceId;
+    strcpy(allocQuery.kernelName, "scaler");
+    queryCuListRes = (xrmCuListResourceV2*)malloc(sizeof(xrmCuListResourceV2));
+    memset(queryCuListRes, 0, sizeof(xrmCuListResourceV2));
+    memset(ops, 0, sizeof(ops));
+    ops[0].opType = XRM_BATCH_OP_CU_CHECK_STATUS;
+    ops[0].cuRes = &scalerCuRes[0];
+    ops[0].cuStat = &scalerCuStat;
+    ops[1].opType = XRM_BATCH_OP_ALLOCATION_QUERY_V2;
+    ops[1].allocQuery = &allocQuery;
+    ops[1].cuListRes = queryCuListRes;
+    ops[2].opType = XRM_BATCH_OP_CU_RELEASE_V2;
+    ops[2].cuRes = &scalerCuRes[0];
+    ops[3].opType = XRM_BATCH_OP_CU_RELEASE_V2;
+    ops[3].cuRes = &scalerCuRes[0];
+    ops[4].opType = XRM_BATCH_OP_CU_RELEASE_V2;
+    ops[4].cuRes = &scalerCuRes[1];
+    ret = xrmBatch(ctx, ops, 5);
+    if (ret != XRM_SUCCESS) {
+        printf("xrmBatch: fail to do the batch, ret is %d\n", ret);
+    } else {
+        for (i = 0; i < 5; i++) printf("xrmBatch: op %d status is %d\n", i, ops[i].status);
+        if (ops[0].status == XRM_SUCCESS)
+            printf("xrmBatch: scaler cu isBusy is %d, usedLoad is %d\n", scalerCuStat.isBusy, scalerCuStat.usedLoad);
+        if (ops[1].status == XRM_SUCCESS)
+            printf("xrmBatch: query scaler cu allocation, cuNum is %d\n", queryCuListRes->cuNum);
+        if (ops[0].status == XRM_SUCCESS && ops[1].status == XRM_SUCCESS && ops[2].status == XRM_SUCCESS &&
+            ops[3].status != XRM_SUCCESS && ops[4].status == XRM_SUCCESS)
+            printf("success to check, query and release scaler cus around the failing op\n");
+        else
+            printf("fail to get the expected status of the batch\n");
+    }
+    free(queryCuListRes);
+
+    printf("<<<<<<<==  end the xrm batch V2 test ===>>>>>>>>\n");
+}
+
+/*
+ * Release the cu after a delay from another context, to wake up the blocking allocation
+ */
+typedef struct xrmTestDelayedRelease {
+    xrmContext ctx;
+    xrmCuResource* cuRes;
+    useconds_t delay;
+} xrmTestDelayedRelease;
+
+void* xrmTestDelayedReleaseThread(void* arg) {
+    xrmTestDelayedRelease* release = (xrmTestDelayedRelease*)arg;
+
+    usleep(release->delay);
+    if (xrmCuRelease(release->ctx, release->cuRes))
+        printf("success to release the full scaler cu from the other context\n");
+    else
+        printf("fail to release the full scaler cu from the other context\n");
+    return (NULL);
+}
+
+/*
+ * Take all the load of the scaler cus, return the number of the full cus
+ */
+int32_t xrmTestFillScalerCus(xrmContext ctx, xrmCuResource* fullCuRes, int32_t maxCuNum) {
+    xrmCuProperty fullCuProp;
+    int32_t cuNum;
+
+    memset(&fullCuProp, 0, sizeof(xrmCuProperty));
+    strcpy(fullCuProp.kernelName, "scaler");
+    strcpy(fullCuProp.kernelAlias, "");
+    fullCuProp.devExcl = false;
+    fullCuProp.requestLoad = 100;
+    fullCuProp.poolId = 0;
+    for (cuNum = 0; cuNum < maxCuNum; cuNum++) {
+        memset(&fullCuRes[cuNum], 0, sizeof(xrmCuResource));
+        if (xrmCuAlloc(ctx, &fullCuProp, &fullCuRes[cuNum]) != XRM_SUCCESS) break;
+    }
+    return (cuNum);
+}
+
+void xrmCuBlockingAllocWithTimeoutTest(xrmContext* ctx) {
+#define FULL_CU_MAX_NUM 1024
+    int32_t i, ret, fullCuNum;
+    pthread_t thread;
+    xrmTestDelayedRelease release;
+    printf("<<<<<<<==  start the xrm blocking allocation with timeout test ===>>>>>>>>\n");
+    if (ctx == NULL) {
+        printf("ctx is null, fail to do cu blocking alloc with timeout test\n");
+        return;
+    }
+
+    /* the scaler cus are taken by the other context, so the requests of this context wait */
+    printf("Test 19-1: fill all the scaler cus from the other context\n");
+    xrmContext* ownerCtx = (xrmContext*)xrmCreateContext(XRM_API_VERSION_1);
+    if (ownerCtx == NULL) {
+        printf("fail to create the other context\n");
+        return;
+    }
+    xrmCuResource* fullCuRes = (xrmCuResource*)malloc(FULL_CU_MAX_NUM * sizeof(xrmCuResource));
+    fullCuNum = xrmTestFillScalerCus(ownerCtx, fullCuRes, FULL_CU_MAX_NUM);
+    printf("filled %d scaler cus\n", fullCuNum);
+    if (fullCuNum == 0) {
+        printf("no scaler cu, fail to do cu blocking alloc with timeout test\n");
+        free(fullCuRes);
+        xrmDestroyContext(ownerCtx);
+        return;
+    }
+    release.ctx = ownerCtx;
+    release.cuRes = &fullCuRes[0];
+    release.delay = 300000; // 300000 useconds (300 ms)
+
+    xrmCuProperty scalerCuProp;
+    xrmCuResource scalerCuRes;
+
+    memset(&scalerCuProp, 0, sizeof(xrmCuProperty));
+    memset(&scalerCuRes, 0, sizeof(xrmCuResource));
+    strcpy(scalerCuProp.kernelName, "scaler");
+    strcpy(scalerCuProp.kernelAlias, "");
+    scalerCuProp.devExcl = false;
+    scalerCuProp.requestLoad = 45;
+    scalerCuProp.poolId = 0;
+
+    xrmCuListProperty scalerCuListProp;
+    xrmCuListResource scalerCuListRes;
+
+    memset(&scalerCuListProp, 0, sizeof(xrmCuListProperty));
+    memset(&scalerCuListRes, 0, sizeof(xrmCuListResource));
+    scalerCuListProp.cuNum = 1;
+    strcpy(scalerCuListProp.cuProps[0].kernelName, "scaler");
+    strcpy(scalerCuListProp.cuProps[0].kernelAlias, "");
+    scalerCuListProp.cuProps[0].devExcl = false;
+    scalerCuListProp.cuProps[0].requestLoad = 45;
+    scalerCuListProp.cuProps[0].poolId = 0;
+
+    /* the cu group of the first full cu, it's the one released to wake up the requests */
+    char udfCuGroupName[XRM_MAX_NAME_LEN];
+    xrmUdfCuGroupProperty* udfCuGroupProp = (xrmUdfCuGroupProperty*)malloc(sizeof(xrmUdfCuGroupProperty));
+    memset(udfCuGroupProp, 0, sizeof(xrmUdfCuGroupProperty));
+    strcpy(udfCuGroupName, "udfCuGroupTimeout");
+    udfCuGroupProp->optionUdfCuListNum = 1;
+    udfCuGroupProp->optionUdfCuListProps[0].cuNum = 1;
+    udfCuGroupProp->optionUdfCuListProps[0].sameDevice = true;
+    strcpy(udfCuGroupProp->optionUdfCuListProps[0].udfCuProps[0].cuName, fullCuRes[0].cuName);
+    udfCuGroupProp->optionUdfCuListProps[0].udfCuProps[0].devExcl = false;
+    udfCuGroupProp->optionUdfCuListProps[0].udfCuProps[0].requestLoad = 45;
+    ret = xrmUdfCuGroupDeclare(ctx, udfCuGroupProp, udfCuGroupName);
+    if (ret != XRM_SUCCESS) printf("xrmUdfCuGroupDeclare(): user defined cu group declaration fail\n");
+
+    xrmCuGroupProperty cuGroupProp;
+    xrmCuGroupResource cuGroupRes;
+
+    memset(&cuGroupProp, 0, sizeof(xrmCuGroupProperty));
+    memset(&cuGroupRes, 0, sizeof(xrmCuGroupResource));
+    strcpy(cuGroupProp.udfCuGroupName, udfCuGroupName);
+    cuGroupProp.poolId = 0;
+
+    uint64_t timeout = 200000; // 200000 useconds (200 ms)
+
+    printf("Test 19-2: blocking alloc scaler cu, timed out\n");
+    ret = xrmCuBlockingAllocWithTimeout(ctx, &scalerCuProp, 0, timeout, &scalerCuRes);
+    if (ret != XRM_SUCCESS) {
+        printf("xrmCuBlockingAllocWithTimeout: timed out as expected, ret is %d\n", ret);
+    } else {
+        printf("xrmCuBlockingAllocWithTimeout: fail to time out, scaler cu is allocated\n");
+        xrmCuRelease(ctx, &scalerCuRes);
+    }
+
+    printf("Test 19-3: blocking alloc scaler cu list, timed out\n");
+    ret = xrmCuListBlockingAllocWithTimeout(ctx, &scalerCuListProp, 0, timeout, &scalerCuListRes);
+    if (ret != XRM_SUCCESS) {
+        printf("xrmCuListBlockingAllocWithTimeout: timed out as expected, ret is %d\n", ret);
+    } else {
+        printf("xrmCuListBlockingAllocWithTimeout: fail to time out, scaler cu list is allocated\n");
+        xrmCuListRelease(ctx, &scalerCuListRes);
+    }
+
+    printf("Test 19-4: blocking alloc user defined cu group, timed out\n");
+    ret = xrmCuGroupBlockingAllocWithTimeout(ctx, &cuGroupProp, 0, timeout, &cuGroupRes);
+    if (ret != XRM_SUCCESS) {
+        printf("xrmCuGroupBlockingAllocWithTimeout: timed out as expected, ret is %d\n", ret);
+    } else {
+        printf("xrmCuGroupBlockingAllocWithTimeout: fail to time out, user defined cu group is allocated\n");
+        xrmCuGroupRelease(ctx, &cuGroupRes);
+    }
+
+    timeout = 10000000; // 10000000 useconds (10 s)
+
+    printf("Test 19-5: blocking alloc scaler cu, woken up by the release from the other context\n");
+    pthread_create(&thread, NULL, xrmTestDelayedReleaseThread, &release);
+    ret = xrmCuBlockingAllocWithTimeout(ctx, &scalerCuProp, 0, timeout, &scalerCuRes);
+    pthread_join(thread, NULL);
+    if (ret != XRM_SUCCESS) {
+        printf("xrmCuBlockingAllocWithTimeout: fail to alloc scaler cu after release, ret is %d\n", ret);
+    } else {
+        printf("xrmCuBlockingAllocWithTimeout: allocated scaler cu: deviceId %d, cuId %d, channelId %d\n",
+               scalerCuRes.deviceId, scalerCuRes.cuId, scalerCuRes.channelId);
+        if (!xrmCuRelease(ctx, &scalerCuRes)) printf("fail to release scaler cu\n");
+    }
+    /* take the released cu again */
+    xrmTestFillScalerCus(ownerCtx, &fullCuRes[0], 1);
+
+    printf("Test 19-6: blocking alloc scaler cu list, woken up by the release from the other context\n");
+    pthread_create(&thread, NULL, xrmTestDelayedReleaseThread, &release);
+    ret = xrmCuListBlockingAllocWithTimeout(ctx, &scalerCuListProp, 0, timeout, &scalerCuListRes);
+    pthread_join(thread, NULL);
+    if (ret != XRM_SUCCESS) {
+        printf("xrmCuListBlockingAllocWithTimeout: fail to alloc scaler cu list after release, ret is %d\n", ret);
+    } else {
+        printf("xrmCuListBlockingAllocWithTimeout: allocated scaler cu list: deviceId %d, cuId %d\n",
+               scalerCuListRes.cuResources[0].deviceId, scalerCuListRes.cuResources[0].cuId);
+        if (!xrmCuListRelease(ctx, &scalerCuListRes)) printf("fail to release scaler cu list\n");
+    }
+    xrmTestFillScalerCus(ownerCtx, &fullCuRes[0], 1);
+
+    printf("Test 19-7: blocking alloc user defined cu group, woken up by the release from the other context\n");
+    pthread_create(&thread, NULL, xrmTestDelayedReleaseThread, &release);
+    ret = xrmCuGroupBlockingAllocWithTimeout(ctx, &cuGroupProp, 0, timeout, &cuGroupRes);
+    pthread_join(thread, NULL);
+    if (ret != XRM_SUCCESS) {
+        printf("xrmCuGroupBlockingAllocWithTimeout: fail to alloc cu group after release, ret is %d\n", ret);
+    } else {
+        printf("xrmCuGroupBlockingAllocWithTimeout: allocated user defined cu group: deviceId %d, cuId %d\n",
+               cuGroupRes.cuResources[0].deviceId, cuGroupRes.cuResources[0].cuId);
+        if (!xrmCuGroupRelease(ctx, &cuGroupRes)) printf("fail to release user defined cu group\n");
+    }
+
+    printf("Test 19-8: release all the full scaler cus\n");
+    /* the first full cu is already released by the last wake up */
+    for (i = 1; i < fullCuNum; i++)
+        if (!xrmCuRelease(ownerCtx, &fullCuRes[i])) printf("fail to release full scaler cu %d\n", i);
+    ret = xrmUdfCuGroupUndeclare(ctx, udfCuGroupName);
+    if (ret != XRM_SUCCESS) printf("xrmUdfCuGroupUndeclare(): user defined cu group undeclaration fail\n");
+    free(udfCuGroupProp);
+    free(fullCuRes);
+    xrmDestroyContext(ownerCtx);
+
+    printf("<<<<<<<==  end the xrm blocking allocation with timeout test ===>>>>>>>>\n");
+}
+
+/*
+ * Events received by the subscribed context, counts the cu available events of the scaler kernel
+ */
+typedef struct xrmTestEventCount {
+    int32_t count;
+    int32_t scalerCount;
+} xrmTestEventCount;
+
+void xrmTestEventCallback(xrmContext context, const xrmEvent* event, void* userData) {
+    xrmTestEventCount* eventCount = (xrmTestEventCount*)userData;
+
+    printf("xrmEventCallback: event type 0x%x, deviceId %d, kernelName %s\n", event->type, event->deviceId,
+           event->kernelName);
+    if (event->type == XRM_EVENT_CU_AVAILABLE &&
+        (strcmp(event->kernelName, "scaler") == 0 || event->kernelName[0] == '\0'))
+        __atomic_add_fetch(&eventCount->scalerCount, 1, __ATOMIC_ACQ_REL);
+    __atomic_add_fetch(&eventCount->count, 1, __ATOMIC_ACQ_REL);
+}
+
+void xrmEventSubscribeTest(xrmContext* ctx) {
+    int32_t ret, count;
+    xrmTestEventCount eventCount;
+    printf("<<<<<<<==  start the xrm event subscribe test ===>>>>>>>>\n");
+    if (ctx == NULL) {
+        printf("ctx is null, fail to do event subscribe test\n");
+        return;
+    }
+
+    xrmCuProperty scalerCuProp;
+    xrmCuResource scalerCuRes;
+
+    memset(&scalerCuProp, 0, sizeof(xrmCuProperty));
+    memset(&scalerCuRes, 0, sizeof(xrmCuResource));
+    strcpy(scalerCuProp.kernelName, "scaler");
+    strcpy(scalerCuProp.kernelAlias, "");
+    scalerCuProp.devExcl = false;
+    scalerCuProp.requestLoad = 45;
+    scalerCuProp.poolId = 0;
+
+    printf("Test 20-1: subscribe cu available event\n");
+    memset(&eventCount, 0, sizeof(eventCount));
+    ret = xrmEventSubscribe(ctx, XRM_EVENT_CU_AVAILABLE, xrmTestEventCallback, &eventCount);
+    if (ret != XRM_SUCCESS) {
+        printf("xrmEventSubscribe: fail to subscribe cu available event, ret is %d\n", ret);
+        return;
+    }
+
+    printf("Test 20-2: alloc and release scaler cu, the event is received\n");
+    ret = xrmCuAlloc(ctx, &scalerCuProp, &scalerCuRes);
+    if (ret != XRM_SUCCESS) {
+        printf("xrmCuAlloc: fail to alloc scaler cu, ret is %d\n", ret);
+    } else {
+        if (!xrmCuRelease(ctx, &scalerCuRes)) printf("fail to release scaler cu\n");
+        if (xrmTestWaitCount(&eventCount.scalerCount, 1, 5000))
+            printf("xrmEventSubscribe: cu available event of scaler is received\n");
+        else
+            printf("xrmEventSubscribe: fail to receive cu available event of scaler\n");
+    }
+
+    printf("Test 20-3: unsubscribe event, alloc and release scaler cu, no event is received\n");
+    ret = xrmEventUnsubscribe(ctx);
+    if (ret != XRM_SUCCESS) printf("xrmEventUnsubscribe: fail to unsubscribe event, ret is %d\n", ret);
+    count = __atomic_load_n(&eventCount.count, __ATOMIC_ACQUIRE);
+    memset(&scalerCuRes, 0, sizeof(xrmCuResource));
+    ret = xrmCuAlloc(ctx, &scalerCuProp, &scalerCuRes);
+    if (ret != XRM_SUCCESS) {
+        printf("xrmCuAlloc: fail to alloc scaler cu, ret is %d\n", ret);
+    } else {
+        if (!xrmCuRelease(ctx, &scalerCuRes)) printf("fail to release scaler cu\n");
+        /* give the event the time to arrive if it were still delivered */
+        if (xrmTestWaitCount(&eventCount.count, count + 1, 500))
+            printf("xrmEventUnsubscribe: fail to stop the event, callback is called after unsubscribe\n");
+        else
+            printf("xrmEventUnsubscribe: no event is received after unsubscribe\n");
+    }
+
+    printf("<<<<<<<==  end the xrm event subscribe test ===>>>>>>>>\n");
+}
+
 void testXrmFunctions(void) {
     printf("<<<<<<<==  Start the xrm function test ===>>>>>>>>\n\n");
     xrmContext* ctx = (xrmContext*)xrmCreateContext(XRM_API_VERSION_1);
@@ -4367,6 +4919,7 @@ void testXrmFunctions(void) {
     xrmCuBlockingAllocReleaseTest(ctx);
     xrmCuListBlockingAllocReleaseTest(ctx);
     xrmCuGroupBlockingAllocReleaseTest(ctx);
+    xrmCuBlockingAllocWithTimeoutTest(ctx);
     xrmCuAllocFromDevReleaseTest(ctx);
     xrmCuAllocReleaseGranularity1000000Test(ctx);
     xrmCuListAllocReleaseGranularity1000000Test(ctx);
@@ -4386,6 +4939,9 @@ void testXrmFunctions(void) {
 
     xrmCuAllocReleaseV2Test(ctx);
     xrmCuListAllocReleaseV2Test(ctx);
+    xrmCuAsyncAllocReleaseV2Test(ctx);
+    xrmBatchV2Test(ctx);
+    xrmEventSubscribeTest(ctx);
 
     xrmCuPoolReserveAllocReleaseRelinquishV2Test(ctx);
 
@@ -28,6 +28,8 @@
 #include <string.h>
 #include <time.h>
 #include <libgen.h>
+#include <poll.h>
+#include <pthread.h>
 #include <stdint.h>
 #include <uuid/uuid.h>
 #include <xrm.h>
@@ -76,6 +78,15 @@ void xrmCuAllocFromDevReleaseGranularity1000000Test(xrmContext* ctx);
 void xrmCuAllocReleaseV2Test(xrmContext* ctx);
 void xrmCuListAllocReleaseV2Test(xrmContext* ctx);
 void xrmCuPoolReserveAllocReleaseRelinquishV2Test(xrmContext* ctx);
+void xrmTestCompletionCallback(xrmRequest request, int32_t status, void* userData);
+bool xrmTestWaitCount(int32_t* count, int32_t expected, int32_t timeout);
+void xrmCuAsyncAllocReleaseV2Test(xrmContext* ctx);
+void xrmBatchV2Test(xrmContext* ctx);
+void* xrmTestDelayedReleaseThread(void* arg);
+int32_t xrmTestFillScalerCus(xrmContext ctx, xrmCuResource* fullCuRes, int32_t maxCuNum);
+void xrmCuBlockingAllocWithTimeoutTest(xrmContext* ctx);
+void xrmTestEventCallback(xrmContext context, const xrmEvent* event, void* userData);
+void xrmEventSubscribeTest(xrmContext* ctx);
 
 #ifdef __cplusplus
 }